@@ -0,0 +1,4 @@
+@echo off
+compiler.exe bench.c -l SDL3 -o bin/bench.exe
+bin\bench.exe --frames 600 --out bench.json
+pause
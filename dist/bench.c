@@ -0,0 +1,488 @@
+// Бенчмарк движка: сцены без окна с фиксированным seed и шагом 1/60.
+// Каждая сцена печатает p50/p99 по фазам кадра, выделения памяти,
+// число вызовов отрисовки и промахи кэша в JSON - для сравнения между
+// версиями.
+//
+//   bench.exe [--frames N] [--seed S] [--scene имя] [--out файл] [--window]
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#define MIRULIT_MAX_ENTITIES 65536
+#define MIRULIT_HEADER_ONLY
+#include <mirulit.h>
+
+// ==================== СЧЕТЧИК ВЫДЕЛЕНИЙ ====================
+// Все выделения движка проходят через MIR_SetAllocator - считаем
+// обращения к системной куче. Выделения из пулов и арены кадра сюда
+// не попадают: это и есть то, что нужно видеть в горячем цикле.
+
+static long long bench_allocs = 0;
+static long long bench_alloc_bytes = 0;
+static long long bench_frees = 0;
+
+static void* Bench_Allocate(size_t size, void* user_data) {
+    (void)user_data;
+    bench_allocs++;
+    bench_alloc_bytes += size;
+    return malloc(size);
+}
+
+static void* Bench_Reallocate(void* ptr, size_t size, void* user_data) {
+    (void)user_data;
+    bench_allocs++;
+    bench_alloc_bytes += size;
+    return realloc(ptr, size);
+}
+
+static void Bench_Deallocate(void* ptr, void* user_data) {
+    (void)user_data;
+    if (ptr) bench_frees++;
+    free(ptr);
+}
+
+// ==================== ПРОМАХИ КЭША ====================
+// На Linux - аппаратный счетчик perf_event (промахи последнего уровня
+// кэша, только код пользователя). Где счетчика нет (Windows, виртуальные
+// машины без PMU), в JSON пишется null.
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int bench_perf_fd = -1;
+
+static void Counters_Open(void) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    bench_perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static long long Counters_Read(void) {
+    long long value = 0;
+    if (bench_perf_fd < 0 || read(bench_perf_fd, &value, sizeof(value)) != sizeof(value)) return 0;
+    return value;
+}
+
+static void Counters_Close(void) {
+    if (bench_perf_fd >= 0) close(bench_perf_fd);
+    bench_perf_fd = -1;
+}
+#else
+static int bench_perf_fd = -1;
+static void Counters_Open(void) {}
+static long long Counters_Read(void) { return 0; }
+static void Counters_Close(void) {}
+#endif
+
+// ==================== ФАЗЫ И СЦЕНЫ ====================
+
+#define BENCH_WIDTH 1280
+#define BENCH_HEIGHT 720
+#define BENCH_WARMUP 10
+#define BENCH_DT (1.0f / 60.0f)
+
+typedef enum {
+    PHASE_SCRIPT,       // действия сцены (создание/удаление, эмиссия)
+    PHASE_UPDATE,
+    PHASE_COLLIDE,
+    PHASE_PARTICLES,
+    PHASE_DRAW,
+    PHASE_PRESENT,
+    PHASE_FRAME,
+    PHASE_COUNT
+} BenchPhase;
+
+static const char* phase_names[PHASE_COUNT] = {
+    "script", "update", "collide", "particles", "draw", "present", "frame"
+};
+
+typedef struct {
+    const char* name;
+    int entities;
+    bool collide;
+    void (*setup)(int entities);
+    void (*step)(int frame);
+} BenchScene;
+
+static SDL_Texture* bench_texture = NULL;
+static int bench_hits = 0;
+
+static MIR_Entity* SpawnEntity(MIR_World* world, bool collider) {
+    MIR_Entity* entity = MIR_World_CreateEntity(world, "Bench");
+    if (!entity) return NULL;
+
+    entity->transform.position = (MIR_Vec2){
+        MIR_Math_RandomRange(-BENCH_WIDTH / 2.0f, BENCH_WIDTH / 2.0f),
+        MIR_Math_RandomRange(-BENCH_HEIGHT / 2.0f, BENCH_HEIGHT / 2.0f)
+    };
+    entity->transform.velocity = (MIR_Vec2){
+        MIR_Math_RandomRange(-100, 100),
+        MIR_Math_RandomRange(-100, 100)
+    };
+    entity->transform.scale = (MIR_Vec2){8, 8};
+    entity->sprite.color = (MIR_Color){
+        (uint8_t)MIR_Rng_Int(MIR_Rng_Thread(), 0, 255),
+        (uint8_t)MIR_Rng_Int(MIR_Rng_Thread(), 0, 255),
+        (uint8_t)MIR_Rng_Int(MIR_Rng_Thread(), 0, 255),
+        255
+    };
+    entity->collider.bounds = (MIR_Rect){0, 0, 8, 8};
+    entity->collider.enabled = collider;
+    return entity;
+}
+
+// Отражение от краев экрана - обычный для игры пользовательский update
+static void BounceUpdate(MIR_Entity* entity, float dt) {
+    (void)dt;
+    MIR_Transform* t = &entity->transform;
+    if (t->position.x < -BENCH_WIDTH / 2.0f || t->position.x > BENCH_WIDTH / 2.0f) {
+        t->velocity.x = -t->velocity.x;
+    }
+    if (t->position.y < -BENCH_HEIGHT / 2.0f || t->position.y > BENCH_HEIGHT / 2.0f) {
+        t->velocity.y = -t->velocity.y;
+    }
+}
+
+static void CountHit(MIR_Entity* self, MIR_Entity* other) {
+    (void)self;
+    (void)other;
+    bench_hits++;
+}
+
+// Движущиеся сущности без коллайдеров
+static void SetupMoving(int entities) {
+    for (int i = 0; i < entities; i++) {
+        MIR_Entity* entity = SpawnEntity(MIR_GetWorld(), false);
+        MIR_SetEntityUpdate(entity, BounceUpdate);
+    }
+}
+
+// Частицы: каждый кадр пул добивается до емкости вспышкой
+static void StepParticles(int frame) {
+    (void)frame;
+    MIR_EmitParticleBurst((MIR_Vec2){0, 0}, MIRULIT_MAX_PARTICLES - _mir->world->particle_count,
+                          200.0f, (MIR_Vec2){0, 50}, MIR_COLOR_ORANGE, 2.0f, 4.0f, 0.2f, 1.0f);
+}
+
+// Плотное поле коллайдеров в центре экрана
+static void SetupCollision(int entities) {
+    for (int i = 0; i < entities; i++) {
+        MIR_Entity* entity = SpawnEntity(MIR_GetWorld(), true);
+        if (!entity) continue;
+        entity->transform.position.x *= 0.25f;
+        entity->transform.position.y *= 0.25f;
+        MIR_SetEntityUpdate(entity, BounceUpdate);
+        MIR_SetEntityOnCollision(entity, CountHit);
+    }
+}
+
+// Спрайты с общей текстурой и случайным z-index
+static void SetupSprites(int entities) {
+    for (int i = 0; i < entities; i++) {
+        MIR_Entity* entity = SpawnEntity(MIR_GetWorld(), false);
+        if (!entity) continue;
+        entity->sprite.texture = bench_texture;
+        entity->sprite.z_index = MIR_Rng_Int(MIR_Rng_Thread(), 0, 15);
+        entity->transform.scale = (MIR_Vec2){16, 16};
+        MIR_SetEntityUpdate(entity, BounceUpdate);
+    }
+}
+
+// Часть спрайтов меняет слой - сортировке есть что делать
+static void StepSprites(int frame) {
+    (void)frame;
+    MIR_Rng* rng = MIR_Rng_Thread();
+    int changes = _mir->world->entity_count / 100;
+    for (int i = 0; i < changes; i++) {
+        _mir->world->entities[MIR_Rng_Int(rng, 0, _mir->world->entity_count - 1)]->sprite.z_index = MIR_Rng_Int(rng, 0, 15);
+    }
+}
+
+// Текучка: каждый кадр удаляется и создается 5% сущностей
+static void StepChurn(int frame) {
+    (void)frame;
+    int churn = _mir->world->entity_count / 20;
+    for (int i = 0; i < churn && _mir->world->entity_count > 0; i++) {
+        MIR_DestroyEntity(_mir->world->entities[MIR_Rng_Int(MIR_Rng_Thread(), 0, _mir->world->entity_count - 1)]);
+    }
+    for (int i = 0; i < churn; i++) {
+        MIR_Entity* entity = SpawnEntity(MIR_GetWorld(), false);
+        MIR_SetEntityUpdate(entity, BounceUpdate);
+    }
+}
+
+// Серверный режим: независимые миры без отрисовки шагают параллельно
+#define BENCH_WORLDS 16
+
+static MIR_World* bench_worlds[BENCH_WORLDS];
+
+static void SetupWorlds(int entities) {
+    for (int w = 0; w < BENCH_WORLDS; w++) {
+        bench_worlds[w] = MIR_World_Create();
+        if (!bench_worlds[w]) continue;
+        bench_worlds[w]->collisions = false;
+        for (int i = 0; i < entities; i++) {
+            MIR_SetEntityUpdate(SpawnEntity(bench_worlds[w], false), BounceUpdate);
+        }
+    }
+}
+
+static void StepWorlds(int frame) {
+    (void)frame;
+    MIR_World_StepParallel(bench_worlds, BENCH_WORLDS, BENCH_DT);
+}
+
+static const BenchScene bench_scenes[] = {
+    {"moving_10k", 10000, false, SetupMoving, NULL},
+    {"moving_50k", 50000, false, SetupMoving, NULL},
+    {"particle_storm", 0, false, NULL, StepParticles},
+    {"collision_field", 2000, true, SetupCollision, NULL},
+    {"sprites_zsorted", 20000, false, SetupSprites, StepSprites},
+    {"entity_churn", 10000, false, SetupMoving, StepChurn},
+    {"worlds_parallel", 5000, false, SetupWorlds, StepWorlds},
+};
+
+#define BENCH_SCENE_COUNT ((int)(sizeof(bench_scenes) / sizeof(bench_scenes[0])))
+
+// ==================== ЗАМЕРЫ ====================
+
+static int CompareUint64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Отметка начала фазы: время и счетчик промахов
+static void Mark(uint64_t* t, long long* m, int phase) {
+    t[phase] = SDL_GetTicksNS();
+    m[phase] = Counters_Read();
+}
+
+// Перцентиль по ближайшему рангу, мс. samples сортируется.
+static double Percentile(uint64_t* samples, int count, double p) {
+    if (count <= 0) return 0.0;
+    int rank = (int)ceil(p * count) - 1;
+    if (rank < 0) rank = 0;
+    return samples[rank] / 1e6;
+}
+
+static void ClearScene(void) {
+    while (_mir->world->entity_count > 0) {
+        MIR_Entity* entity = _mir->world->entities[_mir->world->entity_count - 1];
+        entity->sprite.texture = NULL;     // общая текстура, уничтожается отдельно
+        MIR_DestroyEntity(entity);
+    }
+    for (int i = 0; i < MIRULIT_MAX_PARTICLES; i++) {
+        _mir->world->particles[i].active = false;
+    }
+    _mir->world->particle_count = 0;
+
+    for (int w = 0; w < BENCH_WORLDS; w++) {
+        MIR_World_Destroy(bench_worlds[w]);
+        bench_worlds[w] = NULL;
+    }
+}
+
+static void RunScene(const BenchScene* scene, int frames, unsigned int seed, FILE* out, bool first) {
+    uint64_t* samples = (uint64_t*)calloc((size_t)frames * PHASE_COUNT, sizeof(uint64_t));
+    if (!samples) return;
+
+    MIR_Random_Seed(seed);
+    MIR_World_Seed(MIR_GetWorld(), seed);
+    bench_hits = 0;
+
+    MIR_FrameArenaStats arena_before = MIR_FrameArena_GetStats();
+    long long setup_allocs = bench_allocs;
+    if (scene->setup) scene->setup(scene->entities);
+    setup_allocs = bench_allocs - setup_allocs;
+
+    long long allocs = 0, alloc_bytes = 0, frees = 0, draw_calls = 0;
+    long long misses[PHASE_COUNT] = {0};
+
+    for (int frame = -BENCH_WARMUP; frame < frames; frame++) {
+        uint64_t t[PHASE_COUNT + 1];
+        long long m[PHASE_COUNT + 1];
+        long long allocs_before = bench_allocs;
+        long long bytes_before = bench_alloc_bytes;
+        long long frees_before = bench_frees;
+
+        MIR_ProcessEvents();
+        MIR_BeginFrame();
+        _mir->world->delta_time = BENCH_DT;    // шаг фиксирован - результат не зависит от скорости машины
+
+        Mark(t, m, PHASE_SCRIPT);
+        if (scene->step) scene->step(frame);
+        Mark(t, m, PHASE_UPDATE);
+        MIR_UpdateEntities();
+        Mark(t, m, PHASE_COLLIDE);
+        if (scene->collide) MIR_ResolveCollisions();
+        Mark(t, m, PHASE_PARTICLES);
+        MIR_UpdateParticles();
+        Mark(t, m, PHASE_DRAW);
+        MIR_DrawEntities();
+        MIR_DrawParticles();
+        int frame_draw_calls = _mir->draw_calls;
+        Mark(t, m, PHASE_PRESENT);
+        MIR_EndFrame();
+        Mark(t, m, PHASE_FRAME);
+
+        if (frame < 0) continue;
+
+        for (int p = 0; p < PHASE_FRAME; p++) {
+            samples[p * frames + frame] = t[p + 1] - t[p];
+        }
+        samples[PHASE_FRAME * frames + frame] = t[PHASE_FRAME] - t[PHASE_SCRIPT];
+        for (int p = 0; p < PHASE_FRAME; p++) {
+            misses[p] += m[p + 1] - m[p];
+        }
+        misses[PHASE_FRAME] += m[PHASE_FRAME] - m[PHASE_SCRIPT];
+
+        allocs += bench_allocs - allocs_before;
+        alloc_bytes += bench_alloc_bytes - bytes_before;
+        frees += bench_frees - frees_before;
+        draw_calls += frame_draw_calls;
+    }
+
+    fprintf(out, "%s    {\n", first ? "" : ",\n");
+    fprintf(out, "      \"name\": \"%s\",\n", scene->name);
+    fprintf(out, "      \"entities\": %d,\n", _mir->world->entity_count);
+    fprintf(out, "      \"particles\": %d,\n", _mir->world->particle_count);
+    fprintf(out, "      \"phases\": {\n");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        uint64_t* phase = samples + p * frames;
+        double total = 0.0;
+        for (int i = 0; i < frames; i++) total += phase[i];
+        qsort(phase, frames, sizeof(uint64_t), CompareUint64);
+        fprintf(out, "        \"%s\": {\"p50_ms\": %.4f, \"p99_ms\": %.4f, \"mean_ms\": %.4f, \"max_ms\": %.4f}%s\n",
+                phase_names[p], Percentile(phase, frames, 0.50), Percentile(phase, frames, 0.99),
+                total / frames / 1e6, phase[frames - 1] / 1e6, p + 1 < PHASE_COUNT ? "," : "");
+    }
+    fprintf(out, "      },\n");
+    fprintf(out, "      \"setup_allocs\": %lld,\n", setup_allocs);
+    fprintf(out, "      \"allocs_per_frame\": %.2f,\n", (double)allocs / frames);
+    fprintf(out, "      \"alloc_bytes_per_frame\": %.1f,\n", (double)alloc_bytes / frames);
+    fprintf(out, "      \"frees_per_frame\": %.2f,\n", (double)frees / frames);
+    fprintf(out, "      \"draw_calls_per_frame\": %.1f,\n", (double)draw_calls / frames);
+
+    // Промахи кэша на кадр по фазам
+    if (bench_perf_fd >= 0) {
+        fprintf(out, "      \"cache_misses_per_frame\": {");
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            fprintf(out, "%s\"%s\": %.1f", p ? ", " : "", phase_names[p], (double)misses[p] / frames);
+        }
+        fprintf(out, "},\n");
+    } else {
+        fprintf(out, "      \"cache_misses_per_frame\": null,\n");
+    }
+
+    MIR_FrameArenaStats arena = MIR_FrameArena_GetStats();
+    fprintf(out, "      \"frame_arena\": {\"peak_bytes\": %llu, \"capacity\": %llu, \"overflow_frames\": %d},\n",
+            (unsigned long long)arena.peak, (unsigned long long)arena.capacity,
+            arena.overflows - arena_before.overflows);
+    fprintf(out, "      \"memory\": {");
+    for (int tag = 0; tag < MIR_MEM_TAG_COUNT; tag++) {
+        MIR_MemoryStats stats = MIR_Memory_GetStats((MIR_MemTag)tag);
+        fprintf(out, "%s\"%s\": {\"bytes\": %llu, \"peak_bytes\": %llu, \"blocks\": %d}",
+                tag ? ", " : "", MIR_Memory_TagName((MIR_MemTag)tag),
+                (unsigned long long)stats.bytes, (unsigned long long)stats.peak_bytes, stats.allocations);
+    }
+    fprintf(out, "},\n");
+    fprintf(out, "      \"collision_hits\": %d\n", bench_hits);
+    fprintf(out, "    }");
+
+    ClearScene();
+    free(samples);
+}
+
+// ==================== MAIN ====================
+
+int main(int argc, char** argv) {
+    int frames = 600;
+    unsigned int seed = 12345;
+    const char* only_scene = NULL;
+    const char* out_path = NULL;
+    bool windowed = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+            only_scene = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--window") == 0) {
+            windowed = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--frames N] [--seed S] [--scene name] [--out file] [--window]\n", argv[0]);
+            fprintf(stderr, "Scenes:");
+            for (int s = 0; s < BENCH_SCENE_COUNT; s++) fprintf(stderr, " %s", bench_scenes[s].name);
+            fprintf(stderr, "\n");
+            return 1;
+        }
+    }
+    if (frames < 1) frames = 1;
+
+    // Без окна: offscreen-драйвер SDL и программный рендерер
+    if (!windowed) {
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+        SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    }
+
+    MIR_Allocator allocator = { Bench_Allocate, Bench_Reallocate, Bench_Deallocate, NULL };
+    MIR_SetAllocator(&allocator);
+
+    if (!MIR_Init("Mirulit Bench", BENCH_WIDTH, BENCH_HEIGHT)) {
+        return 1;
+    }
+    MIR_SetTargetFPS(0);
+    MIR_SetVSync(MIR_VSYNC_OFF);
+    MIR_Log_SetConsole(false);      // stdout может быть занят JSON
+
+    // Общая текстура спрайтов 16x16
+    bench_texture = SDL_CreateTexture(_mir->renderer, SDL_PIXELFORMAT_RGBA8888,
+                                      SDL_TEXTUREACCESS_STATIC, 16, 16);
+    if (bench_texture) {
+        uint32_t pixels[16 * 16];
+        for (int i = 0; i < 16 * 16; i++) pixels[i] = 0xFFFFFFFF;
+        SDL_UpdateTexture(bench_texture, NULL, pixels, 16 * sizeof(uint32_t));
+    }
+
+    FILE* out = out_path ? fopen(out_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Failed to open %s\n", out_path);
+        MIR_Shutdown();
+        return 1;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"engine\": \"%s\",\n", MIRULIT_VERSION);
+    fprintf(out, "  \"frames\": %d,\n", frames);
+    fprintf(out, "  \"seed\": %u,\n", seed);
+    fprintf(out, "  \"renderer\": \"%s\",\n", SDL_GetRendererName(_mir->renderer));
+    fprintf(out, "  \"scenes\": [\n");
+
+    Counters_Open();
+    bool first = true;
+    for (int s = 0; s < BENCH_SCENE_COUNT; s++) {
+        if (only_scene && strcmp(only_scene, bench_scenes[s].name) != 0) continue;
+        if (out != stdout) fprintf(stderr, "Scene %s...\n", bench_scenes[s].name);
+        RunScene(&bench_scenes[s], frames, seed, out, first);
+        first = false;
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) fclose(out);
+    Counters_Close();
+
+    if (bench_texture) SDL_DestroyTexture(bench_texture);
+    MIR_Shutdown();
+    return 0;
+}
@@ -1,18 +1,68 @@
 #include <mirulit.h>
 
-MIR_Entity* player = NULL;
-MIR_Entity* enemy = NULL;
-float spawn_timer = 0;
-int score = 0;
-int enemies_destroyed = 0;
-bool game_paused = false;
-bool is_fullscreen = false;
+// Состояние игры хранится в блоке MIR_Hot_Keep: под host.c оно переживает
+// перекомпиляцию этого файла. Новые поля добавлять в конец.
+typedef struct {
+    MIR_Entity* player;
+    float spawn_timer;
+    int score;
+    int enemies_destroyed;
+    bool paused;
+    bool is_fullscreen;
+    
+    // Текстура игрока
+    SDL_Texture* player_texture;
+    
+    // Скорость игрока
+    MIR_Vec2 player_velocity;
+    
+    // Навигация врагов: сетка препятствий и общее поле потока к игроку
+    MIR_NavGrid* nav_grid;
+    MIR_FlowField* enemy_field;
+} Game;
 
-// Текстура игрока
-SDL_Texture* player_texture = NULL;
+static Game* game = NULL;
 
-// Глобальная переменная для скорости игрока
-static MIR_Vec2 player_velocity = {0, 0};
+#define WALL_COUNT 3
+
+// Стены - неподвижные препятствия для навигационной сетки
+void CreateWalls(void) {
+    const MIR_Rect walls[WALL_COUNT] = {
+        {180, 120, 40, 240},
+        {580, 240, 40, 240},
+        {300, 440, 200, 40}
+    };
+    
+    for (int i = 0; i < WALL_COUNT; i++) {
+        MIR_Entity* wall = MIR_CreateEntity("Wall");
+        wall->transform.position = (MIR_Vec2){
+            walls[i].x + walls[i].w / 2,
+            walls[i].y + walls[i].h / 2
+        };
+        wall->transform.scale = (MIR_Vec2){walls[i].w, walls[i].h};
+        wall->sprite.color = MIR_COLOR_GRAY;
+        wall->collider.bounds = walls[i];
+        wall->collider.is_static = true;
+        wall->collider.enabled = true;
+    }
+}
+
+// Проверка, упирается ли прямоугольник с центром pos в стену
+bool HitsWall(MIR_Vec2 pos, MIR_Vec2 size) {
+    MIR_Rect rect = {pos.x - size.x / 2, pos.y - size.y / 2, size.x, size.y};
+    
+    for (int i = 0; i < _mir->world->entity_count; i++) {
+        MIR_Entity* e = _mir->world->entities[i];
+        if (!e || !e->collider.is_static) continue;
+        
+        MIR_Rect wall = e->collider.bounds;
+        if (rect.x < wall.x + wall.w && rect.x + rect.w > wall.x &&
+            rect.y < wall.y + wall.h && rect.y + rect.h > wall.y) {
+            return true;
+        }
+    }
+    return false;
+}
 
 // Функция для создания частиц ходьбы
 void CreateWalkParticles(MIR_Vec2 position, MIR_Vec2 move_direction, int count) {
@@ -61,7 +111,7 @@ void CreateWalkParticles(MIR_Vec2 position, MIR_Vec2 move_direction, int count)
 }
 
 void PlayerUpdate(MIR_Entity* self, float dt) {
-    if (game_paused) return;
+    if (game->paused) return;
     
     float speed = 300.0f * dt;
     MIR_Vec2 move_dir = {0, 0};
@@ -88,7 +138,7 @@ void PlayerUpdate(MIR_Entity* self, float dt) {
     
     // Расчет реальной скорости игрока
     if (dt > 0) {
-        player_velocity = MIR_Vec2_Multiply(
+        game->player_velocity = MIR_Vec2_Multiply(
             MIR_Vec2_Subtract(self->transform.position, prev_pos),
             1.0f / dt
         );
@@ -98,6 +148,20 @@ void PlayerUpdate(MIR_Entity* self, float dt) {
     self->transform.position.x = MIR_Math_Clamp(self->transform.position.x, 40, 760);
     self->transform.position.y = MIR_Math_Clamp(self->transform.position.y, 40, 560);
     
+    // Стены: откатываем движение по оси, которая упирается в стену
+    MIR_Vec2 size = {self->collider.bounds.w, self->collider.bounds.h};
+    if (HitsWall(self->transform.position, size)) {
+        MIR_Vec2 slide_x = {self->transform.position.x, prev_pos.y};
+        MIR_Vec2 slide_y = {prev_pos.x, self->transform.position.y};
+        if (!HitsWall(slide_x, size)) {
+            self->transform.position = slide_x;
+        } else if (!HitsWall(slide_y, size)) {
+            self->transform.position = slide_y;
+        } else {
+            self->transform.position = prev_pos;
+        }
+    }
+    
     // Слежение камеры
     MIR_SetCameraTarget(self->transform.position);
     
@@ -124,21 +188,18 @@ void PlayerUpdate(MIR_Entity* self, float dt) {
 }
 
 void EnemyUpdate(MIR_Entity* self, float dt) {
-    if (game_paused) return;
+    if (game->paused) return;
     
-    // Движение к игроку
-    if (player) {
-        MIR_Vec2 dir = MIR_Vec2_Subtract(
-            player->transform.position,
-            self->transform.position
-        );
+    // Движение к игроку в обход стен по общему полю потока
+    if (game->player) {
         float dist = MIR_Math_Distance(
-            player->transform.position,
+            game->player->transform.position,
             self->transform.position
         );
         
         if (dist > 0 && dist < 500) { // Только если игрок в радиусе 500 пикселей
-            dir = MIR_Vec2_Multiply(MIR_Math_Normalize(dir), 80.0f * dt);
+            MIR_Vec2 dir = MIR_FlowField_Sample(game->enemy_field, self->transform.position);
+            dir = MIR_Vec2_Multiply(dir, 80.0f * dt);
             self->transform.position = MIR_Vec2_Add(self->transform.position, dir);
         }
     }
@@ -150,216 +211,258 @@ void EnemyUpdate(MIR_Entity* self, float dt) {
 }
 
 void CheckCollisions() {
-    if (game_paused) return;
+    if (game->paused) return;
     
     // Проверяем коллизии игрока с врагами
-    if (player && player->active) {
-        for (int i = 0; i < _mir->entity_count; i++) {
-            MIR_Entity* enemy_entity = _mir->entities[i];
+    if (game->player && game->player->active) {
+        for (int i = 0; i < _mir->world->entity_count; i++) {
+            MIR_Entity* enemy_entity = _mir->world->entities[i];
             if (!enemy_entity || !enemy_entity->active || 
-                strcmp(enemy_entity->tag, "Enemy") != 0) continue;
+                strcmp(MIR_GetEntityTag(enemy_entity), "Enemy") != 0) continue;
             
-            if (MIR_CheckCollision(player, enemy_entity)) {
+            if (MIR_CheckCollision(game->player, enemy_entity)) {
                 // Уничтожаем врага
                 enemy_entity->active = false;
-                enemies_destroyed++;
+                game->enemies_destroyed++;
                 
                 // Эффект столкновения
-                for (int k = 0; k < 30; k++) {
-                    MIR_Vec2 vel = {
-                        MIR_Math_RandomRange(-400, 400),
-                        MIR_Math_RandomRange(-400, 400)
-                    };
-                    MIR_Color collision_color = {
-                        255,
-                        100,
-                        100,
-                        255
-                    };
-                    MIR_EmitParticleEx(
-                        enemy_entity->transform.position,
-                        vel,
-                        (MIR_Vec2){0, 30}, // Гравитация
-                        collision_color,
-                        MIR_Math_RandomRange(3.0f, 8.0f),
-                        MIR_Math_RandomRange(0.3f, 0.8f)
-                    );
-                }
+                MIR_EmitParticleBurst(
+                    enemy_entity->transform.position,
+                    30,
+                    400.0f,
+                    (MIR_Vec2){0, 30}, // Гравитация
+                    (MIR_Color){255, 100, 100, 255},
+                    3.0f, 8.0f,
+                    0.3f, 0.8f
+                );
             }
         }
     }
     
     // Удаляем неактивных врагов
-    for (int i = _mir->entity_count - 1; i >= 0; i--) {
-        if (_mir->entities[i] && !_mir->entities[i]->active && 
-            strcmp(_mir->entities[i]->tag, "Enemy") == 0) {
-            MIR_DestroyEntity(_mir->entities[i]);
+    for (int i = _mir->world->entity_count - 1; i >= 0; i--) {
+        if (_mir->world->entities[i] && !_mir->world->entities[i]->active && 
+            strcmp(MIR_GetEntityTag(_mir->world->entities[i]), "Enemy") == 0) {
+            MIR_DestroyEntity(_mir->world->entities[i]);
         }
     }
 }
 
-int main(void) {
-    // Инициализация движка
-    if (!MIR_Init("Mirulit Engine - Space Shooter", 800, 600)) {
-        return 1;
+// ==================== МОДУЛЬ ИГРЫ ====================
+// game_* вызывает main ниже или host.c (горячая перезагрузка, F5)
+
+void game_load(bool reloaded) {
+    game = (Game*)MIR_Hot_Keep("game", sizeof(Game));
+    if (!game) {
+        MIR_Quit();
+        return;
+    }
+    
+    // Сущности и навигация уже живут в движке хоста
+    if (reloaded) {
+        printf("Game code reloaded\n");
+        return;
     }
     
     // Загрузка текстуры игрока
-    player_texture = MIR_LoadTexture("engine/icons/64px.png");
-    if (!player_texture) {
+    game->player_texture = MIR_LoadTexture("engine/icons/64px.png");
+    if (!game->player_texture) {
         printf("Failed to load player texture! Using default color.\n");
         // Если текстура не загрузилась, можно использовать цветной прямоугольник
     }
     
     // Создание игрока
-    player = MIR_CreateEntity("Player");
-    player->transform.position = (MIR_Vec2){400, 300};
-    player->transform.scale = (MIR_Vec2){64, 64};
+    game->player = MIR_CreateEntity("Player");
+    game->player->transform.position = (MIR_Vec2){400, 300};
+    game->player->transform.scale = (MIR_Vec2){64, 64};
     
     // Настройка спрайта
-    if (player_texture) {
-        player->sprite.texture = player_texture;
-        player->sprite.color = MIR_COLOR_WHITE; // Белый цвет для сохранения исходных цветов текстуры
-        player->sprite.source_rect = (MIR_Rect){0, 0, 64, 64}; // Предполагаем, что текстура 64x64
+    if (game->player_texture) {
+        game->player->sprite.texture = game->player_texture;
+        game->player->sprite.color = MIR_COLOR_WHITE; // Белый цвет для сохранения исходных цветов текстуры
+        game->player->sprite.source_rect = (MIR_Rect){0, 0, 64, 64}; // Предполагаем, что текстура 64x64
     } else {
-        player->sprite.color = MIR_COLOR_CYAN; // Цвет по умолчанию
+        game->player->sprite.color = MIR_COLOR_CYAN; // Цвет по умолчанию
     }
     
-    player->update = PlayerUpdate;
-    player->collider.bounds = (MIR_Rect){0, 0, 40, 40};
-    player->collider.enabled = true;
-    player->active = true;
+    MIR_SetEntityUpdate(game->player, PlayerUpdate);
+    game->player->collider.bounds = (MIR_Rect){0, 0, 40, 40};
+    game->player->collider.enabled = true;
+    game->player->active = true;
     
-    // Главный игровой цикл
-    while (MIR_IsRunning()) {
-        // Обработка ввода
-        MIR_ProcessEvents();
-        
-        // Пауза по Escape
-        if (MIR_IsKeyPressed(SDLK_ESCAPE)) {
-            game_paused = !game_paused;
-            printf("Game %s\n", game_paused ? "PAUSED" : "RESUMED");
-        }
-        
-        // Fullscreen по F11
-        if (MIR_IsKeyPressed(SDLK_F11)) {
-            is_fullscreen = !is_fullscreen;
-            SDL_SetWindowFullscreen(_mir->window, is_fullscreen);
-            printf("Fullscreen: %s\n", is_fullscreen ? "ON" : "OFF");
-        }
-        
-        // Замедление времени по Tab (только когда игра не на паузе)
-        if (!game_paused) {
-            if (MIR_IsKeyPressed(SDLK_TAB)) {
-                MIR_SetTimeScale(0.2f);
-            }
-            if (MIR_IsKeyReleased(SDLK_TAB)) {
-                MIR_SetTimeScale(1.0f);
-            }
-        }
-        
-        // Начало кадра
-        MIR_BeginFrame();
-        
-        // Спавн врагов по таймеру (только во время игры)
-        if (!game_paused) {
-            spawn_timer += MIR_GetDeltaTime();
-            if (spawn_timer > 2.0f && _mir->entity_count < 20) { // Не больше 20 врагов
-                MIR_Entity* new_enemy = MIR_CreateEntity("Enemy");
-                new_enemy->transform.position = (MIR_Vec2){
-                    MIR_Math_RandomRange(50, 750),
-                    MIR_Math_RandomRange(50, 550)
-                };
-                new_enemy->transform.scale = (MIR_Vec2){
-                    MIR_Math_RandomRange(35, 65),
-                    MIR_Math_RandomRange(35, 65)
-                };
-                new_enemy->sprite.color = (MIR_Color){
-                    (uint8_t)MIR_Math_RandomRange(150, 255),
-                    (uint8_t)MIR_Math_RandomRange(50, 100),
-                    (uint8_t)MIR_Math_RandomRange(50, 100),
-                    255
-                };
-                new_enemy->update = EnemyUpdate;
-                new_enemy->collider.bounds = (MIR_Rect){0, 0, 
-                    new_enemy->transform.scale.x, new_enemy->transform.scale.y};
-                new_enemy->collider.enabled = true;
-                new_enemy->active = true;
-                spawn_timer = 0;
-            }
-        }
-        
-        // Обновление (если не на паузе)
-        if (!game_paused) {
-            MIR_UpdateEntities();
-            MIR_UpdateParticles();
-            CheckCollisions();
+    // Стены и навигация (клетка 20px, препятствия раздуты на полразмера врага)
+    CreateWalls();
+    game->nav_grid = MIR_NavGrid_Create((MIR_Vec2){0, 0}, 40, 30, 20.0f);
+    MIR_NavGrid_Rasterize(game->nav_grid, 25.0f);
+    game->enemy_field = MIR_FlowField_Create(game->nav_grid);
+    
+    // Трасса профилировщика сохраняется сама при кадре дольше 50 мс
+    MIR_Profile_SetSpikeDump(50.0f, "spike_trace.json");
+}
+
+void game_update(float dt) {
+    // Пауза по Escape
+    if (MIR_IsKeyPressed(SDLK_ESCAPE)) {
+        game->paused = !game->paused;
+        printf("Game %s\n", game->paused ? "PAUSED" : "RESUMED");
+    }
+    
+    // Fullscreen по F11
+    if (MIR_IsKeyPressed(SDLK_F11)) {
+        game->is_fullscreen = !game->is_fullscreen;
+        SDL_SetWindowFullscreen(_mir->window, game->is_fullscreen);
+        printf("Fullscreen: %s\n", game->is_fullscreen ? "ON" : "OFF");
+    }
+    
+    // Трасса профилировщика по F3 (нужен MIRULIT_ENABLE_PROFILER)
+    if (MIR_IsKeyPressed(SDLK_F3) && MIR_Profile_Dump("trace.json")) {
+        printf("Profiler trace saved to trace.json\n");
+    }
+    
+    // Замедление времени по Tab (только когда игра не на паузе)
+    if (!game->paused) {
+        if (MIR_IsKeyPressed(SDLK_TAB)) {
+            MIR_SetTimeScale(0.2f);
         }
-        
-        // Отрисовка прицела (только когда игра не на паузе)
-        if (!game_paused) {
-            MIR_Vec2 mouse_pos = MIR_GetMousePosition();
-            MIR_DrawLine(
-                (MIR_Vec2){mouse_pos.x - 12, mouse_pos.y},
-                (MIR_Vec2){mouse_pos.x + 12, mouse_pos.y},
-                (MIR_Color){255, 100, 100, 220},
-                2.0f
-            );
-            MIR_DrawLine(
-                (MIR_Vec2){mouse_pos.x, mouse_pos.y - 12},
-                (MIR_Vec2){mouse_pos.x, mouse_pos.y + 12},
-                (MIR_Color){255, 100, 100, 220},
-                2.0f
-            );
+        if (MIR_IsKeyReleased(SDLK_TAB)) {
+            MIR_SetTimeScale(1.0f);
         }
+    }
+    
+    // Спавн врагов по таймеру (только во время игры)
+    if (!game->paused) {
+        game->spawn_timer += dt;
+        MIR_Vec2 spawn_pos = {
+            MIR_Math_RandomRange(50, 750),
+            MIR_Math_RandomRange(50, 550)
+        };
+        int spawn_cell = MIR_NavGrid_WorldToCell(game->nav_grid, spawn_pos);
+        bool spawn_free = spawn_cell >= 0 && !game->nav_grid->blocked[spawn_cell];
         
-        // Отрисовка
-        MIR_DrawEntities();
-        MIR_DrawParticles();
-        
-        // Отрисовка надписи PAUSE когда игра на паузе
-        if (game_paused) {
-            // Полупрозрачный черный фон
-            MIR_DrawRect((MIR_Rect){0, 0, 800, 600}, (MIR_Color){0, 0, 0, 128});
-            
-            // Белый прямоугольник с текстом PAUSE
-            MIR_DrawRect((MIR_Rect){300, 250, 200, 100}, MIR_COLOR_WHITE);
-            
-            // Черная рамка
-            MIR_DrawRect((MIR_Rect){302, 252, 196, 96}, MIR_COLOR_BLACK);
-            
-            // Текст PAUSE (примитивная отрисовка)
-            MIR_DrawRect((MIR_Rect){340, 270, 40, 10}, MIR_COLOR_WHITE);
-            MIR_DrawRect((MIR_Rect){340, 290, 40, 10}, MIR_COLOR_WHITE);
-            MIR_DrawRect((MIR_Rect){420, 270, 40, 10}, MIR_COLOR_WHITE);
-            MIR_DrawRect((MIR_Rect){420, 290, 40, 10}, MIR_COLOR_WHITE);
+        if (game->spawn_timer > 2.0f && spawn_free &&
+            _mir->world->entity_count < 20 + WALL_COUNT) { // Не больше 20 врагов
+            MIR_Entity* new_enemy = MIR_CreateEntity("Enemy");
+            new_enemy->transform.position = spawn_pos;
+            new_enemy->transform.scale = (MIR_Vec2){
+                MIR_Math_RandomRange(35, 65),
+                MIR_Math_RandomRange(35, 65)
+            };
+            new_enemy->sprite.color = (MIR_Color){
+                (uint8_t)MIR_Math_RandomRange(150, 255),
+                (uint8_t)MIR_Math_RandomRange(50, 100),
+                (uint8_t)MIR_Math_RandomRange(50, 100),
+                255
+            };
+            MIR_SetEntityUpdate(new_enemy, EnemyUpdate);
+            new_enemy->collider.bounds = (MIR_Rect){0, 0, 
+                new_enemy->transform.scale.x, new_enemy->transform.scale.y};
+            new_enemy->collider.enabled = true;
+            new_enemy->active = true;
+            game->spawn_timer = 0;
         }
+    }
+    
+    // Обновление (если не на паузе)
+    if (!game->paused) {
+        // Поле пересчитывается в фоне; до готовности враги идут по прежнему
+        MIR_FlowField_UpdateAsync(game->enemy_field, game->player->transform.position);
+        MIR_UpdateEntities();
+        MIR_UpdateParticles();
+        CheckCollisions();
+    }
+}
+
+void game_draw(void) {
+    // Отрисовка прицела (только когда игра не на паузе)
+    if (!game->paused) {
+        MIR_Vec2 mouse_pos = MIR_GetMousePosition();
+        MIR_DrawLine(
+            (MIR_Vec2){mouse_pos.x - 12, mouse_pos.y},
+            (MIR_Vec2){mouse_pos.x + 12, mouse_pos.y},
+            (MIR_Color){255, 100, 100, 220},
+            2.0f
+        );
+        MIR_DrawLine(
+            (MIR_Vec2){mouse_pos.x, mouse_pos.y - 12},
+            (MIR_Vec2){mouse_pos.x, mouse_pos.y + 12},
+            (MIR_Color){255, 100, 100, 220},
+            2.0f
+        );
+    }
+    
+    // Отрисовка
+    MIR_DrawEntities();
+    MIR_DrawParticles();
+    
+    // Отрисовка надписи PAUSE когда игра на паузе
+    if (game->paused) {
+        // Полупрозрачный черный фон
+        MIR_DrawRect((MIR_Rect){0, 0, 800, 600}, (MIR_Color){0, 0, 0, 128});
         
-        // Отрисовка статистики в углу
-        MIR_DrawRect((MIR_Rect){10, 10, 200, 70}, (MIR_Color){0, 0, 0, 180});
+        // Белый прямоугольник с текстом PAUSE
+        MIR_DrawRect((MIR_Rect){300, 250, 200, 100}, MIR_COLOR_WHITE);
         
-        // Вывод информации в консоль
-        if (!game_paused) {
-            printf("\rSCORE: %6d | ENEMIES: %3d | FPS: %3d", 
-                   score, enemies_destroyed, MIR_GetFPS());
-            fflush(stdout);
-        } else {
-            printf("\rPAUSED | FPS: %3d | Press ESC to resume", MIR_GetFPS());
-            fflush(stdout);
-        }
+        // Черная рамка
+        MIR_DrawRect((MIR_Rect){302, 252, 196, 96}, MIR_COLOR_BLACK);
         
-        // Конец кадра
-        MIR_EndFrame();
+        // Текст PAUSE
+        MIR_DrawText(320, 280, "PAUSE", MIR_COLOR_WHITE, 4);
+        MIR_DrawText(312, 325, "ESC - resume", MIR_COLOR_LIGHTGRAY, 1);
     }
     
+    // Отрисовка статистики в углу
+    MIR_DrawRect((MIR_Rect){10, 10, 200, 70}, (MIR_Color){0, 0, 0, 180});
+    
+    char hud[64];
+    snprintf(hud, sizeof(hud), "SCORE   %6d", game->score);
+    MIR_DrawText(20, 20, hud, MIR_COLOR_WHITE, 1);
+    snprintf(hud, sizeof(hud), "ENEMIES %6d", game->enemies_destroyed);
+    MIR_DrawText(20, 36, hud, MIR_COLOR_WHITE, 1);
+    snprintf(hud, sizeof(hud), "FPS     %6d", MIR_GetFPS());
+    MIR_DrawText(20, 52, hud, MIR_COLOR_WHITE, 1);
+    
+    // Отладочный оверлей (F1)
+    MIR_DrawDebugInfo();
+}
+
+void game_unload(bool reloading) {
+    if (reloading || !game) return;
+    
     // Очистка текстуры (если она не была привязана к сущности)
-    if (player_texture) {
-        SDL_DestroyTexture(player_texture);
-        player_texture = NULL;
+    if (game->player_texture) {
+        SDL_DestroyTexture(game->player_texture);
+        game->player_texture = NULL;
+    }
+    
+    // Навигация использует пул задач - освобождаем до остановки движка
+    MIR_FlowField_Destroy(game->enemy_field);
+    MIR_NavGrid_Destroy(game->nav_grid);
+    
+    printf("Game Over! Final Score: %d | Enemies Destroyed: %d\n", game->score, game->enemies_destroyed);
+}
+
+#ifndef MIRULIT_HOT_MODULE
+int main(void) {
+    // Инициализация движка
+    if (!MIR_Init("Mirulit Engine - Space Shooter", 800, 600)) {
+        return 1;
+    }
+    
+    game_load(false);
+    
+    // Главный игровой цикл
+    while (MIR_IsRunning()) {
+        MIR_ProcessEvents();
+        MIR_BeginFrame();
+        game_update(MIR_GetDeltaTime());
+        game_draw();
+        MIR_EndFrame();
     }
     
+    game_unload(false);
+    
     // Завершение
     MIR_Shutdown();
-    printf("\nGame Over! Final Score: %d | Enemies Destroyed: %d\n", score, enemies_destroyed);
     return 0;
-}
\ No newline at end of file
+}
+#endif
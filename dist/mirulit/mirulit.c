@@ -0,0 +1,5 @@
+// Единица трансляции движка: компилятор собирает из нее lib/libmirulit.a
+// (с теми же -D, что и игру), файлы игры подключают mirulit.h без
+// MIRULIT_IMPLEMENTATION и получают только объявления.
+#define MIRULIT_IMPLEMENTATION
+#include <mirulit.h>
@@ -6,6 +6,8 @@
 // #define MIRULIT_ENABLE_SDL_IMAGE   // Требует SDL3_image
 // #define MIRULIT_ENABLE_SDL_TTF     // Требует SDL3_ttf
 // #define MIRULIT_ENABLE_PHYSICS     // Простая физика
+// #define MIRULIT_ENABLE_PROFILER    // Зоны профилирования и Chrome trace
+// #define MIRULIT_LOG_LEVEL 0        // Минимальный уровень MIR_Log (0 - debug ... 4 - выкл)
 
 #include <SDL3/SDL.h>
 #include <stdbool.h>
@@ -16,6 +18,21 @@
 #include <string.h>
 #include <time.h>
 
+// SIMD: tcc не поддерживает интринсики, там работает скалярный путь
+#if !defined(__TINYC__) && defined(__AVX2__)
+#include <immintrin.h>
+#define MIRULIT_SIMD_AVX2
+#endif
+#if !defined(__TINYC__) && (defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define MIRULIT_SIMD_SSE2
+#endif
+#if !defined(__TINYC__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define MIRULIT_SIMD_NEON
+#endif
+
 #ifdef MIRULIT_ENABLE_SDL_IMAGE
 #include <SDL3_image/SDL_image.h>
 #endif
@@ -26,11 +43,19 @@
 
 // ==================== ВЕРСИЯ И НАСТРОЙКИ ====================
 #define MIRULIT_VERSION "1.0.0"
+#ifndef MIRULIT_MAX_ENTITIES
 #define MIRULIT_MAX_ENTITIES 1024
+#endif
 #define MIRULIT_MAX_KEYS 512
 #define MIRULIT_MAX_BUTTONS 8
+#ifndef MIRULIT_MAX_PARTICLES
 #define MIRULIT_MAX_PARTICLES 1000
+#endif
 #define MIRULIT_DEFAULT_FPS 60
+#define MIRULIT_DEFAULT_VSYNC 0          // 0 - выкл, 1 - вкл, -1 - адаптивный
+#define MIRULIT_COMPONENT_CLASSES 4       // пулы компонентов по 32, 64, 128, 256 байт
+#define MIRULIT_FRAME_HISTORY 120
+#define MIRULIT_FRAME_SPIN_NS 1000000    // последняя миллисекунда кадра - активное ожидание
 
 // ==================== ЦВЕТА (RGBA) ====================
 #define MIR_COLOR_WHITE      (MIR_Color){255, 255, 255, 255}
@@ -48,17 +73,98 @@
 #define MIR_COLOR_LIGHTGRAY  (MIR_Color){192, 192, 192, 255}
 #define MIR_COLOR_BACKGROUND (MIR_Color){30, 30, 40, 255}
 
+// ==================== СБОРКА ДВИЖКА ====================
+// По умолчанию mirulit.h только объявляет функции и состояние движка, а
+// код лежит в lib/libmirulit.a: компилятор собирает ее один раз из
+// mirulit/mirulit.c (MIRULIT_IMPLEMENTATION) и подключает при линковке.
+// Все файлы игры работают с одним экземпляром движка.
+//
+//   MIRULIT_IMPLEMENTATION - этот файл определяет движок (mirulit.c)
+//   MIRULIT_HEADER_ONLY    - весь движок static в этом файле, без библиотеки
+//                            (однофайловые программы, bench.c, host.c)
+//   MIRULIT_HOT_MODULE     - как HEADER_ONLY, но переменные состояния extern
+//                            и связываются с хостом (см. mirulit_hot.h)
+//
+// Настройки, от которых зависят структуры (MIRULIT_ENABLE_PHYSICS,
+// MIRULIT_ENABLE_PROFILER, MIRULIT_MAX_ENTITIES, MIRULIT_MAX_PARTICLES),
+// у игры и библиотеки должны совпадать - их передают компилятору через -D.
+// Несовпадение дает ошибку линковки с символом _mirulit_config_*.
+#if defined(MIRULIT_IMPLEMENTATION)
+#define MIRULIT_API
+#define MIRULIT_SHARED
+#define MIRULIT_DEFINE_ENGINE
+#elif defined(MIRULIT_HOT_MODULE)
+#define MIRULIT_API static
+#define MIRULIT_SHARED extern
+#define MIRULIT_DEFINE_ENGINE
+#elif defined(MIRULIT_HEADER_ONLY)
+#define MIRULIT_API static
+#define MIRULIT_SHARED static
+#define MIRULIT_DEFINE_ENGINE
+#else
+#define MIRULIT_API extern
+#define MIRULIT_SHARED extern
+#endif
+
+#ifdef MIRULIT_ENABLE_PHYSICS
+#define _MIRULIT_CONFIG_PHYSICS 1
+#else
+#define _MIRULIT_CONFIG_PHYSICS 0
+#endif
+#ifdef MIRULIT_ENABLE_PROFILER
+#define _MIRULIT_CONFIG_PROFILER 1
+#else
+#define _MIRULIT_CONFIG_PROFILER 0
+#endif
+#define _MIRULIT_CONFIG_JOIN(p, r, e, n) _mirulit_config_physics##p##_profiler##r##_entities##e##_particles##n
+#define _MIRULIT_CONFIG_NAME(p, r, e, n) _MIRULIT_CONFIG_JOIN(p, r, e, n)
+#define _MIRULIT_CONFIG_SYMBOL _MIRULIT_CONFIG_NAME(_MIRULIT_CONFIG_PHYSICS, _MIRULIT_CONFIG_PROFILER, \
+                                                     MIRULIT_MAX_ENTITIES, MIRULIT_MAX_PARTICLES)
+
+#if defined(MIRULIT_IMPLEMENTATION)
+const int _MIRULIT_CONFIG_SYMBOL = 1;
+#elif !defined(MIRULIT_DEFINE_ENGINE)
+extern const int _MIRULIT_CONFIG_SYMBOL;
+#if defined(__GNUC__) && !defined(__TINYC__)
+__attribute__((used))
+#endif
+static const int* const _mirulit_config_check = &_MIRULIT_CONFIG_SYMBOL;
+#endif
+
 // Предварительные объявления для устранения циклических зависимостей
 typedef struct MIR_Engine MIR_Engine;
 typedef struct MIR_Entity MIR_Entity;
+typedef struct MIR_World MIR_World;
+MIRULIT_API void MIR_World_UpdateEntities(MIR_World* world);
+MIRULIT_API void MIR_World_UpdateParticles(MIR_World* world);
+MIRULIT_API void MIR_World_ResolveCollisions(MIR_World* world);
+MIRULIT_API void MIR_Text_Flush(void);
+MIRULIT_API void MIR_Text_Shutdown(void);
+MIRULIT_API void _MIR_Hot_Shutdown(void);
+
+#ifdef MIRULIT_ENABLE_PHYSICS
+typedef struct MIR_Body MIR_Body;
+MIRULIT_API void MIR_Physics_Shutdown(void);
+#endif
 
 // Подключение модулей в правильном порядке
+#include <mirulit_memory.h>
 #include <mirulit_math.h>
 #include <mirulit_entity.h>
+#include <mirulit_log.h>
+#include <mirulit_profiler.h>
+#include <mirulit_jobs.h>
+#include <mirulit_world.h>
 #include <mirulit_core.h>
+#include <mirulit_physics.h>
 #include <mirulit_graphics.h>
 #include <mirulit_input.h>
 #include <mirulit_particles.h>
 #include <mirulit_collision.h>
+#include <mirulit_overlay.h>
+#include <mirulit_navgrid.h>
+#include <mirulit_flowfield.h>
+#include <mirulit_pathfinding.h>
+#include <mirulit_hot.h>
 
 #endif // MIRULIT_H
\ No newline at end of file
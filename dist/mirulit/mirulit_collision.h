@@ -1,7 +1,54 @@
 #ifndef MIRULIT_COLLISION_H
 #define MIRULIT_COLLISION_H
 
-static bool MIR_CheckCollision(MIR_Entity* a, MIR_Entity* b) {
+MIRULIT_API bool MIR_CheckCollision(MIR_Entity* a, MIR_Entity* b);
+
+MIRULIT_API MIR_Entity* MIR_World_PointCollision(MIR_World* world, MIR_Vec2 point);
+
+MIRULIT_API MIR_Entity* MIR_PointCollision(MIR_Vec2 point);
+
+// Все сущности, чей коллайдер пересекает area. Массив выделен в арене
+// кадра - действителен до следующего MIR_BeginFrame, освобождать не нужно.
+MIRULIT_API MIR_Entity** MIR_World_QueryRect(MIR_World* world, MIR_Rect area, int* count);
+
+MIRULIT_API MIR_Entity** MIR_QueryRect(MIR_Rect area, int* count);
+
+// ==================== ПАКЕТНАЯ ПРОВЕРКА ПАР ====================
+// Границы коллайдеров в раздельных массивах min/max (SoA), чтобы
+// проверять 4 (SSE2) или 8 (AVX2) пар одной инструкцией.
+// Выключенный коллайдер хранится как "вывернутый" прямоугольник
+// (min = +inf, max = -inf) и не пересекается ни с чем.
+
+#define MIRULIT_PAIR_BATCH 256
+
+typedef struct MIR_BoundsSoA {
+    float min_x[MIRULIT_MAX_ENTITIES];
+    float min_y[MIRULIT_MAX_ENTITIES];
+    float max_x[MIRULIT_MAX_ENTITIES];
+    float max_y[MIRULIT_MAX_ENTITIES];
+    int count;
+} MIR_BoundsSoA;
+
+MIRULIT_API void MIR_PackColliderBounds(MIR_World* world, MIR_BoundsSoA* soa);
+
+// Проверка списка пар (pair_a[k], pair_b[k]) - индексы в soa.
+// В hits пишутся номера пересекающихся пар, возвращается их число.
+// Условие то же, что в MIR_CheckCollision (строгие неравенства).
+MIRULIT_API int MIR_OverlapPairs(const MIR_BoundsSoA* soa, const int* pair_a, const int* pair_b,
+                                 int pair_count, int* hits);
+
+// on_collision для каждой пересекающейся пары. Кандидаты отбираются
+// sweep-and-prune по X, пачки кандидатов проверяются MIR_OverlapPairs.
+// Обработчики могут уничтожать и создавать сущности: пара с уничтоженной
+// сущностью пропускается, новые сущности проверяются со следующего вызова.
+MIRULIT_API void MIR_World_ResolveCollisions(MIR_World* world);
+
+MIRULIT_API void MIR_ResolveCollisions(void);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+MIRULIT_API bool MIR_CheckCollision(MIR_Entity* a, MIR_Entity* b) {
     if (!a || !b || !a->collider.enabled || !b->collider.enabled) return false;
     
     MIR_Rect rectA = a->collider.bounds;
@@ -13,11 +60,11 @@ static bool MIR_CheckCollision(MIR_Entity* a, MIR_Entity* b) {
             rectA.y + rectA.h > rectB.y);
 }
 
-static MIR_Entity* MIR_PointCollision(MIR_Vec2 point) {
-    if (!_mir_initialized || !_mir) return NULL;
+MIRULIT_API MIR_Entity* MIR_World_PointCollision(MIR_World* world, MIR_Vec2 point) {
+    if (!world) return NULL;
     
-    for (int i = 0; i < _mir->entity_count; i++) {
-        MIR_Entity* entity = _mir->entities[i];
+    for (int i = 0; i < world->entity_count; i++) {
+        MIR_Entity* entity = world->entities[i];
         if (!entity || !entity->collider.enabled) continue;
         
         MIR_Rect bounds = entity->collider.bounds;
@@ -29,36 +76,287 @@ static MIR_Entity* MIR_PointCollision(MIR_Vec2 point) {
     return NULL;
 }
 
-static void MIR_ResolveCollisions(void) {
-    if (!_mir_initialized || !_mir) return;
-    
-    for (int i = 0; i < _mir->entity_count; i++) {
-        for (int j = i + 1; j < _mir->entity_count; j++) {
-            if (MIR_CheckCollision(_mir->entities[i], _mir->entities[j])) {
-                if (_mir->entities[i]->collider.on_collision) {
-                    _mir->entities[i]->collider.on_collision(
-                        _mir->entities[i], _mir->entities[j]);
-                }
-                if (_mir->entities[j]->collider.on_collision) {
-                    _mir->entities[j]->collider.on_collision(
-                        _mir->entities[j], _mir->entities[i]);
-                }
-            }
+MIRULIT_API MIR_Entity* MIR_PointCollision(MIR_Vec2 point) {
+    return MIR_World_PointCollision(MIR_GetWorld(), point);
+}
+
+MIRULIT_API MIR_Entity** MIR_World_QueryRect(MIR_World* world, MIR_Rect area, int* count) {
+    *count = 0;
+    if (!world || world->entity_count == 0) return NULL;
+
+    MIR_Entity** result = (MIR_Entity**)MIR_FrameAlloc(sizeof(MIR_Entity*) * world->entity_count);
+    if (!result) return NULL;
+
+    for (int i = 0; i < world->entity_count; i++) {
+        MIR_Entity* entity = world->entities[i];
+        if (!entity || !entity->collider.enabled) continue;
+
+        MIR_Rect bounds = entity->collider.bounds;
+        if (area.x < bounds.x + bounds.w && area.x + area.w > bounds.x &&
+            area.y < bounds.y + bounds.h && area.y + area.h > bounds.y) {
+            result[(*count)++] = entity;
+        }
+    }
+    return result;
+}
+
+MIRULIT_API MIR_Entity** MIR_QueryRect(MIR_Rect area, int* count) {
+    return MIR_World_QueryRect(MIR_GetWorld(), area, count);
+}
+
+MIRULIT_API void MIR_PackColliderBounds(MIR_World* world, MIR_BoundsSoA* soa) {
+    soa->count = 0;
+    if (!world) return;
+
+    for (int i = 0; i < world->entity_count; i++) {
+        MIR_Entity* e = world->entities[i];
+        if (e && e->collider.enabled) {
+            MIR_Rect r = e->collider.bounds;
+            soa->min_x[i] = r.x;
+            soa->min_y[i] = r.y;
+            soa->max_x[i] = r.x + r.w;
+            soa->max_y[i] = r.y + r.h;
+        } else {
+            soa->min_x[i] = soa->min_y[i] = INFINITY;
+            soa->max_x[i] = soa->max_y[i] = -INFINITY;
+        }
+    }
+    soa->count = world->entity_count;
+}
+
+MIRULIT_API int MIR_OverlapPairs(const MIR_BoundsSoA* soa, const int* pair_a, const int* pair_b,
+                                 int pair_count, int* hits) {
+    int hit_count = 0;
+    int k = 0;
+
+#if defined(MIRULIT_SIMD_AVX2)
+    for (; k + 8 <= pair_count; k += 8) {
+        __m256i ia = _mm256_loadu_si256((const __m256i*)(pair_a + k));
+        __m256i ib = _mm256_loadu_si256((const __m256i*)(pair_b + k));
+
+        __m256 a_min_x = _mm256_i32gather_ps(soa->min_x, ia, 4);
+        __m256 a_max_x = _mm256_i32gather_ps(soa->max_x, ia, 4);
+        __m256 b_min_x = _mm256_i32gather_ps(soa->min_x, ib, 4);
+        __m256 b_max_x = _mm256_i32gather_ps(soa->max_x, ib, 4);
+        __m256 mask = _mm256_and_ps(_mm256_cmp_ps(a_min_x, b_max_x, _CMP_LT_OQ),
+                                    _mm256_cmp_ps(a_max_x, b_min_x, _CMP_GT_OQ));
+
+        __m256 a_min_y = _mm256_i32gather_ps(soa->min_y, ia, 4);
+        __m256 a_max_y = _mm256_i32gather_ps(soa->max_y, ia, 4);
+        __m256 b_min_y = _mm256_i32gather_ps(soa->min_y, ib, 4);
+        __m256 b_max_y = _mm256_i32gather_ps(soa->max_y, ib, 4);
+        mask = _mm256_and_ps(mask, _mm256_cmp_ps(a_min_y, b_max_y, _CMP_LT_OQ));
+        mask = _mm256_and_ps(mask, _mm256_cmp_ps(a_max_y, b_min_y, _CMP_GT_OQ));
+
+        // Сжатие без ветвлений: запись всегда, сдвиг только на попадании
+        int bits = _mm256_movemask_ps(mask);
+        for (int lane = 0; lane < 8; lane++) {
+            hits[hit_count] = k + lane;
+            hit_count += (bits >> lane) & 1;
+        }
+    }
+#endif
+
+#if defined(MIRULIT_SIMD_SSE2)
+    for (; k + 4 <= pair_count; k += 4) {
+        const int* a = pair_a + k;
+        const int* b = pair_b + k;
+
+        __m128 a_min_x = _mm_set_ps(soa->min_x[a[3]], soa->min_x[a[2]], soa->min_x[a[1]], soa->min_x[a[0]]);
+        __m128 a_max_x = _mm_set_ps(soa->max_x[a[3]], soa->max_x[a[2]], soa->max_x[a[1]], soa->max_x[a[0]]);
+        __m128 b_min_x = _mm_set_ps(soa->min_x[b[3]], soa->min_x[b[2]], soa->min_x[b[1]], soa->min_x[b[0]]);
+        __m128 b_max_x = _mm_set_ps(soa->max_x[b[3]], soa->max_x[b[2]], soa->max_x[b[1]], soa->max_x[b[0]]);
+        __m128 mask = _mm_and_ps(_mm_cmplt_ps(a_min_x, b_max_x), _mm_cmpgt_ps(a_max_x, b_min_x));
+
+        __m128 a_min_y = _mm_set_ps(soa->min_y[a[3]], soa->min_y[a[2]], soa->min_y[a[1]], soa->min_y[a[0]]);
+        __m128 a_max_y = _mm_set_ps(soa->max_y[a[3]], soa->max_y[a[2]], soa->max_y[a[1]], soa->max_y[a[0]]);
+        __m128 b_min_y = _mm_set_ps(soa->min_y[b[3]], soa->min_y[b[2]], soa->min_y[b[1]], soa->min_y[b[0]]);
+        __m128 b_max_y = _mm_set_ps(soa->max_y[b[3]], soa->max_y[b[2]], soa->max_y[b[1]], soa->max_y[b[0]]);
+        mask = _mm_and_ps(mask, _mm_cmplt_ps(a_min_y, b_max_y));
+        mask = _mm_and_ps(mask, _mm_cmpgt_ps(a_max_y, b_min_y));
+
+        int bits = _mm_movemask_ps(mask);
+        for (int lane = 0; lane < 4; lane++) {
+            hits[hit_count] = k + lane;
+            hit_count += (bits >> lane) & 1;
+        }
+    }
+#endif
+
+    // Хвост и сборка без SIMD (tcc)
+    for (; k < pair_count; k++) {
+        int a = pair_a[k], b = pair_b[k];
+        int overlap = (soa->min_x[a] < soa->max_x[b]) & (soa->max_x[a] > soa->min_x[b]) &
+                      (soa->min_y[a] < soa->max_y[b]) & (soa->max_y[a] > soa->min_y[b]);
+        hits[hit_count] = k;
+        hit_count += overlap;
+    }
+
+    return hit_count;
+}
+
+// Снимок мира на время MIR_World_ResolveCollisions. Хранится в мире, а
+// не на стеке: при больших MIRULIT_MAX_ENTITIES он не помещается в стек
+// рабочего потока (MIR_World_StepParallel).
+typedef struct {
+    float min_x;
+    int index;
+} _MIR_SweepItem;
+
+typedef struct _MIR_CollisionSnapshot {
+    MIR_Entity* entities[MIRULIT_MAX_ENTITIES];     // NULL - уничтожена
+    int ids[MIRULIT_MAX_ENTITIES];
+    _MIR_SweepItem order[MIRULIT_MAX_ENTITIES];     // по возрастанию min_x
+    int order_count;
+    uint32_t order_changes;                         // entity_changes при сборке order
+    uint32_t live_changes;                          // entity_changes при проверке живых
+} _MIR_CollisionSnapshot;
+
+// Отметка сущностей снимка, уничтоженных обработчиками. Уничтожение
+// сдвигает список без смены порядка, создание дописывает в конец, поэтому
+// живые сущности снимка идут в world->entities в том же порядке. Указатель
+// из снимка не разыменовывается: его память могла вернуться в пул, id
+// читается у сущности из живого списка. Без созданий и уничтожений -
+// ничего не делает.
+static void _MIR_Collision_Refresh(MIR_World* world, _MIR_CollisionSnapshot* snap, int count) {
+    if (snap->live_changes == world->entity_changes) return;
+    snap->live_changes = world->entity_changes;
+
+    int j = 0;
+    for (int k = 0; k < count; k++) {
+        if (!snap->entities[k]) continue;
+        while (j < world->entity_count && !world->entities[j]) j++;
+        if (j < world->entity_count && world->entities[j] == snap->entities[k] &&
+            world->entities[j]->id == snap->ids[k]) {
+            j++;
+        } else {
+            snap->entities[k] = NULL;
+        }
+    }
+}
+
+static int _MIR_Collision_CompareX(const void* a, const void* b) {
+    const _MIR_SweepItem* ia = (const _MIR_SweepItem*)a;
+    const _MIR_SweepItem* ib = (const _MIR_SweepItem*)b;
+    if (ia->min_x != ib->min_x) return ia->min_x < ib->min_x ? -1 : 1;
+    return ia->index - ib->index;
+}
+
+// Sweep-and-prune по оси X. Без созданий и уничтожений индексы те же,
+// что при прошлой проверке, и прошлый порядок почти отсортирован -
+// сортировка вставками почти линейна. Иначе порядок сортируется заново.
+static void _MIR_Collision_SortX(MIR_World* world, _MIR_CollisionSnapshot* snap, int count) {
+    const float* min_x = world->bounds->min_x;
+    _MIR_SweepItem* order = snap->order;
+
+    if (snap->order_count != count || snap->order_changes != world->entity_changes) {
+        for (int k = 0; k < count; k++) {
+            order[k].min_x = min_x[k];
+            order[k].index = k;
         }
+        qsort(order, count, sizeof(_MIR_SweepItem), _MIR_Collision_CompareX);
+        snap->order_count = count;
+        snap->order_changes = world->entity_changes;
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        order[i].min_x = min_x[order[i].index];
+    }
+    for (int i = 1; i < count; i++) {
+        _MIR_SweepItem key = order[i];
+        int j = i - 1;
+        while (j >= 0 && order[j].min_x > key.min_x) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = key;
     }
 }
 
-static void MIR_DrawDebugInfo(void) {
-    if (!_mir_initialized || !_mir) return;
+MIRULIT_API void MIR_World_ResolveCollisions(MIR_World* world) {
+    if (!world) return;
+    if (!world->bounds) {
+        world->bounds = (MIR_BoundsSoA*)MIR_Alloc(sizeof(MIR_BoundsSoA), MIR_MEM_CORE);
+        if (!world->bounds) return;
+    }
+    if (!world->collision) {
+        world->collision = (_MIR_CollisionSnapshot*)MIR_Calloc(1, sizeof(_MIR_CollisionSnapshot), MIR_MEM_CORE);
+        if (!world->collision) return;
+    }
+    MIR_PROFILE_BEGIN("ResolveCollisions");
+    
+    int pair_a[MIRULIT_PAIR_BATCH];
+    int pair_b[MIRULIT_PAIR_BATCH];
+    int hits[MIRULIT_PAIR_BATCH];
     
-    // Вывод в консоль
-    static int last_fps = 0;
-    if (_mir->fps != last_fps) {
-        printf("\r[MIRULIT] FPS: %3d | Entities: %3d | Particles: %3d | Draws: %3d", 
-               _mir->fps, _mir->entity_count, _mir->particle_count, _mir->draw_calls);
-        fflush(stdout);
-        last_fps = _mir->fps;
+    // Пары перебираются по снимку списка: обработчики могут создавать,
+    // уничтожать и сдвигать сущности, не сбивая перебор. Созданные в
+    // обработчиках сущности проверяются со следующего шага.
+    _MIR_CollisionSnapshot* snap = world->collision;
+    int count = world->entity_count;
+    for (int k = 0; k < count; k++) {
+        MIR_Entity* entity = world->entities[k];
+        snap->entities[k] = entity;
+        snap->ids[k] = entity ? entity->id : -1;
+    }
+    snap->live_changes = world->entity_changes;
+    MIR_PackColliderBounds(world, world->bounds);
+    _MIR_Collision_SortX(world, snap, count);
+    
+    // Кандидаты - пары, пересекающиеся по X: после сортировки по min_x
+    // для order[i] это order[j], j > i, пока order[j].min_x < max_x[order[i]].
+    // Выключенные коллайдеры (min_x = +inf) стоят в конце и пар не дают.
+    const float* max_x = world->bounds->max_x;
+    const _MIR_SweepItem* order = snap->order;
+    int i = 0, j = 1;
+    while (i < count) {
+        // Набираем пачку пар (a < b - обработчик меньшего индекса первым)
+        int pair_count = 0;
+        while (pair_count < MIRULIT_PAIR_BATCH && i < count) {
+            if (j >= count || !(order[j].min_x < max_x[order[i].index])) {
+                i++;
+                j = i + 1;
+                continue;
+            }
+            int p = order[i].index, q = order[j].index;
+            pair_a[pair_count] = p < q ? p : q;
+            pair_b[pair_count] = p < q ? q : p;
+            pair_count++;
+            j++;
+        }
+        
+        int hit_count = MIR_OverlapPairs(world->bounds, pair_a, pair_b, pair_count, hits);
+        
+        for (int h = 0; h < hit_count; h++) {
+            int a = pair_a[hits[h]], b = pair_b[hits[h]];
+            
+            // Границы в снимке собраны до обработчиков: пару перепроверяем
+            // по живым сущностям
+            _MIR_Collision_Refresh(world, snap, count);
+            MIR_Entity* ea = snap->entities[a];
+            MIR_Entity* eb = snap->entities[b];
+            if (!ea || !eb || !MIR_CheckCollision(ea, eb)) continue;
+            
+            if (ea->flags & MIR_ENTITY_HAS_COLLISION) {
+                ea->cold->on_collision(ea, eb);
+                // Обработчик a мог уничтожить a или b
+                _MIR_Collision_Refresh(world, snap, count);
+                if (!snap->entities[a] || !snap->entities[b]) continue;
+            }
+            if (eb->flags & MIR_ENTITY_HAS_COLLISION) {
+                eb->cold->on_collision(eb, ea);
+            }
+        }
     }
+    
+    MIR_PROFILE_END();
 }
 
+MIRULIT_API void MIR_ResolveCollisions(void) {
+    MIR_World_ResolveCollisions(MIR_GetWorld());
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
 #endif // MIRULIT_COLLISION_H
\ No newline at end of file
@@ -1,27 +1,12 @@
 #ifndef MIRULIT_CORE_H
 #define MIRULIT_CORE_H
 
-// Частица
-typedef struct {
-    MIR_Vec2 position;
-    MIR_Vec2 velocity;
-    MIR_Vec2 acceleration;
-    MIR_Color color;
-    float size;
-    float life;
-    float max_life;
-    bool active;
-} MIR_Particle;
-
-// Камера
-typedef struct {
-    MIR_Vec2 position;
-    float zoom;
-    float rotation;
-    MIR_Vec2 target;
-    float smooth_speed;
-    MIR_Rect bounds;
-} MIR_Camera;
+// Режимы вертикальной синхронизации (значения SDL_SetRenderVSync)
+typedef enum {
+    MIR_VSYNC_ADAPTIVE = SDL_RENDERER_VSYNC_ADAPTIVE,
+    MIR_VSYNC_OFF = SDL_RENDERER_VSYNC_DISABLED,
+    MIR_VSYNC_ON = 1
+} MIR_VSyncMode;
 
 // Основной движок
 struct MIR_Engine {
@@ -34,18 +19,19 @@ struct MIR_Engine {
     int height;
     char title[128];
     bool running;
-    bool paused;
     
-    // Сущности
-    MIR_Entity* entities[MIRULIT_MAX_ENTITIES];
-    int entity_count;
-    int next_id;
+    // Мир по умолчанию: сущности, частицы, камера, время симуляции
+    MIR_World* world;
     
-    // Частицы
-    MIR_Particle particles[MIRULIT_MAX_PARTICLES];
-    
-    // Камера
-    MIR_Camera camera;
+    // Кэш матрицы вида камеры мира (мир -> экран)
+    MIR_Mat3 view;
+    MIR_Mat3 inverse_view;
+    MIR_Vec2 view_position;
+    float view_zoom;
+    float view_rotation;
+    int view_width;
+    int view_height;
+    bool view_valid;
     
     // Ввод
     bool keys[MIRULIT_MAX_KEYS];
@@ -59,18 +45,26 @@ struct MIR_Engine {
     MIR_Vec2 mouse_world_position;
     float mouse_wheel;
     
-    // Время
-    float delta_time;
-    float time_scale;
+    // Автоматическая сессия (MIRULIT_AUTOPLAY): синтетический ввод
+    int autoplay_frames;        // 0 - выключена
+    int autoplay_frame;
+    MIR_Rng autoplay_rng;
+    
+    // Время (метки в наносекундах SDL_GetTicksNS)
     uint64_t last_time;
     uint64_t start_time;
     int fps;
     int target_fps;
+    int vsync;                  // MIR_VSyncMode
+    uint64_t frame_deadline;    // момент окончания текущего кадра для ограничителя
+    uint64_t fps_timer;
+    int fps_frames;
+    float frame_times[MIRULIT_FRAME_HISTORY];   // мс, кольцевой буфер
+    int frame_time_index;
+    int frame_time_count;
     
     // Статистика
     int draw_calls;
-    int update_calls;
-    int particle_count;
     
     // Ресурсы
     SDL_Texture* textures[100];
@@ -84,24 +78,100 @@ struct MIR_Engine {
 };
 
 // Глобальные переменные
-static MIR_Engine* _mir = NULL;
-static bool _mir_initialized = false;
+MIRULIT_SHARED MIR_Engine* _mir;
+MIRULIT_SHARED bool _mir_initialized;
+
+// Мир по умолчанию (NULL до MIR_Init)
+MIRULIT_API MIR_World* MIR_GetWorld(void);
 
 // ==================== ЯДРО ДВИЖКА ====================
 
-static bool MIR_Init(const char* title, int width, int height) {
+// Переменная окружения MIRULIT_AUTOPLAY=кадры[,seed] включает
+// автоматическую сессию: MIR_ProcessEvents подменяет ввод синтетическим
+// (WASD, мышь, клики, Tab), кадры не ограничиваются, а через заданное
+// число кадров MIR_IsRunning возвращает false. Так игра без изменений
+// прогоняется для сбора профиля (compiler --release --pgo).
+MIRULIT_API bool MIR_Init(const char* title, int width, int height);
+
+MIRULIT_API void MIR_Shutdown(void);
+
+// ==================== МАТРИЦА ВИДА ====================
+
+// Пересчитывается, только если камера или размер окна изменились
+// с прошлого вызова. Отрисовка берет ее один раз на проход.
+MIRULIT_API const MIR_Mat3* MIR_GetViewMatrix(void);
+
+MIRULIT_API MIR_Vec2 MIR_WorldToScreen(MIR_Vec2 world);
+
+MIRULIT_API MIR_Vec2 MIR_ScreenToWorld(MIR_Vec2 screen);
+
+// ==================== ЦИКЛ ОБНОВЛЕНИЯ ====================
+
+MIRULIT_API void MIR_ProcessEvents(void);
+
+MIRULIT_API void MIR_BeginFrame(void);
+
+MIRULIT_API void MIR_EndFrame(void);
+
+// Режим VSync: MIR_VSYNC_OFF, MIR_VSYNC_ON или MIR_VSYNC_ADAPTIVE.
+// Если драйвер не поддерживает адаптивный режим, включается обычный.
+MIRULIT_API bool MIR_SetVSync(MIR_VSyncMode mode);
+
+MIRULIT_API MIR_VSyncMode MIR_GetVSync(void);
+
+// Длительности последних кадров в мс, от старых к новым.
+// Возвращает число скопированных значений.
+MIRULIT_API int MIR_GetFrameTimes(float* out, int max_count);
+
+// ==================== КАМЕРА ====================
+
+MIRULIT_API void MIR_SetCameraTarget(MIR_Vec2 target);
+
+MIRULIT_API void MIR_SetCameraZoom(float zoom);
+
+MIRULIT_API void MIR_CameraShake(float intensity, float duration);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+MIRULIT_API MIR_World* MIR_GetWorld(void) {
+    return _mir_initialized && _mir ? _mir->world : NULL;
+}
+
+static void _MIR_Autoplay_Init(void) {
+    const char* autoplay = SDL_getenv("MIRULIT_AUTOPLAY");
+    if (!autoplay || !*autoplay) return;
+    
+    char* end = NULL;
+    long frames = strtol(autoplay, &end, 10);
+    uint64_t seed = *end == ',' ? strtoull(end + 1, NULL, 10) : 1;
+    if (frames <= 0) return;
+    
+    // Повторяемый прогон: тот же seed - тот же ввод и те же случайные числа
+    _mir->autoplay_frames = (int)frames;
+    MIR_Rng_Seed(&_mir->autoplay_rng, seed);
+    MIR_Random_Seed(seed);
+    
+    _mir->target_fps = 0;
+    _mir->vsync = MIR_VSYNC_OFF;
+    SDL_SetRenderVSync(_mir->renderer, MIR_VSYNC_OFF);
+    MIR_Log(MIR_LOG_INFO, "Autoplay: %d frames, seed %llu", _mir->autoplay_frames,
+            (unsigned long long)seed);
+}
+
+MIRULIT_API bool MIR_Init(const char* title, int width, int height) {
     if (_mir_initialized) return true;
     
     // Инициализация SDL
     if (!SDL_Init(SDL_INIT_VIDEO)) {
-        printf("[MIRULIT] SDL_Init failed: %s\n", SDL_GetError());
+        MIR_Log(MIR_LOG_ERROR, "SDL_Init failed: %s", SDL_GetError());
         return false;
     }
     
     // Создание движка
-    _mir = (MIR_Engine*)calloc(1, sizeof(MIR_Engine));
+    _mir = (MIR_Engine*)MIR_Calloc(1, sizeof(MIR_Engine), MIR_MEM_CORE);
     if (!_mir) {
-        printf("[MIRULIT] Memory allocation failed\n");
+        MIR_Log(MIR_LOG_ERROR, "Memory allocation failed");
         SDL_Quit();
         return false;
     }
@@ -109,18 +179,22 @@ static bool MIR_Init(const char* title, int width, int height) {
     // Создание окна
     _mir->window = SDL_CreateWindow(title, width, height, SDL_WINDOW_RESIZABLE);
     if (!_mir->window) {
-        printf("[MIRULIT] Window creation failed: %s\n", SDL_GetError());
-        free(_mir);
+        MIR_Log(MIR_LOG_ERROR, "Window creation failed: %s", SDL_GetError());
+        MIR_Free(_mir);
         SDL_Quit();
         return false;
     }
     
-    // Создание рендерера
-    _mir->renderer = SDL_CreateRenderer(_mir->window, NULL);
+    // Создание рендерера (режим VSync задается свойством при создании)
+    SDL_PropertiesID renderer_props = SDL_CreateProperties();
+    SDL_SetPointerProperty(renderer_props, SDL_PROP_RENDERER_CREATE_WINDOW_POINTER, _mir->window);
+    SDL_SetNumberProperty(renderer_props, SDL_PROP_RENDERER_CREATE_PRESENT_VSYNC_NUMBER, MIRULIT_DEFAULT_VSYNC);
+    _mir->renderer = SDL_CreateRendererWithProperties(renderer_props);
+    SDL_DestroyProperties(renderer_props);
     if (!_mir->renderer) {
-        printf("[MIRULIT] Renderer creation failed: %s\n", SDL_GetError());
+        MIR_Log(MIR_LOG_ERROR, "Renderer creation failed: %s", SDL_GetError());
         SDL_DestroyWindow(_mir->window);
-        free(_mir);
+        MIR_Free(_mir);
         SDL_Quit();
         return false;
     }
@@ -129,62 +203,60 @@ static bool MIR_Init(const char* title, int width, int height) {
     _mir->width = width;
     _mir->height = height;
     _mir->running = true;
-    _mir->paused = false;
-    _mir->delta_time = 0.016f;
-    _mir->time_scale = 1.0f;
     _mir->target_fps = MIRULIT_DEFAULT_FPS;
-    _mir->next_id = 1;
+    _mir->vsync = MIRULIT_DEFAULT_VSYNC;
     
     strncpy(_mir->title, title, sizeof(_mir->title) - 1);
     
-    // Инициализация камеры
-    _mir->camera.position = (MIR_Vec2){0, 0};
-    _mir->camera.zoom = 1.0f;
-    _mir->camera.rotation = 0.0f;
-    _mir->camera.smooth_speed = 5.0f;
-    _mir->camera.bounds = (MIR_Rect){-1000, -1000, 2000, 2000};
-    
     // Инициализация времени
-    _mir->start_time = SDL_GetTicks();
+    _mir->start_time = SDL_GetTicksNS();
     _mir->last_time = _mir->start_time;
+    _mir->fps_timer = _mir->start_time;
+    _mir->frame_deadline = _mir->start_time;
+    
+    // Инициализация рандома (для повторяемости игра пересевает MIR_Random_Seed)
+    MIR_Random_Seed((uint64_t)time(NULL) ^ SDL_GetPerformanceCounter());
+    _MIR_Autoplay_Init();
+    
+    // Мир по умолчанию
+    _mir->world = MIR_World_Create();
+    if (!_mir->world) {
+        SDL_DestroyRenderer(_mir->renderer);
+        SDL_DestroyWindow(_mir->window);
+        MIR_Free(_mir);
+        SDL_Quit();
+        return false;
+    }
     
-    // Инициализация рандома
-    srand((unsigned int)time(NULL));
+    // Поток записи лога, рабочие потоки (физика и фоновые задачи)
+    MIR_Log_Init();
+    MIR_PROFILE_THREAD("Main");
+    MIR_Jobs_Init(-1);
     
-    printf("[MIRULIT] Engine v%s initialized: %dx%d\n", 
-           MIRULIT_VERSION, width, height);
-    printf("[MIRULIT] SDL3 version: %d.%d.%d\n",
-           SDL_MAJOR_VERSION, SDL_MINOR_VERSION, SDL_MICRO_VERSION);
+    MIR_Log(MIR_LOG_INFO, "Engine v%s initialized: %dx%d",
+            MIRULIT_VERSION, width, height);
+    MIR_Log(MIR_LOG_INFO, "SDL3 version: %d.%d.%d",
+            SDL_MAJOR_VERSION, SDL_MINOR_VERSION, SDL_MICRO_VERSION);
     
     _mir_initialized = true;
     return true;
 }
 
-static void MIR_Shutdown(void) {
+MIRULIT_API void MIR_Shutdown(void) {
     if (!_mir_initialized || !_mir) return;
     
-    printf("[MIRULIT] Shutting down...\n");
+    MIR_Log(MIR_LOG_INFO, "Shutting down...");
+    
+#ifdef MIRULIT_ENABLE_PHYSICS
+    MIR_Physics_Shutdown();
+#endif
+    MIR_Jobs_Shutdown();
     
     // Уничтожение всех сущностей
-    for (int i = 0; i < _mir->entity_count; i++) {
-        if (_mir->entities[i]) {
-            if (_mir->entities[i]->on_destroy) {
-                _mir->entities[i]->on_destroy(_mir->entities[i]);
-            }
-            
-            // Освобождение компонентов
-            for (int j = 0; j < _mir->entities[i]->component_count; j++) {
-                free(_mir->entities[i]->components[j]);
-            }
-            
-            // Освобождение текстуры
-            if (_mir->entities[i]->sprite.texture) {
-                SDL_DestroyTexture(_mir->entities[i]->sprite.texture);
-            }
-            
-            free(_mir->entities[i]);
-        }
-    }
+    MIR_World_Destroy(_mir->world);
+    _mir->world = NULL;
+    _MIR_FrameArena_Shutdown();
+    _MIR_Hot_Shutdown();
     
     // Освобождение загруженных текстур
     for (int i = 0; i < _mir->texture_count; i++) {
@@ -193,23 +265,110 @@ static void MIR_Shutdown(void) {
         }
     }
     
-    // Освобождение SDL
+    MIR_Text_Shutdown();
+    
+    // Освобождение SDL (поток лога останавливается до SDL_Quit)
     SDL_DestroyRenderer(_mir->renderer);
     SDL_DestroyWindow(_mir->window);
+    MIR_Log(MIR_LOG_INFO, "Engine shutdown complete");
+    MIR_Log_Shutdown();
+#ifdef MIRULIT_ENABLE_PROFILER
+    // Последним: зоны в on_destroy и потоке лога создали бы кольцо заново
+    MIR_Profile_Shutdown();
+#endif
     SDL_Quit();
     
     // Освобождение движка
-    free(_mir);
+    MIR_Free(_mir);
     _mir = NULL;
     _mir_initialized = false;
-    
-    printf("[MIRULIT] Engine shutdown complete\n");
 }
 
-// ==================== ЦИКЛ ОБНОВЛЕНИЯ ====================
+MIRULIT_API const MIR_Mat3* MIR_GetViewMatrix(void) {
+    static const MIR_Mat3 identity = {{{1, 0, 0}, {0, 1, 0}}};
+    if (!_mir_initialized || !_mir) return &identity;
+    
+    const MIR_Camera* camera = &_mir->world->camera;
+    if (!_mir->view_valid ||
+        camera->position.x != _mir->view_position.x ||
+        camera->position.y != _mir->view_position.y ||
+        camera->zoom != _mir->view_zoom ||
+        camera->rotation != _mir->view_rotation ||
+        _mir->width != _mir->view_width ||
+        _mir->height != _mir->view_height) {
+        // экран = центр окна + поворот(-rotation) * zoom * (мир - позиция камеры)
+        MIR_Mat3 view = MIR_Mat3_Translate((MIR_Vec2){_mir->width / 2.0f, _mir->height / 2.0f});
+        if (camera->rotation != 0.0f) {
+            view = MIR_Mat3_Multiply(view, MIR_Mat3_Rotate(-camera->rotation * 3.14159265f / 180.0f));
+        }
+        view = MIR_Mat3_Multiply(view, MIR_Mat3_Scale((MIR_Vec2){camera->zoom, camera->zoom}));
+        view = MIR_Mat3_Multiply(view, MIR_Mat3_Translate(MIR_Vec2_Multiply(camera->position, -1.0f)));
+        
+        _mir->view = view;
+        _mir->inverse_view = MIR_Mat3_Invert(view);
+        _mir->view_position = camera->position;
+        _mir->view_zoom = camera->zoom;
+        _mir->view_rotation = camera->rotation;
+        _mir->view_width = _mir->width;
+        _mir->view_height = _mir->height;
+        _mir->view_valid = true;
+    }
+    return &_mir->view;
+}
+
+MIRULIT_API MIR_Vec2 MIR_WorldToScreen(MIR_Vec2 world) {
+    return MIR_Mat3_TransformPoint(MIR_GetViewMatrix(), world);
+}
+
+MIRULIT_API MIR_Vec2 MIR_ScreenToWorld(MIR_Vec2 screen) {
+    if (!_mir_initialized || !_mir) return screen;
+    MIR_GetViewMatrix();
+    return MIR_Mat3_TransformPoint(&_mir->inverse_view, screen);
+}
 
-static void MIR_ProcessEvents(void) {
+static void _MIR_Autoplay_SetKey(int key, bool down) {
+    if (down && !_mir->keys[key]) _mir->keys_down[key] = true;
+    if (!down && _mir->keys[key]) _mir->keys_up[key] = true;
+    _mir->keys[key] = down;
+}
+
+static void _MIR_Autoplay_SetButton(int button, bool down) {
+    if (down && !_mir->mouse_buttons[button]) _mir->mouse_down[button] = true;
+    if (!down && _mir->mouse_buttons[button]) _mir->mouse_up[button] = true;
+    _mir->mouse_buttons[button] = down;
+}
+
+// Ввод кадра автоматической сессии: каждые полсекунды новый набор
+// клавиш движения (изредка с Tab), мышь ходит по эллипсу вокруг центра
+// окна, левая кнопка нажимается раз в 20 кадров
+static void _MIR_Autoplay_Step(void) {
+    int frame = _mir->autoplay_frame++;
+    if (frame >= _mir->autoplay_frames) {
+        MIR_Log(MIR_LOG_INFO, "Autoplay finished: %d frames", _mir->autoplay_frames);
+        _mir->running = false;
+        return;
+    }
+    
+    if (frame % 30 == 0) {
+        static const int keys[4] = { SDLK_W, SDLK_A, SDLK_S, SDLK_D };
+        uint32_t bits = MIR_Rng_Next(&_mir->autoplay_rng);
+        for (int i = 0; i < 4; i++) {
+            _MIR_Autoplay_SetKey(keys[i], (bits >> i) & 1);
+        }
+        _MIR_Autoplay_SetKey(SDLK_TAB, ((bits >> 4) & 15) == 0);
+    }
+    
+    float angle = frame * 0.05f;
+    _mir->mouse_position.x = _mir->width * (0.5f + 0.3f * cosf(angle));
+    _mir->mouse_position.y = _mir->height * (0.5f + 0.3f * sinf(angle * 0.7f));
+    _mir->mouse_world_position = MIR_ScreenToWorld(_mir->mouse_position);
+    
+    _MIR_Autoplay_SetButton(SDL_BUTTON_LEFT, frame % 20 < 2);
+}
+
+MIRULIT_API void MIR_ProcessEvents(void) {
     if (!_mir_initialized || !_mir) return;
+    MIR_PROFILE_BEGIN("ProcessEvents");
     
     // Сброс состояний клавиш и мыши
     for (int i = 0; i < MIRULIT_MAX_KEYS; i++) {
@@ -275,12 +434,7 @@ static void MIR_ProcessEvents(void) {
                 _mir->mouse_position.y = event.motion.y;
                 
                 // Конвертация в мировые координаты
-                _mir->mouse_world_position.x = 
-                    (_mir->mouse_position.x - _mir->width / 2.0f) / _mir->camera.zoom + 
-                    _mir->camera.position.x;
-                _mir->mouse_world_position.y = 
-                    (_mir->mouse_position.y - _mir->height / 2.0f) / _mir->camera.zoom + 
-                    _mir->camera.position.y;
+                _mir->mouse_world_position = MIR_ScreenToWorld(_mir->mouse_position);
                 break;
                 
             case SDL_EVENT_MOUSE_WHEEL:
@@ -293,45 +447,60 @@ static void MIR_ProcessEvents(void) {
                 break;
         }
     }
+    
+    if (_mir->autoplay_frames > 0) {
+        _MIR_Autoplay_Step();
+    }
+    
+    MIR_PROFILE_END();
 }
 
-static void MIR_BeginFrame(void) {
+MIRULIT_API void MIR_BeginFrame(void) {
     if (!_mir_initialized || !_mir || !_mir->running) return;
+    MIR_World* world = _mir->world;
+    MIR_Camera* camera = &world->camera;
     
     // Расчет дельта-времени
-    uint64_t current_time = SDL_GetTicks();
-    _mir->delta_time = (current_time - _mir->last_time) / 1000.0f;
+    uint64_t current_time = SDL_GetTicksNS();
+    MIR_PROFILE_FRAME(_mir->last_time, current_time);
+    world->delta_time = (current_time - _mir->last_time) / 1e9f;
     _mir->last_time = current_time;
     
+    // История длительностей кадров (до ограничения дельты)
+    _mir->frame_times[_mir->frame_time_index] = world->delta_time * 1000.0f;
+    _mir->frame_time_index = (_mir->frame_time_index + 1) % MIRULIT_FRAME_HISTORY;
+    if (_mir->frame_time_count < MIRULIT_FRAME_HISTORY) _mir->frame_time_count++;
+    
     // Ограничение дельта-времени (защита от рывков)
-    if (_mir->delta_time > 0.1f) {
-        _mir->delta_time = 0.1f;
+    if (world->delta_time > 0.1f) {
+        world->delta_time = 0.1f;
     }
     
     // Применение time scale
-    float scaled_dt = _mir->delta_time * _mir->time_scale;
-    
-    // Расчет FPS
-    static int frame_counter = 0;
-    static uint64_t fps_timer = 0;
-    frame_counter++;
-    
-    if (current_time - fps_timer >= 1000) {
-        _mir->fps = frame_counter;
-        frame_counter = 0;
-        fps_timer = current_time;
+    float scaled_dt = world->delta_time * world->time_scale;
+    
+    // Расчет FPS: кадры за окно не короче секунды, деленные на его точную длину
+    _mir->fps_frames++;
+    uint64_t fps_window = current_time - _mir->fps_timer;
+    if (fps_window >= SDL_NS_PER_SECOND) {
+        _mir->fps = (int)((_mir->fps_frames * SDL_NS_PER_SECOND + fps_window / 2) / fps_window);
+        _mir->fps_frames = 0;
+        _mir->fps_timer = current_time;
     }
     
     // Обновление камеры
-    if (_mir->camera.smooth_speed > 0 && 
-        (_mir->camera.target.x != 0 || _mir->camera.target.y != 0)) {
-        float t = 1.0f - expf(-_mir->camera.smooth_speed * scaled_dt);
-        _mir->camera.position.x = MIR_Math_Lerp(
-            _mir->camera.position.x, _mir->camera.target.x, t);
-        _mir->camera.position.y = MIR_Math_Lerp(
-            _mir->camera.position.y, _mir->camera.target.y, t);
+    if (camera->smooth_speed > 0 && 
+        (camera->target.x != 0 || camera->target.y != 0)) {
+        float t = 1.0f - expf(-camera->smooth_speed * scaled_dt);
+        camera->position.x = MIR_Math_Lerp(
+            camera->position.x, camera->target.x, t);
+        camera->position.y = MIR_Math_Lerp(
+            camera->position.y, camera->target.y, t);
     }
     
+    // Камера сдвинулась - мышь указывает на другую точку мира
+    _mir->mouse_world_position = MIR_ScreenToWorld(_mir->mouse_position);
+    
     // Очистка экрана
     SDL_SetRenderDrawColor(_mir->renderer, 
                           MIR_COLOR_BACKGROUND.r,
@@ -340,41 +509,92 @@ static void MIR_BeginFrame(void) {
                           MIR_COLOR_BACKGROUND.a);
     SDL_RenderClear(_mir->renderer);
     
+    // Транзиентная память прошлого кадра
+    MIR_FrameArena_Reset();
+    
     // Сброс статистики
     _mir->draw_calls = 0;
-    _mir->update_calls = 0;
+    world->update_calls = 0;
 }
 
-static void MIR_EndFrame(void) {
+MIRULIT_API void MIR_EndFrame(void) {
     if (!_mir_initialized || !_mir) return;
     
+    // Текст и оверлей кадра - одним пакетом поверх сцены
+    MIR_Text_Flush();
+    
     // Отображение
+    MIR_PROFILE_BEGIN("RenderPresent");
     SDL_RenderPresent(_mir->renderer);
+    MIR_PROFILE_END();
     
-    // Ограничение FPS
-    if (_mir->target_fps > 0) {
-        uint64_t frame_time = SDL_GetTicks() - _mir->last_time;
-        uint64_t target_frame_time = 1000 / _mir->target_fps;
+    // Ограничение FPS. С VSync темп задает SDL_RenderPresent.
+    if (_mir->target_fps > 0 && _mir->vsync == MIR_VSYNC_OFF) {
+        uint64_t period = SDL_NS_PER_SECOND / _mir->target_fps;
+        uint64_t now = SDL_GetTicksNS();
+        
+        // Сроки кадров идут с шагом period, поэтому ошибка округления
+        // не копится. Опоздавший кадр сдвигает график, а не догоняет его.
+        _mir->frame_deadline += period;
+        if (_mir->frame_deadline <= now || _mir->frame_deadline > now + period) {
+            _mir->frame_deadline = now;
+            return;
+        }
         
-        if (frame_time < target_frame_time) {
-            SDL_Delay((uint32_t)(target_frame_time - frame_time));
+        // Сон до ~1 мс до срока (точность планировщика), остаток - спин
+        if (now + MIRULIT_FRAME_SPIN_NS < _mir->frame_deadline) {
+            SDL_DelayNS(_mir->frame_deadline - now - MIRULIT_FRAME_SPIN_NS);
+        }
+        while (SDL_GetTicksNS() < _mir->frame_deadline) {
+            SDL_CPUPauseInstruction();
         }
     }
 }
 
-// ==================== КАМЕРА ====================
+MIRULIT_API bool MIR_SetVSync(MIR_VSyncMode mode) {
+    if (!_mir_initialized || !_mir) return false;
+    
+    if (!SDL_SetRenderVSync(_mir->renderer, mode)) {
+        if (mode != MIR_VSYNC_ADAPTIVE || !SDL_SetRenderVSync(_mir->renderer, MIR_VSYNC_ON)) {
+            MIR_Log(MIR_LOG_WARN, "VSync mode %d not supported: %s", (int)mode, SDL_GetError());
+            return false;
+        }
+        mode = MIR_VSYNC_ON;
+    }
+    
+    _mir->vsync = mode;
+    _mir->frame_deadline = SDL_GetTicksNS();
+    return true;
+}
 
-static void MIR_SetCameraTarget(MIR_Vec2 target) {
+MIRULIT_API MIR_VSyncMode MIR_GetVSync(void) {
+    return _mir_initialized && _mir ? (MIR_VSyncMode)_mir->vsync : MIR_VSYNC_OFF;
+}
+
+MIRULIT_API int MIR_GetFrameTimes(float* out, int max_count) {
+    if (!_mir_initialized || !_mir || !out) return 0;
+    
+    int count = _mir->frame_time_count < max_count ? _mir->frame_time_count : max_count;
+    int first = _mir->frame_time_index - count;
+    if (first < 0) first += MIRULIT_FRAME_HISTORY;
+    
+    for (int i = 0; i < count; i++) {
+        out[i] = _mir->frame_times[(first + i) % MIRULIT_FRAME_HISTORY];
+    }
+    return count;
+}
+
+MIRULIT_API void MIR_SetCameraTarget(MIR_Vec2 target) {
     if (!_mir_initialized || !_mir) return;
-    _mir->camera.target = target;
+    _mir->world->camera.target = target;
 }
 
-static void MIR_SetCameraZoom(float zoom) {
+MIRULIT_API void MIR_SetCameraZoom(float zoom) {
     if (!_mir_initialized || !_mir) return;
-    _mir->camera.zoom = MIR_Math_Clamp(zoom, 0.1f, 5.0f);
+    _mir->world->camera.zoom = MIR_Math_Clamp(zoom, 0.1f, 5.0f);
 }
 
-static void MIR_CameraShake(float intensity, float duration) {
+MIRULIT_API void MIR_CameraShake(float intensity, float duration) {
     if (!_mir_initialized || !_mir) return;
     
     static float shake_timer = 0;
@@ -386,17 +606,19 @@ static void MIR_CameraShake(float intensity, float duration) {
     }
     
     if (shake_timer > 0) {
-        shake_timer -= _mir->delta_time;
+        shake_timer -= _mir->world->delta_time;
         
         float offset_x = MIR_Math_RandomRange(-shake_intensity, shake_intensity);
         float offset_y = MIR_Math_RandomRange(-shake_intensity, shake_intensity);
         
-        _mir->camera.position.x += offset_x;
-        _mir->camera.position.y += offset_y;
+        _mir->world->camera.position.x += offset_x;
+        _mir->world->camera.position.y += offset_y;
         
         // Затухание
         shake_intensity *= 0.9f;
     }
 }
 
+#endif // MIRULIT_DEFINE_ENGINE
+
 #endif // MIRULIT_CORE_H
\ No newline at end of file
@@ -22,35 +22,57 @@ typedef struct MIR_Sprite {
 typedef struct MIR_Collider {
     MIR_Rect bounds;
     bool is_trigger;
+    bool is_static;         // неподвижное препятствие (навигационная сетка)
     bool enabled;
-    void (*on_collision)(struct MIR_Entity*, struct MIR_Entity*);
 } MIR_Collider;
 
-// Сущность (Entity)
-struct MIR_Entity {
-    int id;
+// Холодная часть сущности: имя, обработчики, иерархия, компоненты.
+// Лежит в отдельном пуле, циклы обновления и отрисовки ее не читают.
+typedef struct MIR_EntityCold {
     char tag[32];
-    bool active;
-    bool visible;
-    bool persistent;
-    
-    MIR_Transform transform;
-    MIR_Sprite sprite;
-    MIR_Collider collider;
-    
-    void* components[10];
-    int component_count;
+    struct MIR_World* world;
     
     void (*update)(struct MIR_Entity*, float);
     void (*draw)(struct MIR_Entity*);
     void (*on_click)(struct MIR_Entity*);
     void (*on_destroy)(struct MIR_Entity*);
+    void (*on_collision)(struct MIR_Entity*, struct MIR_Entity*);
+    
+    void* components[10];   // только через MIR_AddComponent
+    int component_count;
     
     struct MIR_Entity* parent;
     struct MIR_Entity* children[20];
     int child_count;
     
     void* user_data;
+} MIR_EntityCold;
+
+// Какие обработчики заданы - чтобы не читать холодную часть зря
+#define MIR_ENTITY_HAS_UPDATE (1 << 0)
+#define MIR_ENTITY_HAS_DRAW (1 << 1)
+#define MIR_ENTITY_HAS_COLLISION (1 << 2)
+
+// Сущность (Entity) - горячая запись: все, что каждый кадр читают
+// обновление, коллизии и отрисовка. Записи лежат подряд в чанках пула
+// движка. Холодные поля - через MIR_GetEntityTag, MIR_SetEntityUpdate
+// и прочие функции доступа.
+struct MIR_Entity {
+    MIR_Transform transform;
+    MIR_Collider collider;
+    MIR_Sprite sprite;
+    
+    int id;
+    unsigned char flags;    // MIR_ENTITY_HAS_*
+    bool active;
+    bool visible;
+    bool persistent;
+    
+#ifdef MIRULIT_ENABLE_PHYSICS
+    struct MIR_Body* body;
+#endif
+    
+    MIR_EntityCold* cold;
 };
 
 // Анимация
@@ -0,0 +1,436 @@
+#ifndef MIRULIT_FLOWFIELD_H
+#define MIRULIT_FLOWFIELD_H
+
+// ==================== ПОЛЕ ПОТОКА ====================
+// Одно поле на цель, общее для всех преследующих её агентов.
+// Дейкстра по 8 соседям от цели дает поле стоимости и для каждой
+// клетки направление к соседу с меньшей стоимостью, так что
+// агенту достаточно одного чтения массива за кадр.
+//
+// При смене клеток сетки поле чинится локально: поддеревья,
+// проходившие через занятые клетки, сбрасываются и достраиваются
+// от своей границы, освобожденные клетки просто снова релаксируются.
+// Пересчет идет по снимку сетки и может выполняться на пуле задач,
+// агенты в это время читают прежнее опубликованное поле.
+
+#define MIR_FLOW_NONE 255
+
+typedef struct {
+    float cost;
+    int cell;
+} _MIR_FlowNode;
+
+typedef struct {
+    MIR_NavGrid* grid;
+    int cells;
+    bool valid;
+
+    // Опубликованное поле - его читают агенты
+    float* cost;                // путь до цели в клетках, INFINITY - недостижимо
+    uint8_t* dir;               // индекс соседа по пути к цели или MIR_FLOW_NONE
+    int target_cell;
+    MIR_Vec2 target;
+    uint32_t revision;          // ревизия сетки, по которой построено поле
+
+    // Рабочая копия для пересчета
+    float* work_cost;
+    uint8_t* work_dir;
+    uint8_t* work_blocked;      // снимок сетки на момент запуска
+    int* work_changes;
+    int work_change_count;
+    bool work_full;
+    int work_target_cell;
+    MIR_Vec2 work_target;
+    uint32_t work_revision;
+
+    _MIR_FlowNode* heap;
+    int heap_count;
+    int heap_capacity;
+    int* invalid;               // клетки, сброшенные при инкрементальном пересчете
+    uint8_t* mark;
+
+    MIR_JobCounter job;
+    bool job_running;
+} MIR_FlowField;
+
+MIRULIT_API MIR_FlowField* MIR_FlowField_Create(MIR_NavGrid* grid);
+
+// ==================== ПЕРЕСЧЕТ ====================
+
+// Синхронный пересчет под цель и текущее состояние сетки
+MIRULIT_API void MIR_FlowField_Update(MIR_FlowField* f, MIR_Vec2 target);
+
+// Фоновый пересчет на пуле задач. Вызывается каждый кадр: забирает
+// готовый результат и при необходимости запускает новый пересчет.
+// Возвращает true, если опубликованное поле соответствует цели и сетке.
+MIRULIT_API bool MIR_FlowField_UpdateAsync(MIR_FlowField* f, MIR_Vec2 target);
+
+MIRULIT_API void MIR_FlowField_Destroy(MIR_FlowField* f);
+
+// ==================== ЗАПРОСЫ АГЕНТОВ ====================
+
+// Единичное направление движения к цели, ноль - цель недостижима
+MIRULIT_API MIR_Vec2 MIR_FlowField_Sample(const MIR_FlowField* f, MIR_Vec2 pos);
+
+// Длина пути до цели в мировых единицах, INFINITY - недостижимо
+MIRULIT_API float MIR_FlowField_GetDistance(const MIR_FlowField* f, MIR_Vec2 pos);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+static const uint8_t _mir_flow_opposite[8] = { 2, 3, 0, 1, 6, 7, 4, 5 };
+static const MIR_Vec2 _mir_flow_vectors[8] = {
+    { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 },
+    { 0.70710678f, 0.70710678f }, { -0.70710678f, 0.70710678f },
+    { -0.70710678f, -0.70710678f }, { 0.70710678f, -0.70710678f }
+};
+
+MIRULIT_API MIR_FlowField* MIR_FlowField_Create(MIR_NavGrid* grid) {
+    if (!grid) return NULL;
+
+    MIR_FlowField* f = (MIR_FlowField*)MIR_Calloc(1, sizeof(MIR_FlowField), MIR_MEM_NAVIGATION);
+    if (!f) return NULL;
+
+    int cells = grid->width * grid->height;
+    f->grid = grid;
+    f->cells = cells;
+    f->target_cell = -1;
+    f->cost = (float*)MIR_Alloc(sizeof(float) * cells, MIR_MEM_NAVIGATION);
+    f->dir = (uint8_t*)MIR_Alloc(cells, MIR_MEM_NAVIGATION);
+    f->work_cost = (float*)MIR_Alloc(sizeof(float) * cells, MIR_MEM_NAVIGATION);
+    f->work_dir = (uint8_t*)MIR_Alloc(cells, MIR_MEM_NAVIGATION);
+    f->work_blocked = (uint8_t*)MIR_Alloc(cells, MIR_MEM_NAVIGATION);
+    f->work_changes = (int*)MIR_Alloc(sizeof(int) * MIRULIT_NAV_CHANGE_LOG, MIR_MEM_NAVIGATION);
+    f->invalid = (int*)MIR_Alloc(sizeof(int) * cells, MIR_MEM_NAVIGATION);
+    f->mark = (uint8_t*)MIR_Calloc(cells, 1, MIR_MEM_NAVIGATION);
+    f->heap_capacity = cells;
+    f->heap = (_MIR_FlowNode*)MIR_Alloc(sizeof(_MIR_FlowNode) * f->heap_capacity, MIR_MEM_NAVIGATION);
+
+    if (!f->cost || !f->dir || !f->work_cost || !f->work_dir || !f->work_blocked ||
+        !f->work_changes || !f->invalid || !f->mark || !f->heap) {
+        MIR_Free(f->cost); MIR_Free(f->dir); MIR_Free(f->work_cost); MIR_Free(f->work_dir);
+        MIR_Free(f->work_blocked); MIR_Free(f->work_changes); MIR_Free(f->invalid);
+        MIR_Free(f->mark); MIR_Free(f->heap);
+        MIR_Free(f);
+        return NULL;
+    }
+
+    for (int i = 0; i < cells; i++) {
+        f->cost[i] = INFINITY;
+        f->dir[i] = MIR_FLOW_NONE;
+    }
+    SDL_SetAtomicInt(&f->job.pending, 0);
+    return f;
+}
+
+static void _MIR_Flow_Push(MIR_FlowField* f, int cell, float cost) {
+    if (f->heap_count == f->heap_capacity) {
+        int capacity = f->heap_capacity * 2;
+        _MIR_FlowNode* heap = (_MIR_FlowNode*)MIR_Realloc(f->heap, sizeof(_MIR_FlowNode) * capacity, MIR_MEM_NAVIGATION);
+        if (!heap) return;
+        f->heap = heap;
+        f->heap_capacity = capacity;
+    }
+
+    int i = f->heap_count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (f->heap[parent].cost <= cost) break;
+        f->heap[i] = f->heap[parent];
+        i = parent;
+    }
+    f->heap[i].cost = cost;
+    f->heap[i].cell = cell;
+}
+
+static _MIR_FlowNode _MIR_Flow_Pop(MIR_FlowField* f) {
+    _MIR_FlowNode top = f->heap[0];
+    _MIR_FlowNode last = f->heap[--f->heap_count];
+
+    int i = 0;
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= f->heap_count) break;
+        if (child + 1 < f->heap_count && f->heap[child + 1].cost < f->heap[child].cost) child++;
+        if (last.cost <= f->heap[child].cost) break;
+        f->heap[i] = f->heap[child];
+        i = child;
+    }
+    f->heap[i] = last;
+    return top;
+}
+
+// Дейкстра от клеток в куче; стоимость только уменьшается,
+// поэтому годится и для полного, и для частичного пересчета
+static void _MIR_Flow_Propagate(MIR_FlowField* f) {
+    int width = f->grid->width, height = f->grid->height;
+    float* cost = f->work_cost;
+    uint8_t* dir = f->work_dir;
+    const uint8_t* blocked = f->work_blocked;
+
+    while (f->heap_count > 0) {
+        _MIR_FlowNode node = _MIR_Flow_Pop(f);
+        if (node.cost > cost[node.cell]) continue;
+
+        int x = node.cell % width, y = node.cell / width;
+        for (int d = 0; d < 8; d++) {
+            if (!_MIR_NavGrid_CanStep(blocked, width, height, x, y, d)) continue;
+
+            int n = node.cell + _mir_nav_dy[d] * width + _mir_nav_dx[d];
+            float c = node.cost + _mir_nav_step[d];
+            if (c < cost[n]) {
+                cost[n] = c;
+                dir[n] = _mir_flow_opposite[d];
+                _MIR_Flow_Push(f, n, c);
+            }
+        }
+    }
+}
+
+static void _MIR_Flow_Build(MIR_FlowField* f) {
+    for (int i = 0; i < f->cells; i++) {
+        f->work_cost[i] = INFINITY;
+        f->work_dir[i] = MIR_FLOW_NONE;
+    }
+
+    f->heap_count = 0;
+    if (f->work_target_cell >= 0) {
+        f->work_cost[f->work_target_cell] = 0;
+        _MIR_Flow_Push(f, f->work_target_cell, 0);
+    }
+    _MIR_Flow_Propagate(f);
+}
+
+static inline void _MIR_Flow_Invalidate(MIR_FlowField* f, int cell, int* count) {
+    if (f->mark[cell] || cell == f->work_target_cell) return;
+    f->mark[cell] = 1;
+    f->invalid[(*count)++] = cell;
+}
+
+static void _MIR_Flow_Repair(MIR_FlowField* f) {
+    int width = f->grid->width, height = f->grid->height;
+    float* cost = f->work_cost;
+    uint8_t* dir = f->work_dir;
+    const uint8_t* blocked = f->work_blocked;
+    int invalid_count = 0;
+
+    // Занятые клетки и соседи, чей переход стал недопустим (в том числе
+    // диагональ через новый угол), - корни сбрасываемых поддеревьев
+    for (int i = 0; i < f->work_change_count; i++) {
+        int cell = f->work_changes[i];
+        if (!blocked[cell]) continue;
+
+        _MIR_Flow_Invalidate(f, cell, &invalid_count);
+        int x = cell % width, y = cell / width;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + _mir_nav_dx[d], ny = y + _mir_nav_dy[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+
+            int n = ny * width + nx;
+            if (dir[n] != MIR_FLOW_NONE && !_MIR_NavGrid_CanStep(blocked, width, height, nx, ny, dir[n])) {
+                _MIR_Flow_Invalidate(f, n, &invalid_count);
+            }
+        }
+    }
+
+    // Обход вниз по дереву путей: дети указывают направлением на родителя
+    for (int head = 0; head < invalid_count; head++) {
+        int cell = f->invalid[head];
+        int x = cell % width, y = cell / width;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + _mir_nav_dx[d], ny = y + _mir_nav_dy[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+
+            int n = ny * width + nx;
+            if (dir[n] == _mir_flow_opposite[d]) {
+                _MIR_Flow_Invalidate(f, n, &invalid_count);
+            }
+        }
+        cost[cell] = INFINITY;
+        dir[cell] = MIR_FLOW_NONE;
+    }
+
+    // Достраиваем от уцелевшей границы сброшенной области
+    f->heap_count = 0;
+    for (int i = 0; i < invalid_count; i++) {
+        int cell = f->invalid[i];
+        int x = cell % width, y = cell / width;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + _mir_nav_dx[d], ny = y + _mir_nav_dy[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+
+            int n = ny * width + nx;
+            if (!f->mark[n] && cost[n] < INFINITY) {
+                _MIR_Flow_Push(f, n, cost[n]);
+            }
+        }
+    }
+
+    // Освобожденные клетки: соседи могут пойти через них
+    for (int i = 0; i < f->work_change_count; i++) {
+        int cell = f->work_changes[i];
+        if (blocked[cell]) continue;
+
+        int x = cell % width, y = cell / width;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + _mir_nav_dx[d], ny = y + _mir_nav_dy[d];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+
+            int n = ny * width + nx;
+            if (cost[n] < INFINITY) {
+                _MIR_Flow_Push(f, n, cost[n]);
+            }
+        }
+    }
+
+    for (int i = 0; i < invalid_count; i++) {
+        f->mark[f->invalid[i]] = 0;
+    }
+
+    _MIR_Flow_Propagate(f);
+}
+
+static void _MIR_FlowField_Run(void* data) {
+    MIR_FlowField* f = (MIR_FlowField*)data;
+
+    if (f->work_full) {
+        _MIR_Flow_Build(f);
+    } else {
+        // Опубликованное поле не меняется, пока задача не завершена
+        memcpy(f->work_cost, f->cost, sizeof(float) * f->cells);
+        memcpy(f->work_dir, f->dir, f->cells);
+        _MIR_Flow_Repair(f);
+    }
+}
+
+// Снимок входных данных; false - поле уже актуально
+static bool _MIR_FlowField_Prepare(MIR_FlowField* f, MIR_Vec2 target) {
+    MIR_NavGrid* grid = f->grid;
+    int target_cell = MIR_NavGrid_WorldToCell(grid, target);
+
+    if (f->valid && target_cell == f->target_cell && grid->revision == f->revision) {
+        f->target = target;
+        return false;
+    }
+
+    memcpy(f->work_blocked, grid->blocked, f->cells);
+    f->work_full = !f->valid || target_cell != f->target_cell ||
+                   !MIR_NavGrid_GetChanges(grid, f->revision, f->work_changes,
+                                           MIRULIT_NAV_CHANGE_LOG, &f->work_change_count);
+    f->work_target_cell = target_cell;
+    f->work_target = target;
+    f->work_revision = grid->revision;
+    return true;
+}
+
+static void _MIR_FlowField_Publish(MIR_FlowField* f) {
+    float* cost = f->cost;
+    uint8_t* dir = f->dir;
+    f->cost = f->work_cost;
+    f->dir = f->work_dir;
+    f->work_cost = cost;
+    f->work_dir = dir;
+
+    f->target_cell = f->work_target_cell;
+    f->target = f->work_target;
+    f->revision = f->work_revision;
+    f->valid = true;
+    f->job_running = false;
+}
+
+MIRULIT_API void MIR_FlowField_Update(MIR_FlowField* f, MIR_Vec2 target) {
+    if (!f) return;
+
+    if (f->job_running) {
+        MIR_Jobs_Wait(&f->job);
+        _MIR_FlowField_Publish(f);
+    }
+    if (_MIR_FlowField_Prepare(f, target)) {
+        _MIR_FlowField_Run(f);
+        _MIR_FlowField_Publish(f);
+    }
+}
+
+MIRULIT_API bool MIR_FlowField_UpdateAsync(MIR_FlowField* f, MIR_Vec2 target) {
+    if (!f) return false;
+
+    if (f->job_running) {
+        if (!MIR_Jobs_IsDone(&f->job)) return false;
+        _MIR_FlowField_Publish(f);
+    }
+    if (!_MIR_FlowField_Prepare(f, target)) return true;
+
+    f->job_running = true;
+    MIR_Jobs_Submit(_MIR_FlowField_Run, f, &f->job);
+
+    // Без рабочих потоков задача уже выполнена на месте
+    if (MIR_Jobs_IsDone(&f->job)) {
+        _MIR_FlowField_Publish(f);
+        return true;
+    }
+    return false;
+}
+
+MIRULIT_API void MIR_FlowField_Destroy(MIR_FlowField* f) {
+    if (!f) return;
+    if (f->job_running) MIR_Jobs_Wait(&f->job);
+
+    MIR_Free(f->cost);
+    MIR_Free(f->dir);
+    MIR_Free(f->work_cost);
+    MIR_Free(f->work_dir);
+    MIR_Free(f->work_blocked);
+    MIR_Free(f->work_changes);
+    MIR_Free(f->invalid);
+    MIR_Free(f->mark);
+    MIR_Free(f->heap);
+    MIR_Free(f);
+}
+
+MIRULIT_API MIR_Vec2 MIR_FlowField_Sample(const MIR_FlowField* f, MIR_Vec2 pos) {
+    MIR_Vec2 none = {0, 0};
+    if (!f || !f->valid) return none;
+
+    int cell = MIR_NavGrid_WorldToCell(f->grid, pos);
+    if (cell < 0) return none;
+
+    // В клетке цели - прямо на нее
+    if (cell == f->target_cell) {
+        MIR_Vec2 d = MIR_Vec2_Subtract(f->target, pos);
+        return MIR_Vec2_Dot(d, d) > 1e-6f ? MIR_Math_Normalize(d) : none;
+    }
+
+    uint8_t d = f->dir[cell];
+    if (d != MIR_FLOW_NONE) return _mir_flow_vectors[d];
+
+    // Агента занесло в препятствие (например, в раздутую границу) -
+    // выводим к ближайшей по стоимости соседней клетке
+    int width = f->grid->width;
+    int x = cell % width, y = cell / width;
+    int best = -1;
+    float best_cost = INFINITY;
+    for (int k = 0; k < 8; k++) {
+        int nx = x + _mir_nav_dx[k], ny = y + _mir_nav_dy[k];
+        if (!MIR_NavGrid_InBounds(f->grid, nx, ny)) continue;
+
+        int n = ny * width + nx;
+        if (f->cost[n] < best_cost) {
+            best_cost = f->cost[n];
+            best = n;
+        }
+    }
+    if (best < 0) return none;
+    return MIR_Math_Normalize(MIR_Vec2_Subtract(MIR_NavGrid_CellCenter(f->grid, best), pos));
+}
+
+MIRULIT_API float MIR_FlowField_GetDistance(const MIR_FlowField* f, MIR_Vec2 pos) {
+    if (!f || !f->valid) return INFINITY;
+
+    int cell = MIR_NavGrid_WorldToCell(f->grid, pos);
+    if (cell < 0) return INFINITY;
+    return f->cost[cell] * f->grid->cell_size;
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_FLOWFIELD_H
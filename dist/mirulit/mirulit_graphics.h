@@ -1,21 +1,116 @@
 #ifndef MIRULIT_GRAPHICS_H
 #define MIRULIT_GRAPHICS_H
 
-static MIR_Entity* MIR_CreateEntity(const char* tag) {
-    if (!_mir_initialized || !_mir || _mir->entity_count >= MIRULIT_MAX_ENTITIES) {
+MIRULIT_API MIR_Entity* MIR_World_CreateEntity(MIR_World* world, const char* tag);
+
+MIRULIT_API MIR_Entity* MIR_CreateEntity(const char* tag);
+
+// Удаляет сущность из ее мира (любого, не только по умолчанию)
+MIRULIT_API void MIR_DestroyEntity(MIR_Entity* entity);
+
+// Обнуленный компонент из пула по размеру; освобождается вместе с
+// сущностью или MIR_RemoveComponent. NULL - мест нет или нет памяти.
+MIRULIT_API void* MIR_AddComponent(MIR_Entity* entity, size_t size);
+
+MIRULIT_API void MIR_RemoveComponent(MIR_Entity* entity, void* component);
+
+MIRULIT_API MIR_Entity* MIR_World_FindEntityByTag(MIR_World* world, const char* tag);
+
+MIRULIT_API MIR_Entity* MIR_World_FindEntityByID(MIR_World* world, int id);
+
+MIRULIT_API MIR_Entity* MIR_FindEntityByTag(const char* tag);
+
+MIRULIT_API MIR_Entity* MIR_FindEntityByID(int id);
+
+// ==================== ДОСТУП К ХОЛОДНЫМ ДАННЫМ ====================
+// Обработчики задаются только через эти функции: они же ставят флаги
+// MIR_ENTITY_HAS_*, по которым горячие циклы решают, читать ли cold.
+
+MIRULIT_API const char* MIR_GetEntityTag(MIR_Entity* entity);
+
+MIRULIT_API void MIR_SetEntityTag(MIR_Entity* entity, const char* tag);
+
+MIRULIT_API void MIR_SetEntityUpdate(MIR_Entity* entity, void (*update)(MIR_Entity*, float));
+
+MIRULIT_API void MIR_SetEntityDraw(MIR_Entity* entity, void (*draw)(MIR_Entity*));
+
+MIRULIT_API void MIR_SetEntityOnCollision(MIR_Entity* entity, void (*on_collision)(MIR_Entity*, MIR_Entity*));
+
+MIRULIT_API void MIR_SetEntityOnClick(MIR_Entity* entity, void (*on_click)(MIR_Entity*));
+
+MIRULIT_API void MIR_SetEntityOnDestroy(MIR_Entity* entity, void (*on_destroy)(MIR_Entity*));
+
+MIRULIT_API MIR_World* MIR_GetEntityWorld(MIR_Entity* entity);
+
+MIRULIT_API void* MIR_GetEntityUserData(MIR_Entity* entity);
+
+MIRULIT_API void MIR_SetEntityUserData(MIR_Entity* entity, void* user_data);
+
+MIRULIT_API MIR_Entity* MIR_GetEntityParent(MIR_Entity* entity);
+
+// Привязка к родителю (NULL - отвязать). Дети уничтожаются вместе
+// с родителем. false - у родителя нет места, получился бы цикл или
+// родитель из другого мира.
+MIRULIT_API bool MIR_SetEntityParent(MIR_Entity* entity, MIR_Entity* parent);
+
+MIRULIT_API void MIR_World_UpdateEntities(MIR_World* world);
+
+MIRULIT_API void MIR_UpdateEntities(void);
+
+MIRULIT_API void MIR_DrawEntity(MIR_Entity* entity);
+
+MIRULIT_API void MIR_DrawEntities(void);
+
+MIRULIT_API void MIR_DrawRect(MIR_Rect rect, MIR_Color color);
+
+MIRULIT_API void MIR_DrawCircle(MIR_Vec2 center, float radius, MIR_Color color, int segments);
+
+MIRULIT_API SDL_Texture* MIR_LoadTexture(const char* filepath);
+
+MIRULIT_API void MIR_DrawLine(MIR_Vec2 start, MIR_Vec2 end, MIR_Color color, float thickness);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+// Убрать child из списка детей parent
+static void _MIR_DetachChild(MIR_Entity* parent, MIR_Entity* child) {
+    MIR_EntityCold* cold = parent->cold;
+    for (int i = 0; i < cold->child_count; i++) {
+        if (cold->children[i] == child) {
+            for (int j = i; j < cold->child_count - 1; j++) {
+                cold->children[j] = cold->children[j + 1];
+            }
+            cold->child_count--;
+            break;
+        }
+    }
+    child->cold->parent = NULL;
+}
+
+MIRULIT_API MIR_Entity* MIR_World_CreateEntity(MIR_World* world, const char* tag) {
+    if (!world || world->entity_count >= MIRULIT_MAX_ENTITIES) {
         return NULL;
     }
     
-    MIR_Entity* entity = (MIR_Entity*)calloc(1, sizeof(MIR_Entity));
+    MIR_Entity* entity = (MIR_Entity*)MIR_Pool_Alloc(&world->entity_pool);
     if (!entity) return NULL;
+    MIR_EntityCold* cold = (MIR_EntityCold*)MIR_Pool_Alloc(&world->entity_cold_pool);
+    if (!cold) {
+        MIR_Pool_Free(&world->entity_pool, entity);
+        return NULL;
+    }
+    memset(entity, 0, sizeof(MIR_Entity));
+    memset(cold, 0, sizeof(MIR_EntityCold));
+    entity->cold = cold;
+    cold->world = world;
     
-    entity->id = _mir->next_id++;
+    entity->id = world->next_id++;
     entity->active = true;
     entity->visible = true;
     entity->persistent = false;
     
     if (tag) {
-        strncpy(entity->tag, tag, sizeof(entity->tag) - 1);
+        strncpy(cold->tag, tag, sizeof(cold->tag) - 1);
     }
     
     // Инициализация трансформа
@@ -36,44 +131,47 @@ static MIR_Entity* MIR_CreateEntity(const char* tag) {
     // Инициализация коллайдера
     entity->collider.bounds = (MIR_Rect){0, 0, 1, 1};
     entity->collider.is_trigger = false;
+    entity->collider.is_static = false;
     entity->collider.enabled = true;
-    entity->collider.on_collision = NULL;
     
-    // Добавление в движок
-    _mir->entities[_mir->entity_count++] = entity;
+    // Добавление в мир
+    world->entities[world->entity_count++] = entity;
+    world->entity_changes++;
     
     return entity;
 }
 
-static void MIR_DestroyEntity(MIR_Entity* entity) {
-    if (!_mir_initialized || !_mir || !entity) return;
+MIRULIT_API MIR_Entity* MIR_CreateEntity(const char* tag) {
+    return MIR_World_CreateEntity(MIR_GetWorld(), tag);
+}
+
+MIRULIT_API void MIR_DestroyEntity(MIR_Entity* entity) {
+    if (!entity) return;
+    MIR_EntityCold* cold = entity->cold;
+    MIR_World* world = cold->world;
     
     // Вызов callback
-    if (entity->on_destroy) {
-        entity->on_destroy(entity);
+    if (cold->on_destroy) {
+        cold->on_destroy(entity);
     }
     
     // Удаление из списка детей родителя
-    if (entity->parent) {
-        for (int i = 0; i < entity->parent->child_count; i++) {
-            if (entity->parent->children[i] == entity) {
-                for (int j = i; j < entity->parent->child_count - 1; j++) {
-                    entity->parent->children[j] = entity->parent->children[j + 1];
-                }
-                entity->parent->child_count--;
-                break;
-            }
-        }
+    if (cold->parent) {
+        _MIR_DetachChild(cold->parent, entity);
     }
     
-    // Уничтожение детей
-    for (int i = 0; i < entity->child_count; i++) {
-        MIR_DestroyEntity(entity->children[i]);
+    // Уничтожение детей (каждый сам убирает себя из списка)
+    while (cold->child_count > 0) {
+        MIR_DestroyEntity(cold->children[cold->child_count - 1]);
     }
     
+#ifdef MIRULIT_ENABLE_PHYSICS
+    MIR_RemoveBody(entity);
+#endif
+    
     // Освобождение компонентов
-    for (int i = 0; i < entity->component_count; i++) {
-        free(entity->components[i]);
+    for (int i = 0; i < cold->component_count; i++) {
+        _MIR_Component_Free(world, cold->components[i]);
     }
     
     // Освобождение текстуры
@@ -81,52 +179,181 @@ static void MIR_DestroyEntity(MIR_Entity* entity) {
         SDL_DestroyTexture(entity->sprite.texture);
     }
     
-    // Удаление из массива движка
-    for (int i = 0; i < _mir->entity_count; i++) {
-        if (_mir->entities[i] == entity) {
-            free(entity);
-            for (int j = i; j < _mir->entity_count - 1; j++) {
-                _mir->entities[j] = _mir->entities[j + 1];
+    // Удаление из массива мира
+    for (int i = 0; i < world->entity_count; i++) {
+        if (world->entities[i] == entity) {
+            MIR_Pool_Free(&world->entity_cold_pool, cold);
+            MIR_Pool_Free(&world->entity_pool, entity);
+            for (int j = i; j < world->entity_count - 1; j++) {
+                world->entities[j] = world->entities[j + 1];
             }
-            _mir->entity_count--;
+            world->entity_count--;
+            world->entity_changes++;
             break;
         }
     }
 }
 
-static MIR_Entity* MIR_FindEntityByTag(const char* tag) {
-    if (!_mir_initialized || !_mir || !tag) return NULL;
+MIRULIT_API void* MIR_AddComponent(MIR_Entity* entity, size_t size) {
+    if (!entity) return NULL;
+    
+    MIR_EntityCold* cold = entity->cold;
+    int capacity = (int)(sizeof(cold->components) / sizeof(cold->components[0]));
+    if (cold->component_count >= capacity) return NULL;
     
-    for (int i = 0; i < _mir->entity_count; i++) {
-        if (_mir->entities[i] && strcmp(_mir->entities[i]->tag, tag) == 0) {
-            return _mir->entities[i];
+    void* component = _MIR_Component_Alloc(cold->world, size);
+    if (component) {
+        cold->components[cold->component_count++] = component;
+    }
+    return component;
+}
+
+MIRULIT_API void MIR_RemoveComponent(MIR_Entity* entity, void* component) {
+    if (!entity || !component) return;
+    
+    MIR_EntityCold* cold = entity->cold;
+    for (int i = 0; i < cold->component_count; i++) {
+        if (cold->components[i] == component) {
+            _MIR_Component_Free(cold->world, component);
+            cold->components[i] = cold->components[--cold->component_count];
+            return;
+        }
+    }
+}
+
+MIRULIT_API MIR_Entity* MIR_World_FindEntityByTag(MIR_World* world, const char* tag) {
+    if (!world || !tag) return NULL;
+    
+    for (int i = 0; i < world->entity_count; i++) {
+        if (world->entities[i] && strcmp(world->entities[i]->cold->tag, tag) == 0) {
+            return world->entities[i];
         }
     }
     return NULL;
 }
 
-static MIR_Entity* MIR_FindEntityByID(int id) {
-    if (!_mir_initialized || !_mir) return NULL;
+MIRULIT_API MIR_Entity* MIR_World_FindEntityByID(MIR_World* world, int id) {
+    if (!world) return NULL;
     
-    for (int i = 0; i < _mir->entity_count; i++) {
-        if (_mir->entities[i] && _mir->entities[i]->id == id) {
-            return _mir->entities[i];
+    for (int i = 0; i < world->entity_count; i++) {
+        if (world->entities[i] && world->entities[i]->id == id) {
+            return world->entities[i];
         }
     }
     return NULL;
 }
 
-static void MIR_UpdateEntities(void) {
-    if (!_mir_initialized || !_mir || _mir->paused) return;
+MIRULIT_API MIR_Entity* MIR_FindEntityByTag(const char* tag) {
+    return MIR_World_FindEntityByTag(MIR_GetWorld(), tag);
+}
+
+MIRULIT_API MIR_Entity* MIR_FindEntityByID(int id) {
+    return MIR_World_FindEntityByID(MIR_GetWorld(), id);
+}
+
+static void _MIR_SetEntityFlag(MIR_Entity* entity, int flag, bool set) {
+    if (set) {
+        entity->flags |= flag;
+    } else {
+        entity->flags &= ~flag;
+    }
+}
+
+MIRULIT_API const char* MIR_GetEntityTag(MIR_Entity* entity) {
+    return entity ? entity->cold->tag : "";
+}
+
+MIRULIT_API void MIR_SetEntityTag(MIR_Entity* entity, const char* tag) {
+    if (!entity) return;
+    memset(entity->cold->tag, 0, sizeof(entity->cold->tag));
+    if (tag) strncpy(entity->cold->tag, tag, sizeof(entity->cold->tag) - 1);
+}
+
+MIRULIT_API void MIR_SetEntityUpdate(MIR_Entity* entity, void (*update)(MIR_Entity*, float)) {
+    if (!entity) return;
+    entity->cold->update = update;
+    _MIR_SetEntityFlag(entity, MIR_ENTITY_HAS_UPDATE, update != NULL);
+}
+
+MIRULIT_API void MIR_SetEntityDraw(MIR_Entity* entity, void (*draw)(MIR_Entity*)) {
+    if (!entity) return;
+    entity->cold->draw = draw;
+    _MIR_SetEntityFlag(entity, MIR_ENTITY_HAS_DRAW, draw != NULL);
+}
+
+MIRULIT_API void MIR_SetEntityOnCollision(MIR_Entity* entity, void (*on_collision)(MIR_Entity*, MIR_Entity*)) {
+    if (!entity) return;
+    entity->cold->on_collision = on_collision;
+    _MIR_SetEntityFlag(entity, MIR_ENTITY_HAS_COLLISION, on_collision != NULL);
+}
+
+MIRULIT_API void MIR_SetEntityOnClick(MIR_Entity* entity, void (*on_click)(MIR_Entity*)) {
+    if (entity) entity->cold->on_click = on_click;
+}
+
+MIRULIT_API void MIR_SetEntityOnDestroy(MIR_Entity* entity, void (*on_destroy)(MIR_Entity*)) {
+    if (entity) entity->cold->on_destroy = on_destroy;
+}
+
+MIRULIT_API MIR_World* MIR_GetEntityWorld(MIR_Entity* entity) {
+    return entity ? entity->cold->world : NULL;
+}
+
+MIRULIT_API void* MIR_GetEntityUserData(MIR_Entity* entity) {
+    return entity ? entity->cold->user_data : NULL;
+}
+
+MIRULIT_API void MIR_SetEntityUserData(MIR_Entity* entity, void* user_data) {
+    if (entity) entity->cold->user_data = user_data;
+}
+
+MIRULIT_API MIR_Entity* MIR_GetEntityParent(MIR_Entity* entity) {
+    return entity ? entity->cold->parent : NULL;
+}
+
+MIRULIT_API bool MIR_SetEntityParent(MIR_Entity* entity, MIR_Entity* parent) {
+    if (!entity || parent == entity) return false;
+    if (parent && parent->cold->world != entity->cold->world) return false;
+    
+    for (MIR_Entity* p = parent; p; p = p->cold->parent) {
+        if (p == entity) return false;
+    }
+    
+    int capacity = parent ? (int)(sizeof(parent->cold->children) / sizeof(parent->cold->children[0])) : 0;
+    if (parent && parent->cold->child_count >= capacity) return false;
+    
+    if (entity->cold->parent) {
+        _MIR_DetachChild(entity->cold->parent, entity);
+    }
+    if (parent) {
+        parent->cold->children[parent->cold->child_count++] = entity;
+        entity->cold->parent = parent;
+    }
+    return true;
+}
+
+MIRULIT_API void MIR_World_UpdateEntities(MIR_World* world) {
+    if (!world || world->paused) return;
+    MIR_PROFILE_BEGIN("UpdateEntities");
     
-    float scaled_dt = _mir->delta_time * _mir->time_scale;
+    float scaled_dt = world->delta_time * world->time_scale;
     
-    for (int i = 0; i < _mir->entity_count; i++) {
-        MIR_Entity* entity = _mir->entities[i];
+    for (int i = 0; i < world->entity_count; i++) {
+        MIR_Entity* entity = world->entities[i];
         
         if (!entity || !entity->active) continue;
         
-        _mir->update_calls++;
+        world->update_calls++;
+        
+#ifdef MIRULIT_ENABLE_PHYSICS
+        // Тела с физикой двигает солвер в MIR_UpdatePhysics
+        if (entity->body) {
+            if (entity->flags & MIR_ENTITY_HAS_UPDATE) {
+                entity->cold->update(entity, scaled_dt);
+            }
+            continue;
+        }
+#endif
         
         // Обновление физики
         entity->transform.velocity = MIR_Vec2_Add(
@@ -140,8 +367,8 @@ static void MIR_UpdateEntities(void) {
         );
         
         // Вызов пользовательского обновления
-        if (entity->update) {
-            entity->update(entity, scaled_dt);
+        if (entity->flags & MIR_ENTITY_HAS_UPDATE) {
+            entity->cold->update(entity, scaled_dt);
         }
         
         // Обновление коллайдера
@@ -152,26 +379,31 @@ static void MIR_UpdateEntities(void) {
                                        entity->collider.bounds.h / 2;
         }
     }
+    
+    MIR_PROFILE_END();
 }
 
-static void MIR_DrawEntity(MIR_Entity* entity) {
-    if (!_mir_initialized || !_mir || !entity || !entity->visible) return;
+MIRULIT_API void MIR_UpdateEntities(void) {
+    MIR_World_UpdateEntities(MIR_GetWorld());
+}
+
+static void _MIR_DrawEntityView(MIR_Entity* entity, const MIR_Mat3* view) {
+    if (!entity || !entity->visible) return;
     
     _mir->draw_calls++;
     
-    // Мировые координаты с учётом камеры
-    float world_x = (entity->transform.position.x - _mir->camera.position.x) * 
-                    _mir->camera.zoom + _mir->width / 2.0f;
-    float world_y = (entity->transform.position.y - _mir->camera.position.y) * 
-                    _mir->camera.zoom + _mir->height / 2.0f;
+    // Экранные координаты центра по матрице вида
+    MIR_Vec2 screen = MIR_Mat3_TransformPoint(view, entity->transform.position);
+    float world_x = screen.x;
+    float world_y = screen.y;
     
     if (entity->sprite.texture) {
         // Отрисовка текстуры
         SDL_FRect dest_rect = {
-            world_x - entity->transform.scale.x * _mir->camera.zoom / 2,
-            world_y - entity->transform.scale.y * _mir->camera.zoom / 2,
-            entity->transform.scale.x * _mir->camera.zoom,
-            entity->transform.scale.y * _mir->camera.zoom
+            world_x - entity->transform.scale.x * _mir->world->camera.zoom / 2,
+            world_y - entity->transform.scale.y * _mir->world->camera.zoom / 2,
+            entity->transform.scale.x * _mir->world->camera.zoom,
+            entity->transform.scale.y * _mir->world->camera.zoom
         };
         
         SDL_SetTextureColorMod(entity->sprite.texture,
@@ -190,10 +422,10 @@ static void MIR_DrawEntity(MIR_Entity* entity) {
                               entity->sprite.color.a);
         
         SDL_FRect rect = {
-            world_x - entity->transform.scale.x * _mir->camera.zoom / 2,
-            world_y - entity->transform.scale.y * _mir->camera.zoom / 2,
-            entity->transform.scale.x * _mir->camera.zoom,
-            entity->transform.scale.y * _mir->camera.zoom
+            world_x - entity->transform.scale.x * _mir->world->camera.zoom / 2,
+            world_y - entity->transform.scale.y * _mir->world->camera.zoom / 2,
+            entity->transform.scale.x * _mir->world->camera.zoom,
+            entity->transform.scale.y * _mir->world->camera.zoom
         };
         
         SDL_RenderFillRect(_mir->renderer, &rect);
@@ -208,33 +440,43 @@ static void MIR_DrawEntity(MIR_Entity* entity) {
     }
     
     // Пользовательская отрисовка
-    if (entity->draw) {
-        entity->draw(entity);
+    if (entity->flags & MIR_ENTITY_HAS_DRAW) {
+        entity->cold->draw(entity);
     }
 }
 
-static void MIR_DrawEntities(void) {
+MIRULIT_API void MIR_DrawEntity(MIR_Entity* entity) {
+    if (!_mir_initialized || !_mir || !entity) return;
+    _MIR_DrawEntityView(entity, MIR_GetViewMatrix());
+}
+
+MIRULIT_API void MIR_DrawEntities(void) {
     if (!_mir_initialized || !_mir) return;
-    
-    // Сортировка по z-index
-    for (int i = 0; i < _mir->entity_count - 1; i++) {
-        for (int j = 0; j < _mir->entity_count - i - 1; j++) {
-            if (_mir->entities[j]->sprite.z_index > 
-                _mir->entities[j + 1]->sprite.z_index) {
-                MIR_Entity* temp = _mir->entities[j];
-                _mir->entities[j] = _mir->entities[j + 1];
-                _mir->entities[j + 1] = temp;
-            }
+    MIR_PROFILE_BEGIN("DrawEntities");
+    MIR_World* world = _mir->world;
+    
+    // Сортировка по z-index вставками: устойчивая, как и прежний пузырек,
+    // но на почти упорядоченном с прошлого кадра массиве - линейная
+    for (int i = 1; i < world->entity_count; i++) {
+        MIR_Entity* entity = world->entities[i];
+        int j = i - 1;
+        while (j >= 0 && world->entities[j]->sprite.z_index > entity->sprite.z_index) {
+            world->entities[j + 1] = world->entities[j];
+            j--;
         }
+        world->entities[j + 1] = entity;
     }
     
-    // Отрисовка
-    for (int i = 0; i < _mir->entity_count; i++) {
-        MIR_DrawEntity(_mir->entities[i]);
+    // Отрисовка (матрица вида одна на проход)
+    const MIR_Mat3* view = MIR_GetViewMatrix();
+    for (int i = 0; i < world->entity_count; i++) {
+        _MIR_DrawEntityView(world->entities[i], view);
     }
+    
+    MIR_PROFILE_END();
 }
 
-static void MIR_DrawRect(MIR_Rect rect, MIR_Color color) {
+MIRULIT_API void MIR_DrawRect(MIR_Rect rect, MIR_Color color) {
     if (!_mir_initialized || !_mir) return;
     
     SDL_SetRenderDrawColor(_mir->renderer, color.r, color.g, color.b, color.a);
@@ -243,7 +485,7 @@ static void MIR_DrawRect(MIR_Rect rect, MIR_Color color) {
     _mir->draw_calls++;
 }
 
-static void MIR_DrawCircle(MIR_Vec2 center, float radius, MIR_Color color, int segments) {
+MIRULIT_API void MIR_DrawCircle(MIR_Vec2 center, float radius, MIR_Color color, int segments) {
     if (!_mir_initialized || !_mir || radius <= 0) return;
     
     if (segments < 8) segments = 8;
@@ -264,13 +506,13 @@ static void MIR_DrawCircle(MIR_Vec2 center, float radius, MIR_Color color, int s
     _mir->draw_calls++;
 }
 
-static SDL_Texture* MIR_LoadTexture(const char* filepath) {
+MIRULIT_API SDL_Texture* MIR_LoadTexture(const char* filepath) {
     if (!_mir_initialized || !_mir) return NULL;
     
     // Создаем поверхность из BMP файла (SDL3 пока не поддерживает PNG без SDL_image)
     SDL_Surface* surface = SDL_LoadBMP(filepath);
     if (!surface) {
-        printf("[MIRULIT] Failed to load texture: %s\n", SDL_GetError());
+        MIR_Log(MIR_LOG_ERROR, "Failed to load texture: %s", SDL_GetError());
         return NULL;
     }
     
@@ -279,15 +521,15 @@ static SDL_Texture* MIR_LoadTexture(const char* filepath) {
     SDL_DestroySurface(surface);
     
     if (!texture) {
-        printf("[MIRULIT] Failed to create texture: %s\n", SDL_GetError());
+        MIR_Log(MIR_LOG_ERROR, "Failed to create texture: %s", SDL_GetError());
         return NULL;
     }
     
-    printf("[MIRULIT] Texture loaded: %s\n", filepath);
+    MIR_Log(MIR_LOG_INFO, "Texture loaded: %s", filepath);
     return texture;
 }
 
-static void MIR_DrawLine(MIR_Vec2 start, MIR_Vec2 end, MIR_Color color, float thickness) {
+MIRULIT_API void MIR_DrawLine(MIR_Vec2 start, MIR_Vec2 end, MIR_Color color, float thickness) {
     if (!_mir_initialized || !_mir) return;
     
     SDL_SetRenderDrawColor(_mir->renderer, color.r, color.g, color.b, color.a);
@@ -327,4 +569,6 @@ static void MIR_DrawLine(MIR_Vec2 start, MIR_Vec2 end, MIR_Color color, float th
     _mir->draw_calls++;
 }
 
+#endif // MIRULIT_DEFINE_ENGINE
+
 #endif // MIRULIT_GRAPHICS_H
\ No newline at end of file
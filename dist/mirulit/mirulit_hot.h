@@ -0,0 +1,201 @@
+#ifndef MIRULIT_HOT_H
+#define MIRULIT_HOT_H
+
+// ==================== ГОРЯЧАЯ ПЕРЕЗАГРУЗКА ====================
+// Хост (host.c) владеет движком: окно, миры, пулы и потоки живут в нем.
+// Модуль игры компилируется libtcc прямо в память с MIRULIT_HOT_MODULE:
+// функции движка у модуля свои, а переменные состояния (MIRULIT_SHARED)
+// объявлены extern и при загрузке связываются с переменными хоста через
+// MIR_Hot_ExportState. Поэтому код модуля работает с тем же движком,
+// и сущности, частицы и камера переживают перезагрузку.
+//
+// Глобальные переменные модуля при перезагрузке начинаются заново.
+// Состояние игры, которое нужно сохранить, хранится в блоках
+// MIR_Hot_Keep. Без хоста MIR_Hot_Keep - обычный блок до MIR_Shutdown.
+
+#define MIRULIT_HOT_BLOCKS 32
+
+typedef struct {
+    char name[32];
+    size_t size;
+    void* data;
+} _MIR_HotBlock;
+
+typedef struct {
+    _MIR_HotBlock blocks[MIRULIT_HOT_BLOCKS];
+    int block_count;
+} _MIR_HotState;
+
+MIRULIT_SHARED _MIR_HotState _mir_hot;
+
+// ==================== СОХРАНЯЕМОЕ СОСТОЯНИЕ ====================
+
+// Именованный блок, который переживает перезагрузку модуля. При первом
+// вызове блок обнулен. Если структура изменила размер, старое содержимое
+// копируется в начало нового блока - новые поля добавляйте в конец.
+MIRULIT_API void* MIR_Hot_Keep(const char* name, size_t size);
+
+// ==================== СВЯЗЫВАНИЕ С ХОСТОМ ====================
+
+// Адреса переменных состояния для модуля (tcc_add_symbol). Модуль
+// должен собираться с теми же MIRULIT_ENABLE_* и размерами, что и хост.
+typedef void (*MIR_HotExportFunc)(void* ctx, const char* name, void* address);
+
+MIRULIT_API void MIR_Hot_ExportState(MIR_HotExportFunc export_symbol, void* ctx);
+
+// ==================== ПЕРЕПРИВЯЗКА ОБРАБОТЧИКОВ ====================
+// rebind получает адрес обработчика и возвращает:
+//   - адрес одноименной функции нового модуля;
+//   - тот же адрес, если это не код старых модулей (функции хоста,
+//     библиотек) - такой обработчик остается как есть;
+//   - NULL, если адрес в коде старого модуля, а в новом замены нет.
+// static-функции не экспортируются и остаются на старом коде (хост не
+// выгружает старые модули).
+
+typedef void* (*MIR_HotRebindFunc)(void* ctx, void* function);
+
+// Обработчики мира и его сущностей. Возвращает число обработчиков,
+// которые остались на коде старого модуля.
+MIRULIT_API int MIR_Hot_RebindWorld(MIR_World* world, MIR_HotRebindFunc rebind, void* ctx);
+
+// То же для всех живых миров: мира по умолчанию и созданных игрой
+// через MIR_World_Create. Тела физики своих обработчиков не хранят -
+// их сущности перепривязываются вместе с миром по умолчанию.
+MIRULIT_API int MIR_Hot_RebindWorlds(MIR_HotRebindFunc rebind, void* ctx);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+MIRULIT_API void* MIR_Hot_Keep(const char* name, size_t size) {
+    if (!name || size == 0) return NULL;
+
+    for (int i = 0; i < _mir_hot.block_count; i++) {
+        _MIR_HotBlock* block = &_mir_hot.blocks[i];
+        if (strcmp(block->name, name) != 0) continue;
+        if (block->size == size) return block->data;
+
+        void* data = MIR_Calloc(1, size, MIR_MEM_CORE);
+        if (!data) return NULL;
+        memcpy(data, block->data, block->size < size ? block->size : size);
+        MIR_Log(MIR_LOG_WARN, "Hot block '%s' resized: %zu -> %zu bytes",
+                name, block->size, size);
+
+        MIR_Free(block->data);
+        block->data = data;
+        block->size = size;
+        return data;
+    }
+
+    if (_mir_hot.block_count >= MIRULIT_HOT_BLOCKS) {
+        MIR_Log(MIR_LOG_ERROR, "Too many hot blocks (max %d)", MIRULIT_HOT_BLOCKS);
+        return NULL;
+    }
+
+    void* data = MIR_Calloc(1, size, MIR_MEM_CORE);
+    if (!data) return NULL;
+
+    _MIR_HotBlock* block = &_mir_hot.blocks[_mir_hot.block_count++];
+    strncpy(block->name, name, sizeof(block->name) - 1);
+    block->size = size;
+    block->data = data;
+    return data;
+}
+
+// Вызывается из MIR_Shutdown
+MIRULIT_API void _MIR_Hot_Shutdown(void) {
+    for (int i = 0; i < _mir_hot.block_count; i++) {
+        MIR_Free(_mir_hot.blocks[i].data);
+    }
+    memset(&_mir_hot, 0, sizeof(_mir_hot));
+}
+
+#define _MIR_HOT_EXPORT(variable) export_symbol(ctx, #variable, (void*)&variable)
+
+MIRULIT_API void MIR_Hot_ExportState(MIR_HotExportFunc export_symbol, void* ctx) {
+    if (!export_symbol) return;
+
+    _MIR_HOT_EXPORT(_mir_allocator);
+    _MIR_HOT_EXPORT(_mir_mem_stats);
+    _MIR_HOT_EXPORT(_mir_mem_lock);
+    _MIR_HOT_EXPORT(_mir_frame_arena);
+    _MIR_HOT_EXPORT(_mir_rng_tls);
+    _MIR_HOT_EXPORT(_mir_rng_generation);
+    _MIR_HOT_EXPORT(_mir_rng_next_slot);
+    _MIR_HOT_EXPORT(_mir_rng_seed);
+    _MIR_HOT_EXPORT(_mir_rng_fallback);
+    _MIR_HOT_EXPORT(_mir_log);
+    _MIR_HOT_EXPORT(_mir_jobs);
+    _MIR_HOT_EXPORT(_mir_jobs_initialized);
+    _MIR_HOT_EXPORT(_mir_worlds);
+    _MIR_HOT_EXPORT(_mir_worlds_lock);
+    _MIR_HOT_EXPORT(_mir);
+    _MIR_HOT_EXPORT(_mir_initialized);
+    _MIR_HOT_EXPORT(_mir_text);
+    _MIR_HOT_EXPORT(_mir_overlay_visible);
+    _MIR_HOT_EXPORT(_mir_hot);
+#ifdef MIRULIT_ENABLE_PHYSICS
+    _MIR_HOT_EXPORT(_mir_physics);
+#endif
+#ifdef MIRULIT_ENABLE_PROFILER
+    _MIR_HOT_EXPORT(_mir_profile_threads);
+    _MIR_HOT_EXPORT(_mir_profile_thread_count);
+    _MIR_HOT_EXPORT(_mir_profile_lock);
+    _MIR_HOT_EXPORT(_mir_profile_tls);
+    _MIR_HOT_EXPORT(_mir_profile_spike_ms);
+    _MIR_HOT_EXPORT(_mir_profile_spike_path);
+    _MIR_HOT_EXPORT(_mir_profile_frame_name);
+#endif
+}
+
+#undef _MIR_HOT_EXPORT
+
+static void* _MIR_Hot_Rebind(MIR_HotRebindFunc rebind, void* ctx, void* function, int* stale) {
+    if (!function) return NULL;
+
+    void* rebound = rebind(ctx, function);
+    if (rebound) return rebound;
+
+    // Код старого модуля без замены
+    (*stale)++;
+    return function;
+}
+
+MIRULIT_API int MIR_Hot_RebindWorld(MIR_World* world, MIR_HotRebindFunc rebind, void* ctx) {
+    if (!world || !rebind) return 0;
+    int stale = 0;
+
+    world->on_step = (void (*)(MIR_World*, float))
+        _MIR_Hot_Rebind(rebind, ctx, (void*)world->on_step, &stale);
+
+    for (int i = 0; i < world->entity_count; i++) {
+        MIR_Entity* entity = world->entities[i];
+        if (!entity) continue;
+
+        MIR_EntityCold* cold = entity->cold;
+        cold->update = (void (*)(MIR_Entity*, float))
+            _MIR_Hot_Rebind(rebind, ctx, (void*)cold->update, &stale);
+        cold->draw = (void (*)(MIR_Entity*))
+            _MIR_Hot_Rebind(rebind, ctx, (void*)cold->draw, &stale);
+        cold->on_click = (void (*)(MIR_Entity*))
+            _MIR_Hot_Rebind(rebind, ctx, (void*)cold->on_click, &stale);
+        cold->on_destroy = (void (*)(MIR_Entity*))
+            _MIR_Hot_Rebind(rebind, ctx, (void*)cold->on_destroy, &stale);
+        cold->on_collision = (void (*)(MIR_Entity*, MIR_Entity*))
+            _MIR_Hot_Rebind(rebind, ctx, (void*)cold->on_collision, &stale);
+    }
+    return stale;
+}
+
+MIRULIT_API int MIR_Hot_RebindWorlds(MIR_HotRebindFunc rebind, void* ctx) {
+    int stale = 0;
+    SDL_LockSpinlock(&_mir_worlds_lock);
+    for (MIR_World* world = _mir_worlds; world; world = world->next_world) {
+        stale += MIR_Hot_RebindWorld(world, rebind, ctx);
+    }
+    SDL_UnlockSpinlock(&_mir_worlds_lock);
+    return stale;
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_HOT_H
@@ -0,0 +1,257 @@
+#ifndef MIRULIT_JOBS_H
+#define MIRULIT_JOBS_H
+
+// ==================== СИСТЕМА ЗАДАЧ ====================
+// Пул рабочих потоков на SDL_Thread. Ожидающий поток не спит,
+// а сам выполняет задачи из очереди, поэтому вложенные
+// MIR_Jobs_ParallelFor не блокируют пул.
+
+#define MIRULIT_MAX_WORKERS 16
+#define MIRULIT_JOB_QUEUE_SIZE 1024
+
+typedef void (*MIR_JobFunc)(void* data);
+typedef void (*MIR_ParallelFunc)(void* data, int begin, int end);
+
+// Счетчик незавершенных задач (ноль - все выполнено)
+typedef struct {
+    SDL_AtomicInt pending;
+} MIR_JobCounter;
+
+typedef struct {
+    MIR_JobFunc func;
+    void* data;
+    MIR_JobCounter* counter;
+} MIR_Job;
+
+typedef struct {
+    SDL_Thread* threads[MIRULIT_MAX_WORKERS];
+    int worker_count;
+
+    MIR_Job queue[MIRULIT_JOB_QUEUE_SIZE];
+    int head;
+    int count;
+
+    SDL_Mutex* mutex;
+    SDL_Condition* has_work;
+    bool quit;
+} MIR_JobSystem;
+
+// Данные одного ParallelFor
+typedef struct {
+    MIR_ParallelFunc func;
+    void* data;
+    int count;
+    int grain;
+    SDL_AtomicInt next;
+} MIR_ParallelBatch;
+
+MIRULIT_SHARED MIR_JobSystem _mir_jobs;
+MIRULIT_SHARED bool _mir_jobs_initialized;
+
+// worker_count < 0 - по числу логических ядер минус главный поток
+MIRULIT_API bool MIR_Jobs_Init(int worker_count);
+
+MIRULIT_API void MIR_Jobs_Shutdown(void);
+
+MIRULIT_API int MIR_Jobs_GetWorkerCount(void);
+
+// Постановка задачи в очередь. Без рабочих потоков или при
+// переполненной очереди задача выполняется сразу.
+MIRULIT_API void MIR_Jobs_Submit(MIR_JobFunc func, void* data, MIR_JobCounter* counter);
+
+MIRULIT_API bool MIR_Jobs_IsDone(MIR_JobCounter* counter);
+
+// Ожидание с помощью: пока счетчик не обнулился, выполняем чужие задачи
+MIRULIT_API void MIR_Jobs_Wait(MIR_JobCounter* counter);
+
+// Параллельный цикл по [0, count) кусками по grain элементов.
+// Вызывающий поток участвует в работе и возвращается после завершения.
+MIRULIT_API void MIR_Jobs_ParallelFor(int count, int grain, MIR_ParallelFunc func, void* data);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+static bool _MIR_Jobs_Pop(MIR_Job* job) {
+    if (_mir_jobs.count == 0) return false;
+    *job = _mir_jobs.queue[_mir_jobs.head];
+    _mir_jobs.head = (_mir_jobs.head + 1) % MIRULIT_JOB_QUEUE_SIZE;
+    _mir_jobs.count--;
+    return true;
+}
+
+static void _MIR_Jobs_Execute(MIR_Job* job) {
+    MIR_PROFILE_BEGIN("Job");
+    job->func(job->data);
+    MIR_PROFILE_END();
+    if (job->counter) {
+        SDL_AddAtomicInt(&job->counter->pending, -1);
+    }
+}
+
+static int _MIR_Jobs_WorkerMain(void* unused) {
+    (void)unused;
+    MIR_PROFILE_THREAD("Worker");
+
+    for (;;) {
+        MIR_Job job;
+
+        SDL_LockMutex(_mir_jobs.mutex);
+        while (_mir_jobs.count == 0 && !_mir_jobs.quit) {
+            SDL_WaitCondition(_mir_jobs.has_work, _mir_jobs.mutex);
+        }
+        if (_mir_jobs.quit && _mir_jobs.count == 0) {
+            SDL_UnlockMutex(_mir_jobs.mutex);
+            break;
+        }
+        _MIR_Jobs_Pop(&job);
+        SDL_UnlockMutex(_mir_jobs.mutex);
+
+        _MIR_Jobs_Execute(&job);
+    }
+    return 0;
+}
+
+MIRULIT_API bool MIR_Jobs_Init(int worker_count) {
+    if (_mir_jobs_initialized) return true;
+
+    if (worker_count < 0) {
+        worker_count = SDL_GetNumLogicalCPUCores() - 1;
+    }
+    if (worker_count > MIRULIT_MAX_WORKERS) worker_count = MIRULIT_MAX_WORKERS;
+    if (worker_count < 0) worker_count = 0;
+
+    memset(&_mir_jobs, 0, sizeof(_mir_jobs));
+    _mir_jobs.mutex = SDL_CreateMutex();
+    _mir_jobs.has_work = SDL_CreateCondition();
+    if (!_mir_jobs.mutex || !_mir_jobs.has_work) {
+        MIR_Log(MIR_LOG_ERROR, "Job system init failed: %s", SDL_GetError());
+        if (_mir_jobs.mutex) SDL_DestroyMutex(_mir_jobs.mutex);
+        if (_mir_jobs.has_work) SDL_DestroyCondition(_mir_jobs.has_work);
+        return false;
+    }
+
+    for (int i = 0; i < worker_count; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "MIR_Worker%d", i);
+        _mir_jobs.threads[i] = SDL_CreateThread(_MIR_Jobs_WorkerMain, name, NULL);
+        if (!_mir_jobs.threads[i]) break;
+        _mir_jobs.worker_count++;
+    }
+
+    _mir_jobs_initialized = true;
+    return true;
+}
+
+MIRULIT_API void MIR_Jobs_Shutdown(void) {
+    if (!_mir_jobs_initialized) return;
+
+    SDL_LockMutex(_mir_jobs.mutex);
+    _mir_jobs.quit = true;
+    SDL_BroadcastCondition(_mir_jobs.has_work);
+    SDL_UnlockMutex(_mir_jobs.mutex);
+
+    for (int i = 0; i < _mir_jobs.worker_count; i++) {
+        SDL_WaitThread(_mir_jobs.threads[i], NULL);
+    }
+
+    SDL_DestroyCondition(_mir_jobs.has_work);
+    SDL_DestroyMutex(_mir_jobs.mutex);
+    _mir_jobs_initialized = false;
+}
+
+MIRULIT_API int MIR_Jobs_GetWorkerCount(void) {
+    return _mir_jobs_initialized ? _mir_jobs.worker_count : 0;
+}
+
+MIRULIT_API void MIR_Jobs_Submit(MIR_JobFunc func, void* data, MIR_JobCounter* counter) {
+    MIR_Job job = { func, data, counter };
+
+    if (counter) {
+        SDL_AddAtomicInt(&counter->pending, 1);
+    }
+
+    if (_mir_jobs_initialized && _mir_jobs.worker_count > 0) {
+        SDL_LockMutex(_mir_jobs.mutex);
+        if (_mir_jobs.count < MIRULIT_JOB_QUEUE_SIZE) {
+            int tail = (_mir_jobs.head + _mir_jobs.count) % MIRULIT_JOB_QUEUE_SIZE;
+            _mir_jobs.queue[tail] = job;
+            _mir_jobs.count++;
+            SDL_SignalCondition(_mir_jobs.has_work);
+            SDL_UnlockMutex(_mir_jobs.mutex);
+            return;
+        }
+        SDL_UnlockMutex(_mir_jobs.mutex);
+    }
+
+    _MIR_Jobs_Execute(&job);
+}
+
+MIRULIT_API bool MIR_Jobs_IsDone(MIR_JobCounter* counter) {
+    return !counter || SDL_GetAtomicInt(&counter->pending) == 0;
+}
+
+MIRULIT_API void MIR_Jobs_Wait(MIR_JobCounter* counter) {
+    while (!MIR_Jobs_IsDone(counter)) {
+        MIR_Job job;
+        bool got = false;
+
+        if (_mir_jobs_initialized) {
+            SDL_LockMutex(_mir_jobs.mutex);
+            got = _MIR_Jobs_Pop(&job);
+            SDL_UnlockMutex(_mir_jobs.mutex);
+        }
+
+        if (got) {
+            _MIR_Jobs_Execute(&job);
+        } else {
+            SDL_CPUPauseInstruction();
+        }
+    }
+}
+
+static void _MIR_Jobs_RunBatch(void* data) {
+    MIR_ParallelBatch* batch = (MIR_ParallelBatch*)data;
+
+    for (;;) {
+        int begin = SDL_AddAtomicInt(&batch->next, batch->grain);
+        if (begin >= batch->count) break;
+
+        int end = begin + batch->grain;
+        if (end > batch->count) end = batch->count;
+        batch->func(batch->data, begin, end);
+    }
+}
+
+MIRULIT_API void MIR_Jobs_ParallelFor(int count, int grain, MIR_ParallelFunc func, void* data) {
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+
+    int chunks = (count + grain - 1) / grain;
+    int helpers = MIR_Jobs_GetWorkerCount();
+    if (helpers > chunks - 1) helpers = chunks - 1;
+
+    if (helpers <= 0) {
+        func(data, 0, count);
+        return;
+    }
+
+    MIR_ParallelBatch batch;
+    batch.func = func;
+    batch.data = data;
+    batch.count = count;
+    batch.grain = grain;
+    SDL_SetAtomicInt(&batch.next, 0);
+
+    MIR_JobCounter counter;
+    SDL_SetAtomicInt(&counter.pending, 0);
+
+    for (int i = 0; i < helpers; i++) {
+        MIR_Jobs_Submit(_MIR_Jobs_RunBatch, &batch, &counter);
+    }
+    _MIR_Jobs_RunBatch(&batch);
+    MIR_Jobs_Wait(&counter);
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_JOBS_H
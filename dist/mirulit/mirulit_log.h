@@ -0,0 +1,498 @@
+#ifndef MIRULIT_LOG_H
+#define MIRULIT_LOG_H
+
+// ==================== ЛОГ ====================
+// MIR_Log(уровень, "формат", ...) не форматирует строку на месте:
+// аргументы по разбору формата копируются в запись кольца MPSC
+// (очередь Вьюкова, без блокировок), а фоновый поток собирает
+// текст и отдает его приемникам - консоли, файлу, своим функциям.
+// Уровни ниже MIRULIT_LOG_LEVEL выкидываются при компиляции.
+// Одно место вызова пишет не чаще MIRULIT_LOG_RATE_LIMIT раз в
+// секунду, остальное считается и сообщается следующей записью.
+// До MIR_Log_Init и после MIR_Log_Shutdown запись идет синхронно.
+
+typedef enum {
+    MIR_LOG_DEBUG,
+    MIR_LOG_INFO,
+    MIR_LOG_WARN,
+    MIR_LOG_ERROR,
+    MIR_LOG_NONE
+} MIR_LogLevel;
+
+#ifndef MIRULIT_LOG_LEVEL
+#define MIRULIT_LOG_LEVEL 1             // 0 - debug ... 3 - error, 4 - выключен
+#endif
+
+#define MIRULIT_LOG_RING 4096           // записей, степень двойки
+#define MIRULIT_LOG_MAX_ARGS 12
+#define MIRULIT_LOG_STRING_BYTES 192    // копии аргументов %s одной записи
+#define MIRULIT_LOG_LINE 1024
+#define MIRULIT_LOG_RATE_LIMIT 20
+#define MIRULIT_LOG_MAX_SINKS 4
+
+typedef void (*MIR_LogSink)(MIR_LogLevel level, const char* message, void* user_data);
+
+// Место вызова (для ограничения частоты)
+typedef struct {
+    SDL_AtomicInt window;       // секунда, к которой относится счетчик
+    SDL_AtomicInt count;
+    SDL_AtomicInt suppressed;
+} _MIR_LogSite;
+
+typedef enum {
+    _MIR_LOG_ARG_INT,
+    _MIR_LOG_ARG_DOUBLE,
+    _MIR_LOG_ARG_POINTER,
+    _MIR_LOG_ARG_STRING
+} _MIR_LogArgKind;
+
+typedef union {
+    long long i;
+    double d;
+    const void* p;
+    int offset;                 // строка в strings[]
+} _MIR_LogArg;
+
+typedef struct {
+    SDL_AtomicInt sequence;
+    int level;
+    int suppressed;
+    uint64_t time;
+    const char* format;
+    int arg_count;
+    unsigned char kinds[MIRULIT_LOG_MAX_ARGS];
+    _MIR_LogArg args[MIRULIT_LOG_MAX_ARGS];
+    char strings[MIRULIT_LOG_STRING_BYTES];
+} _MIR_LogRecord;
+
+typedef struct {
+    _MIR_LogRecord ring[MIRULIT_LOG_RING];
+    SDL_AtomicInt enqueue;
+    int dequeue;                // только поток записи
+    SDL_AtomicInt processed;
+    SDL_AtomicInt dropped;
+
+    SDL_Thread* thread;
+    SDL_AtomicInt quit;
+    bool running;
+    uint64_t start_time;
+    int level;
+
+    bool console;
+    FILE* file;
+    MIR_LogSink sinks[MIRULIT_LOG_MAX_SINKS];
+    void* sink_data[MIRULIT_LOG_MAX_SINKS];
+    int sink_count;
+} MIR_Logger;
+
+MIRULIT_SHARED MIR_Logger* _mir_log;
+
+// ==================== API ====================
+
+#if defined(__GNUC__) && !defined(__TINYC__)
+__attribute__((format(printf, 3, 4)))
+#endif
+MIRULIT_API void _MIR_Log_Push(_MIR_LogSite* site, MIR_LogLevel level, const char* format, ...);
+
+// Формат должен быть строковым литералом: он читается позже
+#define MIR_Log(level, ...) do { \
+        if ((int)(level) >= MIRULIT_LOG_LEVEL) { \
+            static _MIR_LogSite _mir_log_site; \
+            _MIR_Log_Push(&_mir_log_site, (level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+MIRULIT_API bool MIR_Log_Init(void);
+
+// Ожидание, пока поток записи выведет все поставленные записи
+MIRULIT_API void MIR_Log_Flush(void);
+
+MIRULIT_API void MIR_Log_Shutdown(void);
+
+// Настройки приемников - до или между кадрами, не из рабочих потоков
+MIRULIT_API void MIR_Log_SetLevel(MIR_LogLevel level);
+
+MIRULIT_API void MIR_Log_SetConsole(bool enabled);
+
+MIRULIT_API bool MIR_Log_SetFile(const char* path);
+
+MIRULIT_API bool MIR_Log_AddSink(MIR_LogSink sink, void* user_data);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+// Разбор формата и копирование аргументов в запись
+static void _MIR_Log_Capture(_MIR_LogRecord* record, const char* format, va_list args) {
+    int strings_used = 0;
+    record->arg_count = 0;
+
+    for (const char* p = format; *p; p++) {
+        if (*p != '%') continue;
+        p++;
+        if (*p == '%') continue;
+
+        // Флаги, ширина, точность ('*' - отдельный аргумент int)
+        int length = 0;     // 1 - l, 2 - ll/j/z/t, 3 - L
+        for (; *p; p++) {
+            if (*p == '*') {
+                if (record->arg_count < MIRULIT_LOG_MAX_ARGS) {
+                    record->kinds[record->arg_count] = _MIR_LOG_ARG_INT;
+                    record->args[record->arg_count++].i = va_arg(args, int);
+                } else {
+                    (void)va_arg(args, int);
+                }
+                continue;
+            }
+            if (strchr("-+ #0123456789.", *p)) continue;
+            if (*p == 'h') continue;
+            if (*p == 'l') { length++; continue; }
+            if (*p == 'j' || *p == 'z' || *p == 't') { length = 2; continue; }
+            if (*p == 'L') { length = 3; continue; }
+            break;
+        }
+        if (!*p) break;
+
+        _MIR_LogArg value;
+        int kind = _MIR_LOG_ARG_INT;
+        switch (*p) {
+            case 'd': case 'i':
+                value.i = length >= 2 ? va_arg(args, long long) :
+                          length == 1 ? va_arg(args, long) : va_arg(args, int);
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                value.i = (long long)(length >= 2 ? va_arg(args, unsigned long long) :
+                                      length == 1 ? va_arg(args, unsigned long) :
+                                      va_arg(args, unsigned int));
+                break;
+            case 'c':
+                value.i = va_arg(args, int);
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                kind = _MIR_LOG_ARG_DOUBLE;
+                value.d = length == 3 ? (double)va_arg(args, long double) : va_arg(args, double);
+                break;
+            case 's': {
+                // Строка может не дожить до потока записи - копируем
+                kind = _MIR_LOG_ARG_STRING;
+                const char* s = va_arg(args, const char*);
+                if (!s) s = "(null)";
+                int room = MIRULIT_LOG_STRING_BYTES - strings_used;
+                int n = (int)strlen(s);
+                if (n >= room) n = room > 0 ? room - 1 : 0;
+                value.offset = strings_used;
+                if (room > 0) {
+                    memcpy(record->strings + strings_used, s, n);
+                    record->strings[strings_used + n] = '\0';
+                    strings_used += n + 1;
+                } else {
+                    value.offset = MIRULIT_LOG_STRING_BYTES - 1;
+                }
+                break;
+            }
+            default:    // 'p', 'n' и неизвестные
+                kind = _MIR_LOG_ARG_POINTER;
+                value.p = va_arg(args, const void*);
+                break;
+        }
+
+        if (record->arg_count < MIRULIT_LOG_MAX_ARGS) {
+            record->kinds[record->arg_count] = (unsigned char)kind;
+            record->args[record->arg_count++] = value;
+        }
+    }
+    record->strings[MIRULIT_LOG_STRING_BYTES - 1] = '\0';
+}
+
+static int _MIR_Log_Format(const _MIR_LogRecord* record, char* out, int size) {
+    int used = 0, arg = 0;
+    char spec[32];
+
+    for (const char* p = record->format; *p && used < size - 1; p++) {
+        if (*p != '%') {
+            out[used++] = *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[used++] = '%';
+            p++;
+            continue;
+        }
+
+        // Спецификатор без модификаторов длины; целые печатаются как ll
+        int spec_len = 0, stars[2], star_count = 0;
+        spec[spec_len++] = '%';
+        for (p++; *p && strchr("-+ #0123456789.*hljztL", *p); p++) {
+            if (*p == '*') {
+                if (star_count < 2 && arg < record->arg_count) stars[star_count++] = (int)record->args[arg].i;
+                arg++;
+            }
+            if (strchr("hljztL", *p)) continue;
+            if (spec_len < (int)sizeof(spec) - 4) spec[spec_len++] = *p;
+        }
+        if (!*p) break;
+
+        char conversion = *p;
+        if (strchr("diuxXo", conversion)) {
+            spec[spec_len++] = 'l';
+            spec[spec_len++] = 'l';
+        }
+        spec[spec_len++] = conversion;
+        spec[spec_len] = '\0';
+
+        if (arg >= record->arg_count) break;
+        const _MIR_LogArg* value = &record->args[arg];
+        int kind = record->kinds[arg++];
+        char* dst = out + used;
+        int room = size - used;
+        int n = 0;
+
+        if (conversion == 'n') continue;
+        if (kind == _MIR_LOG_ARG_STRING) {
+            const char* s = record->strings + value->offset;
+            n = star_count == 2 ? snprintf(dst, room, spec, stars[0], stars[1], s) :
+                star_count == 1 ? snprintf(dst, room, spec, stars[0], s) : snprintf(dst, room, spec, s);
+        } else if (kind == _MIR_LOG_ARG_DOUBLE) {
+            n = star_count == 2 ? snprintf(dst, room, spec, stars[0], stars[1], value->d) :
+                star_count == 1 ? snprintf(dst, room, spec, stars[0], value->d) : snprintf(dst, room, spec, value->d);
+        } else if (kind == _MIR_LOG_ARG_POINTER) {
+            n = star_count == 1 ? snprintf(dst, room, spec, stars[0], value->p) : snprintf(dst, room, spec, value->p);
+        } else if (conversion == 'c') {
+            n = star_count == 1 ? snprintf(dst, room, spec, stars[0], (int)value->i) : snprintf(dst, room, spec, (int)value->i);
+        } else {
+            n = star_count == 2 ? snprintf(dst, room, spec, stars[0], stars[1], value->i) :
+                star_count == 1 ? snprintf(dst, room, spec, stars[0], value->i) : snprintf(dst, room, spec, value->i);
+        }
+        if (n > 0) used += n < room ? n : room - 1;
+    }
+
+    // Переводы строк в конце формата убираем - приемники пишут строками
+    while (used > 0 && out[used - 1] == '\n') used--;
+    out[used] = '\0';
+    return used;
+}
+
+static const char* _mir_log_level_names[MIR_LOG_NONE + 1] = { "DEBUG", "INFO", "WARN", "ERROR", "NONE" };
+
+static void _MIR_Log_Dispatch(MIR_Logger* logger, const _MIR_LogRecord* record) {
+    char message[MIRULIT_LOG_LINE];
+    int length = _MIR_Log_Format(record, message, sizeof(message));
+    if (record->suppressed > 0 && length < (int)sizeof(message) - 1) {
+        snprintf(message + length, sizeof(message) - length,
+                 " (+%d similar suppressed)", record->suppressed);
+    }
+
+    // MIR_Log(MIR_LOG_NONE, ...) проходит фильтр при уровне логгера NONE
+    int index = record->level < 0 ? 0 : record->level > MIR_LOG_NONE ? MIR_LOG_NONE : record->level;
+    const char* level = _mir_log_level_names[index];
+    if (!logger || logger->console) {
+        if (record->level == MIR_LOG_INFO) {
+            printf("[MIRULIT] %s\n", message);
+        } else {
+            printf("[MIRULIT] %s: %s\n", level, message);
+        }
+    }
+    if (!logger) return;
+
+    if (logger->file) {
+        fprintf(logger->file, "[%10.4f] %-5s %s\n",
+                (record->time - logger->start_time) / 1e9, level, message);
+    }
+    for (int i = 0; i < logger->sink_count; i++) {
+        logger->sinks[i]((MIR_LogLevel)record->level, message, logger->sink_data[i]);
+    }
+}
+
+static bool _MIR_Log_Drain(MIR_Logger* logger) {
+    bool any = false;
+    for (;;) {
+        _MIR_LogRecord* record = &logger->ring[logger->dequeue & (MIRULIT_LOG_RING - 1)];
+        int sequence = SDL_GetAtomicInt(&record->sequence);
+        if (sequence != logger->dequeue + 1) break;
+
+        _MIR_Log_Dispatch(logger, record);
+        SDL_SetAtomicInt(&record->sequence, logger->dequeue + MIRULIT_LOG_RING);
+        logger->dequeue++;
+        SDL_SetAtomicInt(&logger->processed, logger->dequeue);
+        any = true;
+    }
+
+    int dropped = SDL_SetAtomicInt(&logger->dropped, 0);
+    if (dropped > 0) {
+        _MIR_LogRecord note;
+        memset(&note, 0, sizeof(note));
+        note.level = MIR_LOG_WARN;
+        note.time = SDL_GetTicksNS();
+        note.format = "Log ring full, %d messages dropped";
+        note.arg_count = 1;
+        note.kinds[0] = _MIR_LOG_ARG_INT;
+        note.args[0].i = dropped;
+        _MIR_Log_Dispatch(logger, &note);
+        any = true;
+    }
+
+    if (any) {
+        if (logger->console) fflush(stdout);
+        if (logger->file) fflush(logger->file);
+    }
+    return any;
+}
+
+static int _MIR_Log_WriterMain(void* data) {
+    MIR_Logger* logger = (MIR_Logger*)data;
+    while (!SDL_GetAtomicInt(&logger->quit)) {
+        if (!_MIR_Log_Drain(logger)) {
+            SDL_DelayNS(1000000);
+        }
+    }
+    _MIR_Log_Drain(logger);
+    return 0;
+}
+
+MIRULIT_API void _MIR_Log_Push(_MIR_LogSite* site, MIR_LogLevel level, const char* format, ...) {
+    MIR_Logger* logger = _mir_log;
+    if (logger && (int)level < logger->level) return;
+    uint64_t now = SDL_GetTicksNS();
+
+    // Ограничение частоты одного места вызова
+    int suppressed = 0;
+    if (site) {
+        int second = (int)(now / SDL_NS_PER_SECOND);
+        int window = SDL_GetAtomicInt(&site->window);
+        if (window != second && SDL_CompareAndSwapAtomicInt(&site->window, window, second)) {
+            SDL_SetAtomicInt(&site->count, 0);
+        }
+        if (SDL_AddAtomicInt(&site->count, 1) >= MIRULIT_LOG_RATE_LIMIT) {
+            SDL_AddAtomicInt(&site->suppressed, 1);
+            return;
+        }
+        suppressed = SDL_SetAtomicInt(&site->suppressed, 0);
+    }
+
+    va_list args;
+    va_start(args, format);
+
+    // Без потока записи - сразу
+    if (!logger || !logger->running) {
+        _MIR_LogRecord record;
+        record.level = level;
+        record.suppressed = suppressed;
+        record.time = now;
+        record.format = format;
+        _MIR_Log_Capture(&record, format, args);
+        va_end(args);
+        _MIR_Log_Dispatch(logger, &record);
+        if (!logger || logger->console) fflush(stdout);
+        return;
+    }
+
+    // Захват ячейки: позиция продвигается CAS, ячейка свободна,
+    // когда ее sequence равен позиции
+    _MIR_LogRecord* record = NULL;
+    int position = SDL_GetAtomicInt(&logger->enqueue);
+    for (;;) {
+        record = &logger->ring[position & (MIRULIT_LOG_RING - 1)];
+        int diff = SDL_GetAtomicInt(&record->sequence) - position;
+        if (diff == 0) {
+            if (SDL_CompareAndSwapAtomicInt(&logger->enqueue, position, position + 1)) break;
+            position = SDL_GetAtomicInt(&logger->enqueue);
+        } else if (diff < 0) {
+            // Кольцо заполнено - сообщение теряется, но вызывающий не ждет
+            SDL_AddAtomicInt(&logger->dropped, 1);
+            va_end(args);
+            return;
+        } else {
+            position = SDL_GetAtomicInt(&logger->enqueue);
+        }
+    }
+
+    record->level = level;
+    record->suppressed = suppressed;
+    record->time = now;
+    record->format = format;
+    _MIR_Log_Capture(record, format, args);
+    va_end(args);
+    SDL_SetAtomicInt(&record->sequence, position + 1);
+}
+
+MIRULIT_API bool MIR_Log_Init(void) {
+    if (_mir_log) return true;
+
+    MIR_Logger* logger = (MIR_Logger*)MIR_Calloc(1, sizeof(MIR_Logger), MIR_MEM_DEBUG);
+    if (!logger) return false;
+
+    for (int i = 0; i < MIRULIT_LOG_RING; i++) {
+        SDL_SetAtomicInt(&logger->ring[i].sequence, i);
+    }
+    logger->console = true;
+    logger->level = MIRULIT_LOG_LEVEL;
+    logger->start_time = SDL_GetTicksNS();
+    _mir_log = logger;
+
+    logger->thread = SDL_CreateThread(_MIR_Log_WriterMain, "MirulitLog", logger);
+    logger->running = logger->thread != NULL;
+    if (!logger->running) {
+        MIR_Log(MIR_LOG_WARN, "Log writer thread failed, logging synchronously: %s", SDL_GetError());
+    }
+    return true;
+}
+
+MIRULIT_API void MIR_Log_Flush(void) {
+    MIR_Logger* logger = _mir_log;
+    if (!logger || !logger->running) return;
+
+    int target = SDL_GetAtomicInt(&logger->enqueue);
+    while (SDL_GetAtomicInt(&logger->processed) - target < 0) {
+        SDL_DelayNS(100000);
+    }
+}
+
+MIRULIT_API void MIR_Log_Shutdown(void) {
+    MIR_Logger* logger = _mir_log;
+    if (!logger) return;
+
+    if (logger->running) {
+        SDL_SetAtomicInt(&logger->quit, 1);
+        SDL_WaitThread(logger->thread, NULL);
+        logger->running = false;
+    }
+    if (logger->file) fclose(logger->file);
+    _mir_log = NULL;
+    MIR_Free(logger);
+}
+
+MIRULIT_API void MIR_Log_SetLevel(MIR_LogLevel level) {
+    if (_mir_log) _mir_log->level = level;
+}
+
+MIRULIT_API void MIR_Log_SetConsole(bool enabled) {
+    if (_mir_log) _mir_log->console = enabled;
+}
+
+MIRULIT_API bool MIR_Log_SetFile(const char* path) {
+    MIR_Logger* logger = _mir_log;
+    if (!logger) return false;
+
+    MIR_Log_Flush();
+    if (logger->file) fclose(logger->file);
+    logger->file = path ? fopen(path, "w") : NULL;
+    if (path && !logger->file) {
+        MIR_Log(MIR_LOG_ERROR, "Failed to open logger file: %s", path);
+        return false;
+    }
+    return true;
+}
+
+MIRULIT_API bool MIR_Log_AddSink(MIR_LogSink sink, void* user_data) {
+    MIR_Logger* logger = _mir_log;
+    if (!logger || !sink || logger->sink_count >= MIRULIT_LOG_MAX_SINKS) return false;
+
+    MIR_Log_Flush();
+    logger->sinks[logger->sink_count] = sink;
+    logger->sink_data[logger->sink_count] = user_data;
+    logger->sink_count++;
+    return true;
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_LOG_H
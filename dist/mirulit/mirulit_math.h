@@ -6,6 +6,7 @@
 // Базовые типы
 typedef struct { float x, y; } MIR_Vec2;
 typedef struct { float x, y, z; } MIR_Vec3;
+typedef struct { float x, y, z, w; } MIR_Vec4;
 typedef struct { uint8_t r, g, b, a; } MIR_Color;
 typedef struct { float x, y, w, h; } MIR_Rect;
 typedef struct { float r, g, b, a; } MIR_Colorf;
@@ -37,8 +38,149 @@ static inline MIR_Vec2 MIR_Math_Normalize(MIR_Vec2 v) {
     return v;
 }
 
+// ==================== ГЕНЕРАТОР СЛУЧАЙНЫХ ЧИСЕЛ ====================
+// MIR_Rng - xoshiro128** для одиночных чисел и четыре потока xoshiro128+
+// для пакетов float (MIR_Rng_FillUniform, SSE2 - по четыре за шаг).
+// Скалярный путь проходит потоки в том же порядке, поэтому результат
+// при одном seed одинаков в сборках tcc и gcc.
+
+typedef struct {
+    uint32_t s[4];
+    uint32_t lanes[4][4];       // [слово состояния][поток]
+} MIR_Rng;
+
+static inline uint32_t _MIR_Rng_Rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint64_t _MIR_Rng_SplitMix(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline void MIR_Rng_Seed(MIR_Rng* rng, uint64_t seed) {
+    uint32_t* words = &rng->s[0];
+    for (int i = 0; i < 4; i += 2) {
+        uint64_t v = _MIR_Rng_SplitMix(&seed);
+        words[i] = (uint32_t)v;
+        words[i + 1] = (uint32_t)(v >> 32);
+    }
+    for (int i = 0; i < 16; i += 2) {
+        uint64_t v = _MIR_Rng_SplitMix(&seed);
+        rng->lanes[i / 4][i % 4] = (uint32_t)v;
+        rng->lanes[i / 4][i % 4 + 1] = (uint32_t)(v >> 32);
+    }
+}
+
+static inline uint32_t MIR_Rng_Next(MIR_Rng* rng) {
+    uint32_t* s = rng->s;
+    uint32_t result = _MIR_Rng_Rotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = _MIR_Rng_Rotl(s[3], 11);
+    return result;
+}
+
+// [0, 1): старшие 24 бита - ровно мантисса float
+static inline float MIR_Rng_Float(MIR_Rng* rng) {
+    return (MIR_Rng_Next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline float MIR_Rng_Range(MIR_Rng* rng, float min, float max) {
+    return min + MIR_Rng_Float(rng) * (max - min);
+}
+
+// Целое в [min, max] включительно, без смещения остатка от деления
+static inline int MIR_Rng_Int(MIR_Rng* rng, int min, int max) {
+    if (max <= min) return min;
+    uint32_t range = (uint32_t)(max - min) + 1;
+    return min + (int)(((uint64_t)MIR_Rng_Next(rng) * range) >> 32);
+}
+
+// count чисел в [min, max). Хвост меньше четырех берется из
+// полного шага, остаток шага отбрасывается.
+static inline void MIR_Rng_FillUniform(MIR_Rng* rng, float* out, int count, float min, float max) {
+    uint32_t (*l)[4] = rng->lanes;
+    float scale = (max - min) * (1.0f / 16777216.0f);
+    int i = 0;
+
+#ifdef MIRULIT_SIMD_SSE2
+    __m128i s0 = _mm_loadu_si128((const __m128i*)l[0]);
+    __m128i s1 = _mm_loadu_si128((const __m128i*)l[1]);
+    __m128i s2 = _mm_loadu_si128((const __m128i*)l[2]);
+    __m128i s3 = _mm_loadu_si128((const __m128i*)l[3]);
+    __m128 vscale = _mm_set1_ps(scale);
+    __m128 vmin = _mm_set1_ps(min);
+
+    for (; i < count; i += 4) {
+        __m128i bits = _mm_srli_epi32(_mm_add_epi32(s0, s3), 8);
+        __m128i t = _mm_slli_epi32(s1, 9);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+        __m128 v = _mm_add_ps(vmin, _mm_mul_ps(_mm_cvtepi32_ps(bits), vscale));
+        if (i + 4 <= count) {
+            _mm_storeu_ps(out + i, v);
+        } else {
+            float tail[4];
+            _mm_storeu_ps(tail, v);
+            for (int k = 0; i + k < count; k++) out[i + k] = tail[k];
+        }
+    }
+
+    _mm_storeu_si128((__m128i*)l[0], s0);
+    _mm_storeu_si128((__m128i*)l[1], s1);
+    _mm_storeu_si128((__m128i*)l[2], s2);
+    _mm_storeu_si128((__m128i*)l[3], s3);
+#else
+    for (; i < count; i += 4) {
+        float v[4];
+        for (int k = 0; k < 4; k++) {
+            uint32_t bits = (l[0][k] + l[3][k]) >> 8;
+            uint32_t t = l[1][k] << 9;
+            l[2][k] ^= l[0][k];
+            l[3][k] ^= l[1][k];
+            l[1][k] ^= l[2][k];
+            l[0][k] ^= l[3][k];
+            l[2][k] ^= t;
+            l[3][k] = _MIR_Rng_Rotl(l[3][k], 11);
+            v[k] = min + (float)bits * scale;
+        }
+        for (int k = 0; k < 4 && i + k < count; k++) out[i + k] = v[k];
+    }
+#endif
+}
+
+// Экземпляр на поток (SDL TLS). MIR_Random_Seed задает общий seed:
+// вызвавший поток получает слот 0, остальные - следующие слоты при
+// первом обращении после пересева. Вызывать, пока задачи не идут.
+typedef struct {
+    MIR_Rng rng;
+    int generation;
+} _MIR_RngThread;
+
+MIRULIT_SHARED SDL_TLSID _mir_rng_tls;
+MIRULIT_SHARED SDL_AtomicInt _mir_rng_generation;
+MIRULIT_SHARED SDL_AtomicInt _mir_rng_next_slot;
+MIRULIT_SHARED uint64_t _mir_rng_seed;
+MIRULIT_SHARED MIR_Rng _mir_rng_fallback;
+
+MIRULIT_API MIR_Rng* MIR_Rng_Thread(void);
+
+MIRULIT_API void MIR_Random_Seed(uint64_t seed);
+
 static inline float MIR_Math_RandomRange(float min, float max) {
-    return min + ((float)rand() / RAND_MAX) * (max - min);
+    return MIR_Rng_Range(MIR_Rng_Thread(), min, max);
 }
 
 static inline MIR_Vec2 MIR_Vec2_Add(MIR_Vec2 a, MIR_Vec2 b) {
@@ -57,4 +199,201 @@ static inline float MIR_Vec2_Dot(MIR_Vec2 a, MIR_Vec2 b) {
     return a.x * b.x + a.y * b.y;
 }
 
+// Приближенный 1/sqrt(x): аппаратная оценка SSE/NEON (без SIMD - битовый
+// трюк и лишний шаг) и шаг Ньютона, ошибка порядка 1e-5. x > 0.
+static inline float MIR_Math_RSqrtFast(float x) {
+#ifdef MIRULIT_SIMD_SSE2
+    float r = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+#elif defined(MIRULIT_SIMD_NEON)
+    float r = vget_lane_f32(vrsqrte_f32(vdup_n_f32(x)), 0);
+#else
+    union { float f; uint32_t i; } u = { x };
+    u.i = 0x5F3759DF - (u.i >> 1);
+    float r = u.f;
+    r = r * (1.5f - 0.5f * x * r * r);
+#endif
+    return r * (1.5f - 0.5f * x * r * r);
+}
+
+static inline MIR_Vec2 MIR_Vec2_NormalizeFast(MIR_Vec2 v) {
+    float length_sq = v.x * v.x + v.y * v.y;
+    if (length_sq <= 0) return v;
+    float inv = MIR_Math_RSqrtFast(length_sq);
+    return (MIR_Vec2){v.x * inv, v.y * inv};
+}
+
+static inline MIR_Vec4 MIR_Vec4_Add(MIR_Vec4 a, MIR_Vec4 b) {
+    return (MIR_Vec4){a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+}
+
+static inline MIR_Vec4 MIR_Vec4_Multiply(MIR_Vec4 v, float s) {
+    return (MIR_Vec4){v.x * s, v.y * s, v.z * s, v.w * s};
+}
+
+static inline float MIR_Vec4_Dot(MIR_Vec4 a, MIR_Vec4 b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+// out[i] = a[i] + b[i] * s для массивов Vec2 (интеграция позиций и т.п.)
+static inline void MIR_Vec2_AddScaledArray(MIR_Vec2* out, const MIR_Vec2* a, const MIR_Vec2* b,
+                                           float s, int count) {
+    int i = 0;
+#ifdef MIRULIT_SIMD_SSE2
+    __m128 vs = _mm_set1_ps(s);
+    for (; i + 2 <= count; i += 2) {
+        __m128 va = _mm_loadu_ps(&a[i].x);
+        __m128 vb = _mm_loadu_ps(&b[i].x);
+        _mm_storeu_ps(&out[i].x, _mm_add_ps(va, _mm_mul_ps(vb, vs)));
+    }
+#elif defined(MIRULIT_SIMD_NEON)
+    for (; i + 2 <= count; i += 2) {
+        float32x4_t va = vld1q_f32(&a[i].x);
+        float32x4_t vb = vld1q_f32(&b[i].x);
+        vst1q_f32(&out[i].x, vmlaq_n_f32(va, vb, s));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i].x = a[i].x + b[i].x * s;
+        out[i].y = a[i].y + b[i].y * s;
+    }
+}
+
+// ==================== МАТРИЦЫ 2D ====================
+// MIR_Mat3 - аффинное преобразование плоскости, нижняя строка (0 0 1)
+// подразумевается:  x' = m[0][0]*x + m[0][1]*y + m[0][2]
+//                   y' = m[1][0]*x + m[1][1]*y + m[1][2]
+
+typedef struct { float m[2][3]; } MIR_Mat3;
+
+static inline MIR_Mat3 MIR_Mat3_Identity(void) {
+    return (MIR_Mat3){{{1, 0, 0}, {0, 1, 0}}};
+}
+
+static inline MIR_Mat3 MIR_Mat3_Translate(MIR_Vec2 offset) {
+    return (MIR_Mat3){{{1, 0, offset.x}, {0, 1, offset.y}}};
+}
+
+static inline MIR_Mat3 MIR_Mat3_Scale(MIR_Vec2 scale) {
+    return (MIR_Mat3){{{scale.x, 0, 0}, {0, scale.y, 0}}};
+}
+
+// Поворот на angle радиан (по часовой стрелке на экране, где y вниз)
+static inline MIR_Mat3 MIR_Mat3_Rotate(float angle) {
+    float c = cosf(angle), s = sinf(angle);
+    return (MIR_Mat3){{{c, -s, 0}, {s, c, 0}}};
+}
+
+// a * b: сначала применяется b, затем a
+static inline MIR_Mat3 MIR_Mat3_Multiply(MIR_Mat3 a, MIR_Mat3 b) {
+    MIR_Mat3 r;
+    for (int i = 0; i < 2; i++) {
+        r.m[i][0] = a.m[i][0] * b.m[0][0] + a.m[i][1] * b.m[1][0];
+        r.m[i][1] = a.m[i][0] * b.m[0][1] + a.m[i][1] * b.m[1][1];
+        r.m[i][2] = a.m[i][0] * b.m[0][2] + a.m[i][1] * b.m[1][2] + a.m[i][2];
+    }
+    return r;
+}
+
+// Перенос * поворот * масштаб - трансформ объекта
+static inline MIR_Mat3 MIR_Mat3_TRS(MIR_Vec2 position, float rotation, MIR_Vec2 scale) {
+    float c = cosf(rotation), s = sinf(rotation);
+    return (MIR_Mat3){{{c * scale.x, -s * scale.y, position.x},
+                       {s * scale.x, c * scale.y, position.y}}};
+}
+
+// Вырожденная матрица обращается в единичную
+static inline MIR_Mat3 MIR_Mat3_Invert(MIR_Mat3 a) {
+    float det = a.m[0][0] * a.m[1][1] - a.m[0][1] * a.m[1][0];
+    if (fabsf(det) < 1e-12f) return MIR_Mat3_Identity();
+    float inv = 1.0f / det;
+    MIR_Mat3 r;
+    r.m[0][0] = a.m[1][1] * inv;
+    r.m[0][1] = -a.m[0][1] * inv;
+    r.m[1][0] = -a.m[1][0] * inv;
+    r.m[1][1] = a.m[0][0] * inv;
+    r.m[0][2] = -(r.m[0][0] * a.m[0][2] + r.m[0][1] * a.m[1][2]);
+    r.m[1][2] = -(r.m[1][0] * a.m[0][2] + r.m[1][1] * a.m[1][2]);
+    return r;
+}
+
+static inline MIR_Vec2 MIR_Mat3_TransformPoint(const MIR_Mat3* a, MIR_Vec2 p) {
+    return (MIR_Vec2){
+        a->m[0][0] * p.x + a->m[0][1] * p.y + a->m[0][2],
+        a->m[1][0] * p.x + a->m[1][1] * p.y + a->m[1][2]
+    };
+}
+
+// Без переноса - для направлений и размеров
+static inline MIR_Vec2 MIR_Mat3_TransformVector(const MIR_Mat3* a, MIR_Vec2 v) {
+    return (MIR_Vec2){
+        a->m[0][0] * v.x + a->m[0][1] * v.y,
+        a->m[1][0] * v.x + a->m[1][1] * v.y
+    };
+}
+
+// Пакетное преобразование точек; in и out могут совпадать
+static inline void MIR_Mat3_TransformPoints(const MIR_Mat3* a, const MIR_Vec2* in, MIR_Vec2* out, int count) {
+    int i = 0;
+#ifdef MIRULIT_SIMD_SSE2
+    // Две точки на регистр: (x0 y0 x1 y1)
+    __m128 col_x = _mm_setr_ps(a->m[0][0], a->m[1][0], a->m[0][0], a->m[1][0]);
+    __m128 col_y = _mm_setr_ps(a->m[0][1], a->m[1][1], a->m[0][1], a->m[1][1]);
+    __m128 offset = _mm_setr_ps(a->m[0][2], a->m[1][2], a->m[0][2], a->m[1][2]);
+    for (; i + 2 <= count; i += 2) {
+        __m128 p = _mm_loadu_ps(&in[i].x);
+        __m128 xs = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 ys = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, col_x), _mm_mul_ps(ys, col_y)), offset);
+        _mm_storeu_ps(&out[i].x, r);
+    }
+#elif defined(MIRULIT_SIMD_NEON)
+    // Четыре точки: vld2 разделяет x и y
+    for (; i + 4 <= count; i += 4) {
+        float32x4x2_t p = vld2q_f32(&in[i].x);
+        float32x4x2_t r;
+        r.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(a->m[0][2]), p.val[0], a->m[0][0]), p.val[1], a->m[0][1]);
+        r.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(a->m[1][2]), p.val[0], a->m[1][0]), p.val[1], a->m[1][1]);
+        vst2q_f32(&out[i].x, r);
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = MIR_Mat3_TransformPoint(a, in[i]);
+    }
+}
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+static void SDLCALL _MIR_Rng_FreeThread(void* thread) {
+    MIR_Free(thread);
+}
+
+MIRULIT_API MIR_Rng* MIR_Rng_Thread(void) {
+    _MIR_RngThread* thread = (_MIR_RngThread*)SDL_GetTLS(&_mir_rng_tls);
+    if (!thread) {
+        thread = (_MIR_RngThread*)MIR_Calloc(1, sizeof(_MIR_RngThread), MIR_MEM_CORE);
+        if (!thread) return &_mir_rng_fallback;
+        thread->generation = -1;
+        SDL_SetTLS(&_mir_rng_tls, thread, _MIR_Rng_FreeThread);
+    }
+
+    int generation = SDL_GetAtomicInt(&_mir_rng_generation);
+    if (thread->generation != generation) {
+        uint64_t slot = (uint64_t)SDL_AddAtomicInt(&_mir_rng_next_slot, 1);
+        MIR_Rng_Seed(&thread->rng, _mir_rng_seed ^ (slot * 0xD1B54A32D192ED03ull));
+        thread->generation = generation;
+    }
+    return &thread->rng;
+}
+
+MIRULIT_API void MIR_Random_Seed(uint64_t seed) {
+    _mir_rng_seed = seed;
+    SDL_SetAtomicInt(&_mir_rng_next_slot, 0);
+    SDL_AddAtomicInt(&_mir_rng_generation, 1);
+    MIR_Rng_Seed(&_mir_rng_fallback, seed);
+    MIR_Rng_Thread();
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
 #endif // MIRULIT_MATH_H
\ No newline at end of file
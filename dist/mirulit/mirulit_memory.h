@@ -0,0 +1,388 @@
+#ifndef MIRULIT_MEMORY_H
+#define MIRULIT_MEMORY_H
+
+// ==================== ПАМЯТЬ ====================
+// Все выделения движка идут через MIR_Alloc/MIR_Calloc/MIR_Realloc/
+// MIR_Free с меткой подсистемы. Перед блоком лежит заголовок с
+// размером и меткой - по нему ведутся счетчики байт и выделений.
+// Сами функции выделения подменяются MIR_SetAllocator.
+//
+// MIR_FrameAlloc - линейная арена кадра: выделение - сдвиг указателя,
+// вся память разом освобождается в MIR_BeginFrame.
+// MIR_Pool - пул блоков одного размера (компоненты, сущности).
+
+#define MIRULIT_FRAME_ARENA (256 * 1024)    // начальный размер арены кадра
+
+typedef enum {
+    MIR_MEM_CORE,           // движок
+    MIR_MEM_ENTITY,
+    MIR_MEM_COMPONENT,
+    MIR_MEM_PHYSICS,
+    MIR_MEM_NAVIGATION,     // навигационная сетка, поля потока, поиск пути
+    MIR_MEM_FRAME,          // арена кадра
+    MIR_MEM_DEBUG,          // лог, профилировщик
+    MIR_MEM_USER,
+    MIR_MEM_TAG_COUNT
+} MIR_MemTag;
+
+typedef struct {
+    void* (*allocate)(size_t size, void* user_data);
+    void* (*reallocate)(void* ptr, size_t size, void* user_data);
+    void (*deallocate)(void* ptr, void* user_data);
+    void* user_data;
+} MIR_Allocator;
+
+typedef struct {
+    size_t bytes;               // занято сейчас
+    size_t peak_bytes;
+    int allocations;            // живых блоков
+    long long total_allocations;
+} MIR_MemoryStats;
+
+typedef struct {
+    size_t used;                // занято в текущем кадре
+    size_t capacity;
+    size_t peak;                // максимум за кадр с начала работы
+    int overflows;              // кадров, не уместившихся в арену
+} MIR_FrameArenaStats;
+
+// ==================== ВЫДЕЛЕНИЕ С УЧЕТОМ ====================
+
+typedef union {
+    struct {
+        size_t size;
+        int tag;
+    } info;
+    char align[16];
+} _MIR_AllocHeader;
+
+MIRULIT_SHARED MIR_Allocator _mir_allocator;
+MIRULIT_SHARED MIR_MemoryStats _mir_mem_stats[MIR_MEM_TAG_COUNT];
+MIRULIT_SHARED SDL_SpinLock _mir_mem_lock;
+
+// Подмена функций выделения. Только пока у движка нет живых блоков:
+// до MIR_Init или после MIR_Shutdown. NULL - вернуть malloc/free.
+MIRULIT_API void MIR_SetAllocator(const MIR_Allocator* allocator);
+
+MIRULIT_API void* MIR_Alloc(size_t size, MIR_MemTag tag);
+
+MIRULIT_API void* MIR_Calloc(size_t count, size_t size, MIR_MemTag tag);
+
+MIRULIT_API void MIR_Free(void* ptr);
+
+// При неудаче старый блок остается действительным, как у realloc
+MIRULIT_API void* MIR_Realloc(void* ptr, size_t size, MIR_MemTag tag);
+
+// Статистика метки; MIR_MEM_TAG_COUNT - сумма по всем (пик - сумма пиков)
+MIRULIT_API MIR_MemoryStats MIR_Memory_GetStats(MIR_MemTag tag);
+
+MIRULIT_API const char* MIR_Memory_TagName(MIR_MemTag tag);
+
+// ==================== АРЕНА КАДРА ====================
+// Выделение - атомарный сдвиг, поэтому арену могут использовать и
+// задачи кадра. Память живет до следующего MIR_BeginFrame. Не
+// уместившееся уходит в отдельные блоки, а при сбросе арена
+// вырастает до пика кадра.
+
+typedef struct _MIR_FrameOverflow {
+    struct _MIR_FrameOverflow* next;
+    size_t size;
+} _MIR_FrameOverflow;
+
+typedef struct {
+    unsigned char* base;
+    size_t capacity;
+    SDL_AtomicInt offset;
+    _MIR_FrameOverflow* overflow;
+    size_t overflow_bytes;
+    MIR_FrameArenaStats stats;
+} _MIR_FrameArena;
+
+MIRULIT_SHARED _MIR_FrameArena _mir_frame_arena;
+
+MIRULIT_API void* MIR_FrameAlloc(size_t size);
+
+// Сброс в начале кадра; вызывается, когда задачи кадра завершены.
+// Окно сбрасывает арену в MIR_BeginFrame, цикл без окна - сам между шагами.
+MIRULIT_API void MIR_FrameArena_Reset(void);
+
+MIRULIT_API MIR_FrameArenaStats MIR_FrameArena_GetStats(void);
+
+// ==================== ПУЛ БЛОКОВ ====================
+// Блоки одного размера нарезаются из кусков по blocks_per_chunk штук;
+// свободные связаны в список. Куски возвращаются только в Destroy.
+
+typedef struct {
+    size_t block_size;
+    int blocks_per_chunk;
+    MIR_MemTag tag;
+    void* free_list;
+    void* chunks;               // первое слово куска - следующий кусок
+    int used;
+    int capacity;
+    SDL_SpinLock lock;
+} MIR_Pool;
+
+MIRULIT_API void MIR_Pool_Init(MIR_Pool* pool, size_t block_size, int blocks_per_chunk, MIR_MemTag tag);
+
+// Блок не обнулен
+MIRULIT_API void* MIR_Pool_Alloc(MIR_Pool* pool);
+
+MIRULIT_API void MIR_Pool_Free(MIR_Pool* pool, void* block);
+
+MIRULIT_API void MIR_Pool_Destroy(MIR_Pool* pool);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+static void* _MIR_Mem_DefaultAlloc(size_t size, void* user_data) {
+    (void)user_data;
+    return malloc(size);
+}
+
+static void* _MIR_Mem_DefaultRealloc(void* ptr, size_t size, void* user_data) {
+    (void)user_data;
+    return realloc(ptr, size);
+}
+
+static void _MIR_Mem_DefaultFree(void* ptr, void* user_data) {
+    (void)user_data;
+    free(ptr);
+}
+
+// Модуль горячей перезагрузки получает аллокатор хоста
+#ifndef MIRULIT_HOT_MODULE
+MIRULIT_SHARED MIR_Allocator _mir_allocator = {
+    _MIR_Mem_DefaultAlloc, _MIR_Mem_DefaultRealloc, _MIR_Mem_DefaultFree, NULL
+};
+#endif
+
+MIRULIT_API void MIR_SetAllocator(const MIR_Allocator* allocator) {
+    if (allocator && allocator->allocate && allocator->reallocate && allocator->deallocate) {
+        _mir_allocator = *allocator;
+    } else {
+        _mir_allocator.allocate = _MIR_Mem_DefaultAlloc;
+        _mir_allocator.reallocate = _MIR_Mem_DefaultRealloc;
+        _mir_allocator.deallocate = _MIR_Mem_DefaultFree;
+        _mir_allocator.user_data = NULL;
+    }
+}
+
+static void _MIR_Mem_Account(int tag, long long bytes, int allocations) {
+    SDL_LockSpinlock(&_mir_mem_lock);
+    MIR_MemoryStats* stats = &_mir_mem_stats[tag];
+    stats->bytes += bytes;
+    stats->allocations += allocations;
+    if (allocations > 0) stats->total_allocations += allocations;
+    if (stats->bytes > stats->peak_bytes) stats->peak_bytes = stats->bytes;
+    SDL_UnlockSpinlock(&_mir_mem_lock);
+}
+
+MIRULIT_API void* MIR_Alloc(size_t size, MIR_MemTag tag) {
+    _MIR_AllocHeader* header = (_MIR_AllocHeader*)_mir_allocator.allocate(
+        sizeof(_MIR_AllocHeader) + size, _mir_allocator.user_data);
+    if (!header) return NULL;
+    header->info.size = size;
+    header->info.tag = tag;
+    _MIR_Mem_Account(tag, (long long)size, 1);
+    return header + 1;
+}
+
+MIRULIT_API void* MIR_Calloc(size_t count, size_t size, MIR_MemTag tag) {
+    if (size && count > (size_t)-1 / size) return NULL;
+    void* ptr = MIR_Alloc(count * size, tag);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+MIRULIT_API void MIR_Free(void* ptr) {
+    if (!ptr) return;
+    _MIR_AllocHeader* header = (_MIR_AllocHeader*)ptr - 1;
+    _MIR_Mem_Account(header->info.tag, -(long long)header->info.size, -1);
+    _mir_allocator.deallocate(header, _mir_allocator.user_data);
+}
+
+MIRULIT_API void* MIR_Realloc(void* ptr, size_t size, MIR_MemTag tag) {
+    if (!ptr) return MIR_Alloc(size, tag);
+
+    _MIR_AllocHeader* header = (_MIR_AllocHeader*)ptr - 1;
+    size_t old_size = header->info.size;
+    int old_tag = header->info.tag;
+    header = (_MIR_AllocHeader*)_mir_allocator.reallocate(
+        header, sizeof(_MIR_AllocHeader) + size, _mir_allocator.user_data);
+    if (!header) return NULL;
+
+    header->info.size = size;
+    header->info.tag = tag;
+    if (old_tag == (int)tag) {
+        _MIR_Mem_Account(tag, (long long)size - (long long)old_size, 0);
+    } else {
+        _MIR_Mem_Account(old_tag, -(long long)old_size, -1);
+        _MIR_Mem_Account(tag, (long long)size, 1);
+    }
+    return header + 1;
+}
+
+MIRULIT_API MIR_MemoryStats MIR_Memory_GetStats(MIR_MemTag tag) {
+    MIR_MemoryStats result = {0};
+    SDL_LockSpinlock(&_mir_mem_lock);
+    if (tag >= 0 && tag < MIR_MEM_TAG_COUNT) {
+        result = _mir_mem_stats[tag];
+    } else {
+        for (int i = 0; i < MIR_MEM_TAG_COUNT; i++) {
+            result.bytes += _mir_mem_stats[i].bytes;
+            result.peak_bytes += _mir_mem_stats[i].peak_bytes;
+            result.allocations += _mir_mem_stats[i].allocations;
+            result.total_allocations += _mir_mem_stats[i].total_allocations;
+        }
+    }
+    SDL_UnlockSpinlock(&_mir_mem_lock);
+    return result;
+}
+
+static const char* _mir_mem_tag_names[MIR_MEM_TAG_COUNT] = {
+    "Core", "Entity", "Component", "Physics", "Navigation", "Frame", "Debug", "User"
+};
+
+MIRULIT_API const char* MIR_Memory_TagName(MIR_MemTag tag) {
+    return tag >= 0 && tag < MIR_MEM_TAG_COUNT ? _mir_mem_tag_names[tag] : "Total";
+}
+
+MIRULIT_API void* MIR_FrameAlloc(size_t size) {
+    _MIR_FrameArena* arena = &_mir_frame_arena;
+    size = (size + 15) & ~(size_t)15;
+
+    if (size <= arena->capacity) {
+        int offset = SDL_AddAtomicInt(&arena->offset, (int)size);
+        if ((size_t)offset + size <= arena->capacity) {
+            return arena->base + offset;
+        }
+    }
+
+    // Арена заполнена (или еще не создана) - отдельный блок до сброса
+    _MIR_FrameOverflow* block = (_MIR_FrameOverflow*)MIR_Alloc(
+        sizeof(_MIR_FrameOverflow) + 16 + size, MIR_MEM_FRAME);
+    if (!block) return NULL;
+    block->size = size;
+
+    SDL_LockSpinlock(&_mir_mem_lock);
+    block->next = arena->overflow;
+    arena->overflow = block;
+    arena->overflow_bytes += size;
+    SDL_UnlockSpinlock(&_mir_mem_lock);
+
+    uintptr_t data = (uintptr_t)(block + 1);
+    return (void*)((data + 15) & ~(uintptr_t)15);
+}
+
+MIRULIT_API void MIR_FrameArena_Reset(void) {
+    _MIR_FrameArena* arena = &_mir_frame_arena;
+
+    size_t offset = (size_t)SDL_GetAtomicInt(&arena->offset);
+    size_t used = (offset < arena->capacity ? offset : arena->capacity) + arena->overflow_bytes;
+    arena->stats.used = used;
+    if (used > arena->stats.peak) arena->stats.peak = used;
+
+    while (arena->overflow) {
+        _MIR_FrameOverflow* next = arena->overflow->next;
+        MIR_Free(arena->overflow);
+        arena->overflow = next;
+    }
+
+    // Кадр не поместился - арена растет до его размера с запасом
+    size_t needed = arena->capacity ? arena->capacity : MIRULIT_FRAME_ARENA;
+    if (arena->overflow_bytes > 0) {
+        if (arena->capacity) arena->stats.overflows++;
+        needed = used + used / 2;
+    }
+    if (needed != arena->capacity && needed < (size_t)SDL_MAX_SINT32) {
+        unsigned char* base = (unsigned char*)MIR_Alloc(needed, MIR_MEM_FRAME);
+        if (base) {
+            MIR_Free(arena->base);
+            arena->base = base;
+            arena->capacity = needed;
+        }
+    }
+
+    arena->overflow_bytes = 0;
+    SDL_SetAtomicInt(&arena->offset, 0);
+}
+
+static void _MIR_FrameArena_Shutdown(void) {
+    _MIR_FrameArena* arena = &_mir_frame_arena;
+    MIR_FrameArena_Reset();
+    MIR_Free(arena->base);
+    memset(arena, 0, sizeof(*arena));
+}
+
+MIRULIT_API MIR_FrameArenaStats MIR_FrameArena_GetStats(void) {
+    MIR_FrameArenaStats stats = _mir_frame_arena.stats;
+    size_t offset = (size_t)SDL_GetAtomicInt(&_mir_frame_arena.offset);
+    stats.used = (offset < _mir_frame_arena.capacity ? offset : _mir_frame_arena.capacity) +
+                 _mir_frame_arena.overflow_bytes;
+    stats.capacity = _mir_frame_arena.capacity;
+    return stats;
+}
+
+MIRULIT_API void MIR_Pool_Init(MIR_Pool* pool, size_t block_size, int blocks_per_chunk, MIR_MemTag tag) {
+    memset(pool, 0, sizeof(*pool));
+    if (block_size < sizeof(void*)) block_size = sizeof(void*);
+    pool->block_size = (block_size + 15) & ~(size_t)15;
+    pool->blocks_per_chunk = blocks_per_chunk > 0 ? blocks_per_chunk : 64;
+    pool->tag = tag;
+}
+
+static bool _MIR_Pool_Grow(MIR_Pool* pool) {
+    unsigned char* chunk = (unsigned char*)MIR_Alloc(
+        16 + pool->block_size * pool->blocks_per_chunk, pool->tag);
+    if (!chunk) return false;
+
+    *(void**)chunk = pool->chunks;
+    pool->chunks = chunk;
+
+    unsigned char* blocks = chunk + 16;
+    for (int i = pool->blocks_per_chunk - 1; i >= 0; i--) {
+        void* block = blocks + pool->block_size * i;
+        *(void**)block = pool->free_list;
+        pool->free_list = block;
+    }
+    pool->capacity += pool->blocks_per_chunk;
+    return true;
+}
+
+MIRULIT_API void* MIR_Pool_Alloc(MIR_Pool* pool) {
+    SDL_LockSpinlock(&pool->lock);
+    if (!pool->free_list && !_MIR_Pool_Grow(pool)) {
+        SDL_UnlockSpinlock(&pool->lock);
+        return NULL;
+    }
+    void* block = pool->free_list;
+    pool->free_list = *(void**)block;
+    pool->used++;
+    SDL_UnlockSpinlock(&pool->lock);
+    return block;
+}
+
+MIRULIT_API void MIR_Pool_Free(MIR_Pool* pool, void* block) {
+    if (!block) return;
+    SDL_LockSpinlock(&pool->lock);
+    *(void**)block = pool->free_list;
+    pool->free_list = block;
+    pool->used--;
+    SDL_UnlockSpinlock(&pool->lock);
+}
+
+MIRULIT_API void MIR_Pool_Destroy(MIR_Pool* pool) {
+    while (pool->chunks) {
+        void* next = *(void**)pool->chunks;
+        MIR_Free(pool->chunks);
+        pool->chunks = next;
+    }
+    pool->free_list = NULL;
+    pool->used = 0;
+    pool->capacity = 0;
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_MEMORY_H
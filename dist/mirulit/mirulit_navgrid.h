@@ -0,0 +1,178 @@
+#ifndef MIRULIT_NAVGRID_H
+#define MIRULIT_NAVGRID_H
+
+// ==================== НАВИГАЦИОННАЯ СЕТКА ====================
+// Сетка проходимости, растеризованная из неподвижных коллайдеров
+// (collider.is_static). Каждое изменение клетки получает номер
+// ревизии и попадает в кольцевой журнал, по которому потребители
+// (поля потоков, поиск пути) догоняют сетку инкрементально.
+
+#define MIRULIT_NAV_CHANGE_LOG 1024
+
+typedef struct {
+    MIR_Vec2 origin;            // мировая позиция левого верхнего угла
+    float cell_size;
+    int width;
+    int height;
+    uint8_t* blocked;           // 1 - клетка непроходима
+
+    uint32_t revision;          // растет на каждое изменение клетки
+    int changes[MIRULIT_NAV_CHANGE_LOG];
+} MIR_NavGrid;
+
+// Соседи в порядке: 4 прямых, затем 4 диагональных
+static const int _mir_nav_dx[8] = { 1, 0, -1, 0, 1, -1, -1, 1 };
+static const int _mir_nav_dy[8] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+static const float _mir_nav_step[8] = { 1, 1, 1, 1, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f };
+
+MIRULIT_API MIR_NavGrid* MIR_NavGrid_Create(MIR_Vec2 origin, int width, int height, float cell_size);
+
+MIRULIT_API void MIR_NavGrid_Destroy(MIR_NavGrid* grid);
+
+static inline bool MIR_NavGrid_InBounds(const MIR_NavGrid* grid, int x, int y) {
+    return x >= 0 && y >= 0 && x < grid->width && y < grid->height;
+}
+
+// Возвращает индекс клетки или -1, если точка вне сетки
+static inline int MIR_NavGrid_WorldToCell(const MIR_NavGrid* grid, MIR_Vec2 pos) {
+    int x = (int)floorf((pos.x - grid->origin.x) / grid->cell_size);
+    int y = (int)floorf((pos.y - grid->origin.y) / grid->cell_size);
+    if (!MIR_NavGrid_InBounds(grid, x, y)) return -1;
+    return y * grid->width + x;
+}
+
+static inline MIR_Vec2 MIR_NavGrid_CellCenter(const MIR_NavGrid* grid, int cell) {
+    return (MIR_Vec2){
+        grid->origin.x + ((cell % grid->width) + 0.5f) * grid->cell_size,
+        grid->origin.y + ((cell / grid->width) + 0.5f) * grid->cell_size
+    };
+}
+
+static inline bool MIR_NavGrid_IsBlocked(const MIR_NavGrid* grid, int x, int y) {
+    return !MIR_NavGrid_InBounds(grid, x, y) || grid->blocked[y * grid->width + x];
+}
+
+// Переход в соседа dir допустим, если сосед свободен, а диагональ
+// не срезает угол занятой клетки
+static inline bool _MIR_NavGrid_CanStep(const uint8_t* blocked, int width, int height,
+                                        int x, int y, int dir) {
+    int nx = x + _mir_nav_dx[dir], ny = y + _mir_nav_dy[dir];
+    if (nx < 0 || ny < 0 || nx >= width || ny >= height) return false;
+    if (blocked[ny * width + nx]) return false;
+    if (dir >= 4) {
+        if (blocked[y * width + nx] || blocked[ny * width + x]) return false;
+    }
+    return true;
+}
+
+MIRULIT_API void MIR_NavGrid_SetBlocked(MIR_NavGrid* grid, int x, int y, bool blocked);
+
+// Перебор клеток, изменившихся после ревизии since.
+// Возвращает false, если журнал уже перезаписан - нужен полный пересчет.
+MIRULIT_API bool MIR_NavGrid_GetChanges(const MIR_NavGrid* grid, uint32_t since,
+                                        int* cells, int max_cells, int* count);
+
+// Растеризация неподвижных коллайдеров мира. inflate расширяет препятствия
+// на радиус агента, чтобы тот не цеплялся за углы.
+// Меняются только отличающиеся клетки - журнал остается коротким.
+MIRULIT_API void MIR_NavGrid_RasterizeWorld(MIR_NavGrid* grid, MIR_World* world, float inflate);
+
+MIRULIT_API void MIR_NavGrid_Rasterize(MIR_NavGrid* grid, float inflate);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+MIRULIT_API MIR_NavGrid* MIR_NavGrid_Create(MIR_Vec2 origin, int width, int height, float cell_size) {
+    if (width <= 0 || height <= 0 || cell_size <= 0) return NULL;
+
+    MIR_NavGrid* grid = (MIR_NavGrid*)MIR_Calloc(1, sizeof(MIR_NavGrid), MIR_MEM_NAVIGATION);
+    if (!grid) return NULL;
+
+    grid->blocked = (uint8_t*)MIR_Calloc((size_t)width * height, 1, MIR_MEM_NAVIGATION);
+    if (!grid->blocked) {
+        MIR_Free(grid);
+        return NULL;
+    }
+
+    grid->origin = origin;
+    grid->cell_size = cell_size;
+    grid->width = width;
+    grid->height = height;
+    return grid;
+}
+
+MIRULIT_API void MIR_NavGrid_Destroy(MIR_NavGrid* grid) {
+    if (!grid) return;
+    MIR_Free(grid->blocked);
+    MIR_Free(grid);
+}
+
+MIRULIT_API void MIR_NavGrid_SetBlocked(MIR_NavGrid* grid, int x, int y, bool blocked) {
+    if (!grid || !MIR_NavGrid_InBounds(grid, x, y)) return;
+
+    int cell = y * grid->width + x;
+    if (grid->blocked[cell] == (uint8_t)blocked) return;
+
+    grid->blocked[cell] = (uint8_t)blocked;
+    grid->revision++;
+    grid->changes[grid->revision % MIRULIT_NAV_CHANGE_LOG] = cell;
+}
+
+MIRULIT_API bool MIR_NavGrid_GetChanges(const MIR_NavGrid* grid, uint32_t since,
+                                        int* cells, int max_cells, int* count) {
+    uint32_t pending = grid->revision - since;
+    *count = 0;
+    if (pending > MIRULIT_NAV_CHANGE_LOG || pending > (uint32_t)max_cells) return false;
+
+    for (uint32_t r = since + 1; r != grid->revision + 1; r++) {
+        cells[(*count)++] = grid->changes[r % MIRULIT_NAV_CHANGE_LOG];
+    }
+    return true;
+}
+
+MIRULIT_API void MIR_NavGrid_RasterizeWorld(MIR_NavGrid* grid, MIR_World* world, float inflate) {
+    if (!grid || !world) return;
+
+    int cells = grid->width * grid->height;
+    uint8_t* occupancy = (uint8_t*)MIR_Calloc((size_t)cells, 1, MIR_MEM_NAVIGATION);
+    if (!occupancy) return;
+
+    for (int i = 0; i < world->entity_count; i++) {
+        MIR_Entity* e = world->entities[i];
+        if (!e || !e->active || !e->collider.enabled || !e->collider.is_static) continue;
+
+        MIR_Rect r = e->collider.bounds;
+        float x0 = (r.x - inflate - grid->origin.x) / grid->cell_size;
+        float y0 = (r.y - inflate - grid->origin.y) / grid->cell_size;
+        float x1 = (r.x + r.w + inflate - grid->origin.x) / grid->cell_size;
+        float y1 = (r.y + r.h + inflate - grid->origin.y) / grid->cell_size;
+
+        // Клетка занята, если прямоугольник заходит в нее строго внутрь
+        int cx0 = (int)floorf(x0), cy0 = (int)floorf(y0);
+        int cx1 = (int)ceilf(x1) - 1, cy1 = (int)ceilf(y1) - 1;
+        if (cx0 < 0) cx0 = 0;
+        if (cy0 < 0) cy0 = 0;
+        if (cx1 >= grid->width) cx1 = grid->width - 1;
+        if (cy1 >= grid->height) cy1 = grid->height - 1;
+        if (cx0 > cx1 || cy0 > cy1) continue;
+
+        for (int y = cy0; y <= cy1; y++) {
+            memset(&occupancy[y * grid->width + cx0], 1, (size_t)(cx1 - cx0 + 1));
+        }
+    }
+
+    for (int cell = 0; cell < cells; cell++) {
+        if (occupancy[cell] != grid->blocked[cell]) {
+            MIR_NavGrid_SetBlocked(grid, cell % grid->width, cell / grid->width, occupancy[cell]);
+        }
+    }
+    MIR_Free(occupancy);
+}
+
+MIRULIT_API void MIR_NavGrid_Rasterize(MIR_NavGrid* grid, float inflate) {
+    MIR_NavGrid_RasterizeWorld(grid, MIR_GetWorld(), inflate);
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_NAVGRID_H
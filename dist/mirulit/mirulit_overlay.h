@@ -0,0 +1,315 @@
+#ifndef MIRULIT_OVERLAY_H
+#define MIRULIT_OVERLAY_H
+
+// ==================== ТЕКСТ ====================
+// Растровый шрифт 8x8: глифы ASCII один раз рисуются через
+// SDL_RenderDebugText в атлас, дальше весь текст кадра копится в
+// буфере вершин и выводится одним SDL_RenderGeometry в MIR_EndFrame.
+// Последняя клетка атласа залита белым - через нее рисуются
+// сплошные прямоугольники того же пакета (фон, графики).
+
+#define MIRULIT_TEXT_MAX_QUADS 4096
+#define MIRULIT_TEXT_GLYPH 8
+#define MIRULIT_TEXT_COLUMNS 16
+#define MIRULIT_TEXT_SOLID 127      // код залитой клетки атласа
+
+typedef struct {
+    SDL_Texture* atlas;
+    bool atlas_failed;
+    SDL_Vertex vertices[MIRULIT_TEXT_MAX_QUADS * 4];
+    int indices[MIRULIT_TEXT_MAX_QUADS * 6];
+    int quad_count;
+} MIR_TextBatch;
+
+MIRULIT_SHARED MIR_TextBatch _mir_text;
+
+// Вывод накопленного пакета (вызывается из MIR_EndFrame)
+MIRULIT_API void MIR_Text_Flush(void);
+
+// Текст в экранных координатах; scale - целый множитель глифа 8x8
+MIRULIT_API void MIR_DrawText(float x, float y, const char* text, MIR_Color color, float scale);
+
+// Прямоугольник в том же пакете, что и текст (порядок сохраняется)
+MIRULIT_API void MIR_DrawTextRect(MIR_Rect rect, MIR_Color color);
+
+MIRULIT_API void MIR_Text_Shutdown(void);
+
+// ==================== ОТЛАДОЧНЫЙ ОВЕРЛЕЙ ====================
+// График времени кадра, зоны профилировщика, счетчики и память
+// текстур. Переключается клавишей MIRULIT_OVERLAY_KEY.
+
+#define MIRULIT_OVERLAY_KEY SDLK_F1
+#define MIRULIT_OVERLAY_WIDTH 260
+#define MIRULIT_OVERLAY_ZONES 12
+
+MIRULIT_SHARED bool _mir_overlay_visible;
+
+MIRULIT_API void MIR_SetDebugOverlay(bool visible);
+
+MIRULIT_API bool MIR_IsDebugOverlayVisible(void);
+
+MIRULIT_API void MIR_DrawDebugInfo(void);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+static bool _MIR_Text_BuildAtlas(void) {
+    if (_mir_text.atlas) return true;
+    if (_mir_text.atlas_failed) return false;
+
+    int rows = (128 - 32 + MIRULIT_TEXT_COLUMNS - 1) / MIRULIT_TEXT_COLUMNS;
+    SDL_Texture* atlas = SDL_CreateTexture(_mir->renderer, SDL_PIXELFORMAT_RGBA8888,
+                                           SDL_TEXTUREACCESS_TARGET,
+                                           MIRULIT_TEXT_COLUMNS * MIRULIT_TEXT_GLYPH,
+                                           rows * MIRULIT_TEXT_GLYPH);
+    if (!atlas) {
+        MIR_Log(MIR_LOG_ERROR, "Font atlas creation failed: %s", SDL_GetError());
+        _mir_text.atlas_failed = true;
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(atlas, SDL_SCALEMODE_NEAREST);
+
+    SDL_Texture* previous = SDL_GetRenderTarget(_mir->renderer);
+    SDL_SetRenderTarget(_mir->renderer, atlas);
+    SDL_SetRenderDrawColor(_mir->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(_mir->renderer);
+    SDL_SetRenderDrawColor(_mir->renderer, 255, 255, 255, 255);
+
+    char glyph[2] = {0, 0};
+    for (int c = 33; c < MIRULIT_TEXT_SOLID; c++) {
+        glyph[0] = (char)c;
+        SDL_RenderDebugText(_mir->renderer,
+                            (float)((c - 32) % MIRULIT_TEXT_COLUMNS * MIRULIT_TEXT_GLYPH),
+                            (float)((c - 32) / MIRULIT_TEXT_COLUMNS * MIRULIT_TEXT_GLYPH), glyph);
+    }
+    SDL_FRect solid = {
+        (float)((MIRULIT_TEXT_SOLID - 32) % MIRULIT_TEXT_COLUMNS * MIRULIT_TEXT_GLYPH),
+        (float)((MIRULIT_TEXT_SOLID - 32) / MIRULIT_TEXT_COLUMNS * MIRULIT_TEXT_GLYPH),
+        MIRULIT_TEXT_GLYPH, MIRULIT_TEXT_GLYPH
+    };
+    SDL_RenderFillRect(_mir->renderer, &solid);
+    SDL_SetRenderTarget(_mir->renderer, previous);
+
+    // Индексы квадов не меняются - заполняем один раз
+    for (int q = 0; q < MIRULIT_TEXT_MAX_QUADS; q++) {
+        int* index = &_mir_text.indices[q * 6];
+        index[0] = q * 4;     index[1] = q * 4 + 1; index[2] = q * 4 + 2;
+        index[3] = q * 4;     index[4] = q * 4 + 2; index[5] = q * 4 + 3;
+    }
+
+    _mir_text.atlas = atlas;
+    return true;
+}
+
+MIRULIT_API void MIR_Text_Flush(void) {
+    if (!_mir_initialized || !_mir || _mir_text.quad_count == 0) return;
+
+    SDL_RenderGeometry(_mir->renderer, _mir_text.atlas,
+                       _mir_text.vertices, _mir_text.quad_count * 4,
+                       _mir_text.indices, _mir_text.quad_count * 6);
+    _mir_text.quad_count = 0;
+    _mir->draw_calls++;
+}
+
+static void _MIR_Text_Quad(float x, float y, float w, float h, int glyph, MIR_Color color) {
+    if (_mir_text.quad_count >= MIRULIT_TEXT_MAX_QUADS) MIR_Text_Flush();
+
+    float atlas_w = (float)(MIRULIT_TEXT_COLUMNS * MIRULIT_TEXT_GLYPH);
+    float atlas_h = (float)_mir_text.atlas->h;
+    float u0 = ((glyph - 32) % MIRULIT_TEXT_COLUMNS * MIRULIT_TEXT_GLYPH) / atlas_w;
+    float v0 = ((glyph - 32) / MIRULIT_TEXT_COLUMNS * MIRULIT_TEXT_GLYPH) / atlas_h;
+    float u1 = u0 + MIRULIT_TEXT_GLYPH / atlas_w;
+    float v1 = v0 + MIRULIT_TEXT_GLYPH / atlas_h;
+
+    // Сплошная заливка берет центр клетки, чтобы не цеплять соседей
+    if (glyph == MIRULIT_TEXT_SOLID) {
+        u0 = u1 = (u0 + u1) * 0.5f;
+        v0 = v1 = (v0 + v1) * 0.5f;
+    }
+
+    SDL_FColor c = { color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f };
+    SDL_Vertex* v = &_mir_text.vertices[_mir_text.quad_count * 4];
+    v[0] = (SDL_Vertex){ {x, y},         c, {u0, v0} };
+    v[1] = (SDL_Vertex){ {x + w, y},     c, {u1, v0} };
+    v[2] = (SDL_Vertex){ {x + w, y + h}, c, {u1, v1} };
+    v[3] = (SDL_Vertex){ {x, y + h},     c, {u0, v1} };
+    _mir_text.quad_count++;
+}
+
+MIRULIT_API void MIR_DrawText(float x, float y, const char* text, MIR_Color color, float scale) {
+    if (!_mir_initialized || !_mir || !text || !_MIR_Text_BuildAtlas()) return;
+
+    float size = MIRULIT_TEXT_GLYPH * (scale > 0 ? scale : 1.0f);
+    float start_x = x;
+    for (const char* p = text; *p; p++) {
+        int c = (unsigned char)*p;
+        if (c == '\n') {
+            x = start_x;
+            y += size * 1.25f;
+            continue;
+        }
+        if (c > 32 && c < MIRULIT_TEXT_SOLID) {
+            _MIR_Text_Quad(x, y, size, size, c, color);
+        }
+        x += size;
+    }
+}
+
+MIRULIT_API void MIR_DrawTextRect(MIR_Rect rect, MIR_Color color) {
+    if (!_mir_initialized || !_mir || !_MIR_Text_BuildAtlas()) return;
+    _MIR_Text_Quad(rect.x, rect.y, rect.w, rect.h, MIRULIT_TEXT_SOLID, color);
+}
+
+MIRULIT_API void MIR_Text_Shutdown(void) {
+    if (_mir_text.atlas) {
+        SDL_DestroyTexture(_mir_text.atlas);
+    }
+    memset(&_mir_text, 0, sizeof(_mir_text));
+}
+
+MIRULIT_API void MIR_SetDebugOverlay(bool visible) {
+    _mir_overlay_visible = visible;
+}
+
+MIRULIT_API bool MIR_IsDebugOverlayVisible(void) {
+    return _mir_overlay_visible;
+}
+
+static int _MIR_Overlay_ComparePointers(const void* a, const void* b) {
+    uintptr_t pa = (uintptr_t)*(SDL_Texture* const*)a;
+    uintptr_t pb = (uintptr_t)*(SDL_Texture* const*)b;
+    return (pa > pb) - (pa < pb);
+}
+
+// Память уникальных текстур движка, сущностей и атласа шрифта
+static size_t _MIR_Overlay_TextureMemory(int* texture_count) {
+    SDL_Texture** textures = (SDL_Texture**)MIR_FrameAlloc(
+        sizeof(SDL_Texture*) * (_mir->texture_count + _mir->world->entity_count + 1));
+    int count = 0;
+    *texture_count = 0;
+    if (!textures) return 0;
+
+    for (int i = 0; i < _mir->texture_count; i++) {
+        if (_mir->textures[i]) textures[count++] = _mir->textures[i];
+    }
+    for (int i = 0; i < _mir->world->entity_count; i++) {
+        if (_mir->world->entities[i] && _mir->world->entities[i]->sprite.texture) {
+            textures[count++] = _mir->world->entities[i]->sprite.texture;
+        }
+    }
+    if (_mir_text.atlas) textures[count++] = _mir_text.atlas;
+
+    qsort(textures, count, sizeof(textures[0]), _MIR_Overlay_ComparePointers);
+
+    size_t bytes = 0;
+    int unique = 0;
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && textures[i] == textures[i - 1]) continue;
+        bytes += (size_t)textures[i]->w * textures[i]->h * SDL_BYTESPERPIXEL(textures[i]->format);
+        unique++;
+    }
+    *texture_count = unique;
+    return bytes;
+}
+
+MIRULIT_API void MIR_DrawDebugInfo(void) {
+    if (!_mir_initialized || !_mir) return;
+
+    if (MIR_IsKeyPressed(MIRULIT_OVERLAY_KEY)) {
+        _mir_overlay_visible = !_mir_overlay_visible;
+    }
+    if (!_mir_overlay_visible) return;
+
+    char line[128];
+    float x = _mir->width - MIRULIT_OVERLAY_WIDTH - 10.0f;
+    float y = 10.0f;
+    MIR_Color text = MIR_COLOR_WHITE;
+    MIR_Color dim = MIR_COLOR_LIGHTGRAY;
+
+    MIR_ProfileZone zones[MIRULIT_OVERLAY_ZONES];
+    int zone_count = MIR_Profile_GetFrameZones(zones, MIRULIT_OVERLAY_ZONES);
+    float frame_times[MIRULIT_FRAME_HISTORY];
+    int frame_count = MIR_GetFrameTimes(frame_times, MIRULIT_FRAME_HISTORY);
+
+    float height = 224.0f + (zone_count > 0 ? zone_count : 1) * 10.0f;
+    MIR_DrawTextRect((MIR_Rect){x, y, MIRULIT_OVERLAY_WIDTH, height}, (MIR_Color){0, 0, 0, 190});
+    x += 8;
+    y += 8;
+
+    // Время кадра: среднее и максимум по истории
+    float sum = 0, worst = 0;
+    for (int i = 0; i < frame_count; i++) {
+        sum += frame_times[i];
+        if (frame_times[i] > worst) worst = frame_times[i];
+    }
+    float average = frame_count > 0 ? sum / frame_count : 0;
+    snprintf(line, sizeof(line), "FPS %d  %.2f ms  max %.2f", _mir->fps, average, worst);
+    MIR_DrawText(x, y, line, text, 1);
+    y += 14;
+
+    // График: столбец на кадр, линия - бюджет целевого FPS
+    float graph_w = MIRULIT_OVERLAY_WIDTH - 16.0f, graph_h = 60.0f, graph_ms = 33.3f;
+    float budget = _mir->target_fps > 0 ? 1000.0f / _mir->target_fps : 1000.0f / MIRULIT_DEFAULT_FPS;
+    float bar_w = graph_w / MIRULIT_FRAME_HISTORY;
+    MIR_DrawTextRect((MIR_Rect){x, y, graph_w, graph_h}, (MIR_Color){40, 40, 50, 200});
+    for (int i = 0; i < frame_count; i++) {
+        float h = frame_times[i] / graph_ms * graph_h;
+        if (h > graph_h) h = graph_h;
+        MIR_Color color = frame_times[i] <= budget * 1.05f ? MIR_COLOR_GREEN :
+                          frame_times[i] <= budget * 2.0f ? MIR_COLOR_YELLOW : MIR_COLOR_RED;
+        MIR_DrawTextRect((MIR_Rect){x + (MIRULIT_FRAME_HISTORY - frame_count + i) * bar_w,
+                                    y + graph_h - h, bar_w, h}, color);
+    }
+    float budget_y = y + graph_h - MIR_Math_Clamp(budget / graph_ms, 0, 1) * graph_h;
+    MIR_DrawTextRect((MIR_Rect){x, budget_y, graph_w, 1}, (MIR_Color){255, 255, 255, 120});
+    y += graph_h + 8;
+
+    // Зоны профилировщика за последний кадр
+    MIR_DrawText(x, y, "Subsystems (ms):", dim, 1);
+    y += 12;
+    if (zone_count == 0) {
+        MIR_DrawText(x + 8, y, "enable MIRULIT_ENABLE_PROFILER", dim, 1);
+        y += 10;
+    }
+    for (int i = 0; i < zone_count; i++) {
+        snprintf(line, sizeof(line), "%-18.18s %6.3f", zones[i].name, zones[i].ms);
+        MIR_DrawText(x + 8, y, line, text, 1);
+        y += 10;
+    }
+    y += 6;
+
+    int texture_count = 0;
+    size_t texture_bytes = _MIR_Overlay_TextureMemory(&texture_count);
+
+    snprintf(line, sizeof(line), "Entities  %4d / %d", _mir->world->entity_count, MIRULIT_MAX_ENTITIES);
+    MIR_DrawText(x, y, line, text, 1);
+    y += 12;
+    snprintf(line, sizeof(line), "Particles %4d / %d", _mir->world->particle_count, MIRULIT_MAX_PARTICLES);
+    MIR_DrawText(x, y, line, text, 1);
+    y += 12;
+    snprintf(line, sizeof(line), "Draws %d  Updates %d", _mir->draw_calls, _mir->world->update_calls);
+    MIR_DrawText(x, y, line, text, 1);
+    y += 12;
+    snprintf(line, sizeof(line), "Textures %d  %.2f MB", texture_count, texture_bytes / (1024.0f * 1024.0f));
+    MIR_DrawText(x, y, line, text, 1);
+    y += 12;
+    
+    // Память движка (MIR_Alloc) и арена прошлого кадра
+    MIR_MemoryStats memory = MIR_Memory_GetStats(MIR_MEM_TAG_COUNT);
+    snprintf(line, sizeof(line), "Heap %.2f MB  %d blocks", memory.bytes / (1024.0f * 1024.0f), memory.allocations);
+    MIR_DrawText(x, y, line, text, 1);
+    y += 12;
+    MIR_FrameArenaStats arena = MIR_FrameArena_GetStats();
+    // snprintf msvcrt (tcc на Windows) не знает %zu
+    snprintf(line, sizeof(line), "Frame arena %llu / %llu KB",
+             (unsigned long long)(arena.used / 1024), (unsigned long long)(arena.capacity / 1024));
+    MIR_DrawText(x, y, line, text, 1);
+    y += 16;
+
+    MIR_DrawText(x, y, "F1 - hide", dim, 1);
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_OVERLAY_H
@@ -1,91 +1,175 @@
 #ifndef MIRULIT_PARTICLES_H
 #define MIRULIT_PARTICLES_H
 
-static void MIR_EmitParticleEx(MIR_Vec2 position, MIR_Vec2 velocity, MIR_Vec2 acceleration, 
-                       MIR_Color color, float size, float life) {
-    if (!_mir_initialized || !_mir) return;
+MIRULIT_API void MIR_World_EmitParticleEx(MIR_World* world, MIR_Vec2 position, MIR_Vec2 velocity,
+                                          MIR_Vec2 acceleration, MIR_Color color, float size, float life);
+
+MIRULIT_API void MIR_EmitParticleEx(MIR_Vec2 position, MIR_Vec2 velocity, MIR_Vec2 acceleration, 
+                            MIR_Color color, float size, float life);
+
+MIRULIT_API void MIR_EmitParticle(MIR_Vec2 position, MIR_Vec2 velocity, 
+                                        MIR_Color color, float size, float life);
+
+// Вспышка из count частиц: скорость по осям в [-speed, speed), размер и
+// время жизни - равномерно в своих диапазонах. Случайные числа
+// генерируются пакетами через MIR_Rng_FillUniform из генератора мира.
+MIRULIT_API void MIR_World_EmitParticleBurst(MIR_World* world, MIR_Vec2 position, int count, float speed,
+                                             MIR_Vec2 acceleration, MIR_Color color, float size_min, float size_max,
+                                             float life_min, float life_max);
+
+MIRULIT_API void MIR_EmitParticleBurst(MIR_Vec2 position, int count, float speed, MIR_Vec2 acceleration,
+                                       MIR_Color color, float size_min, float size_max,
+                                       float life_min, float life_max);
+
+MIRULIT_API void MIR_World_UpdateParticles(MIR_World* world);
+
+MIRULIT_API void MIR_UpdateParticles(void);
+
+MIRULIT_API void MIR_DrawParticles(void);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+MIRULIT_API void MIR_World_EmitParticleEx(MIR_World* world, MIR_Vec2 position, MIR_Vec2 velocity,
+                                          MIR_Vec2 acceleration, MIR_Color color, float size, float life) {
+    if (!world) return;
     
     for (int i = 0; i < MIRULIT_MAX_PARTICLES; i++) {
-        if (!_mir->particles[i].active) {
-            _mir->particles[i].position = position;
-            _mir->particles[i].velocity = velocity;
-            _mir->particles[i].acceleration = acceleration;
-            _mir->particles[i].color = color;
-            _mir->particles[i].size = size;
-            _mir->particles[i].life = life;
-            _mir->particles[i].max_life = life;
-            _mir->particles[i].active = true;
-            _mir->particle_count++;
+        if (!world->particles[i].active) {
+            world->particles[i].position = position;
+            world->particles[i].velocity = velocity;
+            world->particles[i].acceleration = acceleration;
+            world->particles[i].color = color;
+            world->particles[i].size = size;
+            world->particles[i].life = life;
+            world->particles[i].max_life = life;
+            world->particles[i].active = true;
+            world->particle_count++;
             break;
         }
     }
 }
 
-static void MIR_EmitParticle(MIR_Vec2 position, MIR_Vec2 velocity, 
-                                   MIR_Color color, float size, float life) {
+MIRULIT_API void MIR_EmitParticleEx(MIR_Vec2 position, MIR_Vec2 velocity, MIR_Vec2 acceleration, 
+                            MIR_Color color, float size, float life) {
+    MIR_World_EmitParticleEx(MIR_GetWorld(), position, velocity, acceleration, color, size, life);
+}
+
+MIRULIT_API void MIR_EmitParticle(MIR_Vec2 position, MIR_Vec2 velocity, 
+                                        MIR_Color color, float size, float life) {
     MIR_EmitParticleEx(position, velocity, (MIR_Vec2){0, 50}, color, size, life);
 }
 
-static void MIR_UpdateParticles(void) {
-    if (!_mir_initialized || !_mir) return;
+MIRULIT_API void MIR_World_EmitParticleBurst(MIR_World* world, MIR_Vec2 position, int count, float speed,
+                                             MIR_Vec2 acceleration, MIR_Color color, float size_min, float size_max,
+                                             float life_min, float life_max) {
+    if (!world) return;
+    
+    float vx[64], vy[64], size[64], life[64];
+    MIR_Rng* rng = &world->rng;
+    
+    for (int done = 0; done < count; done += 64) {
+        int batch = count - done < 64 ? count - done : 64;
+        MIR_Rng_FillUniform(rng, vx, batch, -speed, speed);
+        MIR_Rng_FillUniform(rng, vy, batch, -speed, speed);
+        MIR_Rng_FillUniform(rng, size, batch, size_min, size_max);
+        MIR_Rng_FillUniform(rng, life, batch, life_min, life_max);
+        
+        for (int i = 0; i < batch; i++) {
+            MIR_World_EmitParticleEx(world, position, (MIR_Vec2){vx[i], vy[i]}, acceleration,
+                                     color, size[i], life[i]);
+        }
+    }
+}
+
+MIRULIT_API void MIR_EmitParticleBurst(MIR_Vec2 position, int count, float speed, MIR_Vec2 acceleration,
+                                       MIR_Color color, float size_min, float size_max,
+                                       float life_min, float life_max) {
+    MIR_World_EmitParticleBurst(MIR_GetWorld(), position, count, speed, acceleration,
+                                color, size_min, size_max, life_min, life_max);
+}
+
+MIRULIT_API void MIR_World_UpdateParticles(MIR_World* world) {
+    if (!world) return;
+    MIR_PROFILE_BEGIN("UpdateParticles");
     
-    float scaled_dt = _mir->delta_time * _mir->time_scale;
+    float scaled_dt = world->delta_time * world->time_scale;
     
     for (int i = 0; i < MIRULIT_MAX_PARTICLES; i++) {
-        if (!_mir->particles[i].active) continue;
+        MIR_Particle* particle = &world->particles[i];
+        if (!particle->active) continue;
         
         // Обновление физики
-        _mir->particles[i].velocity = MIR_Vec2_Add(
-            _mir->particles[i].velocity,
-            MIR_Vec2_Multiply(_mir->particles[i].acceleration, scaled_dt)
+        particle->velocity = MIR_Vec2_Add(
+            particle->velocity,
+            MIR_Vec2_Multiply(particle->acceleration, scaled_dt)
         );
         
-        _mir->particles[i].position = MIR_Vec2_Add(
-            _mir->particles[i].position,
-            MIR_Vec2_Multiply(_mir->particles[i].velocity, scaled_dt)
+        particle->position = MIR_Vec2_Add(
+            particle->position,
+            MIR_Vec2_Multiply(particle->velocity, scaled_dt)
         );
         
         // Обновление жизни
-        _mir->particles[i].life -= scaled_dt;
-        if (_mir->particles[i].life <= 0) {
-            _mir->particles[i].active = false;
-            _mir->particle_count--;
+        particle->life -= scaled_dt;
+        if (particle->life <= 0) {
+            particle->active = false;
+            world->particle_count--;
         }
     }
+    
+    MIR_PROFILE_END();
+}
+
+MIRULIT_API void MIR_UpdateParticles(void) {
+    MIR_World_UpdateParticles(MIR_GetWorld());
 }
 
-static void MIR_DrawParticles(void) {
+MIRULIT_API void MIR_DrawParticles(void) {
     if (!_mir_initialized || !_mir) return;
+    MIR_World* world = _mir->world;
     
-    for (int i = 0; i < MIRULIT_MAX_PARTICLES; i++) {
-        if (!_mir->particles[i].active) continue;
-        
-        // Интерполяция цвета по времени жизни
-        float t = _mir->particles[i].life / _mir->particles[i].max_life;
-        MIR_Color color = _mir->particles[i].color;
-        color.a = (uint8_t)(color.a * t);
-        
-        // Конвертация мировых координат в экранные (с учетом камеры)
-        float screen_x = (_mir->particles[i].position.x - _mir->camera.position.x) * 
-                        _mir->camera.zoom + _mir->width / 2.0f;
-        float screen_y = (_mir->particles[i].position.y - _mir->camera.position.y) * 
-                        _mir->camera.zoom + _mir->height / 2.0f;
-        
-        // Масштабирование размера частицы с учетом зума камеры
-        float screen_size = _mir->particles[i].size * t * _mir->camera.zoom;
-        
-        // Отрисовка частицы
-        SDL_SetRenderDrawColor(_mir->renderer, 
-                              color.r, color.g, color.b, color.a);
+    // Позиции переводятся в экранные пачками через матрицу вида
+    const MIR_Mat3* view = MIR_GetViewMatrix();
+    MIR_Vec2 screen[256];
+    int index[256];
+    
+    int i = 0;
+    while (i < MIRULIT_MAX_PARTICLES) {
+        int count = 0;
+        for (; i < MIRULIT_MAX_PARTICLES && count < 256; i++) {
+            if (!world->particles[i].active) continue;
+            screen[count] = world->particles[i].position;
+            index[count++] = i;
+        }
+        MIR_Mat3_TransformPoints(view, screen, screen, count);
         
-        SDL_FRect rect = {
-            screen_x - screen_size / 2,
-            screen_y - screen_size / 2,
-            screen_size, screen_size
-        };
-        SDL_RenderFillRect(_mir->renderer, &rect);
-        _mir->draw_calls++;
+        for (int k = 0; k < count; k++) {
+            MIR_Particle* particle = &world->particles[index[k]];
+            
+            // Интерполяция цвета по времени жизни
+            float t = particle->life / particle->max_life;
+            MIR_Color color = particle->color;
+            color.a = (uint8_t)(color.a * t);
+            
+            // Масштабирование размера частицы с учетом зума камеры
+            float screen_size = particle->size * t * world->camera.zoom;
+            
+            // Отрисовка частицы
+            SDL_SetRenderDrawColor(_mir->renderer, 
+                                  color.r, color.g, color.b, color.a);
+            
+            SDL_FRect rect = {
+                screen[k].x - screen_size / 2,
+                screen[k].y - screen_size / 2,
+                screen_size, screen_size
+            };
+            SDL_RenderFillRect(_mir->renderer, &rect);
+            _mir->draw_calls++;
+        }
     }
 }
 
+#endif // MIRULIT_DEFINE_ENGINE
+
 #endif // MIRULIT_PARTICLES_H
\ No newline at end of file
@@ -0,0 +1,1081 @@
+#ifndef MIRULIT_PATHFINDING_H
+#define MIRULIT_PATHFINDING_H
+
+// ==================== ПОИСК ПУТИ ====================
+// Сервис индивидуальных путей поверх навигационной сетки.
+//
+// Нижний уровень - jump point search (8 соседей, без срезания углов,
+// как и в поле потока). Верхний уровень - иерархия HPA*: сетка
+// делится на кластеры, на общих границах кластеров ставятся входы,
+// внутри кластера входы связаны ребрами с готовой длиной пути.
+// Запрос: старт и цель подключаются к входам своих кластеров,
+// A* идет по графу входов, затем каждое ребро уточняется JPS
+// внутри одного кластера.
+//
+// Запросы ставятся в очередь и решаются на пуле задач. За кадр
+// тратится не больше заданного числа узлов (с точностью до одного
+// запроса - решение отдельного запроса не прерывается). Результат
+// приходит в обратный вызов из MIR_PathService_Update или читается
+// по дескриптору. Середина пути кэшируется по паре
+// (кластер старта, кластер цели) до следующего изменения сетки.
+
+#define MIRULIT_PATH_CLUSTER 16
+#define MIRULIT_PATH_MAX_REQUESTS 256
+#define MIRULIT_PATH_CACHE_SIZE 128
+#define MIRULIT_PATH_CONTEXTS 4
+#define MIRULIT_PATH_LONG_ENTRANCE 6    // с этой длины вход ставится по краям прохода
+
+typedef enum {
+    MIR_PATH_PENDING,
+    MIR_PATH_FOUND,
+    MIR_PATH_NOT_FOUND
+} MIR_PathStatus;
+
+typedef struct MIR_PathService MIR_PathService;
+typedef struct MIR_PathRequest MIR_PathRequest;
+typedef void (*MIR_PathCallback)(MIR_PathRequest* request, void* user_data);
+
+struct MIR_PathRequest {
+    MIR_PathService* service;
+    MIR_Vec2 start;
+    MIR_Vec2 goal;
+    MIR_PathCallback callback;
+    void* user_data;
+
+    MIR_PathStatus status;      // видимый главному потоку результат
+    MIR_PathStatus result;      // пишет рабочий поток
+    MIR_Vec2* points;           // точки поворота от start до goal
+    int point_count;
+
+    bool in_use;
+    bool released;
+};
+
+typedef struct {
+    int requests;
+    int found;
+    int cache_hits;
+    int nodes;                  // узлов JPS и A* за последний кадр
+    int abstract_nodes;
+    int abstract_edges;
+} MIR_PathStats;
+
+typedef struct {
+    int x0, y0, x1, y1;         // включительно
+} _MIR_PathBox;
+
+typedef struct {
+    float f;
+    int id;
+} _MIR_PathHeapNode;
+
+typedef struct {
+    int cell;
+    int cluster;
+    int first_edge;
+} _MIR_PathNode;
+
+typedef struct {
+    int to;
+    float cost;
+    int next;
+} _MIR_PathEdge;
+
+typedef struct {
+    int node;
+    float cost;
+} _MIR_PathLink;
+
+typedef struct {
+    bool used;
+    int start_cluster;
+    int goal_cluster;
+    int first_node;             // первый и последний вход на пути
+    int last_node;
+    int* cells;                 // уточненная середина пути
+    int cell_count;
+} _MIR_PathCacheEntry;
+
+// Рабочие данные одного потока
+typedef struct {
+    MIR_PathService* service;
+    const uint8_t* blocked;
+    int width;
+    int height;
+    _MIR_PathBox box;
+    int goal;
+    int expanded;
+    int budget;
+
+    // Поиск по клеткам (отметки вместо очистки массивов)
+    float* g;
+    int* parent;
+    uint32_t* seen;
+    uint32_t* closed;
+    uint32_t stamp;
+
+    // Поиск по графу входов
+    float* node_g;
+    int* node_parent;
+    uint32_t* node_seen;
+    uint32_t* node_closed;
+    int node_capacity;
+
+    _MIR_PathHeapNode* heap;
+    int heap_count;
+    int heap_capacity;
+
+    int* path;                  // результат последнего поиска по клеткам
+    int path_count;
+    int* result;                // собираемый путь запроса
+    int result_count;
+    int result_capacity;
+
+    _MIR_PathLink* start_links;
+    _MIR_PathLink* goal_links;
+    int start_link_count;
+    int goal_link_count;
+} _MIR_PathContext;
+
+struct MIR_PathService {
+    MIR_NavGrid* grid;
+    int cluster_size;
+    int clusters_x;
+    int clusters_y;
+
+    // Снимок сетки, по которому построена иерархия
+    uint8_t* blocked;
+    uint32_t revision;
+    bool built;
+
+    _MIR_PathNode* nodes;
+    int node_count;
+    int node_capacity;
+    _MIR_PathEdge* edges;
+    int edge_count;
+    int edge_capacity;
+    int* cell_node;             // клетка -> вход или -1
+    int* cluster_first;         // входы кластера k: cluster_nodes[first[k] .. first[k + 1])
+    int* cluster_nodes;
+
+    _MIR_PathCacheEntry cache[MIRULIT_PATH_CACHE_SIZE];
+    int cache_next;
+    SDL_Mutex* cache_mutex;
+
+    MIR_PathRequest requests[MIRULIT_PATH_MAX_REQUESTS];
+    MIR_PathRequest* pending[MIRULIT_PATH_MAX_REQUESTS];
+    int pending_count;
+    MIR_PathRequest* batch[MIRULIT_PATH_MAX_REQUESTS];
+    int batch_count;
+    SDL_AtomicInt batch_next;
+
+    _MIR_PathContext contexts[MIRULIT_PATH_CONTEXTS];
+    int active_contexts;
+    MIR_JobCounter job;
+    bool job_running;
+
+    MIR_PathStats stats;
+    SDL_AtomicInt cache_hits;
+};
+
+// ==================== ВСПОМОГАТЕЛЬНОЕ ====================
+
+static inline float _MIR_Path_Octile(int width, int a, int b) {
+    int dx = abs(a % width - b % width);
+    int dy = abs(a / width - b / width);
+    return dx > dy ? dx + 0.41421356f * dy : dy + 0.41421356f * dx;
+}
+
+static inline int _MIR_Path_Sign(int v) {
+    return (v > 0) - (v < 0);
+}
+
+static inline int _MIR_Path_ClusterOf(const MIR_PathService* s, int cell) {
+    int width = s->grid->width;
+    return (cell / width / s->cluster_size) * s->clusters_x + (cell % width) / s->cluster_size;
+}
+
+// ==================== API ====================
+
+MIRULIT_API MIR_PathService* MIR_PathService_Create(MIR_NavGrid* grid, int cluster_size);
+
+MIRULIT_API void MIR_PathService_Destroy(MIR_PathService* s);
+
+// Постановка запроса в очередь. NULL - очередь заполнена.
+MIRULIT_API MIR_PathRequest* MIR_Path_Request(MIR_PathService* s, MIR_Vec2 start, MIR_Vec2 goal,
+                                              MIR_PathCallback callback, void* user_data);
+
+MIRULIT_API MIR_PathStatus MIR_Path_GetStatus(const MIR_PathRequest* request);
+
+MIRULIT_API int MIR_Path_GetPoints(const MIR_PathRequest* request, const MIR_Vec2** points);
+
+// Освобождение дескриптора; незавершенный запрос отменяется
+MIRULIT_API void MIR_Path_Release(MIR_PathRequest* request);
+
+// Раз в кадр на главном потоке. node_budget - сколько узлов поиска
+// рабочие потоки могут обработать до следующего вызова.
+MIRULIT_API void MIR_PathService_Update(MIR_PathService* s, int node_budget);
+
+MIRULIT_API MIR_PathStats MIR_PathService_GetStats(const MIR_PathService* s);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+static _MIR_PathBox _MIR_Path_ClusterBox(const MIR_PathService* s, int cluster) {
+    int cx = cluster % s->clusters_x, cy = cluster / s->clusters_x;
+    _MIR_PathBox box;
+    box.x0 = cx * s->cluster_size;
+    box.y0 = cy * s->cluster_size;
+    box.x1 = box.x0 + s->cluster_size - 1;
+    box.y1 = box.y0 + s->cluster_size - 1;
+    if (box.x1 >= s->grid->width) box.x1 = s->grid->width - 1;
+    if (box.y1 >= s->grid->height) box.y1 = s->grid->height - 1;
+    return box;
+}
+
+// Рост массива по указателю; false при нехватке памяти
+static bool _MIR_Path_Reserve(void** array, int* capacity, int needed, size_t item_size) {
+    if (needed <= *capacity) return true;
+
+    int capacity_new = *capacity > 0 ? *capacity : 16;
+    while (capacity_new < needed) capacity_new *= 2;
+
+    void* grown = MIR_Realloc(*array, item_size * capacity_new, MIR_MEM_NAVIGATION);
+    if (!grown) return false;
+    *array = grown;
+    *capacity = capacity_new;
+    return true;
+}
+
+static void _MIR_Path_HeapPush(_MIR_PathContext* ctx, int id, float f) {
+    if (!_MIR_Path_Reserve((void**)&ctx->heap, &ctx->heap_capacity, ctx->heap_count + 1,
+                           sizeof(_MIR_PathHeapNode))) return;
+
+    int i = ctx->heap_count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (ctx->heap[parent].f <= f) break;
+        ctx->heap[i] = ctx->heap[parent];
+        i = parent;
+    }
+    ctx->heap[i].f = f;
+    ctx->heap[i].id = id;
+}
+
+static int _MIR_Path_HeapPop(_MIR_PathContext* ctx) {
+    int top = ctx->heap[0].id;
+    _MIR_PathHeapNode last = ctx->heap[--ctx->heap_count];
+
+    int i = 0;
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= ctx->heap_count) break;
+        if (child + 1 < ctx->heap_count && ctx->heap[child + 1].f < ctx->heap[child].f) child++;
+        if (last.f <= ctx->heap[child].f) break;
+        ctx->heap[i] = ctx->heap[child];
+        i = child;
+    }
+    ctx->heap[i] = last;
+    return top;
+}
+
+// Новая отметка поиска; при переполнении счетчика отметки сбрасываются
+static uint32_t _MIR_Path_NextStamp(_MIR_PathContext* ctx) {
+    if (++ctx->stamp == 0) {
+        memset(ctx->seen, 0, sizeof(uint32_t) * ctx->width * ctx->height);
+        memset(ctx->closed, 0, sizeof(uint32_t) * ctx->width * ctx->height);
+        if (ctx->node_capacity > 0) {
+            memset(ctx->node_seen, 0, sizeof(uint32_t) * ctx->node_capacity);
+            memset(ctx->node_closed, 0, sizeof(uint32_t) * ctx->node_capacity);
+        }
+        ctx->stamp = 1;
+    }
+    return ctx->stamp;
+}
+
+// ==================== JUMP POINT SEARCH ====================
+
+static inline bool _MIR_Path_Free(const _MIR_PathContext* ctx, int x, int y) {
+    return x >= ctx->box.x0 && y >= ctx->box.y0 && x <= ctx->box.x1 && y <= ctx->box.y1 &&
+           !ctx->blocked[y * ctx->width + x];
+}
+
+// Прямой прыжок до точки с вынужденным соседом, цели или стены
+static int _MIR_Path_JumpStraight(_MIR_PathContext* ctx, int x, int y, int dx, int dy) {
+    for (;;) {
+        x += dx;
+        y += dy;
+        ctx->expanded++;
+        if (!_MIR_Path_Free(ctx, x, y)) return -1;
+
+        int cell = y * ctx->width + x;
+        if (cell == ctx->goal) return cell;
+
+        if (dx != 0) {
+            if ((_MIR_Path_Free(ctx, x, y - 1) && !_MIR_Path_Free(ctx, x - dx, y - 1)) ||
+                (_MIR_Path_Free(ctx, x, y + 1) && !_MIR_Path_Free(ctx, x - dx, y + 1))) return cell;
+        } else {
+            if ((_MIR_Path_Free(ctx, x - 1, y) && !_MIR_Path_Free(ctx, x - 1, y - dy)) ||
+                (_MIR_Path_Free(ctx, x + 1, y) && !_MIR_Path_Free(ctx, x + 1, y - dy))) return cell;
+        }
+    }
+}
+
+static int _MIR_Path_Jump(_MIR_PathContext* ctx, int x, int y, int dx, int dy) {
+    if (dx == 0 || dy == 0) return _MIR_Path_JumpStraight(ctx, x, y, dx, dy);
+
+    for (;;) {
+        // Диагональ только между двумя свободными клетками
+        if (!_MIR_Path_Free(ctx, x + dx, y) || !_MIR_Path_Free(ctx, x, y + dy)) return -1;
+        x += dx;
+        y += dy;
+        ctx->expanded++;
+        if (!_MIR_Path_Free(ctx, x, y)) return -1;
+
+        int cell = y * ctx->width + x;
+        if (cell == ctx->goal) return cell;
+        if (_MIR_Path_JumpStraight(ctx, x, y, dx, 0) >= 0 ||
+            _MIR_Path_JumpStraight(ctx, x, y, 0, dy) >= 0) return cell;
+    }
+}
+
+// Поиск от start до goal внутри box. Точки поворота - в ctx->path.
+// Возвращает длину пути в клетках или -1.
+static float _MIR_Path_Search(_MIR_PathContext* ctx, int start, int goal, _MIR_PathBox box) {
+    int width = ctx->width;
+    ctx->box = box;
+    ctx->goal = goal;
+    ctx->path_count = 0;
+    ctx->heap_count = 0;
+
+    _MIR_Path_NextStamp(ctx);
+    ctx->g[start] = 0;
+    ctx->parent[start] = -1;
+    ctx->seen[start] = ctx->stamp;
+    _MIR_Path_HeapPush(ctx, start, _MIR_Path_Octile(width, start, goal));
+
+    while (ctx->heap_count > 0) {
+        int cell = _MIR_Path_HeapPop(ctx);
+        if (ctx->closed[cell] == ctx->stamp) continue;
+        ctx->closed[cell] = ctx->stamp;
+        ctx->expanded++;
+
+        if (cell == goal) {
+            int count = 0;
+            for (int c = cell; c >= 0; c = ctx->parent[c]) count++;
+            ctx->path_count = count;
+            for (int c = cell; c >= 0; c = ctx->parent[c]) ctx->path[--count] = c;
+            return ctx->g[goal];
+        }
+
+        int x = cell % width, y = cell / width;
+        int dirs[8][2];
+        int dir_count = 0;
+
+        if (ctx->parent[cell] < 0) {
+            for (int d = 0; d < 8; d++) {
+                dirs[dir_count][0] = _mir_nav_dx[d];
+                dirs[dir_count][1] = _mir_nav_dy[d];
+                dir_count++;
+            }
+        } else {
+            // Отсечение соседей по направлению прихода
+            int p = ctx->parent[cell];
+            int dx = _MIR_Path_Sign(x - p % width), dy = _MIR_Path_Sign(y - p / width);
+            if (dx != 0 && dy != 0) {
+                dirs[0][0] = 0;  dirs[0][1] = dy;
+                dirs[1][0] = dx; dirs[1][1] = 0;
+                dirs[2][0] = dx; dirs[2][1] = dy;
+                dir_count = 3;
+            } else if (dx != 0) {
+                dirs[0][0] = dx; dirs[0][1] = 0;
+                dirs[1][0] = dx; dirs[1][1] = 1;
+                dirs[2][0] = dx; dirs[2][1] = -1;
+                dirs[3][0] = 0;  dirs[3][1] = 1;
+                dirs[4][0] = 0;  dirs[4][1] = -1;
+                dir_count = 5;
+            } else {
+                dirs[0][0] = 0;  dirs[0][1] = dy;
+                dirs[1][0] = 1;  dirs[1][1] = dy;
+                dirs[2][0] = -1; dirs[2][1] = dy;
+                dirs[3][0] = 1;  dirs[3][1] = 0;
+                dirs[4][0] = -1; dirs[4][1] = 0;
+                dir_count = 5;
+            }
+        }
+
+        for (int i = 0; i < dir_count; i++) {
+            int jump = _MIR_Path_Jump(ctx, x, y, dirs[i][0], dirs[i][1]);
+            if (jump < 0 || ctx->closed[jump] == ctx->stamp) continue;
+
+            float g = ctx->g[cell] + _MIR_Path_Octile(width, cell, jump);
+            if (ctx->seen[jump] != ctx->stamp || g < ctx->g[jump]) {
+                ctx->seen[jump] = ctx->stamp;
+                ctx->g[jump] = g;
+                ctx->parent[jump] = cell;
+                _MIR_Path_HeapPush(ctx, jump, g + _MIR_Path_Octile(width, jump, goal));
+            }
+        }
+    }
+    return -1;
+}
+
+static int _MIR_Path_AddNode(MIR_PathService* s, int cell) {
+    if (s->cell_node[cell] >= 0) return s->cell_node[cell];
+    if (!_MIR_Path_Reserve((void**)&s->nodes, &s->node_capacity, s->node_count + 1,
+                           sizeof(_MIR_PathNode))) return -1;
+
+    _MIR_PathNode* node = &s->nodes[s->node_count];
+    node->cell = cell;
+    node->cluster = _MIR_Path_ClusterOf(s, cell);
+    node->first_edge = -1;
+    s->cell_node[cell] = s->node_count;
+    return s->node_count++;
+}
+
+static void _MIR_Path_AddEdge(MIR_PathService* s, int from, int to, float cost) {
+    if (from < 0 || to < 0) return;
+    if (!_MIR_Path_Reserve((void**)&s->edges, &s->edge_capacity, s->edge_count + 1,
+                           sizeof(_MIR_PathEdge))) return;
+
+    _MIR_PathEdge* edge = &s->edges[s->edge_count];
+    edge->to = to;
+    edge->cost = cost;
+    edge->next = s->nodes[from].first_edge;
+    s->nodes[from].first_edge = s->edge_count++;
+}
+
+static void _MIR_Path_AddEntrance(MIR_PathService* s, int cell_a, int cell_b) {
+    int a = _MIR_Path_AddNode(s, cell_a);
+    int b = _MIR_Path_AddNode(s, cell_b);
+    _MIR_Path_AddEdge(s, a, b, 1.0f);
+    _MIR_Path_AddEdge(s, b, a, 1.0f);
+}
+
+// Проход вдоль границы: пары свободных клеток по обе стороны.
+// (x, y) - первая клетка по эту сторону, (sx, sy) - шаг вдоль границы,
+// (nx, ny) - смещение к клетке соседнего кластера.
+static void _MIR_Path_ScanBorder(MIR_PathService* s, int x, int y, int sx, int sy,
+                                 int length, int nx, int ny) {
+    int width = s->grid->width;
+    int run = 0;
+
+    for (int i = 0; i <= length; i++) {
+        int cx = x + sx * i, cy = y + sy * i;
+        bool open = i < length && !s->blocked[cy * width + cx] &&
+                    !s->blocked[(cy + ny) * width + cx + nx];
+        if (open) {
+            run++;
+            continue;
+        }
+        if (run > 0) {
+            int first = i - run, last = i - 1;
+            if (run >= MIRULIT_PATH_LONG_ENTRANCE) {
+                int fa = (y + sy * first) * width + x + sx * first;
+                int la = (y + sy * last) * width + x + sx * last;
+                _MIR_Path_AddEntrance(s, fa, fa + ny * width + nx);
+                _MIR_Path_AddEntrance(s, la, la + ny * width + nx);
+            } else {
+                int mid = (first + last) / 2;
+                int ma = (y + sy * mid) * width + x + sx * mid;
+                _MIR_Path_AddEntrance(s, ma, ma + ny * width + nx);
+            }
+        }
+        run = 0;
+    }
+}
+
+static bool _MIR_Path_ReserveContext(_MIR_PathContext* ctx, int nodes) {
+    if (nodes <= ctx->node_capacity) return true;
+
+    float* g = (float*)MIR_Realloc(ctx->node_g, sizeof(float) * nodes, MIR_MEM_NAVIGATION);
+    if (g) ctx->node_g = g;
+    int* parent = (int*)MIR_Realloc(ctx->node_parent, sizeof(int) * nodes, MIR_MEM_NAVIGATION);
+    if (parent) ctx->node_parent = parent;
+    uint32_t* seen = (uint32_t*)MIR_Realloc(ctx->node_seen, sizeof(uint32_t) * nodes, MIR_MEM_NAVIGATION);
+    if (seen) ctx->node_seen = seen;
+    uint32_t* closed = (uint32_t*)MIR_Realloc(ctx->node_closed, sizeof(uint32_t) * nodes, MIR_MEM_NAVIGATION);
+    if (closed) ctx->node_closed = closed;
+    _MIR_PathLink* start_links = (_MIR_PathLink*)MIR_Realloc(ctx->start_links, sizeof(_MIR_PathLink) * nodes, MIR_MEM_NAVIGATION);
+    if (start_links) ctx->start_links = start_links;
+    _MIR_PathLink* goal_links = (_MIR_PathLink*)MIR_Realloc(ctx->goal_links, sizeof(_MIR_PathLink) * nodes, MIR_MEM_NAVIGATION);
+    if (goal_links) ctx->goal_links = goal_links;
+    if (!g || !parent || !seen || !closed || !start_links || !goal_links) return false;
+
+    // Отметки узлов обнуляются, stamp общий с клетками
+    memset(ctx->node_seen, 0, sizeof(uint32_t) * nodes);
+    memset(ctx->node_closed, 0, sizeof(uint32_t) * nodes);
+    ctx->node_capacity = nodes;
+    return true;
+}
+
+static void _MIR_Path_ClearCache(MIR_PathService* s) {
+    for (int i = 0; i < MIRULIT_PATH_CACHE_SIZE; i++) {
+        MIR_Free(s->cache[i].cells);
+        s->cache[i].cells = NULL;
+        s->cache[i].used = false;
+    }
+}
+
+// Полная перестройка графа входов по снимку сетки (в задаче пула)
+static void _MIR_Path_BuildJob(void* data) {
+    MIR_PathService* s = (MIR_PathService*)data;
+    _MIR_PathContext* ctx = &s->contexts[0];
+    int width = s->grid->width, height = s->grid->height;
+    int clusters = s->clusters_x * s->clusters_y;
+
+    s->node_count = 0;
+    s->edge_count = 0;
+    for (int i = 0; i < width * height; i++) s->cell_node[i] = -1;
+
+    for (int cy = 0; cy < s->clusters_y; cy++) {
+        for (int cx = 0; cx < s->clusters_x; cx++) {
+            _MIR_PathBox box = _MIR_Path_ClusterBox(s, cy * s->clusters_x + cx);
+            if (cx + 1 < s->clusters_x) {
+                _MIR_Path_ScanBorder(s, box.x1, box.y0, 0, 1, box.y1 - box.y0 + 1, 1, 0);
+            }
+            if (cy + 1 < s->clusters_y) {
+                _MIR_Path_ScanBorder(s, box.x0, box.y1, 1, 0, box.x1 - box.x0 + 1, 0, 1);
+            }
+        }
+    }
+
+    // Входы по кластерам (подсчет и раскладка)
+    memset(s->cluster_first, 0, sizeof(int) * (clusters + 1));
+    for (int i = 0; i < s->node_count; i++) s->cluster_first[s->nodes[i].cluster + 1]++;
+    for (int k = 0; k < clusters; k++) s->cluster_first[k + 1] += s->cluster_first[k];
+
+    int* fill = (int*)MIR_Alloc(sizeof(int) * (clusters + 1), MIR_MEM_NAVIGATION);
+    int* cluster_nodes = (int*)MIR_Realloc(s->cluster_nodes, sizeof(int) * (s->node_count + 1), MIR_MEM_NAVIGATION);
+    if (!fill || !cluster_nodes) {
+        MIR_Free(fill);
+        if (cluster_nodes) s->cluster_nodes = cluster_nodes;
+        s->node_count = 0;
+        return;
+    }
+    s->cluster_nodes = cluster_nodes;
+    memcpy(fill, s->cluster_first, sizeof(int) * (clusters + 1));
+    for (int i = 0; i < s->node_count; i++) {
+        s->cluster_nodes[fill[s->nodes[i].cluster]++] = i;
+    }
+    MIR_Free(fill);
+
+    // Ребра внутри кластера - длины путей JPS в его границах
+    ctx->blocked = s->blocked;
+    for (int k = 0; k < clusters; k++) {
+        _MIR_PathBox box = _MIR_Path_ClusterBox(s, k);
+        for (int i = s->cluster_first[k]; i < s->cluster_first[k + 1]; i++) {
+            for (int j = i + 1; j < s->cluster_first[k + 1]; j++) {
+                int a = s->cluster_nodes[i], b = s->cluster_nodes[j];
+                float cost = _MIR_Path_Search(ctx, s->nodes[a].cell, s->nodes[b].cell, box);
+                if (cost >= 0) {
+                    _MIR_Path_AddEdge(s, a, b, cost);
+                    _MIR_Path_AddEdge(s, b, a, cost);
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < MIRULIT_PATH_CONTEXTS; i++) {
+        _MIR_Path_ReserveContext(&s->contexts[i], s->node_count + 2);
+    }
+}
+
+static bool _MIR_Path_Append(_MIR_PathContext* ctx, const int* cells, int count) {
+    // Первая клетка отрезка совпадает с последней уже собранной
+    int skip = (ctx->result_count > 0 && count > 0 && ctx->result[ctx->result_count - 1] == cells[0]);
+    if (!_MIR_Path_Reserve((void**)&ctx->result, &ctx->result_capacity,
+                           ctx->result_count + count, sizeof(int))) return false;
+
+    for (int i = skip; i < count; i++) ctx->result[ctx->result_count++] = cells[i];
+    return true;
+}
+
+static bool _MIR_Path_Leg(_MIR_PathContext* ctx, int from, int to, int cluster) {
+    MIR_PathService* s = ctx->service;
+    if (_MIR_Path_Search(ctx, from, to, _MIR_Path_ClusterBox(s, cluster)) < 0) return false;
+    return _MIR_Path_Append(ctx, ctx->path, ctx->path_count);
+}
+
+// A* по графу входов; старт и цель подключаются на лету без записи в граф
+static bool _MIR_Path_Abstract(_MIR_PathContext* ctx, int start, int goal,
+                               int start_cluster, int goal_cluster) {
+    MIR_PathService* s = ctx->service;
+    int width = ctx->width;
+    int S = s->node_count, G = s->node_count + 1;
+
+    if (ctx->node_capacity < s->node_count + 2) return false;
+
+    ctx->start_link_count = 0;
+    ctx->goal_link_count = 0;
+    _MIR_PathBox start_box = _MIR_Path_ClusterBox(s, start_cluster);
+    _MIR_PathBox goal_box = _MIR_Path_ClusterBox(s, goal_cluster);
+
+    for (int i = s->cluster_first[start_cluster]; i < s->cluster_first[start_cluster + 1]; i++) {
+        int n = s->cluster_nodes[i];
+        float cost = _MIR_Path_Search(ctx, start, s->nodes[n].cell, start_box);
+        if (cost >= 0) {
+            ctx->start_links[ctx->start_link_count++] = (_MIR_PathLink){n, cost};
+        }
+    }
+    for (int i = s->cluster_first[goal_cluster]; i < s->cluster_first[goal_cluster + 1]; i++) {
+        int n = s->cluster_nodes[i];
+        float cost = _MIR_Path_Search(ctx, s->nodes[n].cell, goal, goal_box);
+        if (cost >= 0) {
+            ctx->goal_links[ctx->goal_link_count++] = (_MIR_PathLink){n, cost};
+        }
+    }
+    if (ctx->start_link_count == 0 || ctx->goal_link_count == 0) return false;
+
+    uint32_t stamp = _MIR_Path_NextStamp(ctx);
+    ctx->heap_count = 0;
+    ctx->node_g[S] = 0;
+    ctx->node_parent[S] = -1;
+    ctx->node_seen[S] = stamp;
+    _MIR_Path_HeapPush(ctx, S, _MIR_Path_Octile(width, start, goal));
+
+    while (ctx->heap_count > 0) {
+        int u = _MIR_Path_HeapPop(ctx);
+        if (ctx->node_closed[u] == stamp) continue;
+        ctx->node_closed[u] = stamp;
+        ctx->expanded++;
+        if (u == G) return true;
+
+        // Соседи: связи старта, ребра графа, связь с целью
+        const _MIR_PathLink* links = NULL;
+        int link_count = 0;
+        if (u == S) {
+            links = ctx->start_links;
+            link_count = ctx->start_link_count;
+        }
+
+        for (int i = 0; i < link_count; i++) {
+            int v = links[i].node;
+            float g = ctx->node_g[u] + links[i].cost;
+            if (ctx->node_seen[v] != stamp || g < ctx->node_g[v]) {
+                ctx->node_seen[v] = stamp;
+                ctx->node_g[v] = g;
+                ctx->node_parent[v] = u;
+                _MIR_Path_HeapPush(ctx, v, g + _MIR_Path_Octile(width, s->nodes[v].cell, goal));
+            }
+        }
+        if (u == S) continue;
+
+        for (int e = s->nodes[u].first_edge; e >= 0; e = s->edges[e].next) {
+            int v = s->edges[e].to;
+            if (ctx->node_closed[v] == stamp) continue;
+
+            float g = ctx->node_g[u] + s->edges[e].cost;
+            if (ctx->node_seen[v] != stamp || g < ctx->node_g[v]) {
+                ctx->node_seen[v] = stamp;
+                ctx->node_g[v] = g;
+                ctx->node_parent[v] = u;
+                _MIR_Path_HeapPush(ctx, v, g + _MIR_Path_Octile(width, s->nodes[v].cell, goal));
+            }
+        }
+
+        if (s->nodes[u].cluster == goal_cluster) {
+            for (int i = 0; i < ctx->goal_link_count; i++) {
+                if (ctx->goal_links[i].node != u) continue;
+
+                float g = ctx->node_g[u] + ctx->goal_links[i].cost;
+                if (ctx->node_seen[G] != stamp || g < ctx->node_g[G]) {
+                    ctx->node_seen[G] = stamp;
+                    ctx->node_g[G] = g;
+                    ctx->node_parent[G] = u;
+                    _MIR_Path_HeapPush(ctx, G, g);
+                }
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+static void _MIR_Path_CacheStore(MIR_PathService* s, int start_cluster, int goal_cluster,
+                                 int first_node, int last_node, const int* cells, int count) {
+    int* copy = (int*)MIR_Alloc(sizeof(int) * (count > 0 ? count : 1), MIR_MEM_NAVIGATION);
+    if (!copy) return;
+    memcpy(copy, cells, sizeof(int) * count);
+
+    SDL_LockMutex(s->cache_mutex);
+    _MIR_PathCacheEntry* entry = NULL;
+    for (int i = 0; i < MIRULIT_PATH_CACHE_SIZE && !entry; i++) {
+        if (s->cache[i].used && s->cache[i].start_cluster == start_cluster &&
+            s->cache[i].goal_cluster == goal_cluster) entry = &s->cache[i];
+    }
+    if (!entry) {
+        entry = &s->cache[s->cache_next];
+        s->cache_next = (s->cache_next + 1) % MIRULIT_PATH_CACHE_SIZE;
+    }
+    MIR_Free(entry->cells);
+    entry->used = true;
+    entry->start_cluster = start_cluster;
+    entry->goal_cluster = goal_cluster;
+    entry->first_node = first_node;
+    entry->last_node = last_node;
+    entry->cells = copy;
+    entry->cell_count = count;
+    SDL_UnlockMutex(s->cache_mutex);
+}
+
+// Путь из кэша: подключаем старт и цель к сохраненной середине
+static bool _MIR_Path_FromCache(_MIR_PathContext* ctx, int start, int goal,
+                                int start_cluster, int goal_cluster) {
+    MIR_PathService* s = ctx->service;
+    int first_cell = -1, last_cell = -1;
+    bool hit = false;
+
+    SDL_LockMutex(s->cache_mutex);
+    for (int i = 0; i < MIRULIT_PATH_CACHE_SIZE; i++) {
+        _MIR_PathCacheEntry* entry = &s->cache[i];
+        if (!entry->used || entry->start_cluster != start_cluster ||
+            entry->goal_cluster != goal_cluster) continue;
+
+        first_cell = s->nodes[entry->first_node].cell;
+        last_cell = s->nodes[entry->last_node].cell;
+        ctx->result_count = 0;
+        hit = _MIR_Path_Leg(ctx, start, first_cell, start_cluster) &&
+              _MIR_Path_Append(ctx, entry->cells, entry->cell_count);
+        break;
+    }
+    SDL_UnlockMutex(s->cache_mutex);
+
+    return hit && _MIR_Path_Leg(ctx, last_cell, goal, goal_cluster);
+}
+
+static bool _MIR_Path_Solve(_MIR_PathContext* ctx, int start, int goal) {
+    MIR_PathService* s = ctx->service;
+    int start_cluster = _MIR_Path_ClusterOf(s, start);
+    int goal_cluster = _MIR_Path_ClusterOf(s, goal);
+    ctx->result_count = 0;
+
+    // В одном кластере сначала пробуем напрямую
+    if (start_cluster == goal_cluster && _MIR_Path_Leg(ctx, start, goal, start_cluster)) return true;
+
+    if (_MIR_Path_FromCache(ctx, start, goal, start_cluster, goal_cluster)) {
+        SDL_AddAtomicInt(&s->cache_hits, 1);
+        return true;
+    }
+
+    if (!_MIR_Path_Abstract(ctx, start, goal, start_cluster, goal_cluster)) return false;
+
+    // Цепочка входов от цели к старту, затем уточнение по ребрам
+    int S = s->node_count, G = s->node_count + 1;
+    int count = 0;
+    for (int n = ctx->node_parent[G]; n != S; n = ctx->node_parent[n]) count++;
+    if (count == 0) return false;
+
+    int* chain = (int*)MIR_Alloc(sizeof(int) * count, MIR_MEM_NAVIGATION);
+    if (!chain) return false;
+    int k = count;
+    for (int n = ctx->node_parent[G]; n != S; n = ctx->node_parent[n]) chain[--k] = n;
+
+    ctx->result_count = 0;
+    bool ok = _MIR_Path_Leg(ctx, start, s->nodes[chain[0]].cell, start_cluster);
+    int middle_begin = ctx->result_count - 1;
+
+    for (int i = 0; ok && i + 1 < count; i++) {
+        const _MIR_PathNode* a = &s->nodes[chain[i]];
+        const _MIR_PathNode* b = &s->nodes[chain[i + 1]];
+        if (a->cluster == b->cluster) {
+            ok = _MIR_Path_Leg(ctx, a->cell, b->cell, a->cluster);
+        } else {
+            ok = _MIR_Path_Append(ctx, &b->cell, 1);
+        }
+    }
+
+    if (ok) {
+        _MIR_Path_CacheStore(s, start_cluster, goal_cluster, chain[0], chain[count - 1],
+                             &ctx->result[middle_begin], ctx->result_count - middle_begin);
+        ok = _MIR_Path_Leg(ctx, s->nodes[chain[count - 1]].cell, goal, goal_cluster);
+    }
+    MIR_Free(chain);
+    return ok;
+}
+
+static void _MIR_Path_Process(_MIR_PathContext* ctx, MIR_PathRequest* request) {
+    MIR_PathService* s = ctx->service;
+    MIR_NavGrid* grid = s->grid;
+    int start = MIR_NavGrid_WorldToCell(grid, request->start);
+    int goal = MIR_NavGrid_WorldToCell(grid, request->goal);
+
+    request->result = MIR_PATH_NOT_FOUND;
+    if (start < 0 || goal < 0 || s->blocked[start] || s->blocked[goal]) return;
+    if (!_MIR_Path_Solve(ctx, start, goal)) return;
+
+    // Клетки -> мировые точки; концы - точные позиции запроса
+    MIR_Vec2* points = (MIR_Vec2*)MIR_Alloc(sizeof(MIR_Vec2) * (ctx->result_count + 1), MIR_MEM_NAVIGATION);
+    if (!points) return;
+
+    int count = 0;
+    points[count++] = request->start;
+    for (int i = 1; i + 1 < ctx->result_count; i++) {
+        points[count++] = MIR_NavGrid_CellCenter(grid, ctx->result[i]);
+    }
+    points[count++] = request->goal;
+
+    request->points = points;
+    request->point_count = count;
+    request->result = MIR_PATH_FOUND;
+}
+
+static void _MIR_Path_SearchJob(void* data) {
+    _MIR_PathContext* ctx = (_MIR_PathContext*)data;
+    MIR_PathService* s = ctx->service;
+    ctx->blocked = s->blocked;
+    ctx->expanded = 0;
+
+    while (ctx->expanded < ctx->budget) {
+        int index = SDL_AddAtomicInt(&s->batch_next, 1);
+        if (index >= s->batch_count) break;
+
+        MIR_PathRequest* request = s->batch[index];
+        if (request->released) {
+            request->result = MIR_PATH_NOT_FOUND;
+            continue;
+        }
+        _MIR_Path_Process(ctx, request);
+    }
+}
+
+static bool _MIR_Path_InitContext(_MIR_PathContext* ctx, MIR_PathService* s) {
+    int cells = s->grid->width * s->grid->height;
+    ctx->service = s;
+    ctx->width = s->grid->width;
+    ctx->height = s->grid->height;
+    ctx->g = (float*)MIR_Alloc(sizeof(float) * cells, MIR_MEM_NAVIGATION);
+    ctx->parent = (int*)MIR_Alloc(sizeof(int) * cells, MIR_MEM_NAVIGATION);
+    ctx->seen = (uint32_t*)MIR_Calloc(cells, sizeof(uint32_t), MIR_MEM_NAVIGATION);
+    ctx->closed = (uint32_t*)MIR_Calloc(cells, sizeof(uint32_t), MIR_MEM_NAVIGATION);
+    ctx->path = (int*)MIR_Alloc(sizeof(int) * cells, MIR_MEM_NAVIGATION);
+    return ctx->g && ctx->parent && ctx->seen && ctx->closed && ctx->path;
+}
+
+static void _MIR_Path_FreeContext(_MIR_PathContext* ctx) {
+    MIR_Free(ctx->g);
+    MIR_Free(ctx->parent);
+    MIR_Free(ctx->seen);
+    MIR_Free(ctx->closed);
+    MIR_Free(ctx->path);
+    MIR_Free(ctx->node_g);
+    MIR_Free(ctx->node_parent);
+    MIR_Free(ctx->node_seen);
+    MIR_Free(ctx->node_closed);
+    MIR_Free(ctx->heap);
+    MIR_Free(ctx->result);
+    MIR_Free(ctx->start_links);
+    MIR_Free(ctx->goal_links);
+}
+
+MIRULIT_API MIR_PathService* MIR_PathService_Create(MIR_NavGrid* grid, int cluster_size) {
+    if (!grid) return NULL;
+
+    MIR_PathService* s = (MIR_PathService*)MIR_Calloc(1, sizeof(MIR_PathService), MIR_MEM_NAVIGATION);
+    if (!s) return NULL;
+
+    int cells = grid->width * grid->height;
+    s->grid = grid;
+    s->cluster_size = cluster_size > 0 ? cluster_size : MIRULIT_PATH_CLUSTER;
+    s->clusters_x = (grid->width + s->cluster_size - 1) / s->cluster_size;
+    s->clusters_y = (grid->height + s->cluster_size - 1) / s->cluster_size;
+    s->blocked = (uint8_t*)MIR_Alloc(cells, MIR_MEM_NAVIGATION);
+    s->cell_node = (int*)MIR_Alloc(sizeof(int) * cells, MIR_MEM_NAVIGATION);
+    s->cluster_first = (int*)MIR_Calloc(s->clusters_x * s->clusters_y + 1, sizeof(int), MIR_MEM_NAVIGATION);
+    s->cache_mutex = SDL_CreateMutex();
+    SDL_SetAtomicInt(&s->job.pending, 0);
+
+    bool ok = s->blocked && s->cell_node && s->cluster_first && s->cache_mutex;
+    for (int i = 0; i < MIRULIT_PATH_CONTEXTS && ok; i++) {
+        ok = _MIR_Path_InitContext(&s->contexts[i], s);
+    }
+    if (!ok) {
+        MIR_Log(MIR_LOG_ERROR, "Path service: out of memory");
+        MIR_PathService_Destroy(s);
+        return NULL;
+    }
+    return s;
+}
+
+MIRULIT_API void MIR_PathService_Destroy(MIR_PathService* s) {
+    if (!s) return;
+    if (s->job_running) MIR_Jobs_Wait(&s->job);
+
+    for (int i = 0; i < MIRULIT_PATH_MAX_REQUESTS; i++) {
+        MIR_Free(s->requests[i].points);
+    }
+    for (int i = 0; i < MIRULIT_PATH_CONTEXTS; i++) {
+        _MIR_Path_FreeContext(&s->contexts[i]);
+    }
+    _MIR_Path_ClearCache(s);
+    if (s->cache_mutex) SDL_DestroyMutex(s->cache_mutex);
+
+    MIR_Free(s->blocked);
+    MIR_Free(s->nodes);
+    MIR_Free(s->edges);
+    MIR_Free(s->cell_node);
+    MIR_Free(s->cluster_first);
+    MIR_Free(s->cluster_nodes);
+    MIR_Free(s);
+}
+
+MIRULIT_API MIR_PathRequest* MIR_Path_Request(MIR_PathService* s, MIR_Vec2 start, MIR_Vec2 goal,
+                                              MIR_PathCallback callback, void* user_data) {
+    if (!s || s->pending_count >= MIRULIT_PATH_MAX_REQUESTS) return NULL;
+
+    for (int i = 0; i < MIRULIT_PATH_MAX_REQUESTS; i++) {
+        MIR_PathRequest* request = &s->requests[i];
+        if (request->in_use) continue;
+
+        memset(request, 0, sizeof(*request));
+        request->service = s;
+        request->start = start;
+        request->goal = goal;
+        request->callback = callback;
+        request->user_data = user_data;
+        request->status = MIR_PATH_PENDING;
+        request->result = MIR_PATH_PENDING;
+        request->in_use = true;
+
+        s->pending[s->pending_count++] = request;
+        s->stats.requests++;
+        return request;
+    }
+    return NULL;
+}
+
+MIRULIT_API MIR_PathStatus MIR_Path_GetStatus(const MIR_PathRequest* request) {
+    return request ? request->status : MIR_PATH_NOT_FOUND;
+}
+
+MIRULIT_API int MIR_Path_GetPoints(const MIR_PathRequest* request, const MIR_Vec2** points) {
+    if (!request || request->status != MIR_PATH_FOUND) {
+        if (points) *points = NULL;
+        return 0;
+    }
+    if (points) *points = request->points;
+    return request->point_count;
+}
+
+static void _MIR_Path_FreeRequest(MIR_PathRequest* request) {
+    MIR_Free(request->points);
+    request->points = NULL;
+    request->point_count = 0;
+    request->in_use = false;
+}
+
+MIRULIT_API void MIR_Path_Release(MIR_PathRequest* request) {
+    if (!request || !request->in_use) return;
+
+    MIR_PathService* s = request->service;
+    request->released = true;
+    request->callback = NULL;
+
+    // Запрос в работе у потока - слот освободится в MIR_PathService_Update
+    if (s->job_running) {
+        for (int i = 0; i < s->batch_count; i++) {
+            if (s->batch[i] == request) return;
+        }
+    }
+
+    for (int i = 0; i < s->pending_count; i++) {
+        if (s->pending[i] == request) {
+            memmove(&s->pending[i], &s->pending[i + 1], sizeof(s->pending[0]) * (s->pending_count - i - 1));
+            s->pending_count--;
+            break;
+        }
+    }
+    _MIR_Path_FreeRequest(request);
+}
+
+// Результаты пачки: публикация статусов и обратные вызовы
+static void _MIR_Path_Finish(MIR_PathService* s) {
+    s->job_running = false;
+    s->stats.nodes = 0;
+    for (int i = 0; i < s->active_contexts; i++) {
+        s->stats.nodes += s->contexts[i].expanded;
+    }
+    s->stats.cache_hits = SDL_GetAtomicInt(&s->cache_hits);
+
+    int kept = 0;
+    for (int i = 0; i < s->pending_count; i++) {
+        MIR_PathRequest* request = s->pending[i];
+        if (request->released) {
+            _MIR_Path_FreeRequest(request);
+        } else if (request->result == MIR_PATH_PENDING) {
+            s->pending[kept++] = request;
+        }
+    }
+    s->pending_count = kept;
+
+    // Обратный вызов может освободить запрос или поставить новый
+    int batch_count = s->batch_count;
+    s->batch_count = 0;
+    for (int i = 0; i < batch_count; i++) {
+        MIR_PathRequest* request = s->batch[i];
+        if (!request->in_use || request->released || request->result == MIR_PATH_PENDING ||
+            request->status != MIR_PATH_PENDING) continue;
+
+        request->status = request->result;
+        if (request->status == MIR_PATH_FOUND) s->stats.found++;
+        if (request->callback) request->callback(request, request->user_data);
+    }
+}
+
+MIRULIT_API void MIR_PathService_Update(MIR_PathService* s, int node_budget) {
+    if (!s) return;
+
+    if (s->job_running) {
+        if (!MIR_Jobs_IsDone(&s->job)) return;
+        if (s->batch_count > 0) {
+            _MIR_Path_Finish(s);
+        } else {
+            s->job_running = false;
+            s->stats.abstract_nodes = s->node_count;
+            s->stats.abstract_edges = s->edge_count;
+        }
+    }
+
+    // Сетка изменилась - перестраиваем граф входов по новому снимку
+    if (!s->built || s->revision != s->grid->revision) {
+        memcpy(s->blocked, s->grid->blocked, s->grid->width * s->grid->height);
+        s->revision = s->grid->revision;
+        s->built = true;
+        _MIR_Path_ClearCache(s);
+
+        s->job_running = true;
+        MIR_Jobs_Submit(_MIR_Path_BuildJob, s, &s->job);
+        return;
+    }
+
+    if (s->pending_count == 0) return;
+
+    s->batch_count = s->pending_count;
+    memcpy(s->batch, s->pending, sizeof(s->pending[0]) * s->pending_count);
+    SDL_SetAtomicInt(&s->batch_next, 0);
+
+    int contexts = MIR_Jobs_GetWorkerCount();
+    if (contexts < 1) contexts = 1;
+    if (contexts > MIRULIT_PATH_CONTEXTS) contexts = MIRULIT_PATH_CONTEXTS;
+    if (contexts > s->batch_count) contexts = s->batch_count;
+    if (node_budget < contexts) node_budget = contexts;
+
+    s->active_contexts = contexts;
+    s->job_running = true;
+    for (int i = 0; i < contexts; i++) {
+        s->contexts[i].budget = node_budget / contexts;
+        MIR_Jobs_Submit(_MIR_Path_SearchJob, &s->contexts[i], &s->job);
+    }
+
+    // Без рабочих потоков все уже выполнено на месте
+    if (MIR_Jobs_IsDone(&s->job)) _MIR_Path_Finish(s);
+}
+
+MIRULIT_API MIR_PathStats MIR_PathService_GetStats(const MIR_PathService* s) {
+    MIR_PathStats empty = {0};
+    return s ? s->stats : empty;
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_PATHFINDING_H
@@ -0,0 +1,1285 @@
+#ifndef MIRULIT_PHYSICS_H
+#define MIRULIT_PHYSICS_H
+
+#ifdef MIRULIT_ENABLE_PHYSICS
+
+// ==================== ФИЗИКА ====================
+// Импульсный 2D-солвер: последовательные импульсы с тёплым стартом,
+// острова контактов (решаются параллельно на пуле задач) и сон тел.
+// Спящие и статические тела не интегрируются и не перебираются
+// в broadphase как активные, поэтому почти ничего не стоят.
+// Единицы - пиксели и секунды, ось Y направлена вниз.
+
+#define MIRULIT_MAX_BODIES 8192
+#define MIRULIT_MAX_ARBITERS (MIRULIT_MAX_BODIES * 4)
+#define MIRULIT_PHYSICS_HZ 60
+#define MIRULIT_PHYSICS_MAX_SUBSTEPS 4
+#define MIRULIT_PHYSICS_ITERATIONS 10
+
+#define MIR_PHYSICS_ALLOWED_PENETRATION 0.5f
+#define MIR_PHYSICS_BIAS_FACTOR 0.2f
+#define MIR_PHYSICS_CONTACT_MARGIN 1.0f
+#define MIR_PHYSICS_RESTITUTION_THRESHOLD 60.0f
+#define MIR_PHYSICS_SLEEP_LINEAR 4.0f
+#define MIR_PHYSICS_SLEEP_ANGULAR 0.05f
+#define MIR_PHYSICS_TIME_TO_SLEEP 0.5f
+#define MIR_PHYSICS_BIG_BODY 256.0f
+
+typedef enum {
+    MIR_BODY_STATIC,
+    MIR_BODY_DYNAMIC
+} MIR_BodyType;
+
+typedef enum {
+    MIR_SHAPE_AABB,     // Прямоугольник без вращения
+    MIR_SHAPE_CIRCLE,
+    MIR_SHAPE_OBB       // Вращающийся прямоугольник
+} MIR_ShapeType;
+
+struct MIR_Body {
+    MIR_Entity* entity;
+    MIR_BodyType type;
+    MIR_ShapeType shape;
+    MIR_Vec2 half_size;
+    float radius;
+
+    MIR_Vec2 position;
+    float angle;                // радианы
+    MIR_Vec2 velocity;
+    float angular_velocity;
+    MIR_Vec2 force;
+    float torque;
+
+    float mass, inv_mass;
+    float inertia, inv_inertia;
+    float restitution;
+    float friction;
+    float gravity_scale;
+
+    bool used;
+    bool awake;
+    float sleep_time;
+    int sleep_next;             // кольцевой список спящего острова
+    int island;
+    MIR_Rect aabb;
+};
+
+// Точка контакта и накопленные импульсы для тёплого старта
+typedef struct {
+    MIR_Vec2 position;
+    float separation;
+    float Pn, Pt;
+    float mass_normal, mass_tangent;
+    float bias;
+    MIR_Vec2 r1, r2;
+    uint32_t feature;
+} MIR_Contact;
+
+// Пара тел в контакте (a < b), нормаль направлена от a к b
+typedef struct {
+    int a, b;
+    MIR_Vec2 normal;
+    MIR_Contact contacts[2];
+    int contact_count;
+    bool block;
+    float k11, k12, k22;        // матрица K двух точек и её обратная
+    float m11, m12, m22;
+    float friction;
+    float restitution;
+    int island;
+    uint32_t stamp;
+} MIR_Arbiter;
+
+typedef struct {
+    int body_start, body_count;
+    int arbiter_start, arbiter_count;
+} MIR_Island;
+
+typedef struct {
+    int bodies;
+    int awake_bodies;
+    int islands;
+    int arbiters;
+    int contacts;
+} MIR_PhysicsStats;
+
+typedef struct {
+    MIR_Body bodies[MIRULIT_MAX_BODIES];
+    int body_high;              // верхняя граница занятых слотов
+    int free_list[MIRULIT_MAX_BODIES];
+    int free_count;
+    int body_count;
+
+    // Broadphase: бодрствующие и неактивные (статика и спящие) отдельно
+    int awake[MIRULIT_MAX_BODIES];
+    int awake_count;
+    int inactive[MIRULIT_MAX_BODIES];
+    int inactive_count;
+    int big[MIRULIT_MAX_BODIES];
+    int big_count;
+    bool inactive_dirty;
+
+    MIR_Arbiter arbiters[MIRULIT_MAX_ARBITERS];
+    int arbiter_count;
+    int hash[MIRULIT_MAX_ARBITERS * 2];
+    uint32_t stamp;
+
+    // Острова текущего шага
+    int parent[MIRULIT_MAX_BODIES];
+    int island_of_root[MIRULIT_MAX_BODIES];
+    MIR_Island islands[MIRULIT_MAX_BODIES];
+    int island_count;
+    int island_bodies[MIRULIT_MAX_BODIES];
+    int island_arbiters[MIRULIT_MAX_ARBITERS];
+
+    MIR_Vec2 gravity;
+    float accumulator;
+    float step_dt;
+    MIR_PhysicsStats stats;
+} MIR_PhysicsWorld;
+
+MIRULIT_SHARED MIR_PhysicsWorld* _mir_physics;
+
+// ==================== ВСПОМОГАТЕЛЬНОЕ ====================
+
+static inline float _MIR_Cross(MIR_Vec2 a, MIR_Vec2 b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+static inline MIR_Vec2 _MIR_CrossSV(float s, MIR_Vec2 v) {
+    return (MIR_Vec2){-s * v.y, s * v.x};
+}
+
+static inline MIR_Vec2 _MIR_Rotate(MIR_Vec2 v, float c, float s) {
+    return (MIR_Vec2){c * v.x - s * v.y, s * v.x + c * v.y};
+}
+
+static inline MIR_Vec2 _MIR_RotateT(MIR_Vec2 v, float c, float s) {
+    return (MIR_Vec2){c * v.x + s * v.y, -s * v.x + c * v.y};
+}
+
+// ==================== МИР ====================
+
+MIRULIT_API bool MIR_Physics_Init(void);
+
+MIRULIT_API void MIR_Physics_Shutdown(void);
+
+MIRULIT_API void MIR_Physics_SetGravity(MIR_Vec2 gravity);
+
+MIRULIT_API MIR_PhysicsStats MIR_Physics_GetStats(void);
+
+// Будит тело и весь его спящий остров
+MIRULIT_API void MIR_Body_Wake(MIR_Body* body);
+
+// Тело создается по трансформу сущности: scale - размер прямоугольника,
+// для круга радиус - половина меньшей стороны
+MIRULIT_API MIR_Body* MIR_AddBody(MIR_Entity* entity, MIR_BodyType type,
+                                  MIR_ShapeType shape, float density);
+
+MIRULIT_API void MIR_RemoveBody(MIR_Entity* entity);
+
+MIRULIT_API void MIR_Body_ApplyImpulse(MIR_Body* body, MIR_Vec2 impulse, MIR_Vec2 point);
+
+MIRULIT_API void MIR_Body_ApplyForce(MIR_Body* body, MIR_Vec2 force);
+
+MIRULIT_API void MIR_Body_SetPosition(MIR_Body* body, MIR_Vec2 position);
+
+// ==================== СТОЛКНОВЕНИЯ ====================
+
+// Идентификатор пары рёбер для сопоставления контактов между шагами
+enum { MIR_EDGE_NONE, MIR_EDGE1, MIR_EDGE2, MIR_EDGE3, MIR_EDGE4 };
+
+#define MIR_FEATURE(in1, out1, in2, out2) \
+    ((uint32_t)(in1) | ((uint32_t)(out1) << 8) | ((uint32_t)(in2) << 16) | ((uint32_t)(out2) << 24))
+
+static inline uint32_t _MIR_FeatureFlip(uint32_t f) {
+    return ((f & 0xFFFFu) << 16) | (f >> 16);
+}
+
+typedef struct {
+    MIR_Vec2 v;
+    uint32_t feature;
+} _MIR_ClipVertex;
+
+// ==================== КОНТАКТЫ ====================
+
+static inline bool _MIR_AABBOverlap(const MIR_Rect* a, const MIR_Rect* b) {
+    return a->x <= b->x + b->w && a->x + a->w >= b->x &&
+           a->y <= b->y + b->h && a->y + a->h >= b->y;
+}
+
+// ==================== СОЛВЕР ====================
+
+static inline void _MIR_ApplyContactImpulse(MIR_Body* A, MIR_Body* B, const MIR_Contact* c, MIR_Vec2 P) {
+    if (A->inv_mass > 0) {
+        A->velocity = MIR_Vec2_Subtract(A->velocity, MIR_Vec2_Multiply(P, A->inv_mass));
+        A->angular_velocity -= A->inv_inertia * _MIR_Cross(c->r1, P);
+    }
+    if (B->inv_mass > 0) {
+        B->velocity = MIR_Vec2_Add(B->velocity, MIR_Vec2_Multiply(P, B->inv_mass));
+        B->angular_velocity += B->inv_inertia * _MIR_Cross(c->r2, P);
+    }
+}
+
+static inline float _MIR_ContactVelocity(const MIR_Body* A, const MIR_Body* B,
+                                         const MIR_Contact* c, MIR_Vec2 axis) {
+    MIR_Vec2 dv = MIR_Vec2_Subtract(
+        MIR_Vec2_Add(B->velocity, _MIR_CrossSV(B->angular_velocity, c->r2)),
+        MIR_Vec2_Add(A->velocity, _MIR_CrossSV(A->angular_velocity, c->r1)));
+    return MIR_Vec2_Dot(dv, axis);
+}
+
+MIRULIT_API void MIR_Physics_Step(float dt);
+
+// Фиксированный шаг с накоплением времени кадра и синхронизация сущностей
+MIRULIT_API void MIR_UpdatePhysics(void);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+static void _MIR_Body_UpdateAABB(MIR_Body* body) {
+    if (body->shape == MIR_SHAPE_CIRCLE) {
+        float r = body->radius + MIR_PHYSICS_CONTACT_MARGIN;
+        body->aabb = (MIR_Rect){body->position.x - r, body->position.y - r, r * 2, r * 2};
+        return;
+    }
+
+    float c = fabsf(cosf(body->angle));
+    float s = fabsf(sinf(body->angle));
+    float ex = c * body->half_size.x + s * body->half_size.y + MIR_PHYSICS_CONTACT_MARGIN;
+    float ey = s * body->half_size.x + c * body->half_size.y + MIR_PHYSICS_CONTACT_MARGIN;
+    body->aabb = (MIR_Rect){body->position.x - ex, body->position.y - ey, ex * 2, ey * 2};
+}
+
+static void _MIR_Body_SetMass(MIR_Body* body, float density) {
+    if (body->type == MIR_BODY_STATIC || density <= 0) {
+        body->mass = body->inv_mass = 0;
+        body->inertia = body->inv_inertia = 0;
+        return;
+    }
+
+    if (body->shape == MIR_SHAPE_CIRCLE) {
+        body->mass = density * 3.14159265f * body->radius * body->radius;
+        body->inertia = 0.5f * body->mass * body->radius * body->radius;
+    } else {
+        float w = body->half_size.x * 2;
+        float h = body->half_size.y * 2;
+        body->mass = density * w * h;
+        body->inertia = body->mass * (w * w + h * h) / 12.0f;
+    }
+
+    body->inv_mass = 1.0f / body->mass;
+    body->inv_inertia = body->shape == MIR_SHAPE_AABB ? 0.0f : 1.0f / body->inertia;
+}
+
+MIRULIT_API bool MIR_Physics_Init(void) {
+    if (_mir_physics) return true;
+
+    _mir_physics = (MIR_PhysicsWorld*)MIR_Calloc(1, sizeof(MIR_PhysicsWorld), MIR_MEM_PHYSICS);
+    if (!_mir_physics) {
+        MIR_Log(MIR_LOG_ERROR, "Physics allocation failed");
+        return false;
+    }
+
+    _mir_physics->gravity = (MIR_Vec2){0, 980.0f};
+    _mir_physics->step_dt = 1.0f / MIRULIT_PHYSICS_HZ;
+    for (int i = 0; i < MIRULIT_MAX_ARBITERS * 2; i++) {
+        _mir_physics->hash[i] = -1;
+    }
+    return true;
+}
+
+MIRULIT_API void MIR_Physics_Shutdown(void) {
+    if (!_mir_physics) return;
+
+    for (int i = 0; i < _mir_physics->body_high; i++) {
+        MIR_Body* body = &_mir_physics->bodies[i];
+        if (body->used && body->entity) {
+            body->entity->body = NULL;
+        }
+    }
+    MIR_Free(_mir_physics);
+    _mir_physics = NULL;
+}
+
+MIRULIT_API void MIR_Physics_SetGravity(MIR_Vec2 gravity) {
+    if (MIR_Physics_Init()) _mir_physics->gravity = gravity;
+}
+
+MIRULIT_API MIR_PhysicsStats MIR_Physics_GetStats(void) {
+    MIR_PhysicsStats empty = {0};
+    return _mir_physics ? _mir_physics->stats : empty;
+}
+
+static void _MIR_Physics_RebuildAwakeList(void) {
+    MIR_PhysicsWorld* w = _mir_physics;
+    w->awake_count = 0;
+    for (int i = 0; i < w->body_high; i++) {
+        if (w->bodies[i].used && w->bodies[i].awake) {
+            w->awake[w->awake_count++] = i;
+        }
+    }
+}
+
+MIRULIT_API void MIR_Body_Wake(MIR_Body* body) {
+    if (!_mir_physics || !body || body->awake || body->type == MIR_BODY_STATIC) return;
+
+    MIR_PhysicsWorld* w = _mir_physics;
+    int start = (int)(body - w->bodies);
+    int i = start;
+    do {
+        MIR_Body* b = &w->bodies[i];
+        int next = b->sleep_next;
+        b->awake = true;
+        b->sleep_time = 0;
+        b->sleep_next = -1;
+        w->awake[w->awake_count++] = i;
+        i = next;
+    } while (i >= 0 && i != start);
+
+    w->inactive_dirty = true;
+}
+
+MIRULIT_API MIR_Body* MIR_AddBody(MIR_Entity* entity, MIR_BodyType type,
+                                  MIR_ShapeType shape, float density) {
+    if (!entity || entity->body || !MIR_Physics_Init()) return NULL;
+
+    MIR_PhysicsWorld* w = _mir_physics;
+    int index;
+    if (w->free_count > 0) {
+        index = w->free_list[--w->free_count];
+    } else if (w->body_high < MIRULIT_MAX_BODIES) {
+        index = w->body_high++;
+    } else {
+        return NULL;
+    }
+
+    MIR_Body* body = &w->bodies[index];
+    memset(body, 0, sizeof(*body));
+    body->entity = entity;
+    body->type = type;
+    body->shape = shape;
+    body->half_size = (MIR_Vec2){entity->transform.scale.x / 2, entity->transform.scale.y / 2};
+    body->radius = fminf(body->half_size.x, body->half_size.y);
+    body->position = entity->transform.position;
+    body->angle = shape == MIR_SHAPE_OBB ? entity->transform.rotation * 3.14159265f / 180.0f : 0.0f;
+    body->velocity = entity->transform.velocity;
+    body->restitution = 0.1f;
+    body->friction = 0.5f;
+    body->gravity_scale = 1.0f;
+    body->used = true;
+    body->sleep_next = -1;
+    _MIR_Body_SetMass(body, density);
+    _MIR_Body_UpdateAABB(body);
+
+    if (type == MIR_BODY_DYNAMIC) {
+        body->awake = true;
+        w->awake[w->awake_count++] = index;
+    }
+    w->inactive_dirty = true;
+    w->body_count++;
+
+    entity->body = body;
+    return body;
+}
+
+static void _MIR_Physics_RebuildHash(void) {
+    MIR_PhysicsWorld* w = _mir_physics;
+    const int size = MIRULIT_MAX_ARBITERS * 2;
+
+    for (int i = 0; i < size; i++) w->hash[i] = -1;
+    for (int i = 0; i < w->arbiter_count; i++) {
+        uint32_t key = (uint32_t)w->arbiters[i].a * 2654435761u ^ (uint32_t)w->arbiters[i].b * 40503u;
+        int slot = (int)(key % (uint32_t)size);
+        while (w->hash[slot] >= 0) slot = (slot + 1) % size;
+        w->hash[slot] = i;
+    }
+}
+
+MIRULIT_API void MIR_RemoveBody(MIR_Entity* entity) {
+    if (!_mir_physics || !entity || !entity->body) return;
+
+    MIR_PhysicsWorld* w = _mir_physics;
+    MIR_Body* body = entity->body;
+    int index = (int)(body - w->bodies);
+
+    // Соседи по спящему острову должны проснуться, иначе повиснут в воздухе
+    MIR_Body_Wake(body);
+
+    int kept = 0;
+    for (int i = 0; i < w->arbiter_count; i++) {
+        MIR_Arbiter* arb = &w->arbiters[i];
+        if (arb->a == index || arb->b == index) {
+            MIR_Body_Wake(&w->bodies[arb->a == index ? arb->b : arb->a]);
+            continue;
+        }
+        w->arbiters[kept++] = *arb;
+    }
+    w->arbiter_count = kept;
+    _MIR_Physics_RebuildHash();
+
+    body->used = false;
+    body->awake = false;
+    body->entity = NULL;
+    w->free_list[w->free_count++] = index;
+    w->body_count--;
+    w->inactive_dirty = true;
+    _MIR_Physics_RebuildAwakeList();
+
+    entity->body = NULL;
+}
+
+MIRULIT_API void MIR_Body_ApplyImpulse(MIR_Body* body, MIR_Vec2 impulse, MIR_Vec2 point) {
+    if (!body || body->type == MIR_BODY_STATIC) return;
+
+    MIR_Body_Wake(body);
+    body->velocity.x += impulse.x * body->inv_mass;
+    body->velocity.y += impulse.y * body->inv_mass;
+    body->angular_velocity += body->inv_inertia *
+        _MIR_Cross(MIR_Vec2_Subtract(point, body->position), impulse);
+}
+
+MIRULIT_API void MIR_Body_ApplyForce(MIR_Body* body, MIR_Vec2 force) {
+    if (!body || body->type == MIR_BODY_STATIC) return;
+
+    MIR_Body_Wake(body);
+    body->force = MIR_Vec2_Add(body->force, force);
+}
+
+MIRULIT_API void MIR_Body_SetPosition(MIR_Body* body, MIR_Vec2 position) {
+    if (!body) return;
+
+    body->position = position;
+    _MIR_Body_UpdateAABB(body);
+    if (body->type == MIR_BODY_STATIC) {
+        _mir_physics->inactive_dirty = true;
+    } else {
+        MIR_Body_Wake(body);
+    }
+}
+
+static int _MIR_ClipSegment(_MIR_ClipVertex out[2], const _MIR_ClipVertex in[2],
+                            MIR_Vec2 normal, float offset, int clip_edge) {
+    int count = 0;
+    float d0 = MIR_Vec2_Dot(normal, in[0].v) - offset;
+    float d1 = MIR_Vec2_Dot(normal, in[1].v) - offset;
+
+    if (d0 <= 0) out[count++] = in[0];
+    if (d1 <= 0) out[count++] = in[1];
+
+    if (d0 * d1 < 0) {
+        float t = d0 / (d0 - d1);
+        out[count].v.x = in[0].v.x + t * (in[1].v.x - in[0].v.x);
+        out[count].v.y = in[0].v.y + t * (in[1].v.y - in[0].v.y);
+        if (d0 > 0) {
+            uint32_t f = in[0].feature;
+            out[count].feature = (f & 0xFF00FF00u) | (uint32_t)clip_edge;
+        } else {
+            uint32_t f = in[1].feature;
+            out[count].feature = (f & 0x00FF00FFu) | ((uint32_t)clip_edge << 8);
+        }
+        count++;
+    }
+    return count;
+}
+
+static void _MIR_IncidentEdge(_MIR_ClipVertex c[2], MIR_Vec2 h, MIR_Vec2 pos,
+                              float cs, float sn, MIR_Vec2 normal) {
+    MIR_Vec2 n = _MIR_RotateT(normal, cs, sn);
+    n.x = -n.x;
+    n.y = -n.y;
+
+    if (fabsf(n.x) > fabsf(n.y)) {
+        if (n.x > 0) {
+            c[0].v = (MIR_Vec2){h.x, -h.y};
+            c[0].feature = MIR_FEATURE(0, 0, MIR_EDGE3, MIR_EDGE4);
+            c[1].v = (MIR_Vec2){h.x, h.y};
+            c[1].feature = MIR_FEATURE(0, 0, MIR_EDGE4, MIR_EDGE1);
+        } else {
+            c[0].v = (MIR_Vec2){-h.x, h.y};
+            c[0].feature = MIR_FEATURE(0, 0, MIR_EDGE1, MIR_EDGE2);
+            c[1].v = (MIR_Vec2){-h.x, -h.y};
+            c[1].feature = MIR_FEATURE(0, 0, MIR_EDGE2, MIR_EDGE3);
+        }
+    } else {
+        if (n.y > 0) {
+            c[0].v = (MIR_Vec2){h.x, h.y};
+            c[0].feature = MIR_FEATURE(0, 0, MIR_EDGE4, MIR_EDGE1);
+            c[1].v = (MIR_Vec2){-h.x, h.y};
+            c[1].feature = MIR_FEATURE(0, 0, MIR_EDGE1, MIR_EDGE2);
+        } else {
+            c[0].v = (MIR_Vec2){-h.x, -h.y};
+            c[0].feature = MIR_FEATURE(0, 0, MIR_EDGE2, MIR_EDGE3);
+            c[1].v = (MIR_Vec2){h.x, -h.y};
+            c[1].feature = MIR_FEATURE(0, 0, MIR_EDGE3, MIR_EDGE4);
+        }
+    }
+
+    c[0].v = MIR_Vec2_Add(pos, _MIR_Rotate(c[0].v, cs, sn));
+    c[1].v = MIR_Vec2_Add(pos, _MIR_Rotate(c[1].v, cs, sn));
+}
+
+// Прямоугольник-прямоугольник: SAT + отсечение инцидентного ребра
+static int _MIR_CollideBoxes(MIR_Contact* contacts, MIR_Vec2* normal_out,
+                             const MIR_Body* A, const MIR_Body* B) {
+    enum { FACE_A_X, FACE_A_Y, FACE_B_X, FACE_B_Y };
+
+    MIR_Vec2 hA = A->half_size, hB = B->half_size;
+    MIR_Vec2 pA = A->position, pB = B->position;
+    float cA = cosf(A->angle), sA = sinf(A->angle);
+    float cB = cosf(B->angle), sB = sinf(B->angle);
+
+    MIR_Vec2 a1 = {cA, sA}, a2 = {-sA, cA};
+    MIR_Vec2 b1 = {cB, sB}, b2 = {-sB, cB};
+
+    MIR_Vec2 dp = MIR_Vec2_Subtract(pB, pA);
+    MIR_Vec2 dA = _MIR_RotateT(dp, cA, sA);
+    MIR_Vec2 dB = _MIR_RotateT(dp, cB, sB);
+
+    // C = RotA^T * RotB
+    float c11 = fabsf(MIR_Vec2_Dot(a1, b1)), c12 = fabsf(MIR_Vec2_Dot(a1, b2));
+    float c21 = fabsf(MIR_Vec2_Dot(a2, b1)), c22 = fabsf(MIR_Vec2_Dot(a2, b2));
+
+    MIR_Vec2 faceA = {
+        fabsf(dA.x) - hA.x - (c11 * hB.x + c12 * hB.y),
+        fabsf(dA.y) - hA.y - (c21 * hB.x + c22 * hB.y)
+    };
+    if (faceA.x > MIR_PHYSICS_CONTACT_MARGIN || faceA.y > MIR_PHYSICS_CONTACT_MARGIN) return 0;
+
+    MIR_Vec2 faceB = {
+        fabsf(dB.x) - (c11 * hA.x + c21 * hA.y) - hB.x,
+        fabsf(dB.y) - (c12 * hA.x + c22 * hA.y) - hB.y
+    };
+    if (faceB.x > MIR_PHYSICS_CONTACT_MARGIN || faceB.y > MIR_PHYSICS_CONTACT_MARGIN) return 0;
+
+    // Выбор оси с предпочтением граней A для стабильности
+    const float relative_tol = 0.95f;
+    const float absolute_tol = 0.01f;
+
+    int axis = FACE_A_X;
+    float separation = faceA.x;
+    MIR_Vec2 normal = dA.x > 0 ? a1 : (MIR_Vec2){-a1.x, -a1.y};
+
+    if (faceA.y > relative_tol * separation + absolute_tol * hA.y) {
+        axis = FACE_A_Y;
+        separation = faceA.y;
+        normal = dA.y > 0 ? a2 : (MIR_Vec2){-a2.x, -a2.y};
+    }
+    if (faceB.x > relative_tol * separation + absolute_tol * hB.x) {
+        axis = FACE_B_X;
+        separation = faceB.x;
+        normal = dB.x > 0 ? b1 : (MIR_Vec2){-b1.x, -b1.y};
+    }
+    if (faceB.y > relative_tol * separation + absolute_tol * hB.y) {
+        axis = FACE_B_Y;
+        separation = faceB.y;
+        normal = dB.y > 0 ? b2 : (MIR_Vec2){-b2.x, -b2.y};
+    }
+
+    MIR_Vec2 front_normal, side_normal;
+    _MIR_ClipVertex incident[2];
+    float front, neg_side, pos_side, side;
+    int neg_edge, pos_edge;
+
+    switch (axis) {
+        case FACE_A_X:
+            front_normal = normal;
+            front = MIR_Vec2_Dot(pA, front_normal) + hA.x;
+            side_normal = a2;
+            side = MIR_Vec2_Dot(pA, side_normal);
+            neg_side = -side + hA.y;
+            pos_side = side + hA.y;
+            neg_edge = MIR_EDGE3;
+            pos_edge = MIR_EDGE1;
+            _MIR_IncidentEdge(incident, hB, pB, cB, sB, front_normal);
+            break;
+        case FACE_A_Y:
+            front_normal = normal;
+            front = MIR_Vec2_Dot(pA, front_normal) + hA.y;
+            side_normal = a1;
+            side = MIR_Vec2_Dot(pA, side_normal);
+            neg_side = -side + hA.x;
+            pos_side = side + hA.x;
+            neg_edge = MIR_EDGE2;
+            pos_edge = MIR_EDGE4;
+            _MIR_IncidentEdge(incident, hB, pB, cB, sB, front_normal);
+            break;
+        case FACE_B_X:
+            front_normal = (MIR_Vec2){-normal.x, -normal.y};
+            front = MIR_Vec2_Dot(pB, front_normal) + hB.x;
+            side_normal = b2;
+            side = MIR_Vec2_Dot(pB, side_normal);
+            neg_side = -side + hB.y;
+            pos_side = side + hB.y;
+            neg_edge = MIR_EDGE3;
+            pos_edge = MIR_EDGE1;
+            _MIR_IncidentEdge(incident, hA, pA, cA, sA, front_normal);
+            break;
+        default:
+            front_normal = (MIR_Vec2){-normal.x, -normal.y};
+            front = MIR_Vec2_Dot(pB, front_normal) + hB.y;
+            side_normal = b1;
+            side = MIR_Vec2_Dot(pB, side_normal);
+            neg_side = -side + hB.x;
+            pos_side = side + hB.x;
+            neg_edge = MIR_EDGE2;
+            pos_edge = MIR_EDGE4;
+            _MIR_IncidentEdge(incident, hA, pA, cA, sA, front_normal);
+            break;
+    }
+
+    _MIR_ClipVertex clip1[2], clip2[2];
+    if (_MIR_ClipSegment(clip1, incident, (MIR_Vec2){-side_normal.x, -side_normal.y},
+                         neg_side, neg_edge) < 2) return 0;
+    if (_MIR_ClipSegment(clip2, clip1, side_normal, pos_side, pos_edge) < 2) return 0;
+
+    int count = 0;
+    for (int i = 0; i < 2; i++) {
+        float sep = MIR_Vec2_Dot(front_normal, clip2[i].v) - front;
+        if (sep <= MIR_PHYSICS_CONTACT_MARGIN) {
+            contacts[count].separation = sep;
+            contacts[count].position = MIR_Vec2_Subtract(clip2[i].v,
+                                                         MIR_Vec2_Multiply(front_normal, sep));
+            contacts[count].feature = (axis == FACE_B_X || axis == FACE_B_Y) ?
+                                      _MIR_FeatureFlip(clip2[i].feature) : clip2[i].feature;
+            count++;
+        }
+    }
+
+    *normal_out = normal;
+    return count;
+}
+
+static int _MIR_CollideCircles(MIR_Contact* contacts, MIR_Vec2* normal_out,
+                               const MIR_Body* A, const MIR_Body* B) {
+    MIR_Vec2 d = MIR_Vec2_Subtract(B->position, A->position);
+    float dist_sq = MIR_Vec2_Dot(d, d);
+    float radii = A->radius + B->radius;
+    float reach = radii + MIR_PHYSICS_CONTACT_MARGIN;
+    if (dist_sq > reach * reach) return 0;
+
+    float dist = sqrtf(dist_sq);
+    MIR_Vec2 n = dist > 1e-6f ? MIR_Vec2_Multiply(d, 1.0f / dist) : (MIR_Vec2){0, 1};
+
+    MIR_Vec2 pa = MIR_Vec2_Add(A->position, MIR_Vec2_Multiply(n, A->radius));
+    MIR_Vec2 pb = MIR_Vec2_Subtract(B->position, MIR_Vec2_Multiply(n, B->radius));
+
+    contacts[0].position = MIR_Vec2_Multiply(MIR_Vec2_Add(pa, pb), 0.5f);
+    contacts[0].separation = dist - radii;
+    contacts[0].feature = 0;
+    *normal_out = n;
+    return 1;
+}
+
+// Прямоугольник (A) - круг (B)
+static int _MIR_CollideBoxCircle(MIR_Contact* contacts, MIR_Vec2* normal_out,
+                                 const MIR_Body* A, const MIR_Body* B) {
+    float cs = cosf(A->angle), sn = sinf(A->angle);
+    MIR_Vec2 h = A->half_size;
+    MIR_Vec2 local = _MIR_RotateT(MIR_Vec2_Subtract(B->position, A->position), cs, sn);
+
+    MIR_Vec2 closest = {
+        MIR_Math_Clamp(local.x, -h.x, h.x),
+        MIR_Math_Clamp(local.y, -h.y, h.y)
+    };
+
+    MIR_Vec2 n_local;
+    float separation;
+
+    if (closest.x == local.x && closest.y == local.y) {
+        // Центр круга внутри прямоугольника - выталкиваем через ближайшую грань
+        float dx = h.x - fabsf(local.x);
+        float dy = h.y - fabsf(local.y);
+        if (dx < dy) {
+            n_local = (MIR_Vec2){local.x > 0 ? 1.0f : -1.0f, 0};
+            closest.x = n_local.x * h.x;
+            separation = -dx - B->radius;
+        } else {
+            n_local = (MIR_Vec2){0, local.y > 0 ? 1.0f : -1.0f};
+            closest.y = n_local.y * h.y;
+            separation = -dy - B->radius;
+        }
+    } else {
+        MIR_Vec2 d = MIR_Vec2_Subtract(local, closest);
+        float dist = sqrtf(MIR_Vec2_Dot(d, d));
+        if (dist > B->radius + MIR_PHYSICS_CONTACT_MARGIN) return 0;
+        n_local = MIR_Vec2_Multiply(d, 1.0f / dist);
+        separation = dist - B->radius;
+    }
+
+    MIR_Vec2 n = _MIR_Rotate(n_local, cs, sn);
+    MIR_Vec2 pa = MIR_Vec2_Add(A->position, _MIR_Rotate(closest, cs, sn));
+    MIR_Vec2 pb = MIR_Vec2_Subtract(B->position, MIR_Vec2_Multiply(n, B->radius));
+
+    contacts[0].position = MIR_Vec2_Multiply(MIR_Vec2_Add(pa, pb), 0.5f);
+    contacts[0].separation = separation;
+    contacts[0].feature = 0;
+    *normal_out = n;
+    return 1;
+}
+
+static int _MIR_Collide(MIR_Contact* contacts, MIR_Vec2* normal,
+                        const MIR_Body* A, const MIR_Body* B) {
+    bool circle_a = A->shape == MIR_SHAPE_CIRCLE;
+    bool circle_b = B->shape == MIR_SHAPE_CIRCLE;
+
+    if (circle_a && circle_b) return _MIR_CollideCircles(contacts, normal, A, B);
+    if (!circle_a && !circle_b) return _MIR_CollideBoxes(contacts, normal, A, B);
+    if (!circle_a) return _MIR_CollideBoxCircle(contacts, normal, A, B);
+
+    int count = _MIR_CollideBoxCircle(contacts, normal, B, A);
+    normal->x = -normal->x;
+    normal->y = -normal->y;
+    return count;
+}
+
+static MIR_Arbiter* _MIR_Physics_FindArbiter(int a, int b, bool create) {
+    MIR_PhysicsWorld* w = _mir_physics;
+    const int size = MIRULIT_MAX_ARBITERS * 2;
+
+    uint32_t key = (uint32_t)a * 2654435761u ^ (uint32_t)b * 40503u;
+    int slot = (int)(key % (uint32_t)size);
+    while (w->hash[slot] >= 0) {
+        MIR_Arbiter* arb = &w->arbiters[w->hash[slot]];
+        if (arb->a == a && arb->b == b) return arb;
+        slot = (slot + 1) % size;
+    }
+
+    if (!create || w->arbiter_count >= MIRULIT_MAX_ARBITERS) return NULL;
+
+    MIR_Arbiter* arb = &w->arbiters[w->arbiter_count];
+    memset(arb, 0, sizeof(*arb));
+    arb->a = a;
+    arb->b = b;
+    w->hash[slot] = w->arbiter_count++;
+    return arb;
+}
+
+static void _MIR_Physics_CollidePair(int ia, int ib) {
+    MIR_PhysicsWorld* w = _mir_physics;
+    if (ia > ib) { int t = ia; ia = ib; ib = t; }
+
+    MIR_Body* A = &w->bodies[ia];
+    MIR_Body* B = &w->bodies[ib];
+    if (A->inv_mass == 0 && B->inv_mass == 0) return;
+
+    MIR_Contact fresh[2];
+    MIR_Vec2 normal;
+    int count = _MIR_Collide(fresh, &normal, A, B);
+
+    MIR_Arbiter* arb = _MIR_Physics_FindArbiter(ia, ib, count > 0);
+    if (!arb) return;
+
+    // Тёплый старт: переносим импульсы из совпавших по ребрам контактов.
+    // У коробок одинаковой ширины отсечение на краю грани меняет ребра
+    // от шага к шагу, поэтому запасной вариант - ближайшая старая точка.
+    for (int i = 0; i < count; i++) {
+        int match = -1;
+        float best = 1.0f;
+        fresh[i].Pn = fresh[i].Pt = 0;
+        for (int j = 0; j < arb->contact_count; j++) {
+            if (arb->contacts[j].feature == fresh[i].feature) {
+                match = j;
+                break;
+            }
+            MIR_Vec2 d = MIR_Vec2_Subtract(arb->contacts[j].position, fresh[i].position);
+            float dist_sq = MIR_Vec2_Dot(d, d);
+            if (dist_sq < best) {
+                best = dist_sq;
+                match = j;
+            }
+        }
+        if (match >= 0) {
+            fresh[i].Pn = arb->contacts[match].Pn;
+            fresh[i].Pt = arb->contacts[match].Pt;
+        }
+    }
+
+    for (int i = 0; i < count; i++) arb->contacts[i] = fresh[i];
+    arb->contact_count = count;
+    arb->normal = normal;
+    arb->friction = sqrtf(A->friction * B->friction);
+    arb->restitution = fmaxf(A->restitution, B->restitution);
+    arb->stamp = w->stamp;
+
+    if (count > 0) {
+        if (!A->awake) MIR_Body_Wake(A);
+        if (!B->awake) MIR_Body_Wake(B);
+    }
+}
+
+static int _MIR_CompareBodyX(const void* a, const void* b) {
+    float xa = _mir_physics->bodies[*(const int*)a].aabb.x;
+    float xb = _mir_physics->bodies[*(const int*)b].aabb.x;
+    return (xa > xb) - (xa < xb);
+}
+
+// Sweep-and-prune по оси X. Порядок бодрствующих тел сохраняется между
+// шагами, поэтому сортировка вставками почти линейна.
+static void _MIR_Physics_Broadphase(void) {
+    MIR_PhysicsWorld* w = _mir_physics;
+
+    if (w->inactive_dirty) {
+        w->inactive_count = 0;
+        w->big_count = 0;
+        for (int i = 0; i < w->body_high; i++) {
+            MIR_Body* body = &w->bodies[i];
+            if (!body->used || body->awake) continue;
+            if (body->aabb.w > MIR_PHYSICS_BIG_BODY) {
+                w->big[w->big_count++] = i;
+            } else {
+                w->inactive[w->inactive_count++] = i;
+            }
+        }
+        qsort(w->inactive, w->inactive_count, sizeof(int), _MIR_CompareBodyX);
+        w->inactive_dirty = false;
+    }
+
+    for (int i = 1; i < w->awake_count; i++) {
+        int key = w->awake[i];
+        float x = w->bodies[key].aabb.x;
+        int j = i - 1;
+        while (j >= 0 && w->bodies[w->awake[j]].aabb.x > x) {
+            w->awake[j + 1] = w->awake[j];
+            j--;
+        }
+        w->awake[j + 1] = key;
+    }
+
+    // Разбуженные по ходу тела попадут в списки со следующего шага
+    int awake_count = w->awake_count;
+    for (int i = 0; i < awake_count; i++) {
+        int ia = w->awake[i];
+        MIR_Rect box = w->bodies[ia].aabb;
+        float max_x = box.x + box.w;
+
+        for (int j = i + 1; j < awake_count; j++) {
+            int ib = w->awake[j];
+            if (w->bodies[ib].aabb.x > max_x) break;
+            if (_MIR_AABBOverlap(&box, &w->bodies[ib].aabb)) {
+                _MIR_Physics_CollidePair(ia, ib);
+            }
+        }
+
+        // Первое неактивное тело, которое может доставать до box
+        int lo = 0, hi = w->inactive_count;
+        float from = box.x - MIR_PHYSICS_BIG_BODY;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (w->bodies[w->inactive[mid]].aabb.x < from) lo = mid + 1;
+            else hi = mid;
+        }
+        for (int j = lo; j < w->inactive_count; j++) {
+            int ib = w->inactive[j];
+            if (w->bodies[ib].aabb.x > max_x) break;
+            if (_MIR_AABBOverlap(&box, &w->bodies[ib].aabb)) {
+                _MIR_Physics_CollidePair(ia, ib);
+            }
+        }
+
+        for (int j = 0; j < w->big_count; j++) {
+            int ib = w->big[j];
+            if (_MIR_AABBOverlap(&box, &w->bodies[ib].aabb)) {
+                _MIR_Physics_CollidePair(ia, ib);
+            }
+        }
+    }
+}
+
+// Удаляет разошедшиеся пары; контакты спящих тел сохраняются для тёплого старта
+static void _MIR_Physics_PruneArbiters(void) {
+    MIR_PhysicsWorld* w = _mir_physics;
+    int kept = 0;
+
+    for (int i = 0; i < w->arbiter_count; i++) {
+        MIR_Arbiter* arb = &w->arbiters[i];
+        bool resting = !w->bodies[arb->a].awake && !w->bodies[arb->b].awake;
+        if (arb->contact_count == 0) continue;
+        if (arb->stamp != w->stamp && !resting) continue;
+        if (kept != i) w->arbiters[kept] = *arb;
+        kept++;
+    }
+
+    if (kept != w->arbiter_count) {
+        w->arbiter_count = kept;
+        _MIR_Physics_RebuildHash();
+    }
+}
+
+static int _MIR_FindRoot(int* parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static void _MIR_Physics_BuildIslands(void) {
+    MIR_PhysicsWorld* w = _mir_physics;
+
+    for (int k = 0; k < w->awake_count; k++) {
+        int i = w->awake[k];
+        w->parent[i] = i;
+        w->island_of_root[i] = -1;
+    }
+
+    // Статика острова не связывает
+    for (int i = 0; i < w->arbiter_count; i++) {
+        MIR_Arbiter* arb = &w->arbiters[i];
+        MIR_Body* A = &w->bodies[arb->a];
+        MIR_Body* B = &w->bodies[arb->b];
+        if (!A->awake || !B->awake) continue;
+
+        int ra = _MIR_FindRoot(w->parent, arb->a);
+        int rb = _MIR_FindRoot(w->parent, arb->b);
+        if (ra != rb) w->parent[ra] = rb;
+    }
+
+    w->island_count = 0;
+    for (int k = 0; k < w->awake_count; k++) {
+        int i = w->awake[k];
+        int root = _MIR_FindRoot(w->parent, i);
+        if (w->island_of_root[root] < 0) {
+            MIR_Island* island = &w->islands[w->island_count];
+            memset(island, 0, sizeof(*island));
+            w->island_of_root[root] = w->island_count++;
+        }
+        w->bodies[i].island = w->island_of_root[root];
+        w->islands[w->bodies[i].island].body_count++;
+    }
+
+    for (int i = 0; i < w->arbiter_count; i++) {
+        MIR_Arbiter* arb = &w->arbiters[i];
+        MIR_Body* A = &w->bodies[arb->a];
+        MIR_Body* B = &w->bodies[arb->b];
+        if (A->awake) arb->island = A->island;
+        else if (B->awake) arb->island = B->island;
+        else { arb->island = -1; continue; }
+        w->islands[arb->island].arbiter_count++;
+    }
+
+    // Сортировка подсчетом: тела и контакты острова лежат подряд
+    int body_offset = 0, arbiter_offset = 0;
+    for (int i = 0; i < w->island_count; i++) {
+        w->islands[i].body_start = body_offset;
+        w->islands[i].arbiter_start = arbiter_offset;
+        body_offset += w->islands[i].body_count;
+        arbiter_offset += w->islands[i].arbiter_count;
+        w->islands[i].body_count = 0;
+        w->islands[i].arbiter_count = 0;
+    }
+    for (int k = 0; k < w->awake_count; k++) {
+        int i = w->awake[k];
+        MIR_Island* island = &w->islands[w->bodies[i].island];
+        w->island_bodies[island->body_start + island->body_count++] = i;
+    }
+    for (int i = 0; i < w->arbiter_count; i++) {
+        if (w->arbiters[i].island < 0) continue;
+        MIR_Island* island = &w->islands[w->arbiters[i].island];
+        w->island_arbiters[island->arbiter_start + island->arbiter_count++] = i;
+    }
+}
+
+static void _MIR_Arbiter_PreStep(MIR_Arbiter* arb, float inv_dt) {
+    MIR_Body* A = &_mir_physics->bodies[arb->a];
+    MIR_Body* B = &_mir_physics->bodies[arb->b];
+    MIR_Vec2 n = arb->normal;
+    MIR_Vec2 t = {n.y, -n.x};
+
+    for (int i = 0; i < arb->contact_count; i++) {
+        MIR_Contact* c = &arb->contacts[i];
+        c->r1 = MIR_Vec2_Subtract(c->position, A->position);
+        c->r2 = MIR_Vec2_Subtract(c->position, B->position);
+
+        float rn1 = MIR_Vec2_Dot(c->r1, n), rn2 = MIR_Vec2_Dot(c->r2, n);
+        float k_normal = A->inv_mass + B->inv_mass +
+            A->inv_inertia * (MIR_Vec2_Dot(c->r1, c->r1) - rn1 * rn1) +
+            B->inv_inertia * (MIR_Vec2_Dot(c->r2, c->r2) - rn2 * rn2);
+        c->mass_normal = 1.0f / k_normal;
+
+        float rt1 = MIR_Vec2_Dot(c->r1, t), rt2 = MIR_Vec2_Dot(c->r2, t);
+        float k_tangent = A->inv_mass + B->inv_mass +
+            A->inv_inertia * (MIR_Vec2_Dot(c->r1, c->r1) - rt1 * rt1) +
+            B->inv_inertia * (MIR_Vec2_Dot(c->r2, c->r2) - rt2 * rt2);
+        c->mass_tangent = 1.0f / k_tangent;
+
+        // Коррекция проникновения и отскок через целевую скорость.
+        // Контакт с зазором (в пределах запаса) разрешает сближение ровно на
+        // величину зазора: пара не рвется, и тёплый старт не теряется.
+        if (c->separation > 0) {
+            c->bias = -c->separation * inv_dt;
+        } else {
+            c->bias = -MIR_PHYSICS_BIAS_FACTOR * inv_dt *
+                      fminf(0.0f, c->separation + MIR_PHYSICS_ALLOWED_PENETRATION);
+        }
+
+        MIR_Vec2 dv = MIR_Vec2_Subtract(
+            MIR_Vec2_Add(B->velocity, _MIR_CrossSV(B->angular_velocity, c->r2)),
+            MIR_Vec2_Add(A->velocity, _MIR_CrossSV(A->angular_velocity, c->r1)));
+        float vn = MIR_Vec2_Dot(dv, n);
+        if (vn < -MIR_PHYSICS_RESTITUTION_THRESHOLD) {
+            c->bias = fmaxf(c->bias, -arb->restitution * vn);
+        }
+
+    }
+
+    // Матрица для совместного решения двух точек, если она обусловлена
+    arb->block = false;
+    if (arb->contact_count == 2) {
+        MIR_Contact* c1 = &arb->contacts[0];
+        MIR_Contact* c2 = &arb->contacts[1];
+        float rn1a = _MIR_Cross(c1->r1, n), rn1b = _MIR_Cross(c1->r2, n);
+        float rn2a = _MIR_Cross(c2->r1, n), rn2b = _MIR_Cross(c2->r2, n);
+        float m = A->inv_mass + B->inv_mass;
+
+        float k11 = m + A->inv_inertia * rn1a * rn1a + B->inv_inertia * rn1b * rn1b;
+        float k22 = m + A->inv_inertia * rn2a * rn2a + B->inv_inertia * rn2b * rn2b;
+        float k12 = m + A->inv_inertia * rn1a * rn2a + B->inv_inertia * rn1b * rn2b;
+        float det = k11 * k22 - k12 * k12;
+
+        if (k11 * k11 < 1000.0f * det) {
+            arb->block = true;
+            arb->k11 = k11;
+            arb->k12 = k12;
+            arb->k22 = k22;
+            arb->m11 = k22 / det;
+            arb->m12 = -k12 / det;
+            arb->m22 = k11 / det;
+        }
+    }
+}
+
+// Тёплый старт идёт после подготовки всех пар острова, иначе скорость
+// удара для отскока считалась бы по уже частично погашенным скоростям
+static void _MIR_Arbiter_WarmStart(MIR_Arbiter* arb) {
+    MIR_Body* A = &_mir_physics->bodies[arb->a];
+    MIR_Body* B = &_mir_physics->bodies[arb->b];
+    MIR_Vec2 n = arb->normal;
+    MIR_Vec2 t = {n.y, -n.x};
+
+    for (int i = 0; i < arb->contact_count; i++) {
+        MIR_Contact* c = &arb->contacts[i];
+        MIR_Vec2 P = MIR_Vec2_Add(MIR_Vec2_Multiply(n, c->Pn), MIR_Vec2_Multiply(t, c->Pt));
+        _MIR_ApplyContactImpulse(A, B, c, P);
+    }
+}
+
+// Статические тела не пишутся: острова могут делить одну статику между потоками
+// Две точки опоры решаются совместно (LCP 2x2 перебором случаев):
+// поочередное решение раскачивает стопки одинаковых ящиков
+static void _MIR_Arbiter_SolveBlock(MIR_Arbiter* arb, MIR_Body* A, MIR_Body* B) {
+    MIR_Contact* c1 = &arb->contacts[0];
+    MIR_Contact* c2 = &arb->contacts[1];
+    MIR_Vec2 n = arb->normal;
+
+    float ax = c1->Pn, ay = c2->Pn;
+    float bx = _MIR_ContactVelocity(A, B, c1, n) - c1->bias;
+    float by = _MIR_ContactVelocity(A, B, c2, n) - c2->bias;
+    bx -= arb->k11 * ax + arb->k12 * ay;
+    by -= arb->k12 * ax + arb->k22 * ay;
+
+    float xx, xy;
+    for (;;) {
+        // Обе точки в контакте
+        xx = -(arb->m11 * bx + arb->m12 * by);
+        xy = -(arb->m12 * bx + arb->m22 * by);
+        if (xx >= 0 && xy >= 0) break;
+
+        // Только первая
+        xx = -c1->mass_normal * bx;
+        xy = 0;
+        if (xx >= 0 && arb->k12 * xx + by >= 0) break;
+
+        // Только вторая
+        xx = 0;
+        xy = -c2->mass_normal * by;
+        if (xy >= 0 && arb->k12 * xy + bx >= 0) break;
+
+        // Ни одной
+        xx = xy = 0;
+        if (bx >= 0 && by >= 0) break;
+        return;
+    }
+
+    _MIR_ApplyContactImpulse(A, B, c1, MIR_Vec2_Multiply(n, xx - ax));
+    _MIR_ApplyContactImpulse(A, B, c2, MIR_Vec2_Multiply(n, xy - ay));
+    c1->Pn = xx;
+    c2->Pn = xy;
+}
+
+static void _MIR_Arbiter_ApplyImpulse(MIR_Arbiter* arb) {
+    MIR_Body* A = &_mir_physics->bodies[arb->a];
+    MIR_Body* B = &_mir_physics->bodies[arb->b];
+    MIR_Vec2 n = arb->normal;
+    MIR_Vec2 t = {n.y, -n.x};
+
+    // Трение первым: его предел зависит от нормального импульса прошлой итерации
+    for (int i = 0; i < arb->contact_count; i++) {
+        MIR_Contact* c = &arb->contacts[i];
+        float dPt = -c->mass_tangent * _MIR_ContactVelocity(A, B, c, t);
+        float max_pt = arb->friction * c->Pn;
+        float Pt0 = c->Pt;
+        c->Pt = MIR_Math_Clamp(Pt0 + dPt, -max_pt, max_pt);
+        _MIR_ApplyContactImpulse(A, B, c, MIR_Vec2_Multiply(t, c->Pt - Pt0));
+    }
+
+    if (arb->block) {
+        _MIR_Arbiter_SolveBlock(arb, A, B);
+        return;
+    }
+
+    for (int i = 0; i < arb->contact_count; i++) {
+        MIR_Contact* c = &arb->contacts[i];
+        float dPn = c->mass_normal * (-_MIR_ContactVelocity(A, B, c, n) + c->bias);
+        float Pn0 = c->Pn;
+        c->Pn = fmaxf(Pn0 + dPn, 0.0f);
+        _MIR_ApplyContactImpulse(A, B, c, MIR_Vec2_Multiply(n, c->Pn - Pn0));
+    }
+}
+
+static void _MIR_Physics_SolveIsland(MIR_Island* island, float dt) {
+    MIR_PhysicsWorld* w = _mir_physics;
+    const int* bodies = &w->island_bodies[island->body_start];
+    const int* arbiters = &w->island_arbiters[island->arbiter_start];
+    float inv_dt = 1.0f / dt;
+
+    for (int i = 0; i < island->body_count; i++) {
+        MIR_Body* b = &w->bodies[bodies[i]];
+        b->velocity.x += dt * (w->gravity.x * b->gravity_scale + b->inv_mass * b->force.x);
+        b->velocity.y += dt * (w->gravity.y * b->gravity_scale + b->inv_mass * b->force.y);
+        b->angular_velocity += dt * b->inv_inertia * b->torque;
+    }
+
+    for (int i = 0; i < island->arbiter_count; i++) {
+        _MIR_Arbiter_PreStep(&w->arbiters[arbiters[i]], inv_dt);
+    }
+    for (int i = 0; i < island->arbiter_count; i++) {
+        _MIR_Arbiter_WarmStart(&w->arbiters[arbiters[i]]);
+    }
+
+    for (int it = 0; it < MIRULIT_PHYSICS_ITERATIONS; it++) {
+        for (int i = 0; i < island->arbiter_count; i++) {
+            _MIR_Arbiter_ApplyImpulse(&w->arbiters[arbiters[i]]);
+        }
+    }
+
+    float min_sleep = 1e9f;
+    for (int i = 0; i < island->body_count; i++) {
+        MIR_Body* b = &w->bodies[bodies[i]];
+        b->position.x += dt * b->velocity.x;
+        b->position.y += dt * b->velocity.y;
+        b->angle += dt * b->angular_velocity;
+        b->force = (MIR_Vec2){0, 0};
+        b->torque = 0;
+        _MIR_Body_UpdateAABB(b);
+
+        if (MIR_Vec2_Dot(b->velocity, b->velocity) >
+                MIR_PHYSICS_SLEEP_LINEAR * MIR_PHYSICS_SLEEP_LINEAR ||
+            fabsf(b->angular_velocity) > MIR_PHYSICS_SLEEP_ANGULAR) {
+            b->sleep_time = 0;
+        } else {
+            b->sleep_time += dt;
+        }
+        min_sleep = fminf(min_sleep, b->sleep_time);
+    }
+
+    // Засыпание всего острова; тела связываются в кольцо для пробуждения
+    if (min_sleep >= MIR_PHYSICS_TIME_TO_SLEEP) {
+        for (int i = 0; i < island->body_count; i++) {
+            MIR_Body* b = &w->bodies[bodies[i]];
+            b->awake = false;
+            b->velocity = (MIR_Vec2){0, 0};
+            b->angular_velocity = 0;
+            b->sleep_next = bodies[(i + 1) % island->body_count];
+        }
+    }
+}
+
+static void _MIR_Physics_SolveIslands(void* data, int begin, int end) {
+    float dt = *(const float*)data;
+    for (int i = begin; i < end; i++) {
+        _MIR_Physics_SolveIsland(&_mir_physics->islands[i], dt);
+    }
+}
+
+// Перенос состояния тела в сущность
+static void _MIR_Physics_SyncEntity(const MIR_Body* body) {
+    MIR_Entity* entity = body->entity;
+    if (!entity) return;
+
+    entity->transform.position = body->position;
+    entity->transform.velocity = body->velocity;
+    entity->transform.rotation = body->angle * 180.0f / 3.14159265f;
+    entity->collider.bounds.x = body->position.x - entity->collider.bounds.w / 2;
+    entity->collider.bounds.y = body->position.y - entity->collider.bounds.h / 2;
+}
+
+MIRULIT_API void MIR_Physics_Step(float dt) {
+    if (!_mir_physics || dt <= 0) return;
+
+    MIR_PhysicsWorld* w = _mir_physics;
+    w->stamp++;
+
+    _MIR_Physics_Broadphase();
+    _MIR_Physics_PruneArbiters();
+    _MIR_Physics_BuildIslands();
+
+    MIR_Jobs_ParallelFor(w->island_count, 4, _MIR_Physics_SolveIslands, &dt);
+
+    // Уснувшие острова уходят из списка бодрствующих. MIR_UpdatePhysics
+    // переносит в сущности только бодрствующие тела, поэтому уснувшие
+    // получают последнее положение и нулевую скорость здесь.
+    int awake = 0;
+    for (int k = 0; k < w->awake_count; k++) {
+        MIR_Body* b = &w->bodies[w->awake[k]];
+        if (b->awake) {
+            w->awake[awake++] = w->awake[k];
+        } else {
+            _MIR_Physics_SyncEntity(b);
+        }
+    }
+    if (awake != w->awake_count) {
+        w->awake_count = awake;
+        w->inactive_dirty = true;
+    }
+
+    int contacts = 0;
+    for (int i = 0; i < w->arbiter_count; i++) {
+        contacts += w->arbiters[i].contact_count;
+    }
+    w->stats.bodies = w->body_count;
+    w->stats.awake_bodies = w->awake_count;
+    w->stats.islands = w->island_count;
+    w->stats.arbiters = w->arbiter_count;
+    w->stats.contacts = contacts;
+}
+
+MIRULIT_API void MIR_UpdatePhysics(void) {
+    if (!_mir_initialized || !_mir || _mir->world->paused || !_mir_physics) return;
+    MIR_PROFILE_BEGIN("UpdatePhysics");
+
+    MIR_PhysicsWorld* w = _mir_physics;
+    w->accumulator += _mir->world->delta_time * _mir->world->time_scale;
+
+    int steps = 0;
+    while (w->accumulator >= w->step_dt && steps < MIRULIT_PHYSICS_MAX_SUBSTEPS) {
+        MIR_Physics_Step(w->step_dt);
+        w->accumulator -= w->step_dt;
+        steps++;
+    }
+    if (steps == MIRULIT_PHYSICS_MAX_SUBSTEPS) {
+        w->accumulator = 0;
+    }
+
+    for (int k = 0; k < w->awake_count; k++) {
+        _MIR_Physics_SyncEntity(&w->bodies[w->awake[k]]);
+    }
+
+    MIR_PROFILE_END();
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_ENABLE_PHYSICS
+
+#endif // MIRULIT_PHYSICS_H
@@ -0,0 +1,313 @@
+#ifndef MIRULIT_PROFILER_H
+#define MIRULIT_PROFILER_H
+
+// ==================== ПРОФИЛИРОВЩИК ====================
+// Вложенные зоны MIR_PROFILE_BEGIN("Имя") ... MIR_PROFILE_END().
+// Каждый поток пишет в свое кольцо событий без блокировок: поток
+// единственный писатель, счетчик публикуется атомарно после записи.
+// Блокировка берется только при регистрации потока и при дампе.
+// MIR_Profile_Dump сохраняет кольца в формате Chrome trace
+// (chrome://tracing, Perfetto). Без MIRULIT_ENABLE_PROFILER макросы
+// пустые, а функции - заглушки.
+
+// Суммарное время зоны за кадр (для оверлея)
+typedef struct {
+    const char* name;
+    float ms;
+} MIR_ProfileZone;
+
+#ifdef MIRULIT_ENABLE_PROFILER
+
+#define MIRULIT_PROFILE_EVENTS 8192         // событий на поток
+#define MIRULIT_PROFILE_MAX_THREADS 32
+#define MIRULIT_PROFILE_MAX_DEPTH 32
+
+typedef struct {
+    const char* name;           // строковый литерал, не копируется
+    uint64_t start;             // нс, SDL_GetTicksNS
+    uint64_t end;
+    int depth;
+} _MIR_ProfileEvent;
+
+typedef struct {
+    const char* name;
+    int depth;
+    const char* open_names[MIRULIT_PROFILE_MAX_DEPTH];
+    uint64_t open_start[MIRULIT_PROFILE_MAX_DEPTH];
+
+    SDL_AtomicInt head;         // всего записано событий
+    _MIR_ProfileEvent events[MIRULIT_PROFILE_EVENTS];
+} _MIR_ProfileThread;
+
+MIRULIT_SHARED _MIR_ProfileThread* _mir_profile_threads[MIRULIT_PROFILE_MAX_THREADS];
+MIRULIT_SHARED SDL_AtomicInt _mir_profile_thread_count;
+MIRULIT_SHARED SDL_SpinLock _mir_profile_lock;     // список потоков
+MIRULIT_SHARED SDL_TLSID _mir_profile_tls;
+
+MIRULIT_SHARED float _mir_profile_spike_ms;
+MIRULIT_SHARED char _mir_profile_spike_path[256];
+
+MIRULIT_API void _MIR_Profile_Begin(const char* name);
+
+MIRULIT_API void _MIR_Profile_End(void);
+
+// Граница кадра: зона "Frame" на весь кадр и проверка на всплеск
+MIRULIT_API void _MIR_Profile_Frame(uint64_t start, uint64_t end);
+
+MIRULIT_API void MIR_Profile_SetThreadName(const char* name);
+
+// Автоматический дамп при кадре длиннее threshold_ms. Срабатывает один
+// раз, затем его нужно взвести снова. threshold_ms <= 0 - выключить.
+MIRULIT_API void MIR_Profile_SetSpikeDump(float threshold_ms, const char* path);
+
+// Зоны верхнего уровня последнего завершенного кадра текущего потока.
+// Одноименные зоны суммируются. Возвращает число зон.
+MIRULIT_API int MIR_Profile_GetFrameZones(MIR_ProfileZone* zones, int max_zones);
+
+// Запись колец в Chrome trace JSON. Незакрытые зоны не попадают в файл.
+MIRULIT_API bool MIR_Profile_Dump(const char* path);
+
+// Вызывается последней: после остановки рабочих потоков и уничтожения
+// мира, иначе зона в on_destroy создаст кольцо заново
+MIRULIT_API void MIR_Profile_Shutdown(void);
+
+#define MIR_PROFILE_BEGIN(name) _MIR_Profile_Begin(name)
+#define MIR_PROFILE_END() _MIR_Profile_End()
+#define MIR_PROFILE_FRAME(start, end) _MIR_Profile_Frame(start, end)
+#define MIR_PROFILE_THREAD(name) MIR_Profile_SetThreadName(name)
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+// Зоны "Frame" узнаются по адресу имени - он общий с модулем игры
+#ifdef MIRULIT_HOT_MODULE
+extern const char _mir_profile_frame_name[];
+#else
+MIRULIT_SHARED const char _mir_profile_frame_name[] = "Frame";
+#endif
+
+// Кольцо текущего потока; создается при первой зоне
+static _MIR_ProfileThread* _MIR_Profile_GetThread(void) {
+    _MIR_ProfileThread* thread = (_MIR_ProfileThread*)SDL_GetTLS(&_mir_profile_tls);
+    if (thread) return thread;
+
+    if (SDL_GetAtomicInt(&_mir_profile_thread_count) >= MIRULIT_PROFILE_MAX_THREADS) return NULL;
+
+    thread = (_MIR_ProfileThread*)MIR_Calloc(1, sizeof(_MIR_ProfileThread), MIR_MEM_DEBUG);
+    if (!thread) return NULL;
+    thread->name = "Thread";
+
+    // Кольцо попадает в список до того, как дамп увидит новый счетчик
+    SDL_LockSpinlock(&_mir_profile_lock);
+    int index = SDL_GetAtomicInt(&_mir_profile_thread_count);
+    if (index < MIRULIT_PROFILE_MAX_THREADS) {
+        _mir_profile_threads[index] = thread;
+        SDL_SetAtomicInt(&_mir_profile_thread_count, index + 1);
+    }
+    SDL_UnlockSpinlock(&_mir_profile_lock);
+
+    if (index >= MIRULIT_PROFILE_MAX_THREADS) {
+        MIR_Free(thread);
+        return NULL;
+    }
+    SDL_SetTLS(&_mir_profile_tls, thread, NULL);
+    return thread;
+}
+
+static void _MIR_Profile_Record(_MIR_ProfileThread* thread, const char* name,
+                                uint64_t start, uint64_t end, int depth) {
+    int head = SDL_GetAtomicInt(&thread->head);
+    _MIR_ProfileEvent* event = &thread->events[head % MIRULIT_PROFILE_EVENTS];
+    event->name = name;
+    event->start = start;
+    event->end = end;
+    event->depth = depth;
+    SDL_SetAtomicInt(&thread->head, head + 1);
+}
+
+MIRULIT_API void _MIR_Profile_Begin(const char* name) {
+    _MIR_ProfileThread* thread = _MIR_Profile_GetThread();
+    if (!thread) return;
+
+    if (thread->depth < MIRULIT_PROFILE_MAX_DEPTH) {
+        thread->open_names[thread->depth] = name;
+        thread->open_start[thread->depth] = SDL_GetTicksNS();
+    }
+    thread->depth++;
+}
+
+MIRULIT_API void _MIR_Profile_End(void) {
+    _MIR_ProfileThread* thread = _MIR_Profile_GetThread();
+    if (!thread || thread->depth == 0) return;
+
+    thread->depth--;
+    if (thread->depth < MIRULIT_PROFILE_MAX_DEPTH) {
+        _MIR_Profile_Record(thread, thread->open_names[thread->depth],
+                            thread->open_start[thread->depth], SDL_GetTicksNS(), thread->depth);
+    }
+}
+
+MIRULIT_API void _MIR_Profile_Frame(uint64_t start, uint64_t end) {
+    _MIR_ProfileThread* thread = _MIR_Profile_GetThread();
+    if (!thread) return;
+
+    _MIR_Profile_Record(thread, _mir_profile_frame_name, start, end, 0);
+
+    if (_mir_profile_spike_ms > 0 && (end - start) > (uint64_t)(_mir_profile_spike_ms * 1e6f)) {
+        MIR_Log(MIR_LOG_WARN, "Frame spike %.2f ms, trace saved to %s",
+                (end - start) / 1e6f, _mir_profile_spike_path);
+        _mir_profile_spike_ms = 0.0f;   // один дамп на взвод
+        MIR_Profile_Dump(_mir_profile_spike_path);
+    }
+}
+
+MIRULIT_API void MIR_Profile_SetThreadName(const char* name) {
+    _MIR_ProfileThread* thread = _MIR_Profile_GetThread();
+    if (thread) thread->name = name;
+}
+
+MIRULIT_API void MIR_Profile_SetSpikeDump(float threshold_ms, const char* path) {
+    _mir_profile_spike_ms = threshold_ms;
+    if (path) {
+        strncpy(_mir_profile_spike_path, path, sizeof(_mir_profile_spike_path) - 1);
+    }
+}
+
+MIRULIT_API int MIR_Profile_GetFrameZones(MIR_ProfileZone* zones, int max_zones) {
+    _MIR_ProfileThread* thread = _MIR_Profile_GetThread();
+    if (!thread || !zones) return 0;
+
+    int head = SDL_GetAtomicInt(&thread->head);
+    int oldest = head > MIRULIT_PROFILE_EVENTS ? head - MIRULIT_PROFILE_EVENTS : 0;
+
+    int frame = head - 1;
+    while (frame >= oldest && thread->events[frame % MIRULIT_PROFILE_EVENTS].name != _mir_profile_frame_name) {
+        frame--;
+    }
+    if (frame < oldest) return 0;
+
+    // События кадра записаны перед его зоной "Frame"
+    uint64_t frame_start = thread->events[frame % MIRULIT_PROFILE_EVENTS].start;
+    int begin = frame;
+    while (begin > oldest && thread->events[(begin - 1) % MIRULIT_PROFILE_EVENTS].start >= frame_start) {
+        begin--;
+    }
+
+    int count = 0;
+    for (int i = begin; i < frame; i++) {
+        const _MIR_ProfileEvent* event = &thread->events[i % MIRULIT_PROFILE_EVENTS];
+        if (event->depth != 0) continue;
+
+        float ms = (event->end - event->start) / 1e6f;
+        int z = 0;
+        while (z < count && strcmp(zones[z].name, event->name) != 0) z++;
+        if (z < count) {
+            zones[z].ms += ms;
+        } else if (count < max_zones) {
+            zones[count].name = event->name;
+            zones[count].ms = ms;
+            count++;
+        }
+    }
+    return count;
+}
+
+MIRULIT_API bool MIR_Profile_Dump(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        MIR_Log(MIR_LOG_ERROR, "Failed to open trace file: %s", path);
+        return false;
+    }
+
+    // Рабочие потоки пишут в кольца во время дампа. Кольцо копируется, и
+    // из копии берутся только события, слоты которых писатель не начал
+    // перезаписывать до конца копирования (head прочитан повторно).
+    _MIR_ProfileEvent* events = (_MIR_ProfileEvent*)MIR_Alloc(
+        sizeof(_MIR_ProfileEvent) * MIRULIT_PROFILE_EVENTS, MIR_MEM_DEBUG);
+    if (!events) {
+        fclose(file);
+        return false;
+    }
+
+    _MIR_ProfileThread* threads[MIRULIT_PROFILE_MAX_THREADS];
+    SDL_LockSpinlock(&_mir_profile_lock);
+    int thread_count = SDL_GetAtomicInt(&_mir_profile_thread_count);
+    memcpy(threads, _mir_profile_threads, sizeof(threads[0]) * thread_count);
+    SDL_UnlockSpinlock(&_mir_profile_lock);
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+
+    for (int t = 0; t < thread_count; t++) {
+        _MIR_ProfileThread* thread = threads[t];
+        if (!thread) continue;
+
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                "\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", t, thread->name);
+        first = false;
+
+        int head = SDL_GetAtomicInt(&thread->head);
+        int begin = head > MIRULIT_PROFILE_EVENTS ? head - MIRULIT_PROFILE_EVENTS : 0;
+        for (int i = begin; i < head; i++) {
+            events[i % MIRULIT_PROFILE_EVENTS] = thread->events[i % MIRULIT_PROFILE_EVENTS];
+        }
+        // Писатель с head = h пишет слот события h - MIRULIT_PROFILE_EVENTS
+        int written = SDL_GetAtomicInt(&thread->head);
+        if (written - MIRULIT_PROFILE_EVENTS + 1 > begin) {
+            begin = written - MIRULIT_PROFILE_EVENTS + 1;
+        }
+
+        for (int i = begin; i < head; i++) {
+            _MIR_ProfileEvent event = events[i % MIRULIT_PROFILE_EVENTS];
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                    "\"ts\":%.3f,\"dur\":%.3f}",
+                    event.name, t, event.start / 1000.0, (event.end - event.start) / 1000.0);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    MIR_Free(events);
+    return true;
+}
+
+MIRULIT_API void MIR_Profile_Shutdown(void) {
+    SDL_LockSpinlock(&_mir_profile_lock);
+    int thread_count = SDL_GetAtomicInt(&_mir_profile_thread_count);
+    for (int t = 0; t < thread_count; t++) {
+        MIR_Free(_mir_profile_threads[t]);
+        _mir_profile_threads[t] = NULL;
+    }
+    SDL_SetAtomicInt(&_mir_profile_thread_count, 0);
+    SDL_UnlockSpinlock(&_mir_profile_lock);
+    SDL_SetTLS(&_mir_profile_tls, NULL, NULL);
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#else
+
+#define MIR_PROFILE_BEGIN(name) ((void)0)
+#define MIR_PROFILE_END() ((void)0)
+#define MIR_PROFILE_FRAME(start, end) ((void)0)
+#define MIR_PROFILE_THREAD(name) ((void)0)
+
+static inline void MIR_Profile_SetSpikeDump(float threshold_ms, const char* path) {
+    (void)threshold_ms;
+    (void)path;
+}
+
+static inline bool MIR_Profile_Dump(const char* path) {
+    (void)path;
+    return false;
+}
+
+static inline int MIR_Profile_GetFrameZones(MIR_ProfileZone* zones, int max_zones) {
+    (void)zones;
+    (void)max_zones;
+    return 0;
+}
+
+#endif // MIRULIT_ENABLE_PROFILER
+
+#endif // MIRULIT_PROFILER_H
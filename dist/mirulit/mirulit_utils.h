@@ -7,7 +7,7 @@ static inline float MIR_GetDeltaTime(void) {
 
 static inline float MIR_GetTime(void) {
     return _mir_initialized && _mir ? 
-           (SDL_GetTicks() - _mir->start_time) / 1000.0f : 0.0f;
+           (SDL_GetTicksNS() - _mir->start_time) / 1e9f : 0.0f;
 }
 
 static inline int MIR_GetFPS(void) {
@@ -0,0 +1,272 @@
+#ifndef MIRULIT_WORLD_H
+#define MIRULIT_WORLD_H
+
+// ==================== МИР ====================
+// MIR_World - независимое состояние симуляции: сущности, частицы,
+// камера, время и пулы памяти. Окно и рендерер ему не нужны, поэтому
+// мир можно создать без MIR_Init (серверы матчей, обучение ботов).
+//
+// MIR_Init создает мир по умолчанию (MIR_GetWorld), и глобальные
+// функции (MIR_CreateEntity, MIR_UpdateEntities, ...) работают с ним.
+// Функции MIR_World_* принимают мир явно. Разные миры не делят
+// изменяемых данных, поэтому MIR_World_StepParallel шагает их
+// одновременно на рабочих потоках.
+//
+// Физика (MIR_ENABLE_PHYSICS) и отрисовка остаются у мира по умолчанию.
+
+// Частица
+typedef struct {
+    MIR_Vec2 position;
+    MIR_Vec2 velocity;
+    MIR_Vec2 acceleration;
+    MIR_Color color;
+    float size;
+    float life;
+    float max_life;
+    bool active;
+} MIR_Particle;
+
+// Камера
+typedef struct {
+    MIR_Vec2 position;
+    float zoom;
+    float rotation;             // градусы
+    MIR_Vec2 target;
+    float smooth_speed;
+    MIR_Rect bounds;
+} MIR_Camera;
+
+struct MIR_World {
+    // Сущности
+    MIR_Entity* entities[MIRULIT_MAX_ENTITIES];
+    int entity_count;
+    int next_id;
+    uint32_t entity_changes;    // счетчик созданий и уничтожений
+
+    // Частицы
+    MIR_Particle particles[MIRULIT_MAX_PARTICLES];
+    int particle_count;
+
+    MIR_Camera camera;
+
+    // Время симуляции
+    float delta_time;
+    float time_scale;
+    bool paused;
+    double time;                // секунд симуляции с создания
+    uint64_t steps;             // вызовов MIR_World_Step
+
+    // Шаг мира: логика игры перед обновлением сущностей
+    void (*on_step)(MIR_World* world, float dt);
+    bool collisions;            // MIR_World_Step вызывает MIR_World_ResolveCollisions
+
+    // Случайные числа мира (частицы) - повторяемы при одном seed
+    MIR_Rng rng;
+
+    // Пулы сущностей (горячие и холодные части отдельно) и компонентов
+    // (классы по 32, 64, 128, 256 байт)
+    MIR_Pool entity_pool;
+    MIR_Pool entity_cold_pool;
+    MIR_Pool component_pools[MIRULIT_COMPONENT_CLASSES];
+
+    // Границы коллайдеров и снимок сущностей для пакетной проверки
+    // (при первой проверке)
+    struct MIR_BoundsSoA* bounds;
+    struct _MIR_CollisionSnapshot* collision;
+
+    // Статистика
+    int update_calls;
+
+    void* user_data;
+
+    // Список живых миров (MIR_Hot_RebindWorlds)
+    struct MIR_World* next_world;
+};
+
+MIRULIT_SHARED MIR_World* _mir_worlds;
+MIRULIT_SHARED SDL_SpinLock _mir_worlds_lock;
+
+// ==================== СОЗДАНИЕ И УДАЛЕНИЕ ====================
+
+// Seed берется из MIR_Rng_Thread: после MIR_Random_Seed миры,
+// созданные в одном порядке, получают одинаковые последовательности.
+MIRULIT_API MIR_World* MIR_World_Create(void);
+
+// Все сущности мира уничтожаются (on_destroy вызывается), пулы
+// освобождаются целиком.
+MIRULIT_API void MIR_World_Destroy(MIR_World* world);
+
+MIRULIT_API void MIR_World_Seed(MIR_World* world, uint64_t seed);
+
+// ==================== ШАГ МИРА ====================
+
+// Один шаг: on_step, сущности, коллизии (если collisions), частицы.
+// Не трогает окно и рендерер - можно вызывать из рабочего потока.
+MIRULIT_API void MIR_World_Step(MIR_World* world, float dt);
+
+typedef struct {
+    MIR_World** worlds;
+    float dt;
+} _MIR_WorldBatch;
+
+// Шаг count миров на рабочих потоках MIR_Jobs; возвращается, когда все
+// миры сделали шаг. Без MIR_Init рабочие потоки запускает MIR_Jobs_Init,
+// иначе миры шагают по очереди в вызывающем потоке. Обработчики не
+// должны трогать чужие миры и мир по умолчанию.
+MIRULIT_API void MIR_World_StepParallel(MIR_World** worlds, int count, float dt);
+
+// ==================== РЕАЛИЗАЦИЯ ====================
+#ifdef MIRULIT_DEFINE_ENGINE
+
+// ==================== КОМПОНЕНТЫ ====================
+// Заголовок перед компонентом хранит класс пула; крупные компоненты
+// (класс MIRULIT_COMPONENT_CLASSES) берутся из кучи.
+
+static void* _MIR_Component_Alloc(MIR_World* world, size_t size) {
+    int size_class = 0;
+    while (size_class < MIRULIT_COMPONENT_CLASSES &&
+           size + 16 > ((size_t)32 << size_class)) {
+        size_class++;
+    }
+
+    unsigned char* block = size_class < MIRULIT_COMPONENT_CLASSES ?
+        (unsigned char*)MIR_Pool_Alloc(&world->component_pools[size_class]) :
+        (unsigned char*)MIR_Alloc(size + 16, MIR_MEM_COMPONENT);
+    if (!block) return NULL;
+
+    memset(block, 0, size + 16);
+    *(int*)block = size_class;
+    return block + 16;
+}
+
+static void _MIR_Component_Free(MIR_World* world, void* component) {
+    if (!component) return;
+    unsigned char* block = (unsigned char*)component - 16;
+    int size_class = *(int*)block;
+    if (size_class < MIRULIT_COMPONENT_CLASSES) {
+        MIR_Pool_Free(&world->component_pools[size_class], block);
+    } else {
+        MIR_Free(block);
+    }
+}
+
+MIRULIT_API MIR_World* MIR_World_Create(void) {
+    MIR_World* world = (MIR_World*)MIR_Calloc(1, sizeof(MIR_World), MIR_MEM_CORE);
+    if (!world) {
+        MIR_Log(MIR_LOG_ERROR, "World allocation failed");
+        return NULL;
+    }
+
+    world->next_id = 1;
+    world->delta_time = 0.016f;
+    world->time_scale = 1.0f;
+    world->collisions = true;
+
+    world->camera.position = (MIR_Vec2){0, 0};
+    world->camera.zoom = 1.0f;
+    world->camera.rotation = 0.0f;
+    world->camera.smooth_speed = 5.0f;
+    world->camera.bounds = (MIR_Rect){-1000, -1000, 2000, 2000};
+
+    MIR_Rng* seed = MIR_Rng_Thread();
+    MIR_Rng_Seed(&world->rng, ((uint64_t)MIR_Rng_Next(seed) << 32) | MIR_Rng_Next(seed));
+
+    MIR_Pool_Init(&world->entity_pool, sizeof(MIR_Entity), 256, MIR_MEM_ENTITY);
+    MIR_Pool_Init(&world->entity_cold_pool, sizeof(MIR_EntityCold), 64, MIR_MEM_ENTITY);
+    for (int i = 0; i < MIRULIT_COMPONENT_CLASSES; i++) {
+        MIR_Pool_Init(&world->component_pools[i], (size_t)32 << i, 64, MIR_MEM_COMPONENT);
+    }
+
+    SDL_LockSpinlock(&_mir_worlds_lock);
+    world->next_world = _mir_worlds;
+    _mir_worlds = world;
+    SDL_UnlockSpinlock(&_mir_worlds_lock);
+    return world;
+}
+
+MIRULIT_API void MIR_World_Destroy(MIR_World* world) {
+    if (!world) return;
+
+    SDL_LockSpinlock(&_mir_worlds_lock);
+    for (MIR_World** link = &_mir_worlds; *link; link = &(*link)->next_world) {
+        if (*link == world) {
+            *link = world->next_world;
+            break;
+        }
+    }
+    SDL_UnlockSpinlock(&_mir_worlds_lock);
+
+    for (int i = 0; i < world->entity_count; i++) {
+        MIR_Entity* entity = world->entities[i];
+        if (!entity) continue;
+
+        MIR_EntityCold* cold = entity->cold;
+        if (cold->on_destroy) {
+            cold->on_destroy(entity);
+        }
+
+        // Освобождение компонентов
+        for (int j = 0; j < cold->component_count; j++) {
+            _MIR_Component_Free(world, cold->components[j]);
+        }
+
+        // Освобождение текстуры
+        if (entity->sprite.texture) {
+            SDL_DestroyTexture(entity->sprite.texture);
+        }
+    }
+
+    MIR_Pool_Destroy(&world->entity_pool);
+    MIR_Pool_Destroy(&world->entity_cold_pool);
+    for (int i = 0; i < MIRULIT_COMPONENT_CLASSES; i++) {
+        MIR_Pool_Destroy(&world->component_pools[i]);
+    }
+    MIR_Free(world->bounds);
+    MIR_Free(world->collision);
+    MIR_Free(world);
+}
+
+MIRULIT_API void MIR_World_Seed(MIR_World* world, uint64_t seed) {
+    if (world) MIR_Rng_Seed(&world->rng, seed);
+}
+
+MIRULIT_API void MIR_World_Step(MIR_World* world, float dt) {
+    if (!world) return;
+    world->delta_time = dt;
+    if (world->paused) return;
+
+    if (world->on_step) {
+        world->on_step(world, dt * world->time_scale);
+    }
+    MIR_World_UpdateEntities(world);
+    if (world->collisions) {
+        MIR_World_ResolveCollisions(world);
+    }
+    MIR_World_UpdateParticles(world);
+
+    world->time += dt * world->time_scale;
+    world->steps++;
+}
+
+static void _MIR_World_StepRange(void* data, int begin, int end) {
+    _MIR_WorldBatch* batch = (_MIR_WorldBatch*)data;
+    for (int i = begin; i < end; i++) {
+        MIR_PROFILE_BEGIN("WorldStep");
+        MIR_World_Step(batch->worlds[i], batch->dt);
+        MIR_PROFILE_END();
+    }
+}
+
+MIRULIT_API void MIR_World_StepParallel(MIR_World** worlds, int count, float dt) {
+    if (!worlds || count <= 0) return;
+    MIR_PROFILE_BEGIN("StepWorlds");
+
+    _MIR_WorldBatch batch = { worlds, dt };
+    MIR_Jobs_ParallelFor(count, 1, _MIR_World_StepRange, &batch);
+
+    MIR_PROFILE_END();
+}
+
+#endif // MIRULIT_DEFINE_ENGINE
+
+#endif // MIRULIT_WORLD_H
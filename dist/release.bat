@@ -0,0 +1,4 @@
+@echo off
+windres app.rc -o app.o
+compiler.exe --release --pgo config.c -l opengl32 -l gdi32 -l SDL3 -l SDL3_ttf -o bin/game.exe
+pause
\ No newline at end of file
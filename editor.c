@@ -6,16 +6,36 @@
 
 #ifdef _WIN32
     #include <direct.h>
+    #include <io.h>
     #include <windows.h>
     #define mkdir(path, mode) _mkdir(path)
-    #define popen _popen
-    #define pclose _pclose
+    #define dup _dup
+    #define dup2 _dup2
+    #define close _close
+    #define fileno _fileno
+    #define getpid() ((int)GetCurrentProcessId())
 #else
     #include <unistd.h>
     #include <errno.h>
     #include <dirent.h>
+    #include <sys/wait.h>
+    #include <poll.h>
+    #ifdef __linux__
+        #include <sys/inotify.h>
+    #endif
 #endif
 
+// Версия формата кэша объектов: смена инвалидирует все записи
+#define BUILD_CACHE_VERSION "mirulit-cache-1"
+
+// Версия формата файлов зависимостей <объект>.d
+#define BUILD_DEPS_VERSION "mirulit-deps-1"
+
+// Результат компиляции одного файла (код выхода --compile-object)
+#define COMPILE_OK 0
+#define COMPILE_FAILED 1
+#define COMPILE_CACHED 2
+
 // Структура для хранения списка файлов
 typedef struct {
     char** files;
@@ -150,117 +170,2133 @@ void ensure_directory(const char* path) {
     }
 }
 
-// Функция для добавления ВСЕХ библиотек из папки lib
-void add_all_library_files(TCCState* tcc, const char* lib_dir, int verbose) {
-    if (verbose) printf("Looking for libraries in: %s\n", lib_dir);
-    
-    if (!file_exists(lib_dir)) {
-        if (verbose) printf("  Directory does not exist\n");
-        return;
-    }
-    
-    // Создаем команду для поиска файлов библиотек
-    char find_cmd[512];
-    
+// Добавление системных библиотек
+void add_system_libraries(TCCState* tcc, int verbose) {
+    if (verbose) printf("Adding system libraries\n");
+    
+    #ifdef _WIN32
+        tcc_add_library(tcc, "kernel32");
+        tcc_add_library(tcc, "user32");
+        tcc_add_library(tcc, "gdi32");
+        tcc_add_library(tcc, "opengl32");
+        tcc_add_library(tcc, "winmm");
+        tcc_add_library(tcc, "ws2_32");
+    #else
+        tcc_add_library(tcc, "m");
+        tcc_add_library(tcc, "dl");
+        tcc_add_library(tcc, "pthread");
+        tcc_add_library(tcc, "GL");
+        tcc_add_library(tcc, "X11");
+        
+        if (file_exists("/usr/lib/libglfw.so") || 
+            file_exists("/usr/local/lib/libglfw.so") ||
+            file_exists("/usr/lib/x86_64-linux-gnu/libglfw.so") ||
+            file_exists("lib/libglfw.a") ||
+            file_exists("lib/libglfw.so")) {
+            if (verbose) printf("  Adding: glfw\n");
+            tcc_add_library(tcc, "glfw");
+        }
+        
+        #ifdef __APPLE__
+            tcc_add_library(tcc, "objc");
+            tcc_add_library(tcc, "Cocoa");
+            tcc_add_library(tcc, "IOKit");
+            tcc_add_library(tcc, "CoreFoundation");
+            tcc_add_library(tcc, "CoreVideo");
+        #endif
+    #endif
+}
+
+// Стандартные и пользовательские пути include
+void add_include_paths(TCCState* tcc, char** include_paths, int include_count, int verbose) {
+    tcc_add_include_path(tcc, "include");
+    tcc_add_include_path(tcc, ".");
+    tcc_add_include_path(tcc, "src");
+    tcc_add_include_path(tcc, "mirulit");
+    
+    for (int i = 0; i < include_count; i++) {
+        if (verbose) printf("Adding include path: %s\n", include_paths[i]);
+        tcc_add_include_path(tcc, include_paths[i]);
+    }
+}
+
+// Макросы -D name[=value]: одни и те же для файлов игры и движка
+void add_defines(TCCState* tcc, char** defines, int define_count, int verbose) {
+    for (int i = 0; i < define_count; i++) {
+        char name[256];
+        snprintf(name, sizeof(name), "%s", defines[i]);
+        char* value = strchr(name, '=');
+        if (value) *value++ = '\0';
+        
+        if (verbose) printf("Adding define: %s\n", defines[i]);
+        tcc_define_symbol(tcc, name, value ? value : "1");
+    }
+}
+
+// Параметры компиляции, общие для всех единиц трансляции
+typedef struct {
+    char** include_paths;
+    int include_count;
+    char** defines;
+    int define_count;
+    const char* cache_dir;          // NULL - без кэша объектов
+} CompileOptions;
+
+// ==================== КЭШ ОБЪЕКТОВ ====================
+// Ключ - FNV-1a 64 от препроцессированного текста и параметров
+// компиляции. Заголовки уже раскрыты в тексте, поэтому правка любого
+// включенного файла меняет ключ, а правка другого файла - нет.
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+unsigned long long hash_bytes(unsigned long long hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+int hash_file(const char* path, unsigned long long* hash) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+    
+    unsigned char buffer[65536];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        *hash = hash_bytes(*hash, buffer, read);
+    }
+    fclose(file);
+    return 1;
+}
+
+// Параметры, которые влияют на объект, но не видны в тексте
+unsigned long long hash_options(const CompileOptions* options) {
+    unsigned long long hash = hash_bytes(FNV_OFFSET, BUILD_CACHE_VERSION, strlen(BUILD_CACHE_VERSION));
+    for (int i = 0; i < options->include_count; i++) {
+        hash = hash_bytes(hash, options->include_paths[i], strlen(options->include_paths[i]) + 1);
+    }
+    for (int i = 0; i < options->define_count; i++) {
+        hash = hash_bytes(hash, "-D", 2);
+        hash = hash_bytes(hash, options->defines[i], strlen(options->defines[i]) + 1);
+    }
+    return hash;
+}
+
+int copy_file(const char* from, const char* to) {
+    FILE* in = fopen(from, "rb");
+    if (!in) return 0;
+    FILE* out = fopen(to, "wb");
+    if (!out) {
+        fclose(in);
+        return 0;
+    }
+    
+    unsigned char buffer[65536];
+    size_t read;
+    int ok = 1;
+    while ((read = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        if (fwrite(buffer, 1, read, out) != read) {
+            ok = 0;
+            break;
+        }
+    }
+    fclose(in);
+    if (fclose(out) != 0) ok = 0;
+    return ok;
+}
+
+// Замена файла готовым временным. rename в Windows не заменяет
+// существующий файл, поэтому старый сначала удаляется.
+int replace_file(const char* temp, const char* path) {
+    #ifdef _WIN32
+        remove(path);
+    #endif
+    return rename(temp, path) == 0;
+}
+
+// Запись в кэш через временный файл: параллельные процессы с одинаковым
+// ключом не видят недописанный объект
+void cache_store(const char* object, const char* cached) {
+    char temp[600];
+    snprintf(temp, sizeof(temp), "%s.%d.tmp", cached, (int)getpid());
+    
+    if (!copy_file(object, temp) || rename(temp, cached) != 0) {
+        remove(temp);
+    }
+}
+
+// Препроцессирование в файл. libtcc пишет результат в stdout,
+// поэтому stdout на время перенаправляется в output.
+int preprocess_source(const char* source, const char* output, const CompileOptions* options) {
+    TCCState* tcc = tcc_new();
+    if (!tcc) return 0;
+    tcc_set_output_type(tcc, TCC_OUTPUT_PREPROCESS);
+    add_include_paths(tcc, options->include_paths, options->include_count, 0);
+    add_defines(tcc, options->defines, options->define_count, 0);
+    
+    fflush(stdout);
+    int saved_stdout = dup(fileno(stdout));
+    if (saved_stdout < 0 || !freopen(output, "wb", stdout)) {
+        if (saved_stdout >= 0) close(saved_stdout);
+        tcc_delete(tcc);
+        return 0;
+    }
+    
+    int ok = tcc_add_file(tcc, source) == 0;
+    
+    fflush(stdout);
+    dup2(saved_stdout, fileno(stdout));
+    close(saved_stdout);
+    clearerr(stdout);
+    
+    tcc_delete(tcc);
+    return ok;
+}
+
+// ==================== ЗАВИСИМОСТИ ====================
+// Дочерний процесс записывает рядом с объектом <объект>.d: все файлы,
+// которые попали в единицу трансляции (по строчным маркерам
+// препроцессора), с временем изменения и размером на момент сборки.
+// Объект актуален, если он есть и ни один файл из списка не изменился -
+// такой файл даже не препроцессируется. Правка mirulit_core.h пересобирает
+// только файлы, которые его включают, правка config.c - только config.c.
+
+typedef struct {
+    long long mtime;
+    long long size;
+} FileStamp;
+
+typedef struct {
+    char** paths;
+    FileStamp* stamps;
+    int count;
+    int capacity;
+} DepList;
+
+int file_stamp(const char* path, FileStamp* stamp) {
+    #ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) return 0;
+        stamp->mtime = ((long long)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+        stamp->size = ((long long)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    #else
+        struct stat st;
+        if (stat(path, &st) != 0) return 0;
+        #ifdef __APPLE__
+            stamp->mtime = (long long)st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+        #else
+            stamp->mtime = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+        #endif
+        stamp->size = (long long)st.st_size;
+    #endif
+    return 1;
+}
+
+int deplist_find(const DepList* list, const char* path) {
+    for (int i = 0; i < list->count; i++) {
+        if (strcmp(list->paths[i], path) == 0) return i;
+    }
+    return -1;
+}
+
+void deplist_add(DepList* list, const char* path, FileStamp stamp) {
+    if (list->count >= list->capacity) {
+        list->capacity = list->capacity == 0 ? 32 : list->capacity * 2;
+        list->paths = realloc(list->paths, list->capacity * sizeof(char*));
+        list->stamps = realloc(list->stamps, list->capacity * sizeof(FileStamp));
+    }
+    list->paths[list->count] = strdup(path);
+    list->stamps[list->count] = stamp;
+    list->count++;
+}
+
+void deplist_free(DepList* list) {
+    for (int i = 0; i < list->count; i++) {
+        free(list->paths[i]);
+    }
+    free(list->paths);
+    free(list->stamps);
+    list->paths = NULL;
+    list->stamps = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+// Файлы из маркеров '# 12 "path"' и '#line 12 "path"'. Псевдофайлы
+// вида <built-in> пропускаются.
+void scan_preprocessed(const char* preprocessed, DepList* deps) {
+    FILE* file = fopen(preprocessed, "rb");
+    if (!file) return;
+    
+    char line[4096];
+    int line_start = 1;
+    while (fgets(line, sizeof(line), file)) {
+        int is_start = line_start;
+        line_start = strchr(line, '\n') != NULL;
+        if (!is_start || line[0] != '#') continue;
+        
+        const char* p = line + 1;
+        if (strncmp(p, "line", 4) == 0) p += 4;
+        while (*p == ' ') p++;
+        if (*p < '0' || *p > '9') continue;
+        while (*p >= '0' && *p <= '9') p++;
+        while (*p == ' ') p++;
+        if (*p != '"') continue;
+        p++;
+        
+        char path[1024];
+        size_t length = 0;
+        while (*p && *p != '"' && length < sizeof(path) - 1) {
+            if (p[0] == '\\' && (p[1] == '\\' || p[1] == '"')) p++;
+            path[length++] = *p++;
+        }
+        path[length] = '\0';
+        if (*p != '"' || length == 0 || path[0] == '<') continue;
+        
+        FileStamp stamp;
+        if (deplist_find(deps, path) < 0 && file_stamp(path, &stamp)) {
+            deplist_add(deps, path, stamp);
+        }
+    }
+    fclose(file);
+}
+
+void dependency_path(const char* object, char* out, size_t size) {
+    snprintf(out, size, "%s.d", object);
+}
+
+// Запись <объект>.d: заголовок с версией и ключом параметров, затем
+// по строке на файл: "<mtime> <size> <path>"
+int write_dependencies(const char* object, const DepList* deps, const CompileOptions* options) {
+    char path[520];
+    dependency_path(object, path, sizeof(path));
+    
+    FILE* file = fopen(path, "wb");
+    if (!file) return 0;
+    
+    fprintf(file, "%s %016llx\n", BUILD_DEPS_VERSION, hash_options(options));
+    for (int i = 0; i < deps->count; i++) {
+        fprintf(file, "%lld %lld %s\n", deps->stamps[i].mtime, deps->stamps[i].size, deps->paths[i]);
+    }
+    
+    if (fclose(file) != 0) {
+        remove(path);
+        return 0;
+    }
+    return 1;
+}
+
+// Чтение <объект>.d. 0 - файла нет или он записан с другими параметрами.
+int read_dependencies(const char* object, const CompileOptions* options, DepList* deps) {
+    char path[520];
+    dependency_path(object, path, sizeof(path));
+    
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+    
+    char line[1100];
+    char expected[64];
+    snprintf(expected, sizeof(expected), "%s %016llx", BUILD_DEPS_VERSION, hash_options(options));
+    if (!fgets(line, sizeof(line), file)) {
+        fclose(file);
+        return 0;
+    }
+    line[strcspn(line, "\r\n")] = 0;
+    if (strcmp(line, expected) != 0) {
+        fclose(file);
+        return 0;
+    }
+    
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = 0;
+        
+        FileStamp stamp;
+        int offset = 0;
+        if (sscanf(line, "%lld %lld %n", &stamp.mtime, &stamp.size, &offset) != 2 || !line[offset]) continue;
+        deplist_add(deps, line + offset, stamp);
+    }
+    fclose(file);
+    return 1;
+}
+
+// Объект собран из текущих версий всех своих файлов
+int object_up_to_date(const char* object, const CompileOptions* options) {
+    if (!file_exists(object)) return 0;
+    
+    DepList deps = {0};
+    int up_to_date = read_dependencies(object, options, &deps) && deps.count > 0;
+    for (int i = 0; i < deps.count && up_to_date; i++) {
+        FileStamp stamp;
+        up_to_date = file_stamp(deps.paths[i], &stamp) &&
+                     stamp.mtime == deps.stamps[i].mtime &&
+                     stamp.size == deps.stamps[i].size;
+    }
+    deplist_free(&deps);
+    return up_to_date;
+}
+
+// Компиляция одного файла в объектный (режим --compile-object).
+// Каждый процесс - свой TCCState: libtcc выполняет компиляцию под
+// глобальной блокировкой, поэтому параллельно работают только процессы.
+// Текст после препроцессора дает список зависимостей (<объект>.d) и,
+// с кэшем, ключ: неизмененный файл не компилируется - объект копируется
+// из кэша. При ошибке объект удаляется, чтобы не считаться актуальным.
+int compile_object(const char* source, const char* object, const CompileOptions* options) {
+    char preprocessed[520];
+    char dependencies[520];
+    char cached[512] = "";
+    snprintf(preprocessed, sizeof(preprocessed), "%s.i", object);
+    dependency_path(object, dependencies, sizeof(dependencies));
+    remove(dependencies);
+    
+    if (preprocess_source(source, preprocessed, options)) {
+        DepList deps = {0};
+        FileStamp stamp;
+        if (file_stamp(source, &stamp)) deplist_add(&deps, source, stamp);
+        scan_preprocessed(preprocessed, &deps);
+        write_dependencies(object, &deps, options);
+        deplist_free(&deps);
+        
+        unsigned long long hash = hash_options(options);
+        if (options->cache_dir && hash_file(preprocessed, &hash)) {
+            snprintf(cached, sizeof(cached), "%s/%016llx.o", options->cache_dir, hash);
+            if (file_exists(cached) && copy_file(cached, object)) {
+                remove(preprocessed);
+                return COMPILE_CACHED;
+            }
+        }
+    }
+    remove(preprocessed);
+    
+    TCCState* tcc = tcc_new();
+    if (!tcc) {
+        fprintf(stderr, "ERROR: Cannot create TCC instance\n");
+        remove(object);
+        return COMPILE_FAILED;
+    }
+    
+    tcc_set_output_type(tcc, TCC_OUTPUT_OBJ);
+    add_include_paths(tcc, options->include_paths, options->include_count, 0);
+    add_defines(tcc, options->defines, options->define_count, 0);
+    
+    int result = COMPILE_OK;
+    if (tcc_add_file(tcc, source) != 0) {
+        fprintf(stderr, "ERROR: Failed to compile %s\n", source);
+        result = COMPILE_FAILED;
+    } else if (tcc_output_file(tcc, object) != 0) {
+        fprintf(stderr, "ERROR: Failed to write %s\n", object);
+        result = COMPILE_FAILED;
+    }
+    tcc_delete(tcc);
+    
+    if (result == COMPILE_FAILED) {
+        remove(object);
+    } else if (cached[0]) {
+        cache_store(object, cached);
+    }
+    return result;
+}
+
+// Число логических процессоров (по умолчанию для -j)
+int cpu_count(void) {
+    #ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return (int)info.dwNumberOfProcessors;
+    #else
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        return count > 0 ? (int)count : 1;
+    #endif
+}
+
+// Имя объектного файла: путь исходника без разделителей
+void object_path(const char* object_dir, const char* source, char* out, size_t size) {
+    char name[256];
+    size_t length = 0;
+    
+    for (const char* p = source; *p && length < sizeof(name) - 1; p++) {
+        if (length == 0 && (*p == '.' || *p == '/' || *p == '\\')) continue;
+        name[length++] = (*p == '/' || *p == '\\' || *p == ':' || *p == '.') ? '_' : *p;
+    }
+    name[length] = '\0';
+    
+    snprintf(out, size, "%s/%s.o", object_dir, name);
+}
+
+// Дочерний процесс компиляции
+typedef struct {
+    const char* source;
+    char object[512];
+    #ifdef _WIN32
+        HANDLE process;
+    #else
+        pid_t pid;
+    #endif
+} CompileJob;
+
+// Запуск "<self> --compile-object <source> -o <object> [-I ...] [-D ...] [--cache-dir ...]"
+int spawn_compile_job(const char* self, CompileJob* job, const CompileOptions* options) {
+    #ifdef _WIN32
+        char command[8192];
+        int length = snprintf(command, sizeof(command), "\"%s\" --compile-object \"%s\" -o \"%s\"",
+                              self, job->source, job->object);
+        for (int i = 0; i < options->include_count && length < (int)sizeof(command); i++) {
+            length += snprintf(command + length, sizeof(command) - length, " -I \"%s\"", options->include_paths[i]);
+        }
+        for (int i = 0; i < options->define_count && length < (int)sizeof(command); i++) {
+            length += snprintf(command + length, sizeof(command) - length, " -D \"%s\"", options->defines[i]);
+        }
+        if (options->cache_dir && length < (int)sizeof(command)) {
+            length += snprintf(command + length, sizeof(command) - length, " --cache-dir \"%s\"", options->cache_dir);
+        }
+        if (length >= (int)sizeof(command)) return 0;
+        
+        fflush(stdout);
+        STARTUPINFOA startup = {0};
+        PROCESS_INFORMATION info = {0};
+        startup.cb = sizeof(startup);
+        if (!CreateProcessA(NULL, command, NULL, NULL, TRUE, 0, NULL, NULL, &startup, &info)) {
+            return 0;
+        }
+        CloseHandle(info.hThread);
+        job->process = info.hProcess;
+        return 1;
+    #else
+        char** args = malloc((8 + (options->include_count + options->define_count) * 2) * sizeof(char*));
+        if (!args) return 0;
+        
+        int count = 0;
+        args[count++] = (char*)self;
+        args[count++] = "--compile-object";
+        args[count++] = (char*)job->source;
+        args[count++] = "-o";
+        args[count++] = job->object;
+        for (int i = 0; i < options->include_count; i++) {
+            args[count++] = "-I";
+            args[count++] = options->include_paths[i];
+        }
+        for (int i = 0; i < options->define_count; i++) {
+            args[count++] = "-D";
+            args[count++] = options->defines[i];
+        }
+        if (options->cache_dir) {
+            args[count++] = "--cache-dir";
+            args[count++] = (char*)options->cache_dir;
+        }
+        args[count] = NULL;
+        
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            execvp(self, args);
+            _exit(127);
+        }
+        free(args);
+        
+        if (pid < 0) return 0;
+        job->pid = pid;
+        return 1;
+    #endif
+}
+
+// Ожидание любого из running запущенных заданий. Возвращает его индекс
+// в jobs, код завершения - в exit_code.
+int wait_compile_job(CompileJob* jobs, int* running, int running_count, int* exit_code) {
+    #ifdef _WIN32
+        HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+        for (int i = 0; i < running_count; i++) {
+            handles[i] = jobs[running[i]].process;
+        }
+        
+        DWORD signaled = WaitForMultipleObjects(running_count, handles, FALSE, INFINITE);
+        int slot = signaled < WAIT_OBJECT_0 + running_count ? (int)(signaled - WAIT_OBJECT_0) : 0;
+        
+        DWORD code = 1;
+        GetExitCodeProcess(handles[slot], &code);
+        CloseHandle(handles[slot]);
+        *exit_code = (int)code;
+        return slot;
+    #else
+        for (;;) {
+            int status = 0;
+            pid_t pid = waitpid(-1, &status, 0);
+            if (pid < 0 && errno != EINTR) return -1;
+            
+            for (int i = 0; i < running_count; i++) {
+                if (jobs[running[i]].pid == pid) {
+                    *exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+                    return i;
+                }
+            }
+        }
+    #endif
+}
+
+// Параллельная компиляция: до job_limit процессов одновременно.
+// Прогресс печатается по мере завершения. После первой ошибки новые
+// задания не запускаются, запущенные дожидаются. 0 - успех.
+int compile_parallel(const char* self, FileList* sources, const char* object_dir,
+                     const CompileOptions* options, int job_limit, int* cached) {
+    #ifdef _WIN32
+        if (job_limit > MAXIMUM_WAIT_OBJECTS) job_limit = MAXIMUM_WAIT_OBJECTS;
+    #endif
+    
+    CompileJob* jobs = calloc(sources->count, sizeof(CompileJob));
+    int* running = malloc(job_limit * sizeof(int));
+    if (!jobs || !running) {
+        free(jobs);
+        free(running);
+        return 1;
+    }
+    
+    ensure_directory(object_dir);
+    
+    int next = 0;
+    int running_count = 0;
+    int completed = 0;
+    int failed = 0;
+    
+    while (running_count > 0 || (next < sources->count && !failed)) {
+        // Заполняем свободные слоты
+        while (running_count < job_limit && next < sources->count && !failed) {
+            CompileJob* job = &jobs[next];
+            job->source = sources->files[next];
+            object_path(object_dir, job->source, job->object, sizeof(job->object));
+            
+            if (!spawn_compile_job(self, job, options)) {
+                fprintf(stderr, "ERROR: Cannot start compiler process for %s\n", job->source);
+                failed = 1;
+                break;
+            }
+            running[running_count++] = next++;
+        }
+        if (running_count == 0) break;
+        
+        int exit_code = 1;
+        int slot = wait_compile_job(jobs, running, running_count, &exit_code);
+        if (slot < 0) {
+            failed = 1;
+            break;
+        }
+        
+        CompileJob* done = &jobs[running[slot]];
+        running[slot] = running[--running_count];
+        completed++;
+        
+        if (exit_code == COMPILE_OK || exit_code == COMPILE_CACHED) {
+            printf("  [%d/%d] %s%s\n", completed, sources->count, done->source,
+                   exit_code == COMPILE_CACHED ? " (cached)" : "");
+            fflush(stdout);
+            if (exit_code == COMPILE_CACHED) (*cached)++;
+        } else {
+            fprintf(stderr, "  [%d/%d] %s FAILED\n", completed, sources->count, done->source);
+            failed = 1;
+        }
+    }
+    
+    free(jobs);
+    free(running);
+    return failed;
+}
+
+// Последовательная компиляция в объекты в этом же процессе
+int compile_serial(FileList* sources, const char* object_dir, const CompileOptions* options, int* cached) {
+    ensure_directory(object_dir);
+    
+    for (int i = 0; i < sources->count; i++) {
+        char object[512];
+        object_path(object_dir, sources->files[i], object, sizeof(object));
+        
+        int result = compile_object(sources->files[i], object, options);
+        if (result == COMPILE_FAILED) {
+            fprintf(stderr, "  [%d/%d] %s FAILED\n", i + 1, sources->count, sources->files[i]);
+            return 1;
+        }
+        
+        printf("  [%d/%d] %s%s\n", i + 1, sources->count, sources->files[i],
+               result == COMPILE_CACHED ? " (cached)" : "");
+        if (result == COMPILE_CACHED) (*cached)++;
+    }
+    return 0;
+}
+
+// ==================== БИБЛИОТЕКИ lib ====================
+// Архивы из lib находятся без запуска оболочки, а их символы читаются
+// один раз и хранятся в манифесте <выход>/libs.manifest. Список архивов
+// перечитывается, только если изменилось время директории lib, символы
+// архива - только если изменился сам архив.
+//
+// При линковке добавляются только архивы, которые определяют еще не
+// найденные символы объектов (и символы, нужные уже выбранным архивам).
+// Архивы добавляются в порядке выбора: архив идет раньше тех, от которых
+// он зависит, как нужно однопроходному линковщику tcc. Архив, который не
+// удалось разобрать (не ELF, например COFF .lib), добавляется всегда.
+
+#define LIBRARY_MANIFEST_VERSION "mirulit-libs-1"
+
+typedef struct {
+    char* path;
+    FileStamp stamp;
+    FileList defined;
+    FileList undefined;             // нужны архиву и не определены в нем
+    int link_always;
+} LibraryArchive;
+
+typedef struct {
+    char dir[512];
+    char manifest[512];
+    FileStamp dir_stamp;
+    LibraryArchive* archives;
+    int count;
+} LibraryIndex;
+
+// Множество строк (открытая адресация) для имен символов
+typedef struct {
+    char** slots;
+    int capacity;
+    int count;
+} SymbolSet;
+
+int symbolset_slot(const SymbolSet* set, const char* name) {
+    unsigned long long hash = hash_bytes(FNV_OFFSET, name, strlen(name));
+    int slot = (int)(hash & (unsigned long long)(set->capacity - 1));
+    while (set->slots[slot] && strcmp(set->slots[slot], name) != 0) {
+        slot = (slot + 1) & (set->capacity - 1);
+    }
+    return slot;
+}
+
+int symbolset_contains(const SymbolSet* set, const char* name) {
+    return set->capacity > 0 && set->slots[symbolset_slot(set, name)] != NULL;
+}
+
+// 1 - символ добавлен, 0 - уже был
+int symbolset_add(SymbolSet* set, const char* name) {
+    if ((set->count + 1) * 2 > set->capacity) {
+        SymbolSet grown = { calloc(set->capacity ? set->capacity * 2 : 256, sizeof(char*)),
+                            set->capacity ? set->capacity * 2 : 256, set->count };
+        for (int i = 0; i < set->capacity; i++) {
+            if (set->slots[i]) grown.slots[symbolset_slot(&grown, set->slots[i])] = set->slots[i];
+        }
+        free(set->slots);
+        *set = grown;
+    }
+    
+    int slot = symbolset_slot(set, name);
+    if (set->slots[slot]) return 0;
+    set->slots[slot] = strdup(name);
+    set->count++;
+    return 1;
+}
+
+void symbolset_free(SymbolSet* set) {
+    for (int i = 0; i < set->capacity; i++) {
+        free(set->slots[i]);
+    }
+    free(set->slots);
+    set->slots = NULL;
+    set->capacity = 0;
+    set->count = 0;
+}
+
+unsigned int read_u16(const unsigned char* p) {
+    return p[0] | (p[1] << 8);
+}
+
+unsigned int read_u32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+unsigned long long read_u64(const unsigned char* p) {
+    return read_u32(p) | ((unsigned long long)read_u32(p + 4) << 32);
+}
+
+// Глобальные символы объектного файла ELF (32 и 64 бит, little-endian).
+// Слабые неопределенные символы архивы не подтягивают и пропускаются.
+// 0 - не ELF или файл поврежден.
+int elf_symbols(const unsigned char* data, size_t size, SymbolSet* defined, SymbolSet* undefined) {
+    if (size < 52 || memcmp(data, "\177ELF", 4) != 0 || data[5] != 1) return 0;
+    int is64 = data[4] == 2;
+    if (is64 && size < 64) return 0;
+    
+    unsigned long long section_offset = is64 ? read_u64(data + 0x28) : read_u32(data + 0x20);
+    unsigned int section_size = read_u16(data + (is64 ? 0x3A : 0x2E));
+    unsigned int section_count = read_u16(data + (is64 ? 0x3C : 0x30));
+    if (section_size < (is64 ? 64u : 40u) ||
+        section_offset + (unsigned long long)section_size * section_count > size) return 0;
+    
+    for (unsigned int i = 0; i < section_count; i++) {
+        const unsigned char* section = data + section_offset + (size_t)i * section_size;
+        if (read_u32(section + 4) != 2) continue;      // SHT_SYMTAB
+        
+        unsigned long long offset = is64 ? read_u64(section + 0x18) : read_u32(section + 0x10);
+        unsigned long long length = is64 ? read_u64(section + 0x20) : read_u32(section + 0x14);
+        unsigned int link = read_u32(section + (is64 ? 0x28 : 0x18));
+        unsigned int entry = is64 ? 24 : 16;
+        if (link >= section_count || offset + length > size) return 0;
+        
+        const unsigned char* strings = data + section_offset + (size_t)link * section_size;
+        unsigned long long string_offset = is64 ? read_u64(strings + 0x18) : read_u32(strings + 0x10);
+        unsigned long long string_length = is64 ? read_u64(strings + 0x20) : read_u32(strings + 0x14);
+        if (string_offset + string_length > size) return 0;
+        
+        for (unsigned long long s = entry; s + entry <= length; s += entry) {
+            const unsigned char* symbol = data + offset + s;
+            unsigned int name = read_u32(symbol);
+            unsigned int bind = symbol[is64 ? 4 : 12] >> 4;
+            unsigned int index = read_u16(symbol + (is64 ? 6 : 14));
+            if ((bind != 1 && bind != 2) || name >= string_length) continue;   // GLOBAL, WEAK
+            
+            const char* text = (const char*)data + string_offset + name;
+            if (!*text || !memchr(text, '\0', string_length - name)) continue;
+            
+            if (index != 0) symbolset_add(defined, text);
+            else if (bind == 1) symbolset_add(undefined, text);
+        }
+    }
+    return 1;
+}
+
+unsigned char* read_whole_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    
+    unsigned char* data = length > 0 ? malloc(length) : NULL;
+    if (data && fread(data, 1, length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+// Символы объектов ELF из архива ar (форматы GNU и BSD)
+void library_parse(LibraryArchive* archive) {
+    filelist_free(&archive->defined);
+    filelist_free(&archive->undefined);
+    archive->link_always = 1;
+    
+    size_t size = 0;
+    unsigned char* data = read_whole_file(archive->path, &size);
+    if (!data) return;
+    if (size < 8 || memcmp(data, "!<arch>\n", 8) != 0) {
+        free(data);
+        return;
+    }
+    
+    SymbolSet defined = {0};
+    SymbolSet undefined = {0};
+    int parsed = 1;
+    size_t position = 8;
+    
+    while (position + 60 <= size && parsed) {
+        const unsigned char* header = data + position;
+        char field[11] = {0};
+        memcpy(field, header + 48, 10);
+        size_t member_size = (size_t)strtoull(field, NULL, 10);
+        if (position + 60 + member_size > size) break;
+        
+        const unsigned char* member = header + 60;
+        size_t length = member_size;
+        
+        if (memcmp(header, "#1/", 3) == 0) {
+            // BSD: длинное имя лежит перед данными
+            char name_length[14] = {0};
+            memcpy(name_length, header + 3, 13);
+            size_t skip = (size_t)strtoull(name_length, NULL, 10);
+            member += skip < length ? skip : length;
+            length -= skip < length ? skip : length;
+        }
+        
+        int is_index = header[0] == '/' ||                            // "/", "//", "/SYM64/"
+                       memcmp(header, "__.SYMDEF", 9) == 0 ||
+                       memcmp(member, "__.SYMDEF", length < 9 ? length : 9) == 0;
+        if (!is_index && length > 0) {
+            parsed = elf_symbols(member, length, &defined, &undefined);
+        }
+        
+        position += 60 + member_size + (member_size & 1);
+    }
+    free(data);
+    
+    if (parsed) {
+        for (int i = 0; i < defined.capacity; i++) {
+            if (defined.slots[i]) filelist_add(&archive->defined, defined.slots[i]);
+        }
+        for (int i = 0; i < undefined.capacity; i++) {
+            if (undefined.slots[i] && !symbolset_contains(&defined, undefined.slots[i])) {
+                filelist_add(&archive->undefined, undefined.slots[i]);
+            }
+        }
+        archive->link_always = 0;
+    }
+    symbolset_free(&defined);
+    symbolset_free(&undefined);
+}
+
+void library_free(LibraryArchive* archive) {
+    free(archive->path);
+    filelist_free(&archive->defined);
+    filelist_free(&archive->undefined);
+}
+
+LibraryArchive* library_index_add(LibraryIndex* index, const char* path) {
+    index->archives = realloc(index->archives, (index->count + 1) * sizeof(LibraryArchive));
+    LibraryArchive* archive = &index->archives[index->count++];
+    memset(archive, 0, sizeof(*archive));
+    archive->path = strdup(path);
+    return archive;
+}
+
+void library_index_free(LibraryIndex* index) {
+    for (int i = 0; i < index->count; i++) {
+        library_free(&index->archives[i]);
+    }
+    free(index->archives);
+    index->archives = NULL;
+    index->count = 0;
+}
+
+int is_library_file(const char* filename) {
+    const char* ext = strrchr(filename, '.');
+    return ext && (strcmp(ext, ".a") == 0 || strcmp(ext, ".lib") == 0);
+}
+
+int compare_strings(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Архивы директории по имени (как раньше выдавал ls)
+void list_library_files(const char* lib_dir, FileList* files) {
+    #ifdef _WIN32
+        char pattern[520];
+        snprintf(pattern, sizeof(pattern), "%s\\*", lib_dir);
+        
+        WIN32_FIND_DATAA findData;
+        HANDLE hFind = FindFirstFileA(pattern, &findData);
+        if (hFind != INVALID_HANDLE_VALUE) {
+            do {
+                if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+                    is_library_file(findData.cFileName)) {
+                    char full_path[520];
+                    snprintf(full_path, sizeof(full_path), "%s\\%s", lib_dir, findData.cFileName);
+                    filelist_add(files, full_path);
+                }
+            } while (FindNextFileA(hFind, &findData));
+            FindClose(hFind);
+        }
+    #else
+        DIR* dir = opendir(lib_dir);
+        if (dir) {
+            struct dirent* entry;
+            while ((entry = readdir(dir)) != NULL) {
+                if (entry->d_name[0] == '.' || !is_library_file(entry->d_name)) continue;
+                
+                char full_path[520];
+                snprintf(full_path, sizeof(full_path), "%s/%s", lib_dir, entry->d_name);
+                filelist_add(files, full_path);
+            }
+            closedir(dir);
+        }
+    #endif
+    
+    if (files->count > 1) qsort(files->files, files->count, sizeof(char*), compare_strings);
+}
+
+int library_index_save(const LibraryIndex* index) {
+    char temp[600];
+    snprintf(temp, sizeof(temp), "%s.%d.tmp", index->manifest, (int)getpid());
+    
+    FILE* file = fopen(temp, "wb");
+    if (!file) return 0;
+    
+    fprintf(file, "%s %lld %lld %s\n", LIBRARY_MANIFEST_VERSION,
+            index->dir_stamp.mtime, index->dir_stamp.size, index->dir);
+    for (int i = 0; i < index->count; i++) {
+        const LibraryArchive* archive = &index->archives[i];
+        fprintf(file, "A %lld %lld %d %s\n", archive->stamp.mtime, archive->stamp.size,
+                archive->link_always, archive->path);
+        for (int j = 0; j < archive->defined.count; j++) {
+            fprintf(file, "D %s\n", archive->defined.files[j]);
+        }
+        for (int j = 0; j < archive->undefined.count; j++) {
+            fprintf(file, "U %s\n", archive->undefined.files[j]);
+        }
+    }
+    
+    if (fclose(file) != 0 || !replace_file(temp, index->manifest)) {
+        remove(temp);
+        return 0;
+    }
+    return 1;
+}
+
+// Манифест другой директории или версии не читается
+int library_index_load(LibraryIndex* index) {
+    FILE* file = fopen(index->manifest, "rb");
+    if (!file) return 0;
+    
+    char line[4096];
+    char expected[16];
+    FileStamp dir_stamp;
+    int offset = 0;
+    if (!fgets(line, sizeof(line), file) ||
+        sscanf(line, "%15s %lld %lld %n", expected, &dir_stamp.mtime, &dir_stamp.size, &offset) != 3 ||
+        strcmp(expected, LIBRARY_MANIFEST_VERSION) != 0) {
+        fclose(file);
+        return 0;
+    }
+    line[strcspn(line, "\r\n")] = 0;
+    if (strcmp(line + offset, index->dir) != 0) {
+        fclose(file);
+        return 0;
+    }
+    index->dir_stamp = dir_stamp;
+    
+    LibraryArchive* archive = NULL;
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = 0;
+        
+        if (line[0] == 'A') {
+            FileStamp stamp;
+            int link_always = 1;
+            if (sscanf(line, "A %lld %lld %d %n", &stamp.mtime, &stamp.size, &link_always, &offset) != 3) continue;
+            archive = library_index_add(index, line + offset);
+            archive->stamp = stamp;
+            archive->link_always = link_always;
+        } else if (archive && line[0] == 'D' && line[1] == ' ') {
+            filelist_add(&archive->defined, line + 2);
+        } else if (archive && line[0] == 'U' && line[1] == ' ') {
+            filelist_add(&archive->undefined, line + 2);
+        }
+    }
+    fclose(file);
+    return 1;
+}
+
+// Сверка с диском перед линковкой: stat директории и архивов, разбор
+// только новых и измененных архивов. Манифест переписывается при изменениях.
+void library_index_refresh(LibraryIndex* index, int verbose) {
+    FileStamp dir_stamp = {0};
+    if (!file_stamp(index->dir, &dir_stamp)) {
+        if (verbose) printf("  Directory %s does not exist\n", index->dir);
+        library_index_free(index);
+        return;
+    }
+    
+    int changed = 0;
+    if (dir_stamp.mtime != index->dir_stamp.mtime || dir_stamp.size != index->dir_stamp.size) {
+        // Состав директории изменился: неизмененные архивы переносим
+        FileList files = {0};
+        list_library_files(index->dir, &files);
+        
+        LibraryIndex fresh = *index;
+        fresh.archives = NULL;
+        fresh.count = 0;
+        for (int i = 0; i < files.count; i++) {
+            LibraryArchive* archive = library_index_add(&fresh, files.files[i]);
+            for (int j = 0; j < index->count; j++) {
+                LibraryArchive* known = &index->archives[j];
+                if (known->path && strcmp(known->path, archive->path) == 0) {
+                    free(archive->path);
+                    *archive = *known;
+                    memset(known, 0, sizeof(*known));
+                    break;
+                }
+            }
+        }
+        filelist_free(&files);
+        
+        library_index_free(index);
+        *index = fresh;
+        index->dir_stamp = dir_stamp;
+        changed = 1;
+    }
+    
+    for (int i = 0; i < index->count; i++) {
+        LibraryArchive* archive = &index->archives[i];
+        FileStamp stamp = {0};
+        file_stamp(archive->path, &stamp);
+        if (stamp.mtime == archive->stamp.mtime && stamp.size == archive->stamp.size) continue;
+        
+        if (verbose) printf("  Reading symbols: %s\n", archive->path);
+        archive->stamp = stamp;
+        library_parse(archive);
+        changed = 1;
+    }
+    
+    if (changed && !library_index_save(index) && verbose) {
+        printf("  Warning: Cannot write %s\n", index->manifest);
+    }
+}
+
+void library_index_open(LibraryIndex* index, const char* lib_dir, const char* manifest, int verbose) {
+    memset(index, 0, sizeof(*index));
+    snprintf(index->dir, sizeof(index->dir), "%s", lib_dir);
+    snprintf(index->manifest, sizeof(index->manifest), "%s", manifest);
+    
+    if (verbose) printf("Looking for libraries in: %s\n", lib_dir);
+    if (!library_index_load(index)) {
+        library_index_free(index);
+        index->dir_stamp = (FileStamp){0};
+    }
+    library_index_refresh(index, verbose);
+    
+    if (verbose && index->count == 0) {
+        printf("  No library files found\n");
+    }
+}
+
+// Обход в глубину по зависимостям: архив попадает в post после всех,
+// от кого зависит
+void library_visit(const char* needs, int count, int node, int* state, int* post, int* post_count) {
+    state[node] = 1;
+    for (int j = 0; j < count; j++) {
+        if (needs[node * count + j] && !state[j]) {
+            library_visit(needs, count, j, state, post, post_count);
+        }
+    }
+    post[(*post_count)++] = node;
+}
+
+// Порядок архивов для tcc. tcc просматривает каждый архив один раз,
+// поэтому архив должен идти раньше архивов, чьи символы ему нужны.
+// Циклическая зависимость разрешается повтором: архив добавляется еще
+// раз после последнего, кому он нужен. link вмещает 2 * count номеров
+// из order, возвращается их число.
+int library_link_order(const LibraryIndex* index, const int* order, int count, int* link, int verbose) {
+    if (count == 0) return 0;
+    
+    SymbolSet* provides = calloc(count, sizeof(SymbolSet));
+    char* needs = calloc((size_t)count * count, 1);
+    int* state = calloc(count, sizeof(int));
+    int* post = malloc(count * sizeof(int));
+    
+    for (int i = 0; i < count; i++) {
+        const LibraryArchive* archive = &index->archives[order[i]];
+        for (int k = 0; k < archive->defined.count; k++) {
+            symbolset_add(&provides[i], archive->defined.files[k]);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        const LibraryArchive* archive = &index->archives[order[i]];
+        for (int j = 0; j < count; j++) {
+            for (int k = 0; j != i && k < archive->undefined.count && !needs[i * count + j]; k++) {
+                needs[i * count + j] = (char)symbolset_contains(&provides[j], archive->undefined.files[k]);
+            }
+        }
+    }
+    
+    // Обратный порядок выхода из обхода: зависимые перед зависимостями.
+    // Обход идет в порядке выбора, независимые архивы его сохраняют.
+    int post_count = 0;
+    for (int i = 0; i < count; i++) {
+        if (!state[i]) library_visit(needs, count, i, state, post, &post_count);
+    }
+    int link_count = 0;
+    for (int i = post_count - 1; i >= 0; i--) {
+        link[link_count++] = post[i];
+    }
+    
+    // После обратного ребра (цикла) зависимость оказалась раньше - она
+    // добавляется еще раз в конец. Повтор подтягивает только недостающие
+    // объекты, его собственные зависимости уже в списке.
+    int first_count = link_count;
+    for (int k = 0; k < first_count; k++) {
+        for (int j = 0; j < count; j++) {
+            if (!needs[link[k] * count + j]) continue;
+            
+            int later = 0;
+            for (int m = k + 1; m < link_count && !later; m++) {
+                later = link[m] == j;
+            }
+            if (later) continue;
+            
+            if (verbose) {
+                printf("  Adding again: %s (needed by %s)\n",
+                    index->archives[order[j]].path, index->archives[order[link[k]]].path);
+            }
+            link[link_count++] = j;
+        }
+    }
+    
+    for (int i = 0; i < count; i++) {
+        symbolset_free(&provides[i]);
+    }
+    free(provides);
+    free(needs);
+    free(state);
+    free(post);
+    return link_count;
+}
+
+// Добавление нужных архивов из lib. objects - объекты сборки; NULL -
+// символы неизвестны (сборка без объектов), добавляются все архивы.
+void add_library_files(TCCState* tcc, LibraryIndex* index, const FileList* objects, int verbose) {
+    library_index_refresh(index, verbose);
+    if (index->count == 0) return;
+    
+    SymbolSet defined = {0};
+    SymbolSet needed = {0};
+    int known = objects != NULL;
+    for (int i = 0; known && i < objects->count; i++) {
+        size_t size = 0;
+        unsigned char* data = read_whole_file(objects->files[i], &size);
+        known = data && elf_symbols(data, size, &defined, &needed);
+        free(data);
+    }
+    
+    int* selected = calloc(index->count, sizeof(int));
+    int* order = malloc(index->count * sizeof(int));
+    int order_count = 0;
+    
+    for (int changed = 1; changed; ) {
+        changed = 0;
+        for (int i = 0; i < index->count; i++) {
+            LibraryArchive* archive = &index->archives[i];
+            if (selected[i]) continue;
+            
+            const char* reason = NULL;
+            if (!known || archive->link_always) {
+                reason = "";
+            } else {
+                for (int j = 0; j < archive->defined.count && !reason; j++) {
+                    const char* symbol = archive->defined.files[j];
+                    if (symbolset_contains(&needed, symbol) && !symbolset_contains(&defined, symbol)) {
+                        reason = symbol;
+                    }
+                }
+            }
+            if (!reason) continue;
+            
+            if (verbose) {
+                if (reason[0]) printf("  Adding: %s (%s)\n", archive->path, reason);
+                else printf("  Adding: %s\n", archive->path);
+            }
+            selected[i] = 1;
+            order[order_count++] = i;
+            for (int j = 0; j < archive->defined.count; j++) {
+                symbolset_add(&defined, archive->defined.files[j]);
+            }
+            for (int j = 0; j < archive->undefined.count; j++) {
+                symbolset_add(&needed, archive->undefined.files[j]);
+            }
+            changed = 1;
+        }
+    }
+    
+    int* link = malloc((2 * order_count + 1) * sizeof(int));
+    int link_count = library_link_order(index, order, order_count, link, verbose);
+    for (int i = 0; i < link_count; i++) {
+        const char* path = index->archives[order[link[i]]].path;
+        if (tcc_add_file(tcc, path) != 0 && verbose) {
+            printf("  Warning: Failed to add %s\n", path);
+        }
+    }
+    if (verbose && order_count < index->count) {
+        printf("  Skipped %d unused of %d archives\n", index->count - order_count, index->count);
+    }
+    
+    free(selected);
+    free(order);
+    free(link);
+    symbolset_free(&defined);
+    symbolset_free(&needed);
+}
+
+// ==================== БИБЛИОТЕКА ДВИЖКА ====================
+// Движок (mirulit/mirulit.c с MIRULIT_IMPLEMENTATION) собирается в
+// lib/libmirulit.a с теми же путями include и -D, что и игра. Объект
+// движка учитывается как остальные: зависимости в .d, кэш по тексту,
+// поэтому повторная сборка компилирует только файлы игры. Дальше архив
+// попадает в линковку через индекс lib - только если игра вызывает
+// движок (с MIRULIT_HEADER_ONLY движок внутри файла игры и архив не нужен).
+
+#define ENGINE_LIBRARY "lib/libmirulit.a"
+
+// Исходник движка: mirulit/mirulit.c или mirulit.c в путях -I.
+// 0 - движок поставляется без него (только заголовки).
+int find_engine_source(const CompileOptions* options, char* out, size_t size) {
+    snprintf(out, size, "mirulit/mirulit.c");
+    if (file_exists(out)) return 1;
+    
+    for (int i = 0; i < options->include_count; i++) {
+        snprintf(out, size, "%s/mirulit.c", options->include_paths[i]);
+        if (file_exists(out)) return 1;
+    }
+    out[0] = '\0';
+    return 0;
+}
+
+void write_u32_be(unsigned char* p, unsigned int value) {
+    p[0] = (unsigned char)(value >> 24);
+    p[1] = (unsigned char)(value >> 16);
+    p[2] = (unsigned char)(value >> 8);
+    p[3] = (unsigned char)value;
+}
+
+// Заголовок члена ar: имя, время, uid, gid, режим, размер
+void write_ar_header(FILE* file, const char* name, size_t size) {
+    fprintf(file, "%-16s%-12s%-6s%-6s%-8s%-10lu`\n", name, "0", "0", "0", "644", (unsigned long)size);
+}
+
+// Архив из одного объекта с таблицей символов GNU ("/"): по ней
+// линковщики находят символы архива, не перебирая объекты.
+// Пишется через временный файл и переименование.
+int write_engine_library(const char* object, const char* library) {
+    size_t size = 0;
+    unsigned char* data = read_whole_file(object, &size);
+    if (!data) return 0;
+    
+    SymbolSet defined = {0};
+    SymbolSet undefined = {0};
+    elf_symbols(data, size, &defined, &undefined);
+    
+    size_t names_size = 0;
+    for (int i = 0; i < defined.capacity; i++) {
+        if (defined.slots[i]) names_size += strlen(defined.slots[i]) + 1;
+    }
+    size_t index_size = 4 + 4 * (size_t)defined.count + names_size;
+    unsigned char* index = calloc(1, index_size + 1);
+    
+    // Единственный объект лежит сразу после таблицы символов
+    unsigned int member_offset = (unsigned int)(8 + 60 + index_size + (index_size & 1));
+    int ok = index != NULL;
+    if (ok) {
+        unsigned char* names = index + 4 + 4 * (size_t)defined.count;
+        write_u32_be(index, (unsigned int)defined.count);
+        for (int i = 0, n = 0; i < defined.capacity; i++) {
+            if (!defined.slots[i]) continue;
+            write_u32_be(index + 4 + 4 * (size_t)n++, member_offset);
+            size_t length = strlen(defined.slots[i]) + 1;
+            memcpy(names, defined.slots[i], length);
+            names += length;
+        }
+    }
+    
+    char temp[600];
+    snprintf(temp, sizeof(temp), "%s.%d.tmp", library, (int)getpid());
+    FILE* file = ok ? fopen(temp, "wb") : NULL;
+    if (file) {
+        fwrite("!<arch>\n", 1, 8, file);
+        if (defined.count > 0) {
+            write_ar_header(file, "/", index_size);
+            fwrite(index, 1, index_size + (index_size & 1), file);
+        }
+        write_ar_header(file, "libmirulit.o/", size);
+        fwrite(data, 1, size, file);
+        if (size & 1) fputc('\n', file);
+        ok = !ferror(file);
+        if (fclose(file) != 0) ok = 0;
+        if (!ok || !replace_file(temp, library)) {
+            remove(temp);
+            ok = 0;
+        }
+    } else {
+        ok = 0;
+    }
+    
+    free(index);
+    free(data);
+    symbolset_free(&defined);
+    symbolset_free(&undefined);
+    return ok;
+}
+
+// ==================== НАБЛЮДЕНИЕ ЗА ФАЙЛАМИ ====================
+// --watch: после сборки драйвер ждет изменений в директориях, где лежат
+// исходники и их зависимости (inotify в Linux, уведомления об изменениях
+// в Windows, опрос раз в секунду на остальных системах), и пересобирает
+// проект. Аргументы разобраны и папка lib просканирована один раз;
+// компилируются только файлы, чьи зависимости изменились.
+
+typedef struct {
+    #ifdef _WIN32
+        HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+        int count;
+    #elif defined(__linux__)
+        int fd;
+    #endif
+} Watcher;
+
+void sleep_ms(int milliseconds) {
+    #ifdef _WIN32
+        Sleep(milliseconds);
+    #else
+        poll(NULL, 0, milliseconds);
+    #endif
+}
+
+int watcher_open(Watcher* watcher, const FileList* dirs) {
+    #ifdef _WIN32
+        watcher->count = 0;
+        for (int i = 0; i < dirs->count && watcher->count < MAXIMUM_WAIT_OBJECTS; i++) {
+            HANDLE handle = FindFirstChangeNotificationA(dirs->files[i], FALSE,
+                FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE);
+            if (handle != INVALID_HANDLE_VALUE) watcher->handles[watcher->count++] = handle;
+        }
+        return watcher->count > 0;
+    #elif defined(__linux__)
+        watcher->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (watcher->fd < 0) return 0;
+        
+        int watched = 0;
+        for (int i = 0; i < dirs->count; i++) {
+            // Редакторы часто пишут во временный файл и переименовывают его
+            if (inotify_add_watch(watcher->fd, dirs->files[i],
+                                  IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_ATTRIB) >= 0) {
+                watched++;
+            }
+        }
+        return watched > 0;
+    #else
+        (void)watcher;
+        (void)dirs;
+        return 1;
+    #endif
+}
+
+// Ожидание события. 1 - что-то изменилось (или пора опросить файлы),
+// 0 - ошибка наблюдения.
+int watcher_wait(Watcher* watcher) {
+    #ifdef _WIN32
+        // Больше MAXIMUM_WAIT_OBJECTS директорий - остальные опрашиваются
+        DWORD result = WaitForMultipleObjects(watcher->count, watcher->handles, FALSE, 1000);
+        if (result == WAIT_FAILED) return 0;
+        if (result < WAIT_OBJECT_0 + watcher->count) {
+            FindNextChangeNotification(watcher->handles[result - WAIT_OBJECT_0]);
+        }
+        return 1;
+    #elif defined(__linux__)
+        struct pollfd descriptor = { watcher->fd, POLLIN, 0 };
+        if (poll(&descriptor, 1, -1) < 0) return errno == EINTR;
+        
+        char buffer[4096];
+        while (read(watcher->fd, buffer, sizeof(buffer)) > 0) {}
+        return 1;
+    #else
+        (void)watcher;
+        sleep_ms(1000);
+        return 1;
+    #endif
+}
+
+void watcher_close(Watcher* watcher) {
+    #ifdef _WIN32
+        for (int i = 0; i < watcher->count; i++) {
+            FindCloseChangeNotification(watcher->handles[i]);
+        }
+        watcher->count = 0;
+    #elif defined(__linux__)
+        if (watcher->fd >= 0) close(watcher->fd);
+        watcher->fd = -1;
+    #else
+        (void)watcher;
+    #endif
+}
+
+// Директория файла ("." для файла без пути)
+void parent_directory(const char* path, char* out, size_t size) {
+    snprintf(out, size, "%s", path);
+    char* slash = strrchr(out, '/');
+    char* backslash = strrchr(out, '\\');
+    if (backslash > slash) slash = backslash;
+    
+    if (!slash) snprintf(out, size, ".");
+    else if (slash == out) slash[1] = '\0';
+    else *slash = '\0';
+}
+
+// Файлы, за которыми следит --watch, с отметками той сборки, которая
+// их прочитала: изменение между сборкой и началом наблюдения не теряется.
+// Файл, не попавший ни в один .d (ошибка препроцессора), отмечается сейчас.
+void collect_watch_files(const FileList* sources, const char* object_dir,
+                         const CompileOptions* options, DepList* files) {
+    for (int i = 0; i < sources->count; i++) {
+        char object[512];
+        object_path(object_dir, sources->files[i], object, sizeof(object));
+        
+        DepList deps = {0};
+        read_dependencies(object, options, &deps);
+        for (int j = 0; j < deps.count; j++) {
+            if (deplist_find(files, deps.paths[j]) < 0) {
+                deplist_add(files, deps.paths[j], deps.stamps[j]);
+            }
+        }
+        deplist_free(&deps);
+        
+        FileStamp stamp = {0};
+        if (deplist_find(files, sources->files[i]) < 0) {
+            file_stamp(sources->files[i], &stamp);
+            deplist_add(files, sources->files[i], stamp);
+        }
+    }
+}
+
+int watch_files_changed(const DepList* files) {
+    for (int i = 0; i < files->count; i++) {
+        FileStamp stamp = {0};
+        file_stamp(files->paths[i], &stamp);
+        if (stamp.mtime != files->stamps[i].mtime || stamp.size != files->stamps[i].size) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Ожидание, пока изменится хотя бы один файл сборки
+void wait_for_changes(const FileList* sources, const char* object_dir, const CompileOptions* options) {
+    DepList files = {0};
+    collect_watch_files(sources, object_dir, options, &files);
+    
+    FileList dirs = {0};
+    for (int i = 0; i < files.count; i++) {
+        char dir[1024];
+        parent_directory(files.paths[i], dir, sizeof(dir));
+        
+        int known = 0;
+        for (int j = 0; j < dirs.count && !known; j++) {
+            known = strcmp(dirs.files[j], dir) == 0;
+        }
+        if (!known) filelist_add(&dirs, dir);
+    }
+    
+    printf("\nWatching %d files in %d directories (Ctrl+C to stop)...\n", files.count, dirs.count);
+    fflush(stdout);
+    
+    Watcher watcher;
+    int watching = watcher_open(&watcher, &dirs);
+    if (!watching) {
+        printf("  Warning: File notifications unavailable, polling\n");
+    }
+    
+    while (!watch_files_changed(&files)) {
+        if (!watching || !watcher_wait(&watcher)) {
+            sleep_ms(1000);
+            continue;
+        }
+        // Сохранение - это обычно несколько событий подряд
+        sleep_ms(100);
+    }
+    
+    if (watching) watcher_close(&watcher);
+    filelist_free(&dirs);
+    deplist_free(&files);
+}
+
+// Показать справку
+void show_help(const char* program_name) {
+    printf("TCC Game Compiler\n");
+    printf("Usage: %s [options] <source.c> [additional_sources...]\n\n", program_name);
+    printf("Options:\n");
+    printf("  -o <file>     Output executable name\n");
+    printf("  -r <file>     Resource object file\n");
+    printf("  -I <path>     Add include path\n");
+    printf("  -D <name[=value]>  Define macro for game and engine sources\n");
+    printf("  -L <path>     Add library path\n");
+    printf("  -l <lib>      Link with library\n");
+    printf("  -v            Verbose output\n");
+    printf("  -j <n>        Parallel compiler processes (default: CPU count)\n");
+    printf("  --cache-dir <dir>  Object cache directory (default: <output dir>/cache)\n");
+    printf("  --no-cache    Compile everything, do not use the object cache\n");
+    printf("  --watch       Rebuild changed files and relink on every save\n");
+    printf("  --run         Link in memory and run at once, no executable written\n");
+    printf("  -- <args>     Arguments for the program started by --run\n");
+    printf("  --release     Optimized build with gcc/clang: -O3, LTO, -march preset\n");
+    printf("  --cc <cc>     Release compiler (default: $CC or gcc)\n");
+    printf("  --march <p>   portable (default), modern, native, none or a -march value\n");
+    printf("  --pgo         Release with profile: build, autoplay session, rebuild\n");
+    printf("  --pgo-frames <n>  Frames of the autoplay session (default: 3600)\n");
+    printf("  -a            Auto-find all .c files in current directory\n");
+    printf("  -r            Recursive search for source files\n");
+    printf("  -h, --help    Show this help\n");
+    printf("\nExamples:\n");
+    printf("  %s main.c render.c game.c\n", program_name);
+    printf("  %s -o mygame.exe main.c\n", program_name);
+    printf("  %s -a -o mygame.exe               # Auto-find all .c files\n", program_name);
+    printf("  %s -r -o mygame.exe               # Recursive search\n", program_name);
+    printf("  %s -I./include -L./lib -lglfw main.c render.c\n", program_name);
+    printf("  %s --watch -a -o bin/game.exe      # Rebuild on every save\n", program_name);
+    printf("  %s --run config.c -- --level 2      # Build and play, nothing on disk\n", program_name);
+    printf("  %s -D MIRULIT_ENABLE_PHYSICS main.c  # Engine library built with physics\n", program_name);
+    printf("  %s --release --pgo -o bin/game.exe config.c  # Shipping build\n", program_name);
+}
+
+// Итог сборки: размер выходного файла и как его запустить. 0 - файл создан.
+int report_output(const char* output_file, const char* what) {
+    // Проверяем, что файл создан
+    if (file_exists(output_file)) {
+        printf("\n✅ SUCCESS: %s completed!\n", what);
+        printf("   Output: %s\n", output_file);
+        
+        // Получаем размер файла
+        FILE* f = fopen(output_file, "rb");
+        if (f) {
+            fseek(f, 0, SEEK_END);
+            long size = ftell(f);
+            fclose(f);
+            
+            if (size < 1024) 
+                printf("   Size: %ld bytes\n", size);
+            else if (size < 1024*1024) 
+                printf("   Size: %.1f KB\n", size/1024.0);
+            else 
+                printf("   Size: %.1f MB\n", size/(1024.0*1024.0));
+        }
+        
+        #ifdef _WIN32
+            printf("   Run: %s\n", output_file);
+        #else
+            if (access(output_file, X_OK) == 0) {
+                printf("   Run: ./%s\n", output_file);
+            } else {
+                printf("   Note: File may not be executable, run: chmod +x %s\n", output_file);
+            }
+        #endif
+    } else {
+        fprintf(stderr, "\n❌ ERROR: Output file was not created\n");
+        return 1;
+    }
+    
+    return 0;
+}
+
+// Все, что нужно для сборки: разбирается один раз и в режиме --watch
+// переиспользуется между сборками
+typedef struct {
+    FileList source_files;
+    LibraryIndex library_index;     // архивы lib и их символы
+    char** library_paths;
+    char** libraries;
+    int library_path_count;
+    int library_count;
+    CompileOptions options;
+    const char* output_file;
+    const char* resource_file;
+    char object_dir[512];
+    char engine_source[512];        // "" - движок только из заголовков
+    char self[1024];
+    int job_limit;
+    int use_objects;                // компиляция через объекты в object_dir
+    int incremental;                // пропускать объекты с неизмененными зависимостями
+    int verbose;
+    int run;                        // --run: собрать в память и запустить
+    int run_argc;                   // аргументы игры (run_argv[0] - имя)
+    char** run_argv;
+} BuildContext;
+
+// Одна сборка: компиляция и линковка. 0 - успех. С --run программа
+// линкуется в память и запускается в этом процессе (tcc_run): исполняемый
+// файл не пишется и не проверяется антивирусом, отдельный процесс не
+// создается. Тогда возвращается код завершения игры.
+int build_project(BuildContext* ctx) {
+    FileList* source_files = &ctx->source_files;
+    FileList objects = {0};
+    
+    // Создаем компилятор
+    TCCState* tcc = tcc_new();
+    if (!tcc) {
+        fprintf(stderr, "ERROR: Cannot create TCC instance\n");
+        return 1;
+    }
+    
+    // Настройки
+    tcc_set_output_type(tcc, ctx->run ? TCC_OUTPUT_MEMORY : TCC_OUTPUT_EXE);
+    
+    // Добавляем стандартные и пользовательские пути include
+    add_include_paths(tcc, ctx->options.include_paths, ctx->options.include_count, ctx->verbose);
+    add_defines(tcc, ctx->options.defines, ctx->options.define_count, ctx->verbose);
+    
+    // Добавляем стандартные пути для библиотек
+    tcc_add_library_path(tcc, "lib");
+    tcc_add_library_path(tcc, ".");
+    
+    // Добавляем пользовательские пути для библиотек
+    for (int i = 0; i < ctx->library_path_count; i++) {
+        if (ctx->verbose) printf("Adding library path: %s\n", ctx->library_paths[i]);
+        tcc_add_library_path(tcc, ctx->library_paths[i]);
+    }
+    
+    // Библиотека движка пересобирается вместе с файлами игры, если
+    // изменились ее зависимости или архива нет
+    char engine_object[512] = "";
+    int engine_stale = 0;
+    if (ctx->engine_source[0]) {
+        object_path(ctx->object_dir, ctx->engine_source, engine_object, sizeof(engine_object));
+        engine_stale = !ctx->incremental || !file_exists(ENGINE_LIBRARY) ||
+                       !object_up_to_date(engine_object, &ctx->options);
+    }
+    
+    // 1. Компилируем все исходные файлы
+    printf("1. Compiling source files:\n");
+    int compile_error = 0;
+    if (ctx->use_objects) {
+        // Файлы с неизмененными зависимостями не трогаем вовсе.
+        // Движок - самый долгий файл, он запускается первым.
+        FileList stale = {0};
+        int up_to_date = 0;
+        if (engine_stale) filelist_add(&stale, ctx->engine_source);
+        for (int i = 0; i < source_files->count; i++) {
+            char object[512];
+            object_path(ctx->object_dir, source_files->files[i], object, sizeof(object));
+            if (ctx->incremental && object_up_to_date(object, &ctx->options)) {
+                if (ctx->verbose) printf("  %s (up to date)\n", source_files->files[i]);
+                up_to_date++;
+            } else {
+                filelist_add(&stale, source_files->files[i]);
+            }
+        }
+        
+        int cached = 0;
+        if (stale.count > 1 && ctx->job_limit > 1) {
+            // Каждый файл - в своем процессе
+            compile_error = compile_parallel(ctx->self, &stale, ctx->object_dir, &ctx->options,
+                                             ctx->job_limit, &cached);
+        } else if (stale.count > 0) {
+            compile_error = compile_serial(&stale, ctx->object_dir, &ctx->options, &cached);
+        }
+        
+        if (!compile_error && ctx->incremental) {
+            printf("  %d compiled, %d from cache, %d up to date\n",
+                   stale.count - cached, cached, up_to_date);
+        }
+        filelist_free(&stale);
+        
+        // Объекты в порядке исходников - порядок линковки не зависит от времени
+        for (int i = 0; i < source_files->count && !compile_error; i++) {
+            char object[512];
+            object_path(ctx->object_dir, source_files->files[i], object, sizeof(object));
+            filelist_add(&objects, object);
+            if (tcc_add_file(tcc, object) != 0) {
+                fprintf(stderr, "ERROR: Failed to load %s\n", object);
+                compile_error = 1;
+            }
+        }
+    } else {
+        if (engine_stale) {
+            FileList engine = {0};
+            int cached = 0;
+            filelist_add(&engine, ctx->engine_source);
+            compile_error = compile_serial(&engine, ctx->object_dir, &ctx->options, &cached);
+            filelist_free(&engine);
+        }
+        for (int i = 0; i < source_files->count && !compile_error; i++) {
+            printf("  [%d/%d] %s\n", i + 1, source_files->count, source_files->files[i]);
+            if (tcc_add_file(tcc, source_files->files[i]) != 0) {
+                fprintf(stderr, "ERROR: Failed to compile %s\n", source_files->files[i]);
+                compile_error = 1;
+                break;
+            }
+        }
+    }
+    
+    if (compile_error) {
+        printf("\nPossible issues:\n");
+        printf("  - Missing include files\n");
+        printf("  - Syntax errors in source code\n");
+        printf("  - Required headers not found\n");
+        
+        tcc_delete(tcc);
+        filelist_free(&objects);
+        return 1;
+    }
+    
+    if (engine_stale) {
+        ensure_directory("lib");
+        if (!write_engine_library(engine_object, ENGINE_LIBRARY)) {
+            fprintf(stderr, "ERROR: Cannot write %s\n", ENGINE_LIBRARY);
+            tcc_delete(tcc);
+            filelist_free(&objects);
+            return 1;
+        }
+        printf("  Engine library: %s\n", ENGINE_LIBRARY);
+    }
+    
+    // 2. Добавляем ресурсы
+    if (file_exists(ctx->resource_file)) {
+        printf("2. Adding resource: %s\n", ctx->resource_file);
+        if (tcc_add_file(tcc, ctx->resource_file) != 0) {
+            printf("  Warning: Could not add %s (may be incompatible format)\n", ctx->resource_file);
+        }
+    } else {
+        printf("2. Resource file not found: %s\n", ctx->resource_file);
+    }
+    
+    // 3. Добавляем библиотеки из lib: только нужные объектам
+    if (ctx->verbose) printf("3. Adding libraries from lib\n");
+    add_library_files(tcc, &ctx->library_index, ctx->use_objects ? &objects : NULL, ctx->verbose);
+    filelist_free(&objects);
+    
+    // 4. Добавляем пользовательские библиотеки
+    for (int i = 0; i < ctx->library_count; i++) {
+        if (ctx->verbose) printf("  Adding library: %s\n", ctx->libraries[i]);
+        tcc_add_library(tcc, ctx->libraries[i]);
+    }
+    
+    // 5. Добавляем системные библиотеки
+    add_system_libraries(tcc, ctx->verbose);
+    
+    // 6. Запуск из памяти
+    if (ctx->run) {
+        printf("\n4. Running in memory\n\n");
+        fflush(stdout);
+        int exit_code = tcc_run(tcc, ctx->run_argc, ctx->run_argv);
+        tcc_delete(tcc);
+        
+        fflush(stdout);
+        printf("\nProgram exited with code %d\n", exit_code);
+        return exit_code;
+    }
+    
+    // 6. Создаем выходной файл
+    const char* output_file = ctx->output_file;
+    printf("\n4. Creating output: %s\n", output_file);
+    if (tcc_output_file(tcc, output_file) != 0) {
+        fprintf(stderr, "ERROR: Failed to create output file\n");
+        
+        printf("\nTroubleshooting:\n");
+        printf("  - Check that all required libraries exist\n");
+        printf("  - Verify library paths are correct\n");
+        printf("  - Ensure output directory is writable\n");
+        printf("  - Check for duplicate main() functions\n");
+        
+        tcc_delete(tcc);
+        return 1;
+    }
+    
+    tcc_delete(tcc);
+    return report_output(output_file, "Compilation");
+}
+
+// ==================== СБОРКА RELEASE ====================
+// tcc почти не оптимизирует, поэтому --release собирает выпускную версию
+// внешним компилятором (gcc или clang, --cc): -O3, LTO и -march по
+// пресету. Файлы игры и исходник движка идут одной командой, и LTO
+// встраивает функции движка в код игры. --pgo собирает дважды: между
+// сборками инструментированная игра проходит автоматическую сессию
+// (MIRULIT_AUTOPLAY, синтетический ввод), и вторая сборка использует
+// собранный профиль. Отладочные сборки по-прежнему идут через tcc.
+
+typedef struct {
+    const char* cc;                 // NULL - обычная сборка tcc
+    const char* march;
+    int pgo;
+    int pgo_frames;
+} ReleaseOptions;
+
+typedef enum {
+    PGO_OFF,
+    PGO_GENERATE,
+    PGO_USE
+} PgoPhase;
+
+// Пресеты --march. Имя не из таблицы передается как -march=<имя>.
+typedef struct {
+    const char* name;
+    const char* flags[2];
+} MarchPreset;
+
+const MarchPreset march_presets[] = {
+    #if defined(__aarch64__) || defined(_M_ARM64)
+        { "portable", { NULL, NULL } },
+        { "modern",   { "-march=armv8.2-a", NULL } },
+        { "native",   { "-mcpu=native", NULL } },
+    #else
+        { "portable", { "-march=x86-64-v2", "-mtune=generic" } },   // SSE4.2
+        { "modern",   { "-march=x86-64-v3", "-mtune=generic" } },   // AVX2, FMA
+        { "native",   { "-march=native", NULL } },                  // только эта машина
+    #endif
+    { "none", { NULL, NULL } },
+};
+
+// Системные библиотеки выпускной сборки. Остальное (GL, X11) подтягивает
+// SDL сам, а отсутствующая библиотека у gcc - ошибка, а не предупреждение.
+const char* release_system_libraries[] = {
+    #ifdef _WIN32
+        "kernel32", "user32", "gdi32", "winmm", "ws2_32",
+    #else
+        "m", "dl", "pthread",
+    #endif
+    NULL
+};
+
+int is_clang(const char* cc) {
+    return strstr(cc, "clang") != NULL;
+}
+
+void set_environment(const char* name, const char* value) {
     #ifdef _WIN32
-        snprintf(find_cmd, sizeof(find_cmd), "dir /b \"%s\\*.lib\" \"%s\\*.a\" 2>nul", lib_dir, lib_dir);
-        FILE* pipe = popen(find_cmd, "r");
+        SetEnvironmentVariableA(name, value);
     #else
-        snprintf(find_cmd, sizeof(find_cmd), "ls \"%s\"/*.a \"%s\"/*.lib 2>/dev/null", lib_dir, lib_dir);
-        FILE* pipe = popen(find_cmd, "r");
+        setenv(name, value, 1);
     #endif
+}
+
+// Запуск программы и ожидание. Возвращает код завершения,
+// -1 - программа не запустилась.
+int run_process(const FileList* args, int verbose) {
+    if (verbose) {
+        printf(" ");
+        for (int i = 0; i < args->count; i++) printf(" %s", args->files[i]);
+        printf("\n");
+    }
+    fflush(stdout);
     
-    if (pipe) {
-        char buffer[256];
-        int count = 0;
+    #ifdef _WIN32
+        char command[32768];
+        int length = 0;
+        for (int i = 0; i < args->count && length < (int)sizeof(command); i++) {
+            length += snprintf(command + length, sizeof(command) - length, "%s\"%s\"",
+                               i ? " " : "", args->files[i]);
+        }
+        if (length >= (int)sizeof(command)) return -1;
         
-        while (fgets(buffer, sizeof(buffer), pipe)) {
-            buffer[strcspn(buffer, "\r\n")] = 0;
-            
-            if (buffer[0]) {
-                char full_path[512];
-                #ifdef _WIN32
-                    snprintf(full_path, sizeof(full_path), "%s\\%s", lib_dir, buffer);
-                #else
-                    snprintf(full_path, sizeof(full_path), "%s/%s", lib_dir, buffer);
-                #endif
-                
-                if (verbose) printf("  Adding: %s\n", buffer);
-                
-                if (tcc_add_file(tcc, full_path) != 0 && verbose) {
-                    printf("  Warning: Failed to add %s\n", buffer);
-                }
-                count++;
-            }
+        STARTUPINFOA startup = {0};
+        PROCESS_INFORMATION info = {0};
+        startup.cb = sizeof(startup);
+        if (!CreateProcessA(NULL, command, NULL, NULL, TRUE, 0, NULL, NULL, &startup, &info)) {
+            return -1;
         }
+        CloseHandle(info.hThread);
+        WaitForSingleObject(info.hProcess, INFINITE);
         
-        pclose(pipe);
+        DWORD code = 1;
+        GetExitCodeProcess(info.hProcess, &code);
+        CloseHandle(info.hProcess);
+        return (int)code;
+    #else
+        char** argv = malloc((args->count + 1) * sizeof(char*));
+        if (!argv) return -1;
+        memcpy(argv, args->files, args->count * sizeof(char*));
+        argv[args->count] = NULL;
         
-        if (verbose && count == 0) {
-            printf("  No library files found\n");
+        pid_t pid = fork();
+        if (pid == 0) {
+            execvp(argv[0], argv);
+            _exit(127);
         }
-    } else if (verbose) {
-        printf("  Could not scan directory\n");
-    }
+        free(argv);
+        if (pid < 0) return -1;
+        
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0) {
+            if (errno != EINTR) return -1;
+        }
+        if (!WIFEXITED(status)) return -1;
+        return WEXITSTATUS(status) == 127 ? -1 : WEXITSTATUS(status);
+    #endif
 }
 
-// Добавление системных библиотек
-void add_system_libraries(TCCState* tcc, int verbose) {
-    if (verbose) printf("Adding system libraries\n");
-    
+// Удаление профилей прошлого прогона: gcc копит счетчики в .gcda,
+// а профиль от старого кода только путает компилятор
+void clear_profile_directory(const char* dir) {
     #ifdef _WIN32
-        tcc_add_library(tcc, "kernel32");
-        tcc_add_library(tcc, "user32");
-        tcc_add_library(tcc, "gdi32");
-        tcc_add_library(tcc, "opengl32");
-        tcc_add_library(tcc, "winmm");
-        tcc_add_library(tcc, "ws2_32");
+        char pattern[600];
+        snprintf(pattern, sizeof(pattern), "%s/*", dir);
+        WIN32_FIND_DATAA data;
+        HANDLE find = FindFirstFileA(pattern, &data);
+        if (find == INVALID_HANDLE_VALUE) return;
+        do {
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+            char path[1024];
+            snprintf(path, sizeof(path), "%s/%s", dir, data.cFileName);
+            remove(path);
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
     #else
-        tcc_add_library(tcc, "m");
-        tcc_add_library(tcc, "dl");
-        tcc_add_library(tcc, "pthread");
-        tcc_add_library(tcc, "GL");
-        tcc_add_library(tcc, "X11");
-        
-        if (file_exists("/usr/lib/libglfw.so") || 
-            file_exists("/usr/local/lib/libglfw.so") ||
-            file_exists("/usr/lib/x86_64-linux-gnu/libglfw.so") ||
-            file_exists("lib/libglfw.a") ||
-            file_exists("lib/libglfw.so")) {
-            if (verbose) printf("  Adding: glfw\n");
-            tcc_add_library(tcc, "glfw");
+        DIR* handle = opendir(dir);
+        if (!handle) return;
+        struct dirent* entry;
+        while ((entry = readdir(handle)) != NULL) {
+            if (entry->d_name[0] == '.') continue;
+            char path[1024];
+            snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+            remove(path);
         }
-        
-        #ifdef __APPLE__
-            tcc_add_library(tcc, "objc");
-            tcc_add_library(tcc, "Cocoa");
-            tcc_add_library(tcc, "IOKit");
-            tcc_add_library(tcc, "CoreFoundation");
-            tcc_add_library(tcc, "CoreVideo");
-        #endif
+        closedir(handle);
     #endif
 }
 
-// Показать справку
-void show_help(const char* program_name) {
-    printf("TCC Game Compiler\n");
-    printf("Usage: %s [options] <source.c> [additional_sources...]\n\n", program_name);
-    printf("Options:\n");
-    printf("  -o <file>     Output executable name\n");
-    printf("  -r <file>     Resource object file\n");
-    printf("  -I <path>     Add include path\n");
-    printf("  -L <path>     Add library path\n");
-    printf("  -l <lib>      Link with library\n");
-    printf("  -v            Verbose output\n");
-    printf("  -a            Auto-find all .c files in current directory\n");
-    printf("  -r            Recursive search for source files\n");
-    printf("  -h, --help    Show this help\n");
-    printf("\nExamples:\n");
-    printf("  %s main.c render.c game.c\n", program_name);
-    printf("  %s -o mygame.exe main.c\n", program_name);
-    printf("  %s -a -o mygame.exe               # Auto-find all .c files\n", program_name);
-    printf("  %s -r -o mygame.exe               # Recursive search\n", program_name);
-    printf("  %s -I./include -L./lib -lglfw main.c render.c\n", program_name);
+// Имя llvm-profdata рядом с clang: clang-17 -> llvm-profdata-17
+void profdata_tool(const char* cc, char* out, size_t size) {
+    const char* clang = strstr(cc, "clang");
+    snprintf(out, size, "%.*sllvm-profdata%s", (int)(clang - cc), cc, clang + 5);
+}
+
+// Одна команда компилятора: все исходники игры и движка -> output_file
+int release_compile(const BuildContext* ctx, const ReleaseOptions* release,
+                    PgoPhase phase, const char* profile_dir) {
+    FileList args = {0};
+    char flag[1100];
+    int clang = is_clang(release->cc);
+    
+    filelist_add(&args, release->cc);
+    filelist_add(&args, "-O3");
+    filelist_add(&args, "-DNDEBUG");
+    filelist_add(&args, clang ? "-flto=thin" : "-flto=auto");
+    
+    const char* march = release->march;
+    int preset = -1;
+    for (int i = 0; i < (int)(sizeof(march_presets) / sizeof(march_presets[0])); i++) {
+        if (strcmp(march_presets[i].name, march) == 0) preset = i;
+    }
+    if (preset >= 0) {
+        for (int i = 0; i < 2 && march_presets[preset].flags[i]; i++) {
+            filelist_add(&args, march_presets[preset].flags[i]);
+        }
+    } else {
+        snprintf(flag, sizeof(flag), "-march=%s", march);
+        filelist_add(&args, flag);
+    }
+    
+    if (phase == PGO_GENERATE) {
+        snprintf(flag, sizeof(flag), "-fprofile-generate=%s", profile_dir);
+        filelist_add(&args, flag);
+        // Счетчики обновляют и рабочие потоки движка
+        if (!clang) filelist_add(&args, "-fprofile-update=atomic");
+    } else if (phase == PGO_USE) {
+        if (clang) {
+            snprintf(flag, sizeof(flag), "-fprofile-use=%s/game.profdata", profile_dir);
+            filelist_add(&args, flag);
+            filelist_add(&args, "-Wno-profile-instr-unprofiled");
+        } else {
+            snprintf(flag, sizeof(flag), "-fprofile-use=%s", profile_dir);
+            filelist_add(&args, flag);
+            filelist_add(&args, "-fprofile-correction");
+            filelist_add(&args, "-Wno-missing-profile");
+        }
+    }
+    
+    // Те же пути include и макросы, что у tcc (add_include_paths)
+    const char* default_includes[] = { "include", ".", "src", "mirulit" };
+    for (int i = 0; i < 4; i++) {
+        snprintf(flag, sizeof(flag), "-I%s", default_includes[i]);
+        filelist_add(&args, flag);
+    }
+    for (int i = 0; i < ctx->options.include_count; i++) {
+        snprintf(flag, sizeof(flag), "-I%s", ctx->options.include_paths[i]);
+        filelist_add(&args, flag);
+    }
+    for (int i = 0; i < ctx->options.define_count; i++) {
+        snprintf(flag, sizeof(flag), "-D%s", ctx->options.defines[i]);
+        filelist_add(&args, flag);
+    }
+    
+    for (int i = 0; i < ctx->source_files.count; i++) {
+        filelist_add(&args, ctx->source_files.files[i]);
+    }
+    if (ctx->engine_source[0]) filelist_add(&args, ctx->engine_source);
+    if (file_exists(ctx->resource_file)) filelist_add(&args, ctx->resource_file);
+    
+    filelist_add(&args, "-o");
+    filelist_add(&args, ctx->output_file);
+    
+    filelist_add(&args, "-Llib");
+    for (int i = 0; i < ctx->library_path_count; i++) {
+        snprintf(flag, sizeof(flag), "-L%s", ctx->library_paths[i]);
+        filelist_add(&args, flag);
+    }
+    for (int i = 0; i < ctx->library_count; i++) {
+        snprintf(flag, sizeof(flag), "-l%s", ctx->libraries[i]);
+        filelist_add(&args, flag);
+    }
+    for (int i = 0; release_system_libraries[i]; i++) {
+        snprintf(flag, sizeof(flag), "-l%s", release_system_libraries[i]);
+        filelist_add(&args, flag);
+    }
+    
+    int code = run_process(&args, ctx->verbose);
+    if (code < 0) {
+        fprintf(stderr, "ERROR: Cannot run %s (install gcc or clang, or pass --cc)\n", release->cc);
+    } else if (code != 0) {
+        fprintf(stderr, "ERROR: %s failed (exit code %d)\n", release->cc, code);
+    }
+    filelist_free(&args);
+    return code != 0;
+}
+
+// Тренировочный прогон инструментированной игры
+int release_train(const BuildContext* ctx, const ReleaseOptions* release, const char* profile_dir) {
+    char value[1100];
+    snprintf(value, sizeof(value), "%d,1", release->pgo_frames);
+    set_environment("MIRULIT_AUTOPLAY", value);
+    if (is_clang(release->cc)) {
+        snprintf(value, sizeof(value), "%s/game.profraw", profile_dir);
+        set_environment("LLVM_PROFILE_FILE", value);
+    }
+    
+    // Без пути execvp искал бы игру в PATH
+    FileList args = {0};
+    if (strchr(ctx->output_file, '/') || strchr(ctx->output_file, '\\')) {
+        filelist_add(&args, ctx->output_file);
+    } else {
+        snprintf(value, sizeof(value), "./%s", ctx->output_file);
+        filelist_add(&args, value);
+    }
+    int code = run_process(&args, ctx->verbose);
+    filelist_free(&args);
+    
+    if (code != 0) {
+        fprintf(stderr, "ERROR: Training run failed (exit code %d)\n", code);
+        fprintf(stderr, "  The game needs a display; on a headless machine try SDL_VIDEO_DRIVER=offscreen\n");
+        return 1;
+    }
+    if (!is_clang(release->cc)) return 0;
+    
+    // clang пишет сырой профиль, компилятору нужен объединенный
+    char tool[512];
+    profdata_tool(release->cc, tool, sizeof(tool));
+    filelist_add(&args, tool);
+    filelist_add(&args, "merge");
+    filelist_add(&args, "-o");
+    snprintf(value, sizeof(value), "%s/game.profdata", profile_dir);
+    filelist_add(&args, value);
+    snprintf(value, sizeof(value), "%s/game.profraw", profile_dir);
+    filelist_add(&args, value);
+    code = run_process(&args, ctx->verbose);
+    filelist_free(&args);
+    
+    if (code != 0) {
+        fprintf(stderr, "ERROR: %s merge failed\n", tool);
+        return 1;
+    }
+    return 0;
+}
+
+// Выпускная сборка; с --pgo - инструментированная сборка, прогон и
+// итоговая сборка с профилем. Обе сборки пишут в один и тот же файл:
+// gcc называет профили по имени выходного файла.
+int build_release(const BuildContext* ctx, const ReleaseOptions* release, const char* build_dir) {
+    printf("Release build: %s, -O3, LTO, march %s%s\n", release->cc, release->march,
+           release->pgo ? ", PGO" : "");
+    
+    if (!release->pgo) {
+        printf("1. Compiling and linking\n");
+        if (release_compile(ctx, release, PGO_OFF, NULL)) return 1;
+        return report_output(ctx->output_file, "Release build");
+    }
+    
+    char profile_dir[512];
+    snprintf(profile_dir, sizeof(profile_dir), "%s/pgo", build_dir);
+    ensure_directory(profile_dir);
+    clear_profile_directory(profile_dir);
+    
+    printf("1. Instrumented build\n");
+    if (release_compile(ctx, release, PGO_GENERATE, profile_dir)) return 1;
+    
+    printf("2. Training run: %d frames of autoplay\n", release->pgo_frames);
+    if (release_train(ctx, release, profile_dir)) return 1;
+    
+    printf("3. Optimized build with profile\n");
+    if (release_compile(ctx, release, PGO_USE, profile_dir)) return 1;
+    return report_output(ctx->output_file, "Release build");
 }
 
 int main(int argc, char** argv) {
@@ -272,12 +2308,25 @@ int main(int argc, char** argv) {
     char** include_paths = NULL;
     char** library_paths = NULL;
     char** libraries = NULL;
+    char** defines = NULL;
     int include_count = 0;
+    int define_count = 0;
     int library_path_count = 0;
     int library_count = 0;
     int verbose = 0;
     int auto_find = 0;
     int recursive = 0;
+    int job_limit = cpu_count();
+    const char* compile_object_source = NULL;
+    const char* cache_dir = NULL;
+    int use_cache = 1;
+    int watch = 0;
+    ReleaseOptions release = { NULL, "portable", 0, 3600 };
+    int run = 0;
+    int run_argc = 0;
+    char** run_argv = NULL;
+    const char* release_cc = getenv("CC");
+    int release_build = 0;
     
     // Парсинг аргументов командной строки
     for (int i = 1; i < argc; i++) {
@@ -292,6 +2341,14 @@ int main(int argc, char** argv) {
                 include_paths = realloc(include_paths, (include_count + 1) * sizeof(char*));
                 include_paths[include_count++] = argv[++i];
             }
+            else if (strcmp(argv[i], "-D") == 0 && i + 1 < argc) {
+                defines = realloc(defines, (define_count + 1) * sizeof(char*));
+                defines[define_count++] = argv[++i];
+            }
+            else if (strncmp(argv[i], "-D", 2) == 0 && argv[i][2]) {
+                defines = realloc(defines, (define_count + 1) * sizeof(char*));
+                defines[define_count++] = argv[i] + 2;
+            }
             else if (strcmp(argv[i], "-L") == 0 && i + 1 < argc) {
                 library_paths = realloc(library_paths, (library_path_count + 1) * sizeof(char*));
                 library_paths[library_path_count++] = argv[++i];
@@ -303,6 +2360,47 @@ int main(int argc, char** argv) {
             else if (strcmp(argv[i], "-v") == 0) {
                 verbose = 1;
             }
+            else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                job_limit = atoi(argv[++i]);
+                if (job_limit < 1) job_limit = 1;
+            }
+            else if (strcmp(argv[i], "--compile-object") == 0 && i + 1 < argc) {
+                compile_object_source = argv[++i];
+            }
+            else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+                cache_dir = argv[++i];
+            }
+            else if (strcmp(argv[i], "--no-cache") == 0) {
+                use_cache = 0;
+            }
+            else if (strcmp(argv[i], "--watch") == 0) {
+                watch = 1;
+            }
+            else if (strcmp(argv[i], "--run") == 0) {
+                run = 1;
+            }
+            else if (strcmp(argv[i], "--") == 0) {
+                // Все после -- - аргументы игры для --run
+                run_argc = argc - i - 1;
+                run_argv = argv + i + 1;
+                break;
+            }
+            else if (strcmp(argv[i], "--release") == 0) {
+                release_build = 1;
+            }
+            else if (strcmp(argv[i], "--cc") == 0 && i + 1 < argc) {
+                release_cc = argv[++i];
+            }
+            else if (strcmp(argv[i], "--march") == 0 && i + 1 < argc) {
+                release.march = argv[++i];
+            }
+            else if (strcmp(argv[i], "--pgo") == 0) {
+                release.pgo = 1;
+            }
+            else if (strcmp(argv[i], "--pgo-frames") == 0 && i + 1 < argc) {
+                release.pgo_frames = atoi(argv[++i]);
+                if (release.pgo_frames < 1) release.pgo_frames = 1;
+            }
             else if (strcmp(argv[i], "-a") == 0) {
                 auto_find = 1;
             }
@@ -329,6 +2427,32 @@ int main(int argc, char** argv) {
         }
     }
     
+    // Дочерний процесс параллельной сборки: один файл -> объектный
+    if (compile_object_source) {
+        CompileOptions options = { include_paths, include_count, defines, define_count, cache_dir };
+        int result = compile_object(compile_object_source, output_file, &options);
+        free(include_paths);
+        free(defines);
+        free(library_paths);
+        free(libraries);
+        return result;
+    }
+    
+    if (release_build) {
+        release.cc = release_cc && *release_cc ? release_cc : "gcc";
+    } else if (release.pgo) {
+        fprintf(stderr, "ERROR: --pgo needs --release\n");
+        return 1;
+    }
+    if (release.cc && run) {
+        fprintf(stderr, "ERROR: --run builds with tcc, not --release\n");
+        return 1;
+    }
+    if (release.cc && watch) {
+        fprintf(stderr, "ERROR: --watch is for tcc debug builds, not --release\n");
+        return 1;
+    }
+    
     // Если включен автопоиск и нет указанных файлов
     if ((auto_find || recursive) && source_files.count == 0) {
         if (recursive) {
@@ -382,7 +2506,7 @@ int main(int argc, char** argv) {
     
     printf("Mirlit Compiler\n");
     printf("============\n");
-    printf("Output: %s\n", output_file);
+    printf("Output: %s\n", run ? "memory (--run)" : output_file);
     printf("Resource: %s\n", resource_file);
     printf("Source files (%d):\n", source_files.count);
     for (int i = 0; i < source_files.count; i++) {
@@ -396,6 +2520,7 @@ int main(int argc, char** argv) {
             fprintf(stderr, "ERROR: Source file '%s' not found!\n", source_files.files[i]);
             filelist_free(&source_files);
             free(include_paths);
+            free(defines);
             free(library_paths);
             free(libraries);
             return 1;
@@ -414,151 +2539,91 @@ int main(int argc, char** argv) {
         ensure_directory("bin");
     }
     
-    // Создаем компилятор
-    TCCState* tcc = tcc_new();
-    if (!tcc) {
-        fprintf(stderr, "ERROR: Cannot create TCC instance\n");
-        filelist_free(&source_files);
-        free(include_paths);
-        free(library_paths);
-        free(libraries);
-        return 1;
-    }
-    
-    // Настройки
-    tcc_set_output_type(tcc, TCC_OUTPUT_EXE);
-    
-    // Добавляем стандартные пути include
-    tcc_add_include_path(tcc, "include");
-    tcc_add_include_path(tcc, ".");
-    tcc_add_include_path(tcc, "src");
-    tcc_add_include_path(tcc, ".");
-    tcc_add_include_path(tcc, "mirulit");
+    // Все, что не меняется между сборками
+    BuildContext ctx = {0};
+    ctx.source_files = source_files;
+    ctx.library_paths = library_paths;
+    ctx.libraries = libraries;
+    ctx.library_path_count = library_path_count;
+    ctx.library_count = library_count;
+    ctx.output_file = output_file;
+    ctx.resource_file = resource_file;
+    ctx.job_limit = job_limit;
+    ctx.verbose = verbose;
+    ctx.run = run;
     
-    // Добавляем пользовательские пути include
-    for (int i = 0; i < include_count; i++) {
-        if (verbose) printf("Adding include path: %s\n", include_paths[i]);
-        tcc_add_include_path(tcc, include_paths[i]);
+    // argv[0] игры - имя выходного файла, как при обычном запуске
+    ctx.run_argv = malloc((run_argc + 2) * sizeof(char*));
+    ctx.run_argv[0] = (char*)output_file;
+    for (int i = 0; i < run_argc; i++) ctx.run_argv[i + 1] = run_argv[i];
+    ctx.run_argv[run_argc + 1] = NULL;
+    ctx.run_argc = run_argc + 1;
+    ctx.options = (CompileOptions){ include_paths, include_count, defines, define_count, NULL };
+    if (find_engine_source(&ctx.options, ctx.engine_source, sizeof(ctx.engine_source)) && verbose) {
+        printf("Engine source: %s -> %s\n", ctx.engine_source, ENGINE_LIBRARY);
     }
     
-    // Добавляем стандартные пути для библиотек
-    tcc_add_library_path(tcc, "lib");
-    tcc_add_library_path(tcc, ".");
-    
-    // Добавляем пользовательские пути для библиотек
-    for (int i = 0; i < library_path_count; i++) {
-        if (verbose) printf("Adding library path: %s\n", library_paths[i]);
-        tcc_add_library_path(tcc, library_paths[i]);
+    // Объекты и зависимости в <выход>/obj, кэш - в <выход>/cache
+    const char* build_dir = last_slash ? output_dir : "bin";
+    char default_cache_dir[512];
+    snprintf(ctx.object_dir, sizeof(ctx.object_dir), "%s/obj", build_dir);
+    snprintf(default_cache_dir, sizeof(default_cache_dir), "%s/cache", build_dir);
+    if (use_cache) {
+        ctx.options.cache_dir = cache_dir ? cache_dir : default_cache_dir;
+        ensure_directory(ctx.options.cache_dir);
     }
     
-    // 1. Компилируем все исходные файлы
-    printf("1. Compiling source files:\n");
-    int compile_error = 0;
-    for (int i = 0; i < source_files.count; i++) {
-        printf("  [%d/%d] %s\n", i + 1, source_files.count, source_files.files[i]);
-        if (tcc_add_file(tcc, source_files.files[i]) != 0) {
-            fprintf(stderr, "ERROR: Failed to compile %s\n", source_files.files[i]);
-            compile_error = 1;
-            break;
-        }
-    }
+    ctx.use_objects = use_cache || watch || (source_files.count > 1 && job_limit > 1);
+    ctx.incremental = use_cache || watch;
     
-    if (compile_error) {
-        printf("\nPossible issues:\n");
-        printf("  - Missing include files\n");
-        printf("  - Syntax errors in source code\n");
-        printf("  - Required headers not found\n");
-        
-        tcc_delete(tcc);
+    // Параллельные задания запускают этот же исполняемый файл
+    #ifdef _WIN32
+        GetModuleFileNameA(NULL, ctx.self, sizeof(ctx.self));
+    #else
+        snprintf(ctx.self, sizeof(ctx.self), "%s", argv[0]);
+    #endif
+    
+    // Выпускная сборка - внешним компилятором, без объектов tcc и lib
+    if (release.cc) {
+        int result = build_release(&ctx, &release, build_dir);
+        free(ctx.run_argv);
         filelist_free(&source_files);
         free(include_paths);
+        free(defines);
         free(library_paths);
         free(libraries);
-        return 1;
+        return result;
     }
     
-    // 2. Добавляем ресурсы
-    if (file_exists(resource_file)) {
-        printf("2. Adding resource: %s\n", resource_file);
-        if (tcc_add_file(tcc, resource_file) != 0) {
-            printf("  Warning: Could not add %s (may be incompatible format)\n", resource_file);
-        }
-    } else {
-        printf("2. Resource file not found: %s\n", resource_file);
-    }
+    char manifest[512];
+    snprintf(manifest, sizeof(manifest), "%s/libs.manifest", build_dir);
+    library_index_open(&ctx.library_index, "lib", manifest, verbose);
     
-    // 3. Добавляем библиотеки из lib
-    if (verbose) printf("3. Adding libraries from lib\n");
-    add_all_library_files(tcc, "lib", verbose);
+    int result = build_project(&ctx);
     
-    // 4. Добавляем пользовательские библиотеки
-    for (int i = 0; i < library_count; i++) {
-        if (verbose) printf("  Adding library: %s\n", libraries[i]);
-        tcc_add_library(tcc, libraries[i]);
+    // --watch: пересборка после каждого сохранения, до Ctrl+C.
+    // Наблюдаются и зависимости движка: правка его заголовка пересобирает архив.
+    FileList watched = {0};
+    for (int i = 0; watch && i < source_files.count; i++) {
+        filelist_add(&watched, source_files.files[i]);
     }
+    if (watch && ctx.engine_source[0]) filelist_add(&watched, ctx.engine_source);
     
-    // 5. Добавляем системные библиотеки
-    add_system_libraries(tcc, verbose);
-    
-    // 6. Создаем выходной файл
-    printf("\n4. Creating output: %s\n", output_file);
-    if (tcc_output_file(tcc, output_file) != 0) {
-        fprintf(stderr, "ERROR: Failed to create output file\n");
-        
-        printf("\nTroubleshooting:\n");
-        printf("  - Check that all required libraries exist\n");
-        printf("  - Verify library paths are correct\n");
-        printf("  - Ensure output directory is writable\n");
-        printf("  - Check for duplicate main() functions\n");
-        
-        tcc_delete(tcc);
-        filelist_free(&source_files);
-        free(include_paths);
-        free(library_paths);
-        free(libraries);
-        return 1;
+    while (watch) {
+        wait_for_changes(&watched, ctx.object_dir, &ctx.options);
+        printf("\nChanges detected, rebuilding...\n\n");
+        result = build_project(&ctx);
     }
     
     // Очистка
-    tcc_delete(tcc);
+    free(ctx.run_argv);
+    filelist_free(&watched);
+    library_index_free(&ctx.library_index);
     filelist_free(&source_files);
     free(include_paths);
+    free(defines);
     free(library_paths);
     free(libraries);
     
-    // Проверяем, что файл создан
-    if (file_exists(output_file)) {
-        printf("\n✅ SUCCESS: Compilation completed!\n");
-        printf("   Output: %s\n", output_file);
-        
-        // Получаем размер файла
-        FILE* f = fopen(output_file, "rb");
-        if (f) {
-            fseek(f, 0, SEEK_END);
-            long size = ftell(f);
-            fclose(f);
-            
-            if (size < 1024) 
-                printf("   Size: %ld bytes\n", size);
-            else if (size < 1024*1024) 
-                printf("   Size: %.1f KB\n", size/1024.0);
-            else 
-                printf("   Size: %.1f MB\n", size/(1024.0*1024.0));
-        }
-        
-        #ifdef _WIN32
-            printf("   Run: %s\n", output_file);
-        #else
-            if (access(output_file, X_OK) == 0) {
-                printf("   Run: ./%s\n", output_file);
-            } else {
-                printf("   Note: File may not be executable, run: chmod +x %s\n", output_file);
-            }
-        #endif
-    } else {
-        fprintf(stderr, "\n❌ ERROR: Output file was not created\n");
-        return 1;
-    }
-    
-    return 0;
+    return result;
 }
\ No newline at end of file
@@ -19,46 +19,169 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <stdatomic.h>
+
+#include "tcc.h"
 
 #ifdef _WIN32
     #include <windows.h>
     #include <direct.h>
-    #define popen _popen
-    #define pclose _pclose
     #define mkdir _mkdir
     #define PATH_SEPARATOR '\\'
     #define PATH_SEPARATOR_STR "\\"
+    #define THREAD_ENTRY(name) static DWORD WINAPI name(void* data)
+    typedef HANDLE ThreadHandle;
+    typedef LPTHREAD_START_ROUTINE ThreadEntry;
 #else
     #include <unistd.h>
+    #include <errno.h>
+    #include <fcntl.h>
     #include <sys/stat.h>
+    #include <sys/wait.h>
     #include <dirent.h>
+    #include <pthread.h>
+    #include <signal.h>
     #define PATH_SEPARATOR '/'
     #define PATH_SEPARATOR_STR "/"
+    #define THREAD_ENTRY(name) static void* name(void* data)
+    typedef pthread_t ThreadHandle;
+    typedef void* (*ThreadEntry)(void*);
 #endif
 
 /* ==================== STRUCTURES ==================== */
 
+/* Text of the editor: a gap buffer. Edits happen at the gap, so typing
+   moves no text unless the cursor jumps. Line starts live in a gap array
+   that follows the text gap: starts before it count from the beginning of
+   the text, starts after it from the end. An edit then only adds or removes
+   the starts of the lines it touches, and no offsets need shifting. */
+typedef struct {
+    char* text;
+    size_t capacity;
+    size_t gap_start;
+    size_t gap_end;
+    size_t* lines;          /* line starts, line 0 always before the gap */
+    int line_capacity;
+    int line_gap_start;     /* lines starting at or before gap_start */
+    int line_gap_end;
+} Document;
+
+#define EDITOR_UNDO_LIMIT 1024
+#define EDITOR_LINE_MAX 4096    /* bytes of a line that are drawn */
+
+/* One edit, enough to undo and redo it */
 typedef struct {
-    char* buffer;
-    size_t buffer_size;
-    size_t buffer_length;
+    int inserted;           /* 1: text was inserted at pos, 0: deleted */
+    size_t pos;
+    char* text;
+    size_t length;
+} EditRecord;
+
+typedef struct {
+    Document doc;
     char filename[256];
     char filepath[512];
     int modified;
-    int line_count;
     int cursor_line;
     int cursor_column;
+    unsigned version;       /* bumped on every change of the text */
+    double changed_at;      /* glfwGetTime() of the last edit */
+    
+    /* Cursor and selection, byte offsets; selected is anchor..cursor */
+    size_t cursor;
+    size_t anchor;
+    float goal_x;           /* column kept while moving up and down */
+    int vertical;           /* last move was up or down, goal_x is valid */
+    
+    /* View */
+    int scroll_line;        /* first visible line */
+    float scroll_x;
+    int focused;
+    int selecting;          /* mouse drag selection */
+    int scrollbar_drag;
+    
+    EditRecord undo[EDITOR_UNDO_LIMIT];
+    int undo_count;
+    int undo_position;      /* records before it are done, after it undone */
 } TextEditor;
 
 typedef struct {
     char output_name[256];
     char compiler[256];
+    char runner[256];       /* Build driver for Run: compiles in memory */
     char cflags[512];
     int optimization;
     int debug_info;
     int warnings;
+    int use_libtcc;         /* Build in-process; compiler is the fallback */
 } BuildConfig;
 
+#define BUILD_QUEUE_SIZE 256    /* lines, power of two */
+#define BUILD_LINE_SIZE 256
+
+/* Compiler output on its way from the build thread to the UI thread.
+   Single producer, single consumer: each side only writes its own index,
+   so neither side ever takes a lock or waits for the other. */
+typedef struct {
+    char lines[BUILD_QUEUE_SIZE][BUILD_LINE_SIZE];
+    atomic_uint head;       /* next slot to write, build thread */
+    atomic_uint tail;       /* next slot to read, UI thread */
+} BuildQueue;
+
+/* A compile of the editor buffer with libtcc on a worker thread. The task
+   owns a copy of the buffer, so the user keeps typing while it compiles. */
+typedef struct {
+    char* source;           /* "#line" prefix + buffer */
+    char directory[512];    /* directory of the file, for its own includes */
+    char options[640];
+    char output_name[256];  /* empty: compile only (syntax check) */
+} TccTask;
+
+/* A build running in the background. An external compiler is started on
+   the UI thread and the build thread only reads its output and waits for
+   it; an in-process build runs libtcc on the build thread itself. */
+typedef struct {
+    BuildQueue queue;
+    atomic_int files_done;  /* from "[k/n]" lines of the build driver */
+    atomic_int files_total;
+    atomic_int cancel;
+    atomic_int finished;
+    int result;             /* exit code, valid once finished is set */
+    int temp_source;        /* temp.c was written for an unsaved buffer */
+    int in_process;         /* libtcc build of task, no process */
+    TccTask task;
+    ThreadHandle thread;
+    #ifdef _WIN32
+        HANDLE process;
+        HANDLE process_group;   /* job object: cancel ends child processes too */
+        HANDLE output;
+    #else
+        pid_t pid;              /* also the process group id */
+        int output;
+    #endif
+} BuildJob;
+
+#define CHECK_DELAY 0.3         /* seconds without typing before a check */
+
+/* Syntax check of the editor buffer: libtcc compiles it in memory on a
+   background thread while the user types */
+typedef struct {
+    TccTask task;
+    ThreadHandle thread;
+    atomic_int finished;
+    int running;
+    unsigned version;       /* editor version of the running or last check */
+    
+    /* Written by the check thread, read once finished is set */
+    char diagnostics[4096];
+    int errors;
+    
+    /* Last finished check, shown next to the editor title */
+    int checked;
+    int error_count;
+    char first_error[256];
+} SyntaxCheck;
+
 typedef struct {
     /* Windows visibility */
     int show_editor;
@@ -77,9 +200,11 @@ typedef struct {
     
     /* Build */
     BuildConfig build;
-    char build_log[4096];
+    char build_log[32768];
     int building;
     nk_size build_progress;
+    BuildJob build_job;
+    SyntaxCheck check;
     
     /* GLFW */
     GLFWwindow* window;
@@ -90,12 +215,17 @@ typedef struct {
 /* ==================== PROTOTYPES ==================== */
 
 static void init_editor(TextEditor* editor);
+static void editor_reset(TextEditor* editor);
 static void init_build_config(BuildConfig* config);
 static void init_state(IDEState* state);
 static int load_file(TextEditor* editor, const char* filepath);
 static int save_file(TextEditor* editor);
 static void scan_directory(IDEState* state);
 static void build_project(IDEState* state);
+static void poll_build(IDEState* state);
+static void cancel_build(IDEState* state);
+static void poll_syntax_check(IDEState* state);
+static void run_project(IDEState* state);
 static void render_ui(IDEState* state);
 
 /* ==================== GLOBAL VARIABLES ==================== */
@@ -108,25 +238,182 @@ static void glfw_error_callback(int error, const char* description) {
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
 }
 
-/* ==================== INITIALIZATION ==================== */
+/* ==================== DOCUMENT ==================== */
 
-static void init_editor(TextEditor* editor) {
-    editor->buffer_size = 65536;
-    editor->buffer = (char*)malloc(editor->buffer_size);
-    if (!editor->buffer) {
-        fprintf(stderr, "Failed to allocate memory for editor\n");
-        exit(1);
+#define DOCUMENT_MIN_GAP 4096
+
+static size_t doc_length(const Document* doc) {
+    return doc->capacity - (doc->gap_end - doc->gap_start);
+}
+
+static int doc_line_count(const Document* doc) {
+    return doc->line_gap_start + (doc->line_capacity - doc->line_gap_end);
+}
+
+static char doc_char(const Document* doc, size_t pos) {
+    return pos < doc->gap_start ? doc->text[pos] :
+        doc->text[pos + (doc->gap_end - doc->gap_start)];
+}
+
+static size_t doc_line_start(const Document* doc, int line) {
+    if (line < doc->line_gap_start) return doc->lines[line];
+    return doc_length(doc) - doc->lines[doc->line_gap_end + (line - doc->line_gap_start)];
+}
+
+/* End of a line, before its '\n' */
+static size_t doc_line_end(const Document* doc, int line) {
+    if (line + 1 < doc_line_count(doc)) return doc_line_start(doc, line + 1) - 1;
+    return doc_length(doc);
+}
+
+/* Line that contains pos: binary search over the line starts */
+static int doc_line_of(const Document* doc, size_t pos) {
+    int low = 0;
+    int high = doc_line_count(doc) - 1;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (doc_line_start(doc, middle) <= pos) low = middle;
+        else high = middle - 1;
+    }
+    return low;
+}
+
+static void doc_copy(const Document* doc, size_t pos, size_t length, char* out) {
+    size_t before = 0;
+    if (pos < doc->gap_start) {
+        before = doc->gap_start - pos;
+        if (before > length) before = length;
+        memcpy(out, doc->text + pos, before);
     }
-    editor->buffer[0] = '\0';
-    editor->buffer_length = 0;
+    memcpy(out + before, doc->text + pos + before + (doc->gap_end - doc->gap_start),
+        length - before);
+}
+
+static size_t doc_write(const Document* doc, FILE* file) {
+    size_t written = fwrite(doc->text, 1, doc->gap_start, file);
+    written += fwrite(doc->text + doc->gap_end, 1, doc->capacity - doc->gap_end, file);
+    return written;
+}
+
+/* Move the gap to pos. Line starts that cross it switch between offsets
+   from the beginning and offsets from the end. */
+static void doc_move_gap(Document* doc, size_t pos) {
+    size_t length = doc_length(doc);
     
-    strcpy(editor->filename, "untitled.c");
-    strcpy(editor->filepath, "");
-    editor->modified = 0;
-    editor->line_count = 1;
-    editor->cursor_line = 1;
-    editor->cursor_column = 0;
+    if (pos < doc->gap_start) {
+        size_t count = doc->gap_start - pos;
+        memmove(doc->text + doc->gap_end - count, doc->text + pos, count);
+        doc->gap_start -= count;
+        doc->gap_end -= count;
+        
+        /* Line 0 starts at 0 and never leaves the front */
+        while (doc->lines[doc->line_gap_start - 1] > pos) {
+            doc->line_gap_start--;
+            doc->lines[--doc->line_gap_end] = length - doc->lines[doc->line_gap_start];
+        }
+    } else if (pos > doc->gap_start) {
+        size_t count = pos - doc->gap_start;
+        memmove(doc->text + doc->gap_start, doc->text + doc->gap_end, count);
+        doc->gap_start += count;
+        doc->gap_end += count;
+        
+        while (doc->line_gap_end < doc->line_capacity &&
+               length - doc->lines[doc->line_gap_end] <= pos) {
+            doc->lines[doc->line_gap_start++] = length - doc->lines[doc->line_gap_end++];
+        }
+    }
+}
+
+/* Make room for bytes more text and lines more line starts */
+static int doc_reserve(Document* doc, size_t bytes, int lines) {
+    if (doc->gap_end - doc->gap_start < bytes) {
+        size_t after = doc->capacity - doc->gap_end;
+        size_t capacity = doc->capacity * 2 + bytes;
+        char* text = (char*)realloc(doc->text, capacity);
+        if (!text) return 0;
+        memmove(text + capacity - after, text + doc->gap_end, after);
+        doc->text = text;
+        doc->gap_end = capacity - after;
+        doc->capacity = capacity;
+    }
+    
+    if (doc->line_gap_end - doc->line_gap_start < lines) {
+        int after = doc->line_capacity - doc->line_gap_end;
+        int capacity = doc->line_capacity * 2 + lines;
+        size_t* starts = (size_t*)realloc(doc->lines, (size_t)capacity * sizeof(size_t));
+        if (!starts) return 0;
+        memmove(starts + capacity - after, starts + doc->line_gap_end, (size_t)after * sizeof(size_t));
+        doc->lines = starts;
+        doc->line_gap_end = capacity - after;
+        doc->line_capacity = capacity;
+    }
+    return 1;
+}
+
+static int doc_insert(Document* doc, size_t pos, const char* text, size_t length) {
+    int newlines = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '\n') newlines++;
+    }
+    if (!doc_reserve(doc, length, newlines)) return 0;
+    
+    doc_move_gap(doc, pos);
+    memcpy(doc->text + doc->gap_start, text, length);
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '\n') doc->lines[doc->line_gap_start++] = pos + i + 1;
+    }
+    doc->gap_start += length;
+    return 1;
+}
+
+static void doc_delete(Document* doc, size_t pos, size_t length) {
+    doc_move_gap(doc, pos);
     
+    /* Lines that start inside the deleted text go with it */
+    size_t total = doc_length(doc);
+    while (doc->line_gap_end < doc->line_capacity &&
+           total - doc->lines[doc->line_gap_end] <= pos + length) {
+        doc->line_gap_end++;
+    }
+    doc->gap_end += length;
+}
+
+static void doc_free(Document* doc) {
+    free(doc->text);
+    free(doc->lines);
+    memset(doc, 0, sizeof(*doc));
+}
+
+/* Replace the whole text; the line index is built once here */
+static int doc_set(Document* doc, const char* text, size_t length) {
+    Document fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    fresh.capacity = length + DOCUMENT_MIN_GAP;
+    fresh.gap_end = fresh.capacity;
+    fresh.text = (char*)malloc(fresh.capacity);
+    fresh.line_capacity = 1024;
+    fresh.line_gap_start = 1;
+    fresh.line_gap_end = fresh.line_capacity;
+    fresh.lines = (size_t*)malloc((size_t)fresh.line_capacity * sizeof(size_t));
+    
+    if (!fresh.text || !fresh.lines) {
+        doc_free(&fresh);
+        return 0;
+    }
+    fresh.lines[0] = 0;
+    if (!doc_insert(&fresh, 0, text, length)) {
+        doc_free(&fresh);
+        return 0;
+    }
+    
+    doc_free(doc);
+    *doc = fresh;
+    return 1;
+}
+
+/* ==================== INITIALIZATION ==================== */
+
+static void init_editor(TextEditor* editor) {
     /* Default C code */
     const char* default_code = 
         "/* Welcome to C Editor */\n"
@@ -142,32 +429,33 @@ static void init_editor(TextEditor* editor) {
         "    return 0;\n"
         "}\n";
     
-    strncpy(editor->buffer, default_code, editor->buffer_size - 1);
-    editor->buffer[editor->buffer_size - 1] = '\0';
-    editor->buffer_length = strlen(editor->buffer);
-    
-    /* Count lines */
-    editor->line_count = 1;
-    for (size_t i = 0; i < editor->buffer_length; i++) {
-        if (editor->buffer[i] == '\n') {
-            editor->line_count++;
-        }
+    if (!doc_set(&editor->doc, default_code, strlen(default_code))) {
+        fprintf(stderr, "Failed to allocate memory for editor\n");
+        exit(1);
     }
+    editor_reset(editor);
+    
+    strcpy(editor->filename, "untitled.c");
+    strcpy(editor->filepath, "");
+    editor->modified = 0;
 }
 
 static void init_build_config(BuildConfig* config) {
     strcpy(config->output_name, "program");
     #ifdef _WIN32
         strcpy(config->compiler, "gcc");
+        strcpy(config->runner, "compiler.exe");
         strcat(config->output_name, ".exe");
     #else
         strcpy(config->compiler, "gcc");
+        strcpy(config->runner, "./compiler");
     #endif
     
     strcpy(config->cflags, "-Wall -Wextra -std=c11");
     config->optimization = 1;
     config->debug_info = 1;
     config->warnings = 2;
+    config->use_libtcc = 1;
 }
 
 static void init_state(IDEState* state) {
@@ -225,24 +513,20 @@ static int load_file(TextEditor* editor, const char* filepath) {
         return 0;
     }
     
-    /* Check if file fits */
-    if ((size_t)size >= editor->buffer_size - 1) {
-        editor->buffer_size = (size_t)size + 1024;
-        char* new_buffer = (char*)realloc(editor->buffer, editor->buffer_size);
-        if (!new_buffer) {
-            fclose(file);
-            return 0;
-        }
-        editor->buffer = new_buffer;
-    }
-    
     /* Read file */
-    size_t read = fread(editor->buffer, 1, (size_t)size, file);
-    editor->buffer[read] = '\0';
-    editor->buffer_length = read;
-    
+    char* text = (char*)malloc((size_t)size);
+    if (!text) {
+        fclose(file);
+        return 0;
+    }
+    size_t read = fread(text, 1, (size_t)size, file);
     fclose(file);
     
+    int loaded = doc_set(&editor->doc, text, read);
+    free(text);
+    if (!loaded) return 0;
+    editor_reset(editor);
+    
     /* Update information */
     const char* slash = strrchr(filepath, PATH_SEPARATOR);
     if (slash) {
@@ -256,14 +540,6 @@ static int load_file(TextEditor* editor, const char* filepath) {
     editor->filepath[sizeof(editor->filepath) - 1] = '\0';
     editor->modified = 0;
     
-    /* Count lines */
-    editor->line_count = 1;
-    for (size_t i = 0; i < editor->buffer_length; i++) {
-        if (editor->buffer[i] == '\n') {
-            editor->line_count++;
-        }
-    }
-    
     return 1;
 }
 
@@ -276,10 +552,10 @@ static int save_file(TextEditor* editor) {
     FILE* file = fopen(editor->filepath, "wb");
     if (!file) return 0;
     
-    size_t written = fwrite(editor->buffer, 1, editor->buffer_length, file);
+    size_t written = doc_write(&editor->doc, file);
     fclose(file);
     
-    if (written != editor->buffer_length) {
+    if (written != doc_length(&editor->doc)) {
         return 0;
     }
     
@@ -287,6 +563,189 @@ static int save_file(TextEditor* editor) {
     return 1;
 }
 
+/* New text in the editor: cursor, view and undo history start over */
+static void editor_reset(TextEditor* editor) {
+    for (int i = 0; i < editor->undo_count; i++) {
+        free(editor->undo[i].text);
+    }
+    editor->undo_count = 0;
+    editor->undo_position = 0;
+    
+    editor->cursor = 0;
+    editor->anchor = 0;
+    editor->vertical = 0;
+    editor->scroll_line = 0;
+    editor->scroll_x = 0;
+    editor->selecting = 0;
+    editor->scrollbar_drag = 0;
+    editor->cursor_line = 1;
+    editor->cursor_column = 0;
+    editor->version++;
+}
+
+/* Every change of the text ends here */
+static void editor_changed(TextEditor* editor) {
+    editor->modified = 1;
+    editor->version++;
+    editor->changed_at = glfwGetTime();
+    editor->vertical = 0;
+}
+
+/* Remember an edit for undo; text is taken over by the history */
+static void editor_record(TextEditor* editor, int inserted, size_t pos, char* text, size_t length) {
+    /* A new edit drops everything that could be redone */
+    for (int i = editor->undo_position; i < editor->undo_count; i++) {
+        free(editor->undo[i].text);
+    }
+    editor->undo_count = editor->undo_position;
+    
+    if (editor->undo_count == EDITOR_UNDO_LIMIT) {
+        free(editor->undo[0].text);
+        memmove(editor->undo, editor->undo + 1, (EDITOR_UNDO_LIMIT - 1) * sizeof(EditRecord));
+        editor->undo_count--;
+    }
+    
+    EditRecord* record = &editor->undo[editor->undo_count++];
+    record->inserted = inserted;
+    record->pos = pos;
+    record->text = text;
+    record->length = length;
+    editor->undo_position = editor->undo_count;
+}
+
+static void editor_delete(TextEditor* editor, size_t pos, size_t length) {
+    if (length == 0) return;
+    
+    char* text = (char*)malloc(length);
+    if (!text) return;
+    doc_copy(&editor->doc, pos, length, text);
+    doc_delete(&editor->doc, pos, length);
+    editor_record(editor, 0, pos, text, length);
+    
+    editor->cursor = pos;
+    editor->anchor = pos;
+    editor_changed(editor);
+}
+
+static int editor_delete_selection(TextEditor* editor) {
+    if (editor->cursor == editor->anchor) return 0;
+    size_t start = editor->cursor < editor->anchor ? editor->cursor : editor->anchor;
+    size_t end = editor->cursor < editor->anchor ? editor->anchor : editor->cursor;
+    editor_delete(editor, start, end - start);
+    return 1;
+}
+
+/* Insert at the cursor, replacing the selection */
+static void editor_insert(TextEditor* editor, const char* text, size_t length) {
+    if (length == 0) return;
+    editor_delete_selection(editor);
+    
+    char* copy = (char*)malloc(length);
+    if (!copy) return;
+    memcpy(copy, text, length);
+    if (!doc_insert(&editor->doc, editor->cursor, text, length)) {
+        free(copy);
+        return;
+    }
+    editor_record(editor, 1, editor->cursor, copy, length);
+    
+    editor->cursor += length;
+    editor->anchor = editor->cursor;
+    editor_changed(editor);
+}
+
+/* Undo of an insert deletes the text again, undo of a delete puts it back;
+   redo repeats the edit */
+static void editor_undo(TextEditor* editor, int redo) {
+    if (redo ? editor->undo_position == editor->undo_count : editor->undo_position == 0) return;
+    
+    EditRecord* record = &editor->undo[redo ? editor->undo_position++ : --editor->undo_position];
+    if (record->inserted == redo) {
+        if (!doc_insert(&editor->doc, record->pos, record->text, record->length)) return;
+        editor->cursor = record->pos + record->length;
+    } else {
+        doc_delete(&editor->doc, record->pos, record->length);
+        editor->cursor = record->pos;
+    }
+    editor->anchor = editor->cursor;
+    editor_changed(editor);
+}
+
+/* Cursor steps over whole UTF-8 characters */
+static size_t editor_next_char(const Document* doc, size_t pos) {
+    size_t length = doc_length(doc);
+    if (pos >= length) return length;
+    pos++;
+    while (pos < length && (doc_char(doc, pos) & 0xC0) == 0x80) pos++;
+    return pos;
+}
+
+static size_t editor_prev_char(const Document* doc, size_t pos) {
+    if (pos == 0) return 0;
+    pos--;
+    while (pos > 0 && (doc_char(doc, pos) & 0xC0) == 0x80) pos--;
+    return pos;
+}
+
+static int is_word_char(char c) {
+    return c == '_' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+           (c >= 'A' && c <= 'Z') || (c & 0x80);
+}
+
+/* Ctrl+Left/Right: to the start of the previous or next word */
+static size_t editor_word_move(const Document* doc, size_t pos, int forward) {
+    size_t length = doc_length(doc);
+    if (forward) {
+        while (pos < length && !is_word_char(doc_char(doc, pos))) pos++;
+        while (pos < length && is_word_char(doc_char(doc, pos))) pos++;
+    } else {
+        while (pos > 0 && !is_word_char(doc_char(doc, pos - 1))) pos--;
+        while (pos > 0 && is_word_char(doc_char(doc, pos - 1))) pos--;
+    }
+    return pos;
+}
+
+/* Text of a line for drawing and measuring, at most EDITOR_LINE_MAX bytes */
+static size_t editor_line_text(const Document* doc, int line, char* out) {
+    size_t start = doc_line_start(doc, line);
+    size_t length = doc_line_end(doc, line) - start;
+    if (length > EDITOR_LINE_MAX) length = EDITOR_LINE_MAX;
+    doc_copy(doc, start, length, out);
+    return length;
+}
+
+static float text_width(const struct nk_user_font* font, const char* text, size_t length) {
+    if (length == 0) return 0;
+    return font->width(font->userdata, font->height, text, (int)length);
+}
+
+/* Horizontal position of pos within its line */
+static float editor_x_of(const Document* doc, const struct nk_user_font* font, size_t pos) {
+    char text[EDITOR_LINE_MAX];
+    int line = doc_line_of(doc, pos);
+    size_t length = editor_line_text(doc, line, text);
+    size_t column = pos - doc_line_start(doc, line);
+    return text_width(font, text, column < length ? column : length);
+}
+
+/* Position in a line closest to x */
+static size_t editor_pos_at(const Document* doc, const struct nk_user_font* font, int line, float x) {
+    char text[EDITOR_LINE_MAX];
+    size_t length = editor_line_text(doc, line, text);
+    
+    float width = 0;
+    size_t i = 0;
+    while (i < length) {
+        size_t next = i + 1;
+        while (next < length && (text[next] & 0xC0) == 0x80) next++;
+        float glyph = text_width(font, text + i, next - i);
+        if (width + glyph / 2 > x) break;
+        width += glyph;
+        i = next;
+    }
+    return doc_line_start(doc, line) + i;
+}
+
 /* ==================== FILE MANAGER ==================== */
 
 static void scan_directory(IDEState* state) {
@@ -361,10 +820,387 @@ static void scan_directory(IDEState* state) {
 
 /* ==================== BUILD ==================== */
 
+static int build_queue_push(BuildQueue* queue, const char* line) {
+    unsigned head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head - tail >= BUILD_QUEUE_SIZE) return 0;
+    
+    char* slot = queue->lines[head & (BUILD_QUEUE_SIZE - 1)];
+    strncpy(slot, line, BUILD_LINE_SIZE - 1);
+    slot[BUILD_LINE_SIZE - 1] = '\0';
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return 1;
+}
+
+static int build_queue_pop(BuildQueue* queue, char* out) {
+    unsigned tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail == head) return 0;
+    
+    memcpy(out, queue->lines[tail & (BUILD_QUEUE_SIZE - 1)], BUILD_LINE_SIZE);
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+static void sleep_milliseconds(int ms) {
+    #ifdef _WIN32
+        Sleep(ms);
+    #else
+        struct timespec delay = { ms / 1000, (ms % 1000) * 1000000L };
+        nanosleep(&delay, NULL);
+    #endif
+}
+
+static int thread_start(ThreadHandle* thread, ThreadEntry entry, void* data) {
+    #ifdef _WIN32
+        *thread = CreateThread(NULL, 0, entry, data, 0, NULL);
+        return *thread != NULL;
+    #else
+        return pthread_create(thread, NULL, entry, data) == 0;
+    #endif
+}
+
+static void thread_join(ThreadHandle thread) {
+    #ifdef _WIN32
+        WaitForSingleObject(thread, INFINITE);
+        CloseHandle(thread);
+    #else
+        pthread_join(thread, NULL);
+    #endif
+}
+
+/* Append to the build log; when it is full the oldest lines are dropped */
+static void build_log_append(IDEState* state, const char* text) {
+    size_t length = strlen(state->build_log);
+    size_t add = strlen(text);
+    if (add >= sizeof(state->build_log) / 2) return;
+    
+    if (length + add >= sizeof(state->build_log)) {
+        char* cut = strchr(state->build_log + sizeof(state->build_log) / 2, '\n');
+        size_t drop = cut ? (size_t)(cut + 1 - state->build_log) : length;
+        memmove(state->build_log, state->build_log + drop, length - drop + 1);
+        length -= drop;
+    }
+    memcpy(state->build_log + length, text, add + 1);
+}
+
+/* One line of compiler output: queue it for the UI and count finished
+   files. The build driver reports each compiled file as "[k/n] name". */
+static void build_output_line(BuildJob* job, const char* line) {
+    const char* bracket = strchr(line, '[');
+    int done, total;
+    if (bracket && sscanf(bracket, "[%d/%d]", &done, &total) == 2 && total > 0) {
+        atomic_store(&job->files_total, total);
+        atomic_store(&job->files_done, done);
+    }
+    
+    /* The UI drains the queue every frame; a full queue only waits */
+    while (!build_queue_push(&job->queue, line)) {
+        if (atomic_load(&job->cancel)) return;
+        sleep_milliseconds(1);
+    }
+}
+
+THREAD_ENTRY(build_thread_main) {
+    BuildJob* job = (BuildJob*)data;
+    char chunk[1024];
+    char line[BUILD_LINE_SIZE];
+    size_t line_length = 0;
+    
+    for (;;) {
+        #ifdef _WIN32
+            DWORD got = 0;
+            if (!ReadFile(job->output, chunk, sizeof(chunk), &got, NULL) || got == 0) break;
+        #else
+            ssize_t got = read(job->output, chunk, sizeof(chunk));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) break;
+        #endif
+        
+        for (size_t i = 0; i < (size_t)got; i++) {
+            char c = chunk[i];
+            if (c == '\r') continue;
+            if (c != '\n' && line_length < sizeof(line) - 2) {
+                line[line_length++] = c;
+                continue;
+            }
+            if (c != '\n') line[line_length++] = c;
+            line[line_length++] = '\n';
+            line[line_length] = '\0';
+            build_output_line(job, line);
+            line_length = 0;
+        }
+    }
+    if (line_length > 0) {
+        line[line_length++] = '\n';
+        line[line_length] = '\0';
+        build_output_line(job, line);
+    }
+    
+    #ifdef _WIN32
+        DWORD code = 1;
+        WaitForSingleObject(job->process, INFINITE);
+        GetExitCodeProcess(job->process, &code);
+        job->result = (int)code;
+    #else
+        int status = 0;
+        while (waitpid(job->pid, &status, 0) < 0 && errno == EINTR) {}
+        job->result = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    #endif
+    
+    atomic_store(&job->finished, 1);
+    return 0;
+}
+
+/* Start the compiler with stdout and stderr going into one pipe */
+static int build_spawn(BuildJob* job, char* command) {
+    #ifdef _WIN32
+        SECURITY_ATTRIBUTES security = { sizeof(security), NULL, TRUE };
+        HANDLE read_end, write_end;
+        if (!CreatePipe(&read_end, &write_end, &security, 0)) return 0;
+        SetHandleInformation(read_end, HANDLE_FLAG_INHERIT, 0);
+        
+        STARTUPINFOA startup;
+        PROCESS_INFORMATION info;
+        memset(&startup, 0, sizeof(startup));
+        startup.cb = sizeof(startup);
+        startup.dwFlags = STARTF_USESTDHANDLES;
+        startup.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+        startup.hStdOutput = write_end;
+        startup.hStdError = write_end;
+        
+        /* Suspended until it is in the job object, so no child escapes cancel */
+        if (!CreateProcessA(NULL, command, NULL, NULL, TRUE,
+                CREATE_NO_WINDOW | CREATE_SUSPENDED, NULL, NULL, &startup, &info)) {
+            CloseHandle(read_end);
+            CloseHandle(write_end);
+            return 0;
+        }
+        CloseHandle(write_end);
+        
+        job->process_group = CreateJobObjectA(NULL, NULL);
+        if (job->process_group) AssignProcessToJobObject(job->process_group, info.hProcess);
+        ResumeThread(info.hThread);
+        CloseHandle(info.hThread);
+        
+        job->process = info.hProcess;
+        job->output = read_end;
+        return 1;
+    #else
+        int fds[2];
+        if (pipe(fds) != 0) return 0;
+        
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return 0;
+        }
+        if (pid == 0) {
+            /* Own process group: cancel stops the shell and the compiler */
+            setpgid(0, 0);
+            dup2(fds[1], STDOUT_FILENO);
+            dup2(fds[1], STDERR_FILENO);
+            close(fds[0]);
+            close(fds[1]);
+            execl("/bin/sh", "sh", "-c", command, (char*)NULL);
+            _exit(127);
+        }
+        setpgid(pid, pid);
+        close(fds[1]);
+        
+        job->pid = pid;
+        job->output = fds[0];
+        return 1;
+    #endif
+}
+
+/* Copy the editor buffer into a task. The "#line" prefix makes diagnostics
+   name the file instead of "<string>". An empty output_name only compiles. */
+static int tcc_task_init(TccTask* task, const TextEditor* editor,
+                         const char* options, const char* output_name) {
+    size_t prefix = strlen(editor->filename) + 16;
+    size_t text_length = doc_length(&editor->doc);
+    task->source = (char*)malloc(prefix + text_length + 1);
+    if (!task->source) return 0;
+    
+    int length = snprintf(task->source, prefix, "#line 1 \"%s\"\n", editor->filename);
+    doc_copy(&editor->doc, 0, text_length, task->source + length);
+    task->source[length + text_length] = '\0';
+    
+    /* Quoted includes next to the file work as in a compile from disk */
+    task->directory[0] = '\0';
+    const char* slash = strrchr(editor->filepath, PATH_SEPARATOR);
+    if (slash) {
+        snprintf(task->directory, sizeof(task->directory), "%.*s",
+            (int)(slash - editor->filepath), editor->filepath);
+    }
+    
+    snprintf(task->options, sizeof(task->options), "%s", options);
+    snprintf(task->output_name, sizeof(task->output_name), "%s", output_name);
+    return 1;
+}
+
+/* Compile the task's source. Diagnostics go to error_func; on errors the
+   state is deleted and NULL is returned. */
+static TCCState* tcc_task_compile(TccTask* task, void* opaque, TCCErrorFunc* error_func) {
+    TCCState* tcc = tcc_new();
+    if (!tcc) {
+        error_func(opaque, "Error: Cannot create TCC instance");
+        return NULL;
+    }
+    
+    tcc_set_error_func(tcc, opaque, error_func);
+    tcc_set_options(tcc, task->options);
+    tcc_set_output_type(tcc, task->output_name[0] ? TCC_OUTPUT_EXE : TCC_OUTPUT_MEMORY);
+    
+    /* Same include paths as the build driver */
+    tcc_add_include_path(tcc, "include");
+    tcc_add_include_path(tcc, ".");
+    tcc_add_include_path(tcc, "src");
+    tcc_add_include_path(tcc, "mirulit");
+    if (task->directory[0]) tcc_add_include_path(tcc, task->directory);
+    tcc_add_library_path(tcc, "lib");
+    
+    if (tcc_compile_string(tcc, task->source) != 0) {
+        tcc_delete(tcc);
+        return NULL;
+    }
+    return tcc;
+}
+
+/* libtcc diagnostics of a build go to the output like compiler output */
+static void tcc_build_error(void* opaque, const char* message) {
+    char line[BUILD_LINE_SIZE];
+    snprintf(line, sizeof(line), "%s\n", message);
+    build_output_line((BuildJob*)opaque, line);
+}
+
+THREAD_ENTRY(tcc_build_thread_main) {
+    BuildJob* job = (BuildJob*)data;
+    atomic_store(&job->files_total, 1);
+    job->result = 1;
+    
+    TCCState* tcc = tcc_task_compile(&job->task, job, tcc_build_error);
+    if (tcc) {
+        /* libtcc cannot be stopped midway; a cancelled build writes nothing */
+        if (!atomic_load(&job->cancel)) {
+            atomic_store(&job->files_done, 1);
+            job->result = tcc_output_file(tcc, job->task.output_name) == 0 ? 0 : 1;
+        }
+        tcc_delete(tcc);
+    }
+    
+    atomic_store(&job->finished, 1);
+    return 0;
+}
+
+/* libtcc diagnostics of a syntax check are kept for the editor */
+static void tcc_check_error(void* opaque, const char* message) {
+    SyntaxCheck* check = (SyntaxCheck*)opaque;
+    if (strstr(message, "error:")) check->errors++;
+    
+    size_t length = strlen(check->diagnostics);
+    snprintf(check->diagnostics + length, sizeof(check->diagnostics) - length,
+        "%s\n", message);
+}
+
+THREAD_ENTRY(syntax_check_main) {
+    SyntaxCheck* check = (SyntaxCheck*)data;
+    TCCState* tcc = tcc_task_compile(&check->task, check, tcc_check_error);
+    if (tcc) tcc_delete(tcc);
+    
+    atomic_store(&check->finished, 1);
+    return 0;
+}
+
+/* Called every frame. Once typing pauses for CHECK_DELAY, the buffer is
+   compiled in memory on a background thread: errors show up without a
+   build and the editor never waits for the compiler. */
+static void poll_syntax_check(IDEState* state) {
+    SyntaxCheck* check = &state->check;
+    
+    if (check->running) {
+        if (!atomic_load(&check->finished)) return;
+        thread_join(check->thread);
+        free(check->task.source);
+        check->running = 0;
+        
+        /* First error line, without the newline */
+        check->first_error[0] = '\0';
+        const char* error = strstr(check->diagnostics, "error:");
+        if (error) {
+            const char* start = error;
+            while (start > check->diagnostics && start[-1] != '\n') start--;
+            snprintf(check->first_error, sizeof(check->first_error), "%.*s",
+                (int)strcspn(start, "\n"), start);
+        }
+        check->error_count = check->errors;
+        check->checked = 1;
+    }
+    
+    if (!state->build.use_libtcc) return;
+    if (check->checked && check->version == state->editor.version) return;
+    if (glfwGetTime() - state->editor.changed_at < CHECK_DELAY) return;
+    
+    check->version = state->editor.version;
+    if (!tcc_task_init(&check->task, &state->editor, state->build.cflags, "")) return;
+    check->diagnostics[0] = '\0';
+    check->errors = 0;
+    atomic_store(&check->finished, 0);
+    
+    if (!thread_start(&check->thread, syntax_check_main, check)) {
+        free(check->task.source);
+        return;
+    }
+    check->running = 1;
+}
+
+/* Builds run on a background thread: the UI keeps drawing, output shows up
+   line by line through job->queue, and the build can be cancelled. */
 static void build_project(IDEState* state) {
-    state->building = 1;
+    if (state->building) return;
+    
+    BuildJob* job = &state->build_job;
+    memset(job, 0, sizeof(*job));
     state->build_progress = 0;
     state->build_log[0] = '\0';
+    state->show_output = 1;
+    
+    char flags[640];
+    strcpy(flags, state->build.cflags);
+    
+    /* Add optimization */
+    if (state->build.optimization == 1) strcat(flags, " -O1");
+    else if (state->build.optimization == 2) strcat(flags, " -O2");
+    else if (state->build.optimization == 3) strcat(flags, " -O3");
+    
+    /* Add debug info */
+    if (state->build.debug_info) strcat(flags, " -g");
+    
+    /* In-process: libtcc compiles the buffer itself, saved or not, with no
+       compiler process and no temporary file */
+    if (state->build.use_libtcc) {
+        if (!tcc_task_init(&job->task, &state->editor, flags, state->build.output_name)) {
+            build_log_append(state, "Error: Out of memory\n");
+            return;
+        }
+        job->in_process = 1;
+        
+        char command[2048];
+        snprintf(command, sizeof(command), "libtcc %s %s -o %s\n\n",
+            flags, state->editor.filename, state->build.output_name);
+        build_log_append(state, "Compile in-process:\n");
+        build_log_append(state, command);
+        
+        if (!thread_start(&job->thread, tcc_build_thread_main, job)) {
+            free(job->task.source);
+            build_log_append(state, "Error: Cannot start build thread\n");
+            return;
+        }
+        state->building = 1;
+        return;
+    }
     
     char command[2048];
     
@@ -373,76 +1209,219 @@ static void build_project(IDEState* state) {
         snprintf(command, sizeof(command),
             "%s %s %s -o %s",
             state->build.compiler,
-            state->build.cflags,
+            flags,
             state->editor.filepath,
             state->build.output_name);
     } else {
-        /* Create a temporary file */
+        /* Create a temporary file, removed when the build finishes */
         FILE* temp = fopen("temp.c", "w");
         if (temp) {
-            fwrite(state->editor.buffer, 1, state->editor.buffer_length, temp);
+            doc_write(&state->editor.doc, temp);
             fclose(temp);
+            job->temp_source = 1;
             snprintf(command, sizeof(command),
                 "%s %s temp.c -o %s",
                 state->build.compiler,
-                state->build.cflags,
+                flags,
                 state->build.output_name);
         } else {
             strcpy(state->build_log, "Error: Cannot create temporary file\n");
-            state->building = 0;
             return;
         }
     }
     
-    /* Add optimization */
-    if (state->build.optimization == 1) strcat(command, " -O1");
-    else if (state->build.optimization == 2) strcat(command, " -O2");
-    else if (state->build.optimization == 3) strcat(command, " -O3");
+    /* Log command */
+    build_log_append(state, "Compile command:\n");
+    build_log_append(state, command);
+    build_log_append(state, "\n\n");
     
-    /* Add debug info */
-    if (state->build.debug_info) strcat(command, " -g");
+    if (!build_spawn(job, command)) {
+        build_log_append(state, "Error: Cannot execute compiler\n");
+        if (job->temp_source) remove("temp.c");
+        return;
+    }
     
-    /* Log command */
-    strcat(state->build_log, "Compile command:\n");
-    strcat(state->build_log, command);
-    strcat(state->build_log, "\n\n");
-    
-    state->build_progress = 30;
-    
-    /* Execute compilation */
-    FILE* pipe = popen(command, "r");
-    if (pipe) {
-        char buffer[256];
-        while (fgets(buffer, sizeof(buffer), pipe)) {
-            if (strlen(state->build_log) + strlen(buffer) < sizeof(state->build_log)) {
-                strcat(state->build_log, buffer);
-            }
+    if (!thread_start(&job->thread, build_thread_main, job)) {
+        /* Without a reader the compiler would block on a full pipe */
+        cancel_build(state);
+        #ifdef _WIN32
+            CloseHandle(job->output);
+            CloseHandle(job->process);
+            if (job->process_group) CloseHandle(job->process_group);
+        #else
+            close(job->output);
+            waitpid(job->pid, NULL, 0);
+        #endif
+        build_log_append(state, "Error: Cannot start build thread\n");
+        if (job->temp_source) remove("temp.c");
+        return;
+    }
+    
+    state->building = 1;
+}
+
+/* Stop the compiler and everything it started. The build thread sees the
+   pipe close and finishes as usual. An in-process build finishes its
+   compile but writes no output. */
+static void cancel_build(IDEState* state) {
+    BuildJob* job = &state->build_job;
+    atomic_store(&job->cancel, 1);
+    if (job->in_process) return;
+    
+    #ifdef _WIN32
+        if (job->process_group) TerminateJobObject(job->process_group, 1);
+        else TerminateProcess(job->process, 1);
+    #else
+        kill(-job->pid, SIGTERM);
+    #endif
+}
+
+/* Called every frame: move new output into the log, update progress and
+   collect the build once its thread is done */
+static void poll_build(IDEState* state) {
+    if (!state->building) return;
+    BuildJob* job = &state->build_job;
+    
+    /* Read before draining, so no line pushed before the end is missed */
+    int finished = atomic_load(&job->finished);
+    
+    char line[BUILD_LINE_SIZE];
+    while (build_queue_pop(&job->queue, line)) {
+        build_log_append(state, line);
+    }
+    
+    int total = atomic_load(&job->files_total);
+    if (total > 0) {
+        state->build_progress = (nk_size)(atomic_load(&job->files_done) * 100 / total);
+    }
+    if (!finished) return;
+    
+    thread_join(job->thread);
+    if (job->in_process) {
+        free(job->task.source);
+    } else {
+        #ifdef _WIN32
+            CloseHandle(job->output);
+            CloseHandle(job->process);
+            if (job->process_group) CloseHandle(job->process_group);
+        #else
+            close(job->output);
+        #endif
+    }
+    
+    if (atomic_load(&job->cancel)) {
+        build_log_append(state, "\nBuild cancelled.\n");
+    } else if (job->result == 0) {
+        build_log_append(state, "\nBuild successful!\n");
+        state->build_progress = 100;
+    } else {
+        build_log_append(state, "\nBuild failed!\n");
+    }
+    
+    if (job->temp_source) remove("temp.c");
+    state->building = 0;
+}
+
+/* Start a program without waiting for it. The IDE keeps running, and a
+   crash in the program cannot take the IDE down with it. */
+static int spawn_detached(char** argv) {
+    #ifdef _WIN32
+        char command[2048] = "";
+        for (int i = 0; argv[i]; i++) {
+            size_t length = strlen(command);
+            snprintf(command + length, sizeof(command) - length, "%s\"%s\"",
+                i ? " " : "", argv[i]);
         }
         
-        int result = pclose(pipe);
+        STARTUPINFOA startup;
+        PROCESS_INFORMATION info;
+        memset(&startup, 0, sizeof(startup));
+        startup.cb = sizeof(startup);
+        if (!CreateProcessA(NULL, command, NULL, NULL, FALSE, CREATE_NEW_CONSOLE,
+                NULL, NULL, &startup, &info)) {
+            return 0;
+        }
+        CloseHandle(info.hThread);
+        CloseHandle(info.hProcess);
+        return 1;
+    #else
+        /* Double fork: the program is reparented and never becomes a zombie.
+           The status pipe closes on a successful exec; if exec fails, the
+           grandchild writes errno into it first. */
+        int fds[2];
+        if (pipe(fds) != 0) return 0;
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
         
-        if (result == 0) {
-            if (strlen(state->build_log) + 50 < sizeof(state->build_log)) {
-                strcat(state->build_log, "\nBuild successful!\n");
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return 0;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            pid_t program = fork();
+            if (program == 0) {
+                execvp(argv[0], argv);
             }
-        } else {
-            if (strlen(state->build_log) + 50 < sizeof(state->build_log)) {
-                strcat(state->build_log, "\nBuild failed!\n");
+            if (program <= 0) {
+                int error = errno;
+                ssize_t written = write(fds[1], &error, sizeof(error));
+                (void)written;
+                _exit(127);
             }
+            _exit(0);
         }
+        close(fds[1]);
+        waitpid(pid, NULL, 0);
         
-        state->build_progress = 100;
-    } else {
-        if (strlen(state->build_log) + 50 < sizeof(state->build_log)) {
-            strcat(state->build_log, "Error: Cannot execute compiler\n");
+        int error;
+        ssize_t got;
+        do {
+            got = read(fds[0], &error, sizeof(error));
+        } while (got < 0 && errno == EINTR);
+        close(fds[0]);
+        return got == 0;
+    #endif
+}
+
+/* Run: the build driver (compiler --run) links the program in memory and
+   starts it at once. No executable is written, so there is no file to be
+   scanned and no second process launch after the build. */
+static void run_project(IDEState* state) {
+    const char* source = state->editor.filepath;
+    
+    /* The log is streaming build output; do not overwrite it */
+    if (state->building) {
+        build_log_append(state, "\nRun skipped: wait for the build to finish.\n");
+        state->show_output = 1;
+        return;
+    }
+    
+    if (source[0] == '\0') {
+        /* The driver reads the file after we return, so it is not removed */
+        FILE* temp = fopen("temp_run.c", "w");
+        if (!temp) {
+            strcpy(state->build_log, "Error: Cannot create temporary file\n");
+            state->show_output = 1;
+            return;
         }
+        doc_write(&state->editor.doc, temp);
+        fclose(temp);
+        source = "temp_run.c";
+    } else if (state->editor.modified) {
+        save_file(&state->editor);
     }
     
-    /* Clean up temp file if it exists */
-    remove("temp.c");
+    char* argv[] = { state->build.runner, "--run", (char*)source, NULL };
+    snprintf(state->build_log, sizeof(state->build_log),
+        "Run command:\n%s --run %s\n", state->build.runner, source);
     
-    state->building = 0;
-    state->show_output = 1;
+    if (!spawn_detached(argv)) {
+        strcat(state->build_log, "Error: Cannot start build driver\n");
+        state->show_output = 1;
+    }
 }
 
 /* ==================== UI RENDERING ==================== */
@@ -540,11 +1519,7 @@ static void render_menu_bar(IDEState* state) {
                 build_project(state);
             }
             if (nk_menu_item_label(state->nk_ctx, "Run", NK_TEXT_LEFT)) {
-                #ifdef _WIN32
-                    char command[512];
-                    snprintf(command, sizeof(command), "start %s", state->build.output_name);
-                    system(command);
-                #endif
+                run_project(state);
             }
             if (nk_menu_item_label(state->nk_ctx, "Settings", NK_TEXT_LEFT)) {
                 state->show_build_settings = 1;
@@ -582,11 +1557,7 @@ static void render_toolbar(IDEState* state) {
         
         nk_layout_row_push(state->nk_ctx, 60);
         if (nk_button_label(state->nk_ctx, "Run")) {
-            #ifdef _WIN32
-                char command[512];
-                snprintf(command, sizeof(command), "start %s", state->build.output_name);
-                system(command);
-            #endif
+            run_project(state);
         }
         
         nk_layout_row_push(state->nk_ctx, 20); /* Spacer */
@@ -610,6 +1581,286 @@ static void render_toolbar(IDEState* state) {
     nk_end(state->nk_ctx);
 }
 
+#define EDITOR_GUTTER 50
+#define EDITOR_SCROLLBAR 10
+
+static struct nk_rect rect_intersect(struct nk_rect a, struct nk_rect b) {
+    float x0 = a.x > b.x ? a.x : b.x;
+    float y0 = a.y > b.y ? a.y : b.y;
+    float x1 = a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w;
+    float y1 = a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h;
+    return nk_rect(x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0);
+}
+
+/* Keys and typed text for the focused editor; page is lines in view */
+static void editor_keyboard(IDEState* state, const struct nk_input* in, int page) {
+    TextEditor* editor = &state->editor;
+    Document* doc = &editor->doc;
+    const struct nk_user_font* font = state->nk_ctx->style.font;
+    int shift = in->keyboard.keys[NK_KEY_SHIFT].down;
+    
+    /* Typed text arrives as UTF-8 */
+    if (in->keyboard.text_len > 0) {
+        editor_insert(editor, in->keyboard.text, (size_t)in->keyboard.text_len);
+    }
+    if (nk_input_is_key_pressed(in, NK_KEY_ENTER)) editor_insert(editor, "\n", 1);
+    if (nk_input_is_key_pressed(in, NK_KEY_TAB)) editor_insert(editor, "    ", 4);
+    
+    if (nk_input_is_key_pressed(in, NK_KEY_BACKSPACE) && !editor_delete_selection(editor)) {
+        size_t prev = editor_prev_char(doc, editor->cursor);
+        editor_delete(editor, prev, editor->cursor - prev);
+    }
+    if (nk_input_is_key_pressed(in, NK_KEY_DEL) && !editor_delete_selection(editor)) {
+        size_t next = editor_next_char(doc, editor->cursor);
+        editor_delete(editor, editor->cursor, next - editor->cursor);
+    }
+    
+    /* Clipboard */
+    size_t start = editor->cursor < editor->anchor ? editor->cursor : editor->anchor;
+    size_t end = editor->cursor < editor->anchor ? editor->anchor : editor->cursor;
+    int cut = nk_input_is_key_pressed(in, NK_KEY_CUT);
+    if ((cut || nk_input_is_key_pressed(in, NK_KEY_COPY)) && start != end) {
+        char* text = (char*)malloc(end - start + 1);
+        if (text) {
+            doc_copy(doc, start, end - start, text);
+            text[end - start] = '\0';
+            glfwSetClipboardString(state->window, text);
+            free(text);
+        }
+        if (cut) editor_delete_selection(editor);
+    }
+    if (nk_input_is_key_pressed(in, NK_KEY_PASTE)) {
+        const char* text = glfwGetClipboardString(state->window);
+        char* clean = text ? (char*)malloc(strlen(text) + 1) : NULL;
+        if (clean) {
+            /* Windows line endings become '\n' */
+            size_t length = 0;
+            for (const char* c = text; *c; c++) {
+                if (*c != '\r') clean[length++] = *c;
+            }
+            editor_insert(editor, clean, length);
+            free(clean);
+        }
+    }
+    
+    if (nk_input_is_key_pressed(in, NK_KEY_TEXT_UNDO)) editor_undo(editor, 0);
+    if (nk_input_is_key_pressed(in, NK_KEY_TEXT_REDO)) editor_undo(editor, 1);
+    if (nk_input_is_key_pressed(in, NK_KEY_TEXT_SELECT_ALL)) {
+        editor->anchor = 0;
+        editor->cursor = doc_length(doc);
+    }
+    
+    /* Movement; with Shift the selection follows the cursor */
+    start = editor->cursor < editor->anchor ? editor->cursor : editor->anchor;
+    end = editor->cursor < editor->anchor ? editor->anchor : editor->cursor;
+    size_t cursor = editor->cursor;
+    int moved = 0;
+    int lines = 0;
+    
+    if (nk_input_is_key_pressed(in, NK_KEY_LEFT)) {
+        cursor = start != end && !shift ? start : editor_prev_char(doc, cursor);
+        moved = 1;
+    }
+    if (nk_input_is_key_pressed(in, NK_KEY_RIGHT)) {
+        cursor = start != end && !shift ? end : editor_next_char(doc, cursor);
+        moved = 1;
+    }
+    if (nk_input_is_key_pressed(in, NK_KEY_TEXT_WORD_LEFT)) {
+        cursor = editor_word_move(doc, cursor, 0);
+        moved = 1;
+    }
+    if (nk_input_is_key_pressed(in, NK_KEY_TEXT_WORD_RIGHT)) {
+        cursor = editor_word_move(doc, cursor, 1);
+        moved = 1;
+    }
+    if (nk_input_is_key_pressed(in, NK_KEY_TEXT_START) ||
+        nk_input_is_key_pressed(in, NK_KEY_TEXT_LINE_START)) {
+        cursor = doc_line_start(doc, doc_line_of(doc, cursor));
+        moved = 1;
+    }
+    if (nk_input_is_key_pressed(in, NK_KEY_TEXT_END) ||
+        nk_input_is_key_pressed(in, NK_KEY_TEXT_LINE_END)) {
+        cursor = doc_line_end(doc, doc_line_of(doc, cursor));
+        moved = 1;
+    }
+    if (nk_input_is_key_pressed(in, NK_KEY_UP)) lines = -1;
+    if (nk_input_is_key_pressed(in, NK_KEY_DOWN)) lines = 1;
+    if (nk_input_is_key_pressed(in, NK_KEY_SCROLL_UP)) lines = -page;
+    if (nk_input_is_key_pressed(in, NK_KEY_SCROLL_DOWN)) lines = page;
+    
+    if (lines != 0) {
+        /* Up and down keep the column the cursor started from */
+        if (!editor->vertical) editor->goal_x = editor_x_of(doc, font, cursor);
+        int line = doc_line_of(doc, cursor) + lines;
+        if (line < 0) line = 0;
+        if (line >= doc_line_count(doc)) line = doc_line_count(doc) - 1;
+        cursor = editor_pos_at(doc, font, line, editor->goal_x);
+        moved = 1;
+    }
+    
+    if (moved) {
+        editor->cursor = cursor;
+        if (!shift) editor->anchor = cursor;
+        editor->vertical = lines != 0;
+    }
+}
+
+/* The code editor. Only the lines in view are copied out of the document,
+   measured and drawn, so a frame costs the same for a short file and for
+   one with 50000 lines, and a keystroke costs the size of the edit. */
+static void editor_widget(IDEState* state, float height) {
+    struct nk_context* ctx = state->nk_ctx;
+    TextEditor* editor = &state->editor;
+    Document* doc = &editor->doc;
+    const struct nk_user_font* font = ctx->style.font;
+    
+    nk_layout_row_dynamic(ctx, height, 1);
+    struct nk_rect bounds;
+    if (!nk_widget(&bounds, ctx)) return;
+    
+    float line_height = font->height + 4;
+    int page = (int)(bounds.h / line_height);
+    if (page < 1) page = 1;
+    struct nk_rect gutter = nk_rect(bounds.x, bounds.y, EDITOR_GUTTER, bounds.h);
+    struct nk_rect area = nk_rect(bounds.x + EDITOR_GUTTER + 6, bounds.y,
+        bounds.w - EDITOR_GUTTER - 6 - EDITOR_SCROLLBAR, bounds.h);
+    struct nk_rect scrollbar = nk_rect(bounds.x + bounds.w - EDITOR_SCROLLBAR, bounds.y,
+        EDITOR_SCROLLBAR, bounds.h);
+    
+    size_t old_cursor = editor->cursor;
+    unsigned old_version = editor->version;
+    
+    /* Input only while the editor window is the active one */
+    struct nk_input* in = nk_window_has_focus(ctx) ? &ctx->input : NULL;
+    if (!in) {
+        editor->focused = 0;
+        editor->selecting = 0;
+        editor->scrollbar_drag = 0;
+    } else {
+        int pressed = nk_input_is_mouse_pressed(in, NK_BUTTON_LEFT);
+        if (pressed) {
+            editor->focused = nk_input_is_mouse_hovering_rect(in, bounds);
+            if (nk_input_is_mouse_hovering_rect(in, scrollbar)) editor->scrollbar_drag = 1;
+            else if (editor->focused) editor->selecting = 1;
+        }
+        if (!in->mouse.buttons[NK_BUTTON_LEFT].down) {
+            editor->selecting = 0;
+            editor->scrollbar_drag = 0;
+        }
+        
+        int line_count = doc_line_count(doc);
+        if (editor->selecting) {
+            /* Dragging past the top or bottom scrolls along with the cursor */
+            float row = (in->mouse.pos.y - area.y) / line_height;
+            int line = editor->scroll_line + (row < 0 ? (int)row - 1 : (int)row);
+            if (line < 0) line = 0;
+            if (line >= line_count) line = line_count - 1;
+            
+            editor->cursor = editor_pos_at(doc, font, line,
+                in->mouse.pos.x - area.x + editor->scroll_x);
+            if (pressed && !in->keyboard.keys[NK_KEY_SHIFT].down) editor->anchor = editor->cursor;
+            editor->vertical = 0;
+        } else if (editor->scrollbar_drag) {
+            editor->scroll_line = (int)((in->mouse.pos.y - bounds.y) / bounds.h * line_count) - page / 2;
+        }
+        
+        if (nk_input_is_mouse_hovering_rect(in, bounds) && in->mouse.scroll_delta.y != 0) {
+            editor->scroll_line -= (int)(in->mouse.scroll_delta.y * 3);
+            in->mouse.scroll_delta.y = 0;
+        }
+        if (nk_input_is_mouse_hovering_rect(in, area)) {
+            ctx->style.cursor_active = ctx->style.cursors[NK_CURSOR_TEXT];
+        }
+        
+        if (editor->focused) editor_keyboard(state, in, page);
+    }
+    
+    /* Keep the cursor in view after it moved or the text changed */
+    int line_count = doc_line_count(doc);
+    int cursor_line = doc_line_of(doc, editor->cursor);
+    if (editor->cursor != old_cursor || editor->version != old_version) {
+        if (cursor_line < editor->scroll_line) editor->scroll_line = cursor_line;
+        if (cursor_line >= editor->scroll_line + page) editor->scroll_line = cursor_line - page + 1;
+        
+        float x = editor_x_of(doc, font, editor->cursor);
+        if (x < editor->scroll_x) editor->scroll_x = x > 40 ? x - 40 : 0;
+        if (x > editor->scroll_x + area.w - 20) editor->scroll_x = x - area.w + 40;
+    }
+    if (editor->scroll_line > line_count - page) editor->scroll_line = line_count - page;
+    if (editor->scroll_line < 0) editor->scroll_line = 0;
+    
+    editor->cursor_line = cursor_line + 1;
+    editor->cursor_column = (int)(editor->cursor - doc_line_start(doc, cursor_line));
+    
+    /* Draw */
+    struct nk_command_buffer* canvas = nk_window_get_canvas(ctx);
+    struct nk_rect clip = canvas->clip;
+    struct nk_color background = nk_rgb(30, 30, 30);
+    nk_fill_rect(canvas, bounds, 0, background);
+    nk_fill_rect(canvas, gutter, 0, nk_rgb(37, 37, 38));
+    
+    int last = editor->scroll_line + page + 1;
+    if (last > line_count) last = line_count;
+    
+    /* Line numbers */
+    nk_push_scissor(canvas, rect_intersect(clip, gutter));
+    for (int line = editor->scroll_line; line < last; line++) {
+        float y = bounds.y + (line - editor->scroll_line) * line_height;
+        char number[16];
+        int digits = snprintf(number, sizeof(number), "%d", line + 1);
+        float number_width = text_width(font, number, (size_t)digits);
+        
+        struct nk_color color = line == cursor_line ?
+            nk_rgb(206, 145, 120) : nk_rgb(133, 133, 133);
+        nk_draw_text(canvas, nk_rect(gutter.x + gutter.w - 6 - number_width, y + 2,
+            number_width + 1, line_height), number, digits, font, background, color);
+    }
+    
+    /* Text, selection and cursor */
+    size_t select_start = editor->cursor < editor->anchor ? editor->cursor : editor->anchor;
+    size_t select_end = editor->cursor < editor->anchor ? editor->anchor : editor->cursor;
+    float x = area.x - editor->scroll_x;
+    char text[EDITOR_LINE_MAX];
+    
+    nk_push_scissor(canvas, rect_intersect(clip, area));
+    for (int line = editor->scroll_line; line < last; line++) {
+        float y = bounds.y + (line - editor->scroll_line) * line_height;
+        size_t start = doc_line_start(doc, line);
+        size_t length = editor_line_text(doc, line, text);
+        
+        if (select_start < select_end && select_start <= start + length && select_end > start) {
+            size_t from = select_start > start ? select_start - start : 0;
+            size_t to = select_end - start < length ? select_end - start : length;
+            float x0 = text_width(font, text, from);
+            float x1 = text_width(font, text, to);
+            /* A selected line break shows as a little space after the text */
+            if (select_end > start + length && line + 1 < line_count) x1 += 6;
+            nk_fill_rect(canvas, nk_rect(x + x0, y, x1 - x0, line_height), 0, nk_rgb(38, 79, 120));
+        }
+        
+        if (length > 0) {
+            nk_draw_text(canvas, nk_rect(x, y + 2, editor->scroll_x + area.w, line_height),
+                text, (int)length, font, background, nk_rgb(210, 210, 210));
+        }
+        
+        if (line == cursor_line && editor->focused) {
+            size_t column = editor->cursor - start;
+            float cursor_x = x + text_width(font, text, column < length ? column : length);
+            nk_fill_rect(canvas, nk_rect(cursor_x, y + 1, 2, line_height - 2), 0, nk_rgb(200, 200, 200));
+        }
+    }
+    nk_push_scissor(canvas, clip);
+    
+    /* Scrollbar */
+    if (line_count > page) {
+        float thumb = bounds.h * page / line_count;
+        if (thumb < 20) thumb = 20;
+        float top = bounds.y + (bounds.h - thumb) * editor->scroll_line / (line_count - page);
+        nk_fill_rect(canvas, nk_rect(scrollbar.x + 2, top, scrollbar.w - 4, thumb), 3,
+            editor->scrollbar_drag ? nk_rgb(82, 82, 86) : nk_rgb(62, 62, 66));
+    }
+}
+
 static void render_editor(IDEState* state) {
     if (!state->show_editor) return;
     
@@ -621,71 +1872,37 @@ static void render_editor(IDEState* state) {
         NK_WINDOW_BORDER | NK_WINDOW_TITLE | NK_WINDOW_MOVABLE | 
         NK_WINDOW_SCALABLE)) {
         
-        /* Line numbers and editor */
-        nk_layout_row_begin(state->nk_ctx, NK_STATIC, height - 150, 2);
-        
-        /* Line numbers (50px width) */
-        nk_layout_row_push(state->nk_ctx, 50);
-        if (nk_group_begin(state->nk_ctx, "LineNumbers", NK_WINDOW_NO_SCROLLBAR)) {
-            nk_layout_row_dynamic(state->nk_ctx, 20, 1);
-            
-            for (int i = 1; i <= state->editor.line_count; i++) {
-                char num[16];
-                snprintf(num, sizeof(num), "%4d", i);
-                
-                struct nk_color color = (i == state->editor.cursor_line) ? 
-                    nk_rgb(206, 145, 120) : nk_rgb(133, 133, 133);
-                
-                nk_label_colored(state->nk_ctx, num, NK_TEXT_RIGHT, color);
-            }
-            
-            nk_group_end(state->nk_ctx);
-        }
+        /* Editor title */
+        char title[320];
+        snprintf(title, sizeof(title), "%s%s   Ln %d, Col %d", 
+                state->editor.filename,
+                state->editor.modified ? " *" : "",
+                state->editor.cursor_line,
+                state->editor.cursor_column + 1);
         
-        /* Text editor (remaining space) */
-        nk_layout_row_push(state->nk_ctx, width - 320);
+        nk_layout_row_dynamic(state->nk_ctx, 25, 2);
+        nk_label(state->nk_ctx, title, NK_TEXT_LEFT);
         
-        if (nk_group_begin(state->nk_ctx, "CodeEditor", NK_WINDOW_BORDER)) {
-            /* Editor title */
-            char title[256];
-            snprintf(title, sizeof(title), "%s%s", 
-                    state->editor.filename,
-                    state->editor.modified ? " *" : "");
-            
-            nk_layout_row_dynamic(state->nk_ctx, 25, 1);
-            nk_label(state->nk_ctx, title, NK_TEXT_LEFT);
-            
-            /* Text editor - use zero-terminated string function */
-            nk_layout_row_dynamic(state->nk_ctx, height - 180, 1);
-            
-            /* Save old length */
-            size_t old_len = state->editor.buffer_length;
-            
-            /* Edit string - use zero-terminated version */
-            state->editor.modified = nk_edit_string_zero_terminated(
-                state->nk_ctx,
-                NK_EDIT_BOX | NK_EDIT_MULTILINE | NK_EDIT_SELECTABLE | NK_EDIT_CLIPBOARD,
-                state->editor.buffer,
-                (int)state->editor.buffer_size,
-                nk_filter_default);
-            
-            /* Update buffer length */
-            state->editor.buffer_length = strlen(state->editor.buffer);
-            
-            /* Count lines if buffer changed */
-            if (old_len != state->editor.buffer_length) {
-                state->editor.line_count = 1;
-                for (size_t i = 0; i < state->editor.buffer_length; i++) {
-                    if (state->editor.buffer[i] == '\n') {
-                        state->editor.line_count++;
-                    }
-                }
+        /* Result of the last syntax check */
+        SyntaxCheck* check = &state->check;
+        if (state->build.use_libtcc && check->checked) {
+            char status[320];
+            if (check->error_count == 0) {
+                nk_label_colored(state->nk_ctx, "No errors", NK_TEXT_RIGHT,
+                    nk_rgb(106, 153, 85));
+            } else {
+                snprintf(status, sizeof(status), "%d error%s: %s",
+                    check->error_count, check->error_count == 1 ? "" : "s",
+                    check->first_error);
+                nk_label_colored(state->nk_ctx, status, NK_TEXT_RIGHT,
+                    nk_rgb(244, 71, 71));
             }
-            
-            nk_group_end(state->nk_ctx);
+        } else {
+            nk_spacing(state->nk_ctx, 1);
         }
         
-        nk_layout_row_end(state->nk_ctx);
+        /* Line numbers and text */
+        editor_widget(state, height - 180);
         
     } else {
         state->show_editor = 0;
@@ -793,12 +2010,22 @@ static void render_build_settings(IDEState* state) {
         nk_label(state->nk_ctx, "Build Configuration", NK_TEXT_CENTERED);
         
         /* Compiler settings */
+        nk_layout_row_dynamic(state->nk_ctx, 30, 2);
+        nk_label(state->nk_ctx, "Build in-process (libtcc):", NK_TEXT_LEFT);
+        nk_checkbox_label(state->nk_ctx, "", &state->build.use_libtcc);
+        
         nk_layout_row_dynamic(state->nk_ctx, 30, 1);
-        nk_label(state->nk_ctx, "Compiler:", NK_TEXT_LEFT);
+        nk_label(state->nk_ctx, "Compiler (when not in-process):", NK_TEXT_LEFT);
         nk_edit_string_zero_terminated(state->nk_ctx, NK_EDIT_FIELD,
             state->build.compiler, sizeof(state->build.compiler),
             nk_filter_default);
         
+        nk_layout_row_dynamic(state->nk_ctx, 30, 1);
+        nk_label(state->nk_ctx, "Run driver (compiles in memory):", NK_TEXT_LEFT);
+        nk_edit_string_zero_terminated(state->nk_ctx, NK_EDIT_FIELD,
+            state->build.runner, sizeof(state->build.runner),
+            nk_filter_default);
+        
         nk_layout_row_dynamic(state->nk_ctx, 30, 1);
         nk_label(state->nk_ctx, "Output file:", NK_TEXT_LEFT);
         nk_edit_string_zero_terminated(state->nk_ctx, NK_EDIT_FIELD,
@@ -853,28 +2080,42 @@ static void render_build_output(IDEState* state) {
         nk_rect(width/4, height/4, width/2, height/2),
         NK_WINDOW_BORDER | NK_WINDOW_TITLE | NK_WINDOW_MOVABLE)) {
         
+        /* Output streams in while building; progress counts finished files */
+        int log_height = height/2 - 100;
         if (state->building) {
-            nk_layout_row_dynamic(state->nk_ctx, 30, 1);
-            nk_label(state->nk_ctx, "Building...", NK_TEXT_CENTERED);
-            
-            nk_layout_row_dynamic(state->nk_ctx, 30, 1);
-            nk_progress(state->nk_ctx, &state->build_progress, 100, NK_FIXED);
-        } else {
-            nk_layout_row_dynamic(state->nk_ctx, height/2 - 100, 1);
-            
-            if (nk_group_begin(state->nk_ctx, "BuildOutput", NK_WINDOW_BORDER)) {
-                nk_layout_row_dynamic(state->nk_ctx, height/2 - 120, 1);
-                nk_edit_string_zero_terminated(state->nk_ctx, 
-                    NK_EDIT_BOX | NK_EDIT_READ_ONLY | NK_EDIT_MULTILINE,
-                    state->build_log, sizeof(state->build_log),
-                    nk_filter_default);
-                nk_group_end(state->nk_ctx);
+            char status[64];
+            int total = atomic_load(&state->build_job.files_total);
+            if (total > 0) {
+                snprintf(status, sizeof(status), "Building... %d/%d files",
+                    atomic_load(&state->build_job.files_done), total);
+            } else {
+                strcpy(status, "Building...");
             }
             
-            nk_layout_row_dynamic(state->nk_ctx, 40, 1);
-            if (nk_button_label(state->nk_ctx, "Close")) {
-                state->show_output = 0;
+            nk_layout_row_dynamic(state->nk_ctx, 30, 2);
+            nk_label(state->nk_ctx, status, NK_TEXT_LEFT);
+            nk_progress(state->nk_ctx, &state->build_progress, 100, NK_FIXED);
+            log_height -= 35;
+        }
+        
+        nk_layout_row_dynamic(state->nk_ctx, log_height, 1);
+        
+        if (nk_group_begin(state->nk_ctx, "BuildOutput", NK_WINDOW_BORDER)) {
+            nk_layout_row_dynamic(state->nk_ctx, log_height - 20, 1);
+            nk_edit_string_zero_terminated(state->nk_ctx, 
+                NK_EDIT_BOX | NK_EDIT_READ_ONLY | NK_EDIT_MULTILINE,
+                state->build_log, sizeof(state->build_log),
+                nk_filter_default);
+            nk_group_end(state->nk_ctx);
+        }
+        
+        nk_layout_row_dynamic(state->nk_ctx, 40, 1);
+        if (state->building) {
+            if (nk_button_label(state->nk_ctx, "Cancel")) {
+                cancel_build(state);
             }
+        } else if (nk_button_label(state->nk_ctx, "Close")) {
+            state->show_output = 0;
         }
         
     } else {
@@ -966,6 +2207,8 @@ int main(void) {
     /* Main loop */
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
+        poll_build(&g_state);
+        poll_syntax_check(&g_state);
         nk_glfw3_new_frame(&g_state.nk_glfw);
         
         /* Clear screen */
@@ -985,13 +2228,25 @@ int main(void) {
         glfwSwapBuffers(window);
     }
     
-    /* Cleanup */
+    /* Cleanup: a running build is cancelled and waited for */
+    if (g_state.building) {
+        cancel_build(&g_state);
+        while (g_state.building) {
+            poll_build(&g_state);
+            sleep_milliseconds(1);
+        }
+    }
+    if (g_state.check.running) {
+        thread_join(g_state.check.thread);
+        free(g_state.check.task.source);
+    }
     nk_glfw3_shutdown(&g_state.nk_glfw);
     glfwDestroyWindow(window);
     glfwTerminate();
     
     /* Free memory */
-    if (g_state.editor.buffer) free(g_state.editor.buffer);
+    editor_reset(&g_state.editor);
+    doc_free(&g_state.editor.doc);
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,421 @@
+#include "tcc.h"
+#define MIRULIT_HEADER_ONLY
+#include <mirulit.h>
+
+// Хост горячей перезагрузки. Движок (окно, миры, пулы, потоки) живет
+// здесь, а код игры компилируется libtcc прямо в память и
+// перекомпилируется, когда исходник сохранен или нажата F5. Сущности,
+// частицы, камера и блоки MIR_Hot_Keep при этом не теряются.
+//
+// Модуль игры экспортирует (см. config.c):
+//   void game_load(bool reloaded)    - после каждой загрузки, обязательна
+//   void game_update(float dt)       - каждый кадр, обязательна
+//   void game_draw(void)             - каждый кадр после update
+//   void game_unload(bool reloading) - перед заменой модуля и при выходе
+//
+// Если новая версия не компилируется, продолжает работать старая.
+// Старые модули не выгружаются до выхода: на их код и строки еще могут
+// ссылаться записи лога, зоны профилировщика, задачи в очереди и
+// static-обработчики, которые не перепривязать.
+//
+// Сборка хоста: gcc host.c -Idist/mirulit -Idist/include -L./ -llibtcc
+//               -Ldist/lib -lSDL3 -o dist/host.exe
+
+#define HOST_MAX_SOURCES 32
+#define HOST_MAX_MODULES 256
+#define HOST_WATCH_INTERVAL_NS (250 * SDL_NS_PER_MS)
+
+typedef void (*GameLoadFunc)(bool reloaded);
+typedef void (*GameUpdateFunc)(float dt);
+typedef void (*GameDrawFunc)(void);
+typedef void (*GameUnloadFunc)(bool reloading);
+
+// Параметры командной строки
+typedef struct {
+    const char* sources[HOST_MAX_SOURCES];
+    SDL_Time modify_times[HOST_MAX_SOURCES];
+    int source_count;
+
+    const char* include_paths[HOST_MAX_SOURCES];
+    int include_count;
+    const char* library_paths[HOST_MAX_SOURCES];
+    int library_path_count;
+    const char* libraries[HOST_MAX_SOURCES];
+    int library_count;
+    const char* defines[HOST_MAX_SOURCES];
+    int define_count;
+
+    const char* title;
+    int width;
+    int height;
+} HostOptions;
+
+// Загруженный модуль игры
+typedef struct {
+    TCCState* tcc;
+    GameLoadFunc load;
+    GameUpdateFunc update;
+    GameDrawFunc draw;
+    GameUnloadFunc unload;
+} GameModule;
+
+// Адрес -> имя экспортированной функции старого модуля
+typedef struct {
+    const void* address;
+    char* name;
+} ModuleSymbol;
+
+// Адреса, занятые модулем: от первого до последнего его глобального
+// символа. static-функции лежат между ними в той же секции кода.
+typedef struct {
+    uintptr_t begin;
+    uintptr_t end;
+} ModuleRange;
+
+typedef struct {
+    ModuleSymbol* symbols;
+    int count;
+    int capacity;
+    TCCState* target;           // новый модуль
+    const ModuleRange* ranges;  // все старые модули
+    int range_count;
+} RebindTable;
+
+static GameModule module = {0};
+static TCCState* retired_modules[HOST_MAX_MODULES];
+static ModuleRange retired_ranges[HOST_MAX_MODULES];
+static int retired_count = 0;
+
+// ==================== КОМПИЛЯЦИЯ МОДУЛЯ ====================
+
+// Ошибки и предупреждения tcc - в лог движка
+static void host_tcc_error(void* opaque, const char* message) {
+    (void)opaque;
+    MIR_Log(strstr(message, "warning") ? MIR_LOG_WARN : MIR_LOG_ERROR, "%s", message);
+}
+
+static void host_export_symbol(void* ctx, const char* name, void* address) {
+    tcc_add_symbol((TCCState*)ctx, name, address);
+}
+
+// Модуль должен видеть те же настройки движка, что и хост: от них
+// зависят размеры общих структур
+static void host_define_engine_config(TCCState* tcc) {
+    char value[32];
+
+    tcc_define_symbol(tcc, "MIRULIT_HOT_MODULE", NULL);
+#ifdef MIRULIT_ENABLE_SDL_IMAGE
+    tcc_define_symbol(tcc, "MIRULIT_ENABLE_SDL_IMAGE", NULL);
+#endif
+#ifdef MIRULIT_ENABLE_SDL_TTF
+    tcc_define_symbol(tcc, "MIRULIT_ENABLE_SDL_TTF", NULL);
+#endif
+#ifdef MIRULIT_ENABLE_PHYSICS
+    tcc_define_symbol(tcc, "MIRULIT_ENABLE_PHYSICS", NULL);
+#endif
+#ifdef MIRULIT_ENABLE_PROFILER
+    tcc_define_symbol(tcc, "MIRULIT_ENABLE_PROFILER", NULL);
+#endif
+    snprintf(value, sizeof(value), "%d", MIRULIT_MAX_ENTITIES);
+    tcc_define_symbol(tcc, "MIRULIT_MAX_ENTITIES", value);
+    snprintf(value, sizeof(value), "%d", MIRULIT_MAX_PARTICLES);
+    tcc_define_symbol(tcc, "MIRULIT_MAX_PARTICLES", value);
+    snprintf(value, sizeof(value), "%d", MIRULIT_LOG_LEVEL);
+    tcc_define_symbol(tcc, "MIRULIT_LOG_LEVEL", value);
+}
+
+// Компиляция исходников игры в память. NULL при ошибке.
+static TCCState* host_compile(const HostOptions* options) {
+    TCCState* tcc = tcc_new();
+    if (!tcc) {
+        MIR_Log(MIR_LOG_ERROR, "Cannot create TCC instance");
+        return NULL;
+    }
+
+    tcc_set_error_func(tcc, NULL, host_tcc_error);
+    tcc_set_output_type(tcc, TCC_OUTPUT_MEMORY);
+
+    // Те же пути, что у compiler.exe
+    tcc_add_include_path(tcc, "include");
+    tcc_add_include_path(tcc, ".");
+    tcc_add_include_path(tcc, "src");
+    tcc_add_include_path(tcc, "mirulit");
+    for (int i = 0; i < options->include_count; i++) {
+        tcc_add_include_path(tcc, options->include_paths[i]);
+    }
+
+    host_define_engine_config(tcc);
+    for (int i = 0; i < options->define_count; i++) {
+        tcc_define_symbol(tcc, options->defines[i], NULL);
+    }
+
+    for (int i = 0; i < options->source_count; i++) {
+        if (tcc_add_file(tcc, options->sources[i]) != 0) {
+            MIR_Log(MIR_LOG_ERROR, "Failed to compile %s", options->sources[i]);
+            tcc_delete(tcc);
+            return NULL;
+        }
+    }
+
+    tcc_add_library_path(tcc, "lib");
+    tcc_add_library_path(tcc, ".");
+    for (int i = 0; i < options->library_path_count; i++) {
+        tcc_add_library_path(tcc, options->library_paths[i]);
+    }
+    tcc_add_library(tcc, "SDL3");
+    for (int i = 0; i < options->library_count; i++) {
+        tcc_add_library(tcc, options->libraries[i]);
+    }
+#ifndef _WIN32
+    tcc_add_library(tcc, "m");
+#endif
+
+    // Переменные состояния движка модуля - это переменные хоста
+    MIR_Hot_ExportState(host_export_symbol, tcc);
+
+    if (tcc_relocate(tcc) < 0) {
+        MIR_Log(MIR_LOG_ERROR, "Failed to link game module");
+        tcc_delete(tcc);
+        return NULL;
+    }
+    return tcc;
+}
+
+// ==================== ПЕРЕПРИВЯЗКА ====================
+
+static void host_collect_symbol(void* ctx, const char* name, const void* address) {
+    RebindTable* table = (RebindTable*)ctx;
+    if (table->count >= table->capacity) {
+        int capacity = table->capacity ? table->capacity * 2 : 256;
+        ModuleSymbol* symbols = (ModuleSymbol*)realloc(table->symbols, capacity * sizeof(ModuleSymbol));
+        if (!symbols) return;
+        table->symbols = symbols;
+        table->capacity = capacity;
+    }
+    table->symbols[table->count].address = address;
+    table->symbols[table->count].name = strdup(name);
+    table->count++;
+}
+
+// Старый адрес -> имя -> адрес в новом модуле. Адрес вне старых
+// модулей (функции хоста и библиотек) остается как есть, адрес в старом
+// модуле без замены - NULL (см. MIR_HotRebindFunc).
+static void* host_rebind_function(void* ctx, void* function) {
+    RebindTable* table = (RebindTable*)ctx;
+    for (int i = 0; i < table->count; i++) {
+        if (table->symbols[i].address == function) {
+            return tcc_get_symbol(table->target, table->symbols[i].name);
+        }
+    }
+
+    uintptr_t address = (uintptr_t)function;
+    for (int i = 0; i < table->range_count; i++) {
+        if (address >= table->ranges[i].begin && address <= table->ranges[i].end) {
+            return NULL;
+        }
+    }
+    return function;
+}
+
+// Границы старого модуля. Внешние символы (переменные хоста, SDL, libc)
+// разрешаются в новом модуле в тот же адрес и в границы не входят.
+static ModuleRange host_module_range(const RebindTable* table) {
+    ModuleRange range = { UINTPTR_MAX, 0 };
+    for (int i = 0; i < table->count; i++) {
+        const ModuleSymbol* symbol = &table->symbols[i];
+        if (tcc_get_symbol(table->target, symbol->name) == symbol->address) continue;
+
+        uintptr_t address = (uintptr_t)symbol->address;
+        if (address < range.begin) range.begin = address;
+        if (address > range.end) range.end = address;
+    }
+    return range;
+}
+
+// Перепривязка обработчиков всех миров; границы old_tcc записываются
+// в retired_ranges[retired_count]
+static void host_rebind_callbacks(TCCState* old_tcc, TCCState* new_tcc) {
+    RebindTable table = {0};
+    table.target = new_tcc;
+    tcc_list_symbols(old_tcc, &table, host_collect_symbol);
+
+    retired_ranges[retired_count] = host_module_range(&table);
+    table.ranges = retired_ranges;
+    table.range_count = retired_count + 1;
+
+    int stale = MIR_Hot_RebindWorlds(host_rebind_function, &table);
+    if (stale > 0) {
+        MIR_Log(MIR_LOG_WARN, "%d callbacks stay on old code (static or removed functions)", stale);
+    }
+
+    for (int i = 0; i < table.count; i++) {
+        free(table.symbols[i].name);
+    }
+    free(table.symbols);
+}
+
+// ==================== ЗАГРУЗКА ====================
+
+// Компиляция и подмена модуля. При ошибке работает прежний модуль.
+static bool host_load_module(const HostOptions* options) {
+    uint64_t start = SDL_GetTicksNS();
+
+    TCCState* tcc = host_compile(options);
+    if (!tcc) return false;
+
+    GameModule next = {0};
+    next.tcc = tcc;
+    next.load = (GameLoadFunc)tcc_get_symbol(tcc, "game_load");
+    next.update = (GameUpdateFunc)tcc_get_symbol(tcc, "game_update");
+    next.draw = (GameDrawFunc)tcc_get_symbol(tcc, "game_draw");
+    next.unload = (GameUnloadFunc)tcc_get_symbol(tcc, "game_unload");
+    if (!next.load || !next.update) {
+        MIR_Log(MIR_LOG_ERROR, "Game module must export game_load and game_update");
+        tcc_delete(tcc);
+        return false;
+    }
+
+    bool reloaded = module.tcc != NULL;
+    if (reloaded) {
+        if (retired_count >= HOST_MAX_MODULES) {
+            MIR_Log(MIR_LOG_ERROR, "Too many reloads (max %d), restart the host", HOST_MAX_MODULES);
+            tcc_delete(tcc);
+            return false;
+        }
+        if (module.unload) module.unload(true);
+
+        host_rebind_callbacks(module.tcc, tcc);
+        retired_modules[retired_count++] = module.tcc;
+    }
+
+    module = next;
+    module.load(reloaded);
+
+    MIR_Log(MIR_LOG_INFO, "Game module %s in %.1f ms", reloaded ? "reloaded" : "loaded",
+            (SDL_GetTicksNS() - start) / 1e6);
+    return true;
+}
+
+// Время изменения исходников; true, если какой-то изменился
+static bool host_sources_changed(HostOptions* options) {
+    bool changed = false;
+    for (int i = 0; i < options->source_count; i++) {
+        SDL_PathInfo info;
+        if (!SDL_GetPathInfo(options->sources[i], &info)) continue;
+        if (info.modify_time != options->modify_times[i]) {
+            options->modify_times[i] = info.modify_time;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// ==================== ТОЧКА ВХОДА ====================
+
+static void host_show_help(const char* program_name) {
+    printf("Mirulit Hot Reload Host\n");
+    printf("Usage: %s [options] <game.c> [additional_sources...]\n\n", program_name);
+    printf("Options:\n");
+    printf("  -I <path>          Add include path\n");
+    printf("  -L <path>          Add library path\n");
+    printf("  -l <lib>           Link with library\n");
+    printf("  -D <sym>           Define preprocessor symbol\n");
+    printf("  --title <text>     Window title\n");
+    printf("  --size <w>x<h>     Window size (default 800x600)\n");
+    printf("  -h, --help         Show this help\n");
+    printf("\nSave a source file or press F5 to reload the game code.\n");
+}
+
+int main(int argc, char** argv) {
+    HostOptions options = {0};
+    options.title = "Mirulit Host";
+    options.width = 800;
+    options.height = 600;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            host_show_help(argv[0]);
+            return 0;
+        }
+        else if (strcmp(arg, "-I") == 0 && has_value && options.include_count < HOST_MAX_SOURCES) {
+            options.include_paths[options.include_count++] = argv[++i];
+        }
+        else if (strcmp(arg, "-L") == 0 && has_value && options.library_path_count < HOST_MAX_SOURCES) {
+            options.library_paths[options.library_path_count++] = argv[++i];
+        }
+        else if (strcmp(arg, "-l") == 0 && has_value && options.library_count < HOST_MAX_SOURCES) {
+            options.libraries[options.library_count++] = argv[++i];
+        }
+        else if (strcmp(arg, "-D") == 0 && has_value && options.define_count < HOST_MAX_SOURCES) {
+            options.defines[options.define_count++] = argv[++i];
+        }
+        else if (strcmp(arg, "--title") == 0 && has_value) {
+            options.title = argv[++i];
+        }
+        else if (strcmp(arg, "--size") == 0 && has_value) {
+            if (sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2) {
+                fprintf(stderr, "Invalid size: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (arg[0] == '-') {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            fprintf(stderr, "Use %s --help for usage information\n", argv[0]);
+            return 1;
+        }
+        else if (options.source_count < HOST_MAX_SOURCES) {
+            options.sources[options.source_count++] = arg;
+        }
+    }
+
+    if (options.source_count == 0) {
+        fprintf(stderr, "ERROR: No game source given\n");
+        host_show_help(argv[0]);
+        return 1;
+    }
+
+    if (!MIR_Init(options.title, options.width, options.height)) {
+        return 1;
+    }
+
+    host_sources_changed(&options);
+    if (!host_load_module(&options)) {
+        MIR_Shutdown();
+        return 1;
+    }
+
+    uint64_t next_watch = SDL_GetTicksNS() + HOST_WATCH_INTERVAL_NS;
+
+    while (MIR_IsRunning()) {
+        MIR_ProcessEvents();
+
+        // Опрос времени изменения - раз в HOST_WATCH_INTERVAL_NS
+        bool reload = MIR_IsKeyPressed(SDLK_F5);
+        uint64_t now = SDL_GetTicksNS();
+        if (now >= next_watch) {
+            next_watch = now + HOST_WATCH_INTERVAL_NS;
+            reload |= host_sources_changed(&options);
+        }
+        if (reload) {
+            host_load_module(&options);
+        }
+
+        MIR_BeginFrame();
+        module.update(MIR_GetDeltaTime());
+        if (module.draw) module.draw();
+        MIR_EndFrame();
+    }
+
+    if (module.unload) module.unload(false);
+
+    // on_destroy сущностей указывают в модули - удаляем их после движка
+    MIR_Shutdown();
+    tcc_delete(module.tcc);
+    for (int i = 0; i < retired_count; i++) {
+        tcc_delete(retired_modules[i]);
+    }
+    return 0;
+}